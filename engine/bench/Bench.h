@@ -0,0 +1,46 @@
+#pragma once
+#include <chrono>
+#include <string>
+
+#define GENX_BENCHMARK(name) \
+    static void name(); \
+    static eng::bench::Registrar name##Registrar(#name, name); \
+    static void name()
+
+namespace eng
+{
+    namespace bench
+    {
+        using BenchFunction = void (*)();
+
+        struct Registrar
+        {
+            Registrar(const char* name, BenchFunction function);
+        };
+
+        // Prints "<benchmark> <metric> <value>" so runs are easy to diff and parse
+        void Report(const std::string& benchmark, const std::string& metric, double value);
+        // Marks the run as failed, e.g. an optimized kernel disagreeing with its reference. The process then
+        // exits with 1 after the remaining benchmarks.
+        void Fail(const std::string& benchmark, const std::string& reason);
+
+        class Timer
+        {
+        public:
+            Timer() : m_start(std::chrono::steady_clock::now())
+            {
+            }
+
+            double ElapsedMs() const
+            {
+                return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_start).count();
+            }
+
+        private:
+            std::chrono::steady_clock::time_point m_start;
+        };
+
+        // Keeps the optimizer from discarding a computed value
+        void DoNotOptimize(const void* value);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,65 @@
+#include "Bench.h"
+#include <cstring>
+#include <iostream>
+#include <vector>
+
+namespace eng
+{
+    namespace bench
+    {
+        struct Entry
+        {
+            const char* name;
+            BenchFunction function;
+        };
+
+        static std::vector<Entry>& GetRegistry()
+        {
+            static std::vector<Entry> registry;
+            return registry;
+        }
+
+        Registrar::Registrar(const char* name, BenchFunction function)
+        {
+            GetRegistry().push_back({ name, function });
+        }
+
+        void Report(const std::string& benchmark, const std::string& metric, double value)
+        {
+            std::cout << benchmark << " " << metric << " " << value << std::endl;
+        }
+
+        static bool g_failed = false;
+
+        void Fail(const std::string& benchmark, const std::string& reason)
+        {
+            std::cerr << "FAILED " << benchmark << ": " << reason << std::endl;
+            g_failed = true;
+        }
+
+        const void* volatile g_optimizerSink = nullptr;
+
+        void DoNotOptimize(const void* value)
+        {
+            g_optimizerSink = value;
+        }
+    }
+}
+
+// Runs every benchmark, or only those whose name contains one of the arguments
+int main(int argc, char** argv)
+{
+    for (auto& entry : eng::bench::GetRegistry())
+    {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc && !selected; ++i)
+        {
+            selected = strstr(entry.name, argv[i]) != nullptr;
+        }
+        if (selected)
+        {
+            entry.function();
+        }
+    }
+    return eng::bench::g_failed ? 1 : 0;
+}
\ No newline at end of file
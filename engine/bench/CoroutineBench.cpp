@@ -0,0 +1,104 @@
+#include "Bench.h"
+#include "coro/TaskScheduler.h"
+#include <new>
+#include <vector>
+
+namespace
+{
+    eng::Task<int> Step(eng::TaskScheduler& scheduler, int value)
+    {
+        co_await scheduler.NextFrame();
+        co_return value + 1;
+    }
+
+    eng::Task<> Script(eng::TaskScheduler& scheduler, int frames, int& total)
+    {
+        for (int i = 0; i < frames; ++i)
+        {
+            total += co_await Step(scheduler, i);
+        }
+    }
+}
+
+GENX_BENCHMARK(CoroutineScripts)
+{
+    // Thousands of scripts that each start a child task per frame, so every frame allocates and frees a
+    // coroutine frame per script
+    const int scriptCount = 10000;
+    const int frames = 100;
+    eng::TaskScheduler scheduler;
+    int total = 0;
+
+    eng::bench::Timer spawnTimer;
+    for (int i = 0; i < scriptCount; ++i)
+    {
+        scheduler.Spawn(Script(scheduler, frames, total));
+    }
+    double spawnElapsed = spawnTimer.ElapsedMs();
+
+    eng::bench::Timer updateTimer;
+    for (int frame = 0; frame < frames; ++frame)
+    {
+        scheduler.Update(1.0f / 60.0f);
+    }
+    double updateElapsed = updateTimer.ElapsedMs();
+    eng::bench::DoNotOptimize(&total);
+
+    eng::bench::Report("CoroutineScripts/spawn", "ns_per_task", spawnElapsed * 1e6 / scriptCount);
+    eng::bench::Report("CoroutineScripts/update", "ms_per_frame", updateElapsed / frames);
+    eng::bench::Report("CoroutineScripts", "remaining_tasks", static_cast<double>(scheduler.GetTaskCount()));
+}
+
+GENX_BENCHMARK(CoroutineFramePool)
+{
+    // Allocation pattern of the scripts above: many live frames, each churning a short-lived one
+    const int liveCount = 10000;
+    const int rounds = 100;
+    const size_t liveBytes = 192;
+    const size_t childBytes = 96;
+    std::vector<void*> live(liveCount);
+
+    eng::bench::Timer heapTimer;
+    for (int i = 0; i < liveCount; ++i)
+    {
+        live[i] = ::operator new(liveBytes);
+    }
+    for (int round = 0; round < rounds; ++round)
+    {
+        for (int i = 0; i < liveCount; ++i)
+        {
+            void* child = ::operator new(childBytes);
+            eng::bench::DoNotOptimize(child);
+            ::operator delete(child);
+        }
+    }
+    for (void* frame : live)
+    {
+        ::operator delete(frame);
+    }
+    double heapElapsed = heapTimer.ElapsedMs();
+
+    eng::bench::Timer poolTimer;
+    for (int i = 0; i < liveCount; ++i)
+    {
+        live[i] = eng::AllocateCoroutineFrame(liveBytes);
+    }
+    for (int round = 0; round < rounds; ++round)
+    {
+        for (int i = 0; i < liveCount; ++i)
+        {
+            void* child = eng::AllocateCoroutineFrame(childBytes);
+            eng::bench::DoNotOptimize(child);
+            eng::FreeCoroutineFrame(child, childBytes);
+        }
+    }
+    for (void* frame : live)
+    {
+        eng::FreeCoroutineFrame(frame, liveBytes);
+    }
+    double poolElapsed = poolTimer.ElapsedMs();
+
+    const double operations = static_cast<double>(liveCount) * (rounds + 1);
+    eng::bench::Report("CoroutineFramePool/heap", "ns_per_frame", heapElapsed * 1e6 / operations);
+    eng::bench::Report("CoroutineFramePool/pool", "ns_per_frame", poolElapsed * 1e6 / operations);
+}
\ No newline at end of file
@@ -0,0 +1,94 @@
+#include "Bench.h"
+#include "render/FrustumCulling.h"
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    // Column-major perspective * look-down-negative-z view, 90 degree vertical field of view
+    void MakeViewProjection(float* m)
+    {
+        const float nearPlane = 0.1f;
+        const float farPlane = 500.0f;
+        const float aspect = 16.0f / 9.0f;
+        const float f = 1.0f / std::tan(3.14159265f / 4.0f);
+        for (int i = 0; i < 16; ++i)
+        {
+            m[i] = 0.0f;
+        }
+        m[0] = f / aspect;
+        m[5] = f;
+        m[10] = (farPlane + nearPlane) / (nearPlane - farPlane);
+        m[11] = -1.0f;
+        m[14] = 2.0f * farPlane * nearPlane / (nearPlane - farPlane);
+    }
+
+    const char* PathName(eng::CullingPath path)
+    {
+        switch (path)
+        {
+        case eng::CullingPath::AVX2:
+            return "avx2";
+        case eng::CullingPath::SSE:
+            return "sse";
+        default:
+            return "scalar";
+        }
+    }
+}
+
+GENX_BENCHMARK(FrustumCullBoxes)
+{
+    const size_t objectCount = 1 << 20;
+    const int iterations = 20;
+
+    std::mt19937 random(1234);
+    std::uniform_real_distribution<float> position(-500.0f, 500.0f);
+    std::uniform_real_distribution<float> size(0.1f, 4.0f);
+
+    eng::CullingBounds bounds;
+    bounds.Reserve(objectCount);
+    for (size_t i = 0; i < objectCount; ++i)
+    {
+        eng::BoundingBox box;
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            float center = position(random);
+            float extent = size(random);
+            box.min[axis] = center - extent;
+            box.max[axis] = center + extent;
+        }
+        bounds.Add(box);
+    }
+
+    float viewProjection[16];
+    MakeViewProjection(viewProjection);
+    eng::Frustum frustum = eng::Frustum::FromViewProjection(viewProjection);
+    std::vector<uint8_t> visible(objectCount);
+
+    const eng::CullingPath original = eng::GetCullingPath();
+    for (eng::CullingPath path : { eng::CullingPath::Scalar, eng::CullingPath::SSE, eng::CullingPath::AVX2 })
+    {
+        eng::SetCullingPath(path);
+        if (eng::GetCullingPath() != path)
+        {
+            continue;
+        }
+
+        size_t visibleCount = eng::CullBoxes(frustum, bounds, visible.data());
+        eng::bench::Timer timer;
+        for (int i = 0; i < iterations; ++i)
+        {
+            visibleCount = eng::CullBoxes(frustum, bounds, visible.data());
+            eng::bench::DoNotOptimize(visible.data());
+        }
+        double elapsed = timer.ElapsedMs();
+
+        std::string name = std::string("FrustumCullBoxes/") + PathName(path);
+        eng::bench::Report(name, "objects_tested_per_ms", objectCount * iterations / elapsed);
+        eng::bench::Report(name, "objects_culled_per_ms", (objectCount - visibleCount) * iterations / elapsed);
+        eng::bench::Report(name, "visible", static_cast<double>(visibleCount));
+    }
+    eng::SetCullingPath(original);
+}
\ No newline at end of file
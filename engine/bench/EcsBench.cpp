@@ -0,0 +1,218 @@
+#include "Bench.h"
+#include "ecs/CommandBuffer.h"
+#include "ecs/World.h"
+#include <memory>
+#include <vector>
+
+namespace
+{
+    const size_t EntityCount = 100000;
+    const int Iterations = 50;
+
+    struct Position
+    {
+        float x, y, z;
+    };
+
+    struct Velocity
+    {
+        float x, y, z;
+    };
+
+    struct Health
+    {
+        float value;
+    };
+
+    struct Frozen
+    {
+    };
+
+    // The layout the demo uses today: one heap object per thing with its state as members
+    struct GameObject
+    {
+        virtual ~GameObject() = default;
+        virtual void Update(float deltaTime)
+        {
+            position.x += velocity.x * deltaTime;
+            position.y += velocity.y * deltaTime;
+            position.z += velocity.z * deltaTime;
+        }
+
+        Position position = {};
+        Velocity velocity = { 1.0f, 2.0f, 3.0f };
+        float other[16] = {};
+    };
+
+    // Four archetypes share Position and Velocity, so queries walk several of them
+    void Populate(eng::World& world, size_t count)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            switch (i & 3)
+            {
+            case 0:
+                world.CreateEntity(Position{}, Velocity{ 1.0f, 2.0f, 3.0f });
+                break;
+            case 1:
+                world.CreateEntity(Position{}, Velocity{ 1.0f, 2.0f, 3.0f }, Health{ 100.0f });
+                break;
+            case 2:
+                world.CreateEntity(Position{}, Velocity{ 1.0f, 2.0f, 3.0f }, Frozen{});
+                break;
+            default:
+                world.CreateEntity(Position{}, Velocity{ 1.0f, 2.0f, 3.0f }, Health{ 100.0f }, Frozen{});
+                break;
+            }
+        }
+    }
+}
+
+GENX_BENCHMARK(EcsIterate)
+{
+    const float deltaTime = 1.0f / 60.0f;
+
+    std::vector<std::unique_ptr<GameObject>> objects;
+    for (size_t i = 0; i < EntityCount; ++i)
+    {
+        objects.push_back(std::make_unique<GameObject>());
+    }
+    eng::bench::Timer objectTimer;
+    for (int i = 0; i < Iterations; ++i)
+    {
+        for (auto& object : objects)
+        {
+            object->Update(deltaTime);
+        }
+        eng::bench::DoNotOptimize(objects.data());
+    }
+    eng::bench::Report("EcsIterate/objects", "entities_per_ms", EntityCount * Iterations / objectTimer.ElapsedMs());
+
+    eng::World world;
+    Populate(world, EntityCount);
+    eng::Query& query = world.CreateQuery<Position, Velocity>();
+
+    eng::bench::Timer eachTimer;
+    for (int i = 0; i < Iterations; ++i)
+    {
+        query.ForEach<Position, Velocity>([deltaTime](Position& position, const Velocity& velocity)
+        {
+            position.x += velocity.x * deltaTime;
+            position.y += velocity.y * deltaTime;
+            position.z += velocity.z * deltaTime;
+        });
+    }
+    eng::bench::Report("EcsIterate/for_each", "entities_per_ms", EntityCount * Iterations / eachTimer.ElapsedMs());
+
+    eng::bench::Timer chunkTimer;
+    for (int i = 0; i < Iterations; ++i)
+    {
+        query.ForEachChunk<Position, Velocity>(
+            [deltaTime](size_t count, const eng::Entity*, Position* positions, const Velocity* velocities)
+        {
+            for (size_t j = 0; j < count; ++j)
+            {
+                positions[j].x += velocities[j].x * deltaTime;
+                positions[j].y += velocities[j].y * deltaTime;
+                positions[j].z += velocities[j].z * deltaTime;
+            }
+        });
+    }
+    eng::bench::Report("EcsIterate/for_each_chunk", "entities_per_ms",
+        EntityCount * Iterations / chunkTimer.ElapsedMs());
+
+    // Only the half without the tag, two of the four archetypes
+    eng::Query& filtered = world.CreateQuery<Position, Velocity>(eng::ComponentMaskOf<Frozen>());
+    eng::bench::Timer filteredTimer;
+    for (int i = 0; i < Iterations; ++i)
+    {
+        filtered.ForEach<Position, Velocity>([deltaTime](Position& position, const Velocity& velocity)
+        {
+            position.x += velocity.x * deltaTime;
+        });
+    }
+    eng::bench::Report("EcsIterate/excluding_tag", "entities_per_ms",
+        filtered.GetEntityCount() * Iterations / filteredTimer.ElapsedMs());
+}
+
+GENX_BENCHMARK(EcsAddRemoveComponent)
+{
+    eng::World world;
+    std::vector<eng::Entity> entities;
+    for (size_t i = 0; i < EntityCount; ++i)
+    {
+        entities.push_back(world.CreateEntity(Position{}, Velocity{}));
+    }
+
+    eng::bench::Timer directTimer;
+    for (eng::Entity entity : entities)
+    {
+        world.AddComponent(entity, Health{ 1.0f });
+    }
+    for (eng::Entity entity : entities)
+    {
+        world.RemoveComponent<Health>(entity);
+    }
+    eng::bench::Report("EcsAddRemoveComponent/direct", "changes_per_ms", 2 * EntityCount / directTimer.ElapsedMs());
+
+    // Recorded during iteration, the way systems make structural changes
+    eng::Query& query = world.CreateQuery<Position>();
+    eng::CommandBuffer commands;
+    eng::bench::Timer bufferedTimer;
+    query.ForEachChunk<Position>([&commands](size_t count, const eng::Entity* chunkEntities, Position*)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            commands.AddComponent(chunkEntities[i], Health{ 1.0f });
+        }
+    });
+    commands.Playback(world);
+    query.ForEachChunk<Position>([&commands](size_t count, const eng::Entity* chunkEntities, Position*)
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            commands.RemoveComponent<Health>(chunkEntities[i]);
+        }
+    });
+    commands.Playback(world);
+    eng::bench::Report("EcsAddRemoveComponent/command_buffer", "changes_per_ms",
+        2 * EntityCount / bufferedTimer.ElapsedMs());
+}
+
+GENX_BENCHMARK(EcsCreateEntities)
+{
+    {
+        eng::World world;
+        eng::bench::Timer timer;
+        for (size_t i = 0; i < EntityCount; ++i)
+        {
+            world.CreateEntity(Position{}, Velocity{}, Health{ 100.0f });
+        }
+        eng::bench::Report("EcsCreateEntities/cold", "entities_per_ms", EntityCount / timer.ElapsedMs());
+    }
+
+    // Reuses freed handles and chunks, the steady state of a game spawning and despawning
+    eng::World world;
+    std::vector<eng::Entity> entities;
+    for (size_t i = 0; i < EntityCount; ++i)
+    {
+        entities.push_back(world.CreateEntity(Position{}, Velocity{}, Health{ 100.0f }));
+    }
+    for (eng::Entity entity : entities)
+    {
+        world.DestroyEntity(entity);
+    }
+    eng::bench::Timer warmTimer;
+    for (size_t i = 0; i < EntityCount; ++i)
+    {
+        entities[i] = world.CreateEntity(Position{}, Velocity{}, Health{ 100.0f });
+    }
+    eng::bench::Report("EcsCreateEntities/warm", "entities_per_ms", EntityCount / warmTimer.ElapsedMs());
+
+    eng::bench::Timer destroyTimer;
+    for (eng::Entity entity : entities)
+    {
+        world.DestroyEntity(entity);
+    }
+    eng::bench::Report("EcsCreateEntities/destroy", "entities_per_ms", EntityCount / destroyTimer.ElapsedMs());
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#include "Bench.h"
+#include "time/FramePacer.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <ctime>
+#include <string>
+
+namespace
+{
+    // A frame's worth of CPU work without a window
+    void BusyFor(double seconds)
+    {
+        const auto end = std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds);
+        while (std::chrono::steady_clock::now() < end)
+        {
+        }
+    }
+
+    void RunPaced(const std::string& name, double targetFrameRate, eng::FrameWaitMode mode)
+    {
+        const int frames = 240;
+        const double workSeconds = 0.002;
+        eng::FramePacer pacer;
+        pacer.SetTargetFrameRate(targetFrameRate);
+        pacer.SetWaitMode(mode);
+
+        double sum = 0.0;
+        double sumSquares = 0.0;
+        double worst = 0.0;
+        const std::clock_t cpuStart = std::clock();
+        eng::bench::Timer wall;
+        pacer.Wait();
+        for (int i = 0; i < frames; ++i)
+        {
+            BusyFor(workSeconds);
+            pacer.Wait();
+            const double frameMs = pacer.GetLastFrameTime() * 1000.0;
+            sum += frameMs;
+            sumSquares += frameMs * frameMs;
+            worst = std::max(worst, frameMs);
+        }
+        const double wallMs = wall.ElapsedMs();
+        const double cpuMs = 1000.0 * static_cast<double>(std::clock() - cpuStart) / CLOCKS_PER_SEC;
+
+        const double mean = sum / frames;
+        eng::bench::Report(name, "cpu_percent", 100.0 * cpuMs / wallMs);
+        eng::bench::Report(name, "mean_frame_ms", mean);
+        eng::bench::Report(name, "stddev_frame_ms", std::sqrt(std::max(0.0, sumSquares / frames - mean * mean)));
+        eng::bench::Report(name, "worst_frame_ms", worst);
+    }
+}
+
+GENX_BENCHMARK(FramePacer)
+{
+    // 2 ms of work per frame held to 120 fps: sleeping should cut CPU to about a quarter of a core, the spin
+    // tail should keep frame times as tight as spinning the whole wait
+    RunPaced("FramePacer/unlimited", 0.0, eng::FrameWaitMode::Hybrid);
+    RunPaced("FramePacer/spin", 120.0, eng::FrameWaitMode::Spin);
+    RunPaced("FramePacer/sleep", 120.0, eng::FrameWaitMode::Sleep);
+    RunPaced("FramePacer/hybrid", 120.0, eng::FrameWaitMode::Hybrid);
+}
\ No newline at end of file
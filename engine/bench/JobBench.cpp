@@ -0,0 +1,110 @@
+#include "Bench.h"
+#include "jobs/JobSystem.h"
+#include <cmath>
+#include <vector>
+
+namespace
+{
+    float Work(float value)
+    {
+        return std::sqrt(value) * std::sin(value) + std::cos(value * 0.5f);
+    }
+}
+
+GENX_BENCHMARK(JobParallelFor)
+{
+    const size_t count = 1 << 22;
+    std::vector<float> values(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        values[i] = static_cast<float>(i) * 0.001f;
+    }
+    std::vector<float> out(count);
+
+    eng::bench::Timer serialTimer;
+    for (size_t i = 0; i < count; ++i)
+    {
+        out[i] = Work(values[i]);
+    }
+    double serialElapsed = serialTimer.ElapsedMs();
+    eng::bench::DoNotOptimize(out.data());
+
+    eng::JobSystem jobs;
+    jobs.Init();
+    eng::bench::Timer parallelTimer;
+    jobs.ParallelFor(count, [&](size_t begin, size_t end)
+    {
+        for (size_t i = begin; i < end; ++i)
+        {
+            out[i] = Work(values[i]);
+        }
+    });
+    double parallelElapsed = parallelTimer.ElapsedMs();
+    eng::bench::DoNotOptimize(out.data());
+
+    eng::bench::Report("JobParallelFor", "threads", static_cast<double>(jobs.GetThreadCount()));
+    eng::bench::Report("JobParallelFor/serial", "ms", serialElapsed);
+    eng::bench::Report("JobParallelFor/parallel", "ms", parallelElapsed);
+    eng::bench::Report("JobParallelFor", "speedup", serialElapsed / parallelElapsed);
+}
+
+GENX_BENCHMARK(JobThroughput)
+{
+    // Empty jobs, so this is the scheduling cost per job
+    const int jobCount = 100000;
+    eng::JobSystem jobs;
+    jobs.Init();
+
+    eng::JobCounter counter;
+    eng::bench::Timer timer;
+    for (int i = 0; i < jobCount; ++i)
+    {
+        jobs.Run([]() {}, &counter);
+    }
+    jobs.Wait(counter);
+    eng::bench::Report("JobThroughput", "jobs_per_ms", jobCount / timer.ElapsedMs());
+
+    // A chain where every job waits for the previous one through a dependency
+    const int chainLength = 10000;
+    std::vector<eng::JobCounter> links(chainLength);
+    eng::bench::Timer chainTimer;
+    for (int i = 0; i < chainLength; ++i)
+    {
+        jobs.Run([]() {}, &links[i], i > 0 ? &links[i - 1] : nullptr);
+    }
+    jobs.Wait(links.back());
+    eng::bench::Report("JobThroughput/dependency_chain", "jobs_per_ms", chainLength / chainTimer.ElapsedMs());
+}
+
+GENX_BENCHMARK(JobFiberWait)
+{
+    // Every job waits on a child job, on a fiber that suspends versus on the thread that helps in place
+    const int jobCount = 20000;
+    eng::JobSystem jobs;
+    jobs.Init();
+
+    auto waitOnChild = [&jobs]()
+    {
+        eng::JobCounter child;
+        jobs.Run([]() {}, &child);
+        jobs.Wait(child);
+    };
+
+    eng::JobCounter helping;
+    eng::bench::Timer helpingTimer;
+    for (int i = 0; i < jobCount; ++i)
+    {
+        jobs.Run(waitOnChild, &helping);
+    }
+    jobs.Wait(helping);
+    eng::bench::Report("JobFiberWait/helping", "jobs_per_ms", jobCount / helpingTimer.ElapsedMs());
+
+    eng::JobCounter suspending;
+    eng::bench::Timer fiberTimer;
+    for (int i = 0; i < jobCount; ++i)
+    {
+        jobs.RunOnFiber(waitOnChild, &suspending);
+    }
+    jobs.Wait(suspending);
+    eng::bench::Report("JobFiberWait/fiber", "jobs_per_ms", jobCount / fiberTimer.ElapsedMs());
+}
\ No newline at end of file
@@ -0,0 +1,265 @@
+#include "Bench.h"
+#include "math/BatchMath.h"
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace
+{
+    const char* PathName(eng::SimdPath path)
+    {
+        switch (path)
+        {
+        case eng::SimdPath::AVX2:
+            return "avx2";
+        case eng::SimdPath::SSE:
+            return "sse";
+        case eng::SimdPath::NEON:
+            return "neon";
+        default:
+            return "scalar";
+        }
+    }
+
+    const eng::SimdPath AllPaths[] = { eng::SimdPath::Scalar, eng::SimdPath::SSE, eng::SimdPath::AVX2,
+        eng::SimdPath::NEON };
+
+    eng::Mat4 RandomMatrix(std::mt19937& random)
+    {
+        std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+        eng::Mat4 matrix;
+        for (int i = 0; i < 16; ++i)
+        {
+            matrix.Data()[i] = value(random);
+        }
+        return matrix;
+    }
+
+    // Paths may use FMA or another summation order, so only require a small relative error
+    bool NearlyEqual(float value, float reference)
+    {
+        return std::fabs(value - reference) <= 1e-4f * std::max(1.0f, std::fabs(reference));
+    }
+
+    bool NearlyEqual(const eng::Mat4& value, const eng::Mat4& reference)
+    {
+        for (int i = 0; i < 16; ++i)
+        {
+            if (!NearlyEqual(value.Data()[i], reference.Data()[i]))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Compares both overloads of the selected path against scalar::Multiply, before anything is timed
+    bool VerifyMultiplyMatrices(const std::vector<eng::Mat4>& a, const std::vector<eng::Mat4>& b)
+    {
+        std::vector<eng::Mat4> out(a.size());
+        eng::MultiplyMatrices(a.data(), b.data(), out.data(), a.size());
+        for (size_t i = 0; i < a.size(); ++i)
+        {
+            if (!NearlyEqual(out[i], eng::scalar::Multiply(a[i], b[i])))
+            {
+                return false;
+            }
+        }
+
+        eng::MultiplyMatrices(a[0], b.data(), out.data(), b.size());
+        for (size_t i = 0; i < b.size(); ++i)
+        {
+            if (!NearlyEqual(out[i], eng::scalar::Multiply(a[0], b[i])))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Both layouts of the selected path against scalar::Transform
+    bool VerifyTransformPoints(const eng::Mat4& matrix, const std::vector<eng::Vec3>& points)
+    {
+        const size_t count = points.size();
+        std::vector<eng::Vec3> out(count);
+        std::vector<float> x(count);
+        std::vector<float> y(count);
+        std::vector<float> z(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            x[i] = points[i].x;
+            y[i] = points[i].y;
+            z[i] = points[i].z;
+        }
+        std::vector<float> outX(count);
+        std::vector<float> outY(count);
+        std::vector<float> outZ(count);
+        eng::TransformPoints(matrix, points.data(), out.data(), count);
+        eng::TransformPoints(matrix, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(), count);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            const eng::Vec4 reference = eng::scalar::Transform(matrix,
+                eng::Vec4(points[i].x, points[i].y, points[i].z, 1.0f));
+            if (!NearlyEqual(out[i].x, reference.x) || !NearlyEqual(out[i].y, reference.y)
+                || !NearlyEqual(out[i].z, reference.z) || !NearlyEqual(outX[i], reference.x)
+                || !NearlyEqual(outY[i], reference.y) || !NearlyEqual(outZ[i], reference.z))
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+GENX_BENCHMARK(MathMultiplyMatrices)
+{
+    // Small enough to stay in cache, this measures the kernel rather than memory
+    const size_t matrixCount = 4096;
+    const int iterations = 500;
+
+    std::mt19937 random(42);
+    std::vector<eng::Mat4> a(matrixCount);
+    std::vector<eng::Mat4> b(matrixCount);
+    std::vector<eng::Mat4> out(matrixCount);
+    for (size_t i = 0; i < matrixCount; ++i)
+    {
+        a[i] = RandomMatrix(random);
+        b[i] = RandomMatrix(random);
+    }
+
+    const eng::SimdPath original = eng::GetBatchMathPath();
+    for (eng::SimdPath path : AllPaths)
+    {
+        eng::SetBatchMathPath(path);
+        if (eng::GetBatchMathPath() != path)
+        {
+            continue;
+        }
+        if (!VerifyMultiplyMatrices(a, b))
+        {
+            eng::bench::Fail(std::string("MathMultiplyMatrices/") + PathName(path), "differs from scalar::Multiply");
+            continue;
+        }
+
+        eng::bench::Timer timer;
+        for (int i = 0; i < iterations; ++i)
+        {
+            eng::MultiplyMatrices(a.data(), b.data(), out.data(), matrixCount);
+            eng::bench::DoNotOptimize(out.data());
+        }
+        double elapsed = timer.ElapsedMs();
+        eng::bench::Report(std::string("MathMultiplyMatrices/") + PathName(path), "matrices_per_ms",
+            matrixCount * iterations / elapsed);
+    }
+    eng::SetBatchMathPath(original);
+}
+
+GENX_BENCHMARK(MathTransformPoints)
+{
+    const size_t pointCount = 1 << 14;
+    const int iterations = 500;
+
+    std::mt19937 random(7);
+    std::uniform_real_distribution<float> value(-100.0f, 100.0f);
+    std::vector<eng::Vec3> points(pointCount);
+    std::vector<eng::Vec3> out(pointCount);
+    std::vector<float> x(pointCount);
+    std::vector<float> y(pointCount);
+    std::vector<float> z(pointCount);
+    std::vector<float> outX(pointCount);
+    std::vector<float> outY(pointCount);
+    std::vector<float> outZ(pointCount);
+    for (size_t i = 0; i < pointCount; ++i)
+    {
+        points[i] = eng::Vec3(value(random), value(random), value(random));
+        x[i] = points[i].x;
+        y[i] = points[i].y;
+        z[i] = points[i].z;
+    }
+    const eng::Mat4 matrix = eng::Mat4::Compose(eng::Vec3(1.0f, 2.0f, 3.0f),
+        eng::Quat::FromAxisAngle(eng::Normalize(eng::Vec3(1.0f, 1.0f, 0.0f)), 0.7f), eng::Vec3(2.0f));
+
+    const eng::SimdPath original = eng::GetBatchMathPath();
+    for (eng::SimdPath path : AllPaths)
+    {
+        eng::SetBatchMathPath(path);
+        if (eng::GetBatchMathPath() != path)
+        {
+            continue;
+        }
+        if (!VerifyTransformPoints(matrix, points))
+        {
+            eng::bench::Fail(std::string("MathTransformPoints/") + PathName(path), "differs from scalar::Transform");
+            continue;
+        }
+
+        eng::bench::Timer aosTimer;
+        for (int i = 0; i < iterations; ++i)
+        {
+            eng::TransformPoints(matrix, points.data(), out.data(), pointCount);
+            eng::bench::DoNotOptimize(out.data());
+        }
+        double aosElapsed = aosTimer.ElapsedMs();
+
+        eng::bench::Timer soaTimer;
+        for (int i = 0; i < iterations; ++i)
+        {
+            eng::TransformPoints(matrix, x.data(), y.data(), z.data(), outX.data(), outY.data(), outZ.data(),
+                pointCount);
+            eng::bench::DoNotOptimize(outX.data());
+        }
+        double soaElapsed = soaTimer.ElapsedMs();
+
+        eng::bench::Report(std::string("MathTransformPoints/aos/") + PathName(path), "points_per_ms",
+            pointCount * iterations / aosElapsed);
+        eng::bench::Report(std::string("MathTransformPoints/soa/") + PathName(path), "points_per_ms",
+            pointCount * iterations / soaElapsed);
+    }
+    eng::SetBatchMathPath(original);
+}
+
+GENX_BENCHMARK(MathQuatMultiply)
+{
+    // A dependent chain, so this is the latency of one product as used when composing rotations
+    const int products = 1 << 22;
+    const eng::Quat step = eng::Quat::FromAxisAngle(eng::Normalize(eng::Vec3(0.3f, 1.0f, 0.2f)), 0.001f);
+
+    std::mt19937 random(3);
+    std::uniform_real_distribution<float> value(-1.0f, 1.0f);
+    for (int i = 0; i < 1024; ++i)
+    {
+        const eng::Quat a(value(random), value(random), value(random), value(random));
+        const eng::Quat b(value(random), value(random), value(random), value(random));
+        const eng::Quat product = a * b;
+        const eng::Quat reference = eng::scalar::Multiply(a, b);
+        if (!NearlyEqual(product.x, reference.x) || !NearlyEqual(product.y, reference.y)
+            || !NearlyEqual(product.z, reference.z) || !NearlyEqual(product.w, reference.w))
+        {
+            eng::bench::Fail("MathQuatMultiply/inline", "differs from scalar::Multiply");
+            return;
+        }
+    }
+
+    eng::Quat reference;
+    eng::bench::Timer scalarTimer;
+    for (int i = 0; i < products; ++i)
+    {
+        reference = eng::scalar::Multiply(reference, step);
+    }
+    double scalarElapsed = scalarTimer.ElapsedMs();
+    eng::bench::DoNotOptimize(&reference);
+
+    eng::Quat simd;
+    eng::bench::Timer simdTimer;
+    for (int i = 0; i < products; ++i)
+    {
+        simd = simd * step;
+    }
+    double simdElapsed = simdTimer.ElapsedMs();
+    eng::bench::DoNotOptimize(&simd);
+
+    eng::bench::Report("MathQuatMultiply/scalar", "products_per_ms", products / scalarElapsed);
+    eng::bench::Report("MathQuatMultiply/inline", "products_per_ms", products / simdElapsed);
+}
\ No newline at end of file
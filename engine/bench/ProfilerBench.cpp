@@ -0,0 +1,49 @@
+#include "Bench.h"
+#include "profile/Profiler.h"
+#include <cstdio>
+#include <string>
+
+namespace
+{
+    void Work(int& value)
+    {
+        ENG_PROFILE_SCOPE("ProfilerBench::Work");
+        value = value * 1664525 + 1013904223;
+    }
+}
+
+GENX_BENCHMARK(ProfilerScopes)
+{
+    // Cost of a marker around a tiny function, off and on. Off should be indistinguishable from no marker.
+    const int iterations = 1000000;
+    int value = 1;
+
+    eng::Profiler::SetEnabled(false);
+    eng::bench::Timer disabledTimer;
+    for (int i = 0; i < iterations; ++i)
+    {
+        Work(value);
+    }
+    const double disabledMs = disabledTimer.ElapsedMs();
+
+    eng::Profiler::SetEnabled(true);
+    eng::bench::Timer enabledTimer;
+    for (int i = 0; i < iterations; ++i)
+    {
+        Work(value);
+    }
+    const double enabledMs = enabledTimer.ElapsedMs();
+    eng::Profiler::SetEnabled(false);
+    eng::bench::DoNotOptimize(&value);
+
+    const std::string path = "ProfilerBench.trace.json";
+    eng::bench::Timer exportTimer;
+    eng::Profiler::ExportChromeTrace(path);
+    const double exportMs = exportTimer.ElapsedMs();
+    std::remove(path.c_str());
+    eng::Profiler::Clear();
+
+    eng::bench::Report("ProfilerScopes/disabled", "ns_per_scope", disabledMs * 1e6 / iterations);
+    eng::bench::Report("ProfilerScopes/enabled", "ns_per_scope", enabledMs * 1e6 / iterations);
+    eng::bench::Report("ProfilerScopes/export", "ms", exportMs);
+}
\ No newline at end of file
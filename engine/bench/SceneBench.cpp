@@ -0,0 +1,362 @@
+#include "StressScenes.h"
+#include <eng.h>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        std::vector<const eng::bench::StressSceneInfo*> scenes;
+        // 0 uses each scene's default
+        int count = 0;
+        int frames = 300;
+        int warmupFrames = 30;
+        int width = 1280;
+        int height = 720;
+        bool headless = true;
+        // Empty writes to stdout
+        std::string outputPath;
+    };
+
+    struct SceneResult
+    {
+        std::string name;
+        int count = 0;
+        std::vector<double> frameMilliseconds;
+        std::vector<double> gpuMilliseconds;
+        std::array<uint64_t, eng::RenderStats::CounterCount> counterTotals = {};
+    };
+
+    struct Report
+    {
+        std::string renderer;
+        std::vector<SceneResult> scenes;
+    };
+
+    // Runs the selected scenes one after another, each for warmup plus measured frames, then closes
+    class SceneBench : public eng::Application
+    {
+    public:
+        SceneBench(const Options& options, Report& report) : m_options(options), m_report(report)
+        {
+        }
+
+        bool Init() override
+        {
+            const GLubyte* renderer = glGetString(GL_RENDERER);
+            m_report.renderer = renderer ? reinterpret_cast<const char*>(renderer) : "";
+            eng::Engine::GetInstance().GetGpuProfiler().SetEnabled(true);
+            return true;
+        }
+
+        void Update(float deltaTime) override
+        {
+            if (!m_scene && !StartScene())
+            {
+                SetNeedsToBeClosed(true);
+                return;
+            }
+
+            // The frame time and the published counters both belong to the previous frame
+            if (m_frame > m_options.warmupFrames)
+            {
+                auto& engine = eng::Engine::GetInstance();
+                SceneResult& result = m_report.scenes.back();
+                result.frameMilliseconds.push_back(deltaTime * 1000.0);
+                result.gpuMilliseconds.push_back(engine.GetGpuProfiler().GetLastFrameTime());
+                const eng::RenderStats& stats = engine.GetGraphicsAPI().GetStats();
+                for (size_t i = 0; i < stats.counters.size(); ++i)
+                {
+                    result.counterTotals[i] += stats.counters[i];
+                }
+
+                if (result.frameMilliseconds.size() >= static_cast<size_t>(m_options.frames))
+                {
+                    m_scene->Destroy();
+                    m_scene.reset();
+                    if (!StartScene())
+                    {
+                        SetNeedsToBeClosed(true);
+                        return;
+                    }
+                }
+            }
+
+            m_scene->Update(m_time);
+            m_time += deltaTime;
+            ++m_frame;
+        }
+
+        void Destroy() override
+        {
+            if (m_scene)
+            {
+                m_scene->Destroy();
+                m_scene.reset();
+            }
+        }
+
+    private:
+        // False once every scene ran or one failed to initialize
+        bool StartScene()
+        {
+            if (m_nextScene >= m_options.scenes.size())
+            {
+                return false;
+            }
+
+            const eng::bench::StressSceneInfo& info = *m_options.scenes[m_nextScene++];
+            const int count = m_options.count > 0 ? m_options.count : info.defaultCount;
+            std::cerr << "Running " << info.name << " with " << count << " objects" << std::endl;
+
+            m_scene = info.create();
+            if (!m_scene->Init(count))
+            {
+                std::cerr << "ERROR:BENCH_SCENE_INIT_FAILED: " << info.name << std::endl;
+                m_scene->Destroy();
+                m_scene.reset();
+                return false;
+            }
+
+            SceneResult result;
+            result.name = info.name;
+            result.count = count;
+            result.frameMilliseconds.reserve(m_options.frames);
+            result.gpuMilliseconds.reserve(m_options.frames);
+            m_report.scenes.push_back(std::move(result));
+            m_frame = 0;
+            m_time = 0.0f;
+            return true;
+        }
+
+        const Options& m_options;
+        Report& m_report;
+        std::unique_ptr<eng::bench::StressScene> m_scene;
+        size_t m_nextScene = 0;
+        int m_frame = 0;
+        float m_time = 0.0f;
+    };
+
+    // Nearest rank on sorted values
+    double Percentile(const std::vector<double>& sorted, double percent)
+    {
+        if (sorted.empty())
+        {
+            return 0.0;
+        }
+        const size_t rank = static_cast<size_t>(std::ceil(percent / 100.0 * sorted.size()));
+        return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+    }
+
+    void WriteString(std::ostream& out, const std::string& value)
+    {
+        out << '"';
+        for (char c : value)
+        {
+            if (c == '"' || c == '\\')
+            {
+                out << '\\' << c;
+            }
+            else if (static_cast<unsigned char>(c) >= 0x20)
+            {
+                out << c;
+            }
+        }
+        out << '"';
+    }
+
+    void WriteDistribution(std::ostream& out, const char* name, std::vector<double> values)
+    {
+        std::sort(values.begin(), values.end());
+        double sum = 0.0;
+        for (double value : values)
+        {
+            sum += value;
+        }
+        const double mean = values.empty() ? 0.0 : sum / values.size();
+
+        out << "      \"" << name << "\": { \"mean\": " << mean
+            << ", \"min\": " << (values.empty() ? 0.0 : values.front())
+            << ", \"p50\": " << Percentile(values, 50.0)
+            << ", \"p90\": " << Percentile(values, 90.0)
+            << ", \"p95\": " << Percentile(values, 95.0)
+            << ", \"p99\": " << Percentile(values, 99.0)
+            << ", \"max\": " << (values.empty() ? 0.0 : values.back()) << " }";
+    }
+
+    void WriteReport(std::ostream& out, const Options& options, const Report& report)
+    {
+        out << std::fixed << std::setprecision(3);
+        out << "{\n  \"renderer\": ";
+        WriteString(out, report.renderer);
+        out << ",\n  \"headless\": " << (options.headless ? "true" : "false")
+            << ",\n  \"width\": " << options.width
+            << ",\n  \"height\": " << options.height
+            << ",\n  \"warmup_frames\": " << options.warmupFrames
+            << ",\n  \"scenes\": [";
+
+        for (size_t s = 0; s < report.scenes.size(); ++s)
+        {
+            const SceneResult& scene = report.scenes[s];
+            const size_t frames = scene.frameMilliseconds.size();
+            out << (s > 0 ? ",\n" : "\n") << "    {\n      \"name\": ";
+            WriteString(out, scene.name);
+            out << ",\n      \"count\": " << scene.count
+                << ",\n      \"frames\": " << frames << ",\n";
+            WriteDistribution(out, "frame_ms", scene.frameMilliseconds);
+            out << ",\n";
+            WriteDistribution(out, "gpu_ms", scene.gpuMilliseconds);
+
+            // Per frame averages
+            out << ",\n      \"counters\": {";
+            for (size_t i = 0; i < eng::RenderStats::CounterCount; ++i)
+            {
+                const double average = frames > 0 ? static_cast<double>(scene.counterTotals[i]) / frames : 0.0;
+                out << (i > 0 ? ", " : " ") << '"' << eng::RenderStats::GetName(static_cast<eng::RenderCounter>(i))
+                    << "\": " << average;
+            }
+            out << " }\n    }";
+        }
+        out << "\n  ]\n}\n";
+    }
+
+    const eng::bench::StressSceneInfo* FindScene(const char* name)
+    {
+        for (const auto& info : eng::bench::GetStressScenes())
+        {
+            if (std::strcmp(info.name, name) == 0)
+            {
+                return &info;
+            }
+        }
+        return nullptr;
+    }
+
+    void PrintUsage()
+    {
+        std::cerr << "Usage: GenXBench [options] [scene...]\n"
+            << "  --frames N     measured frames per scene (300)\n"
+            << "  --warmup N     frames dropped before measuring (30)\n"
+            << "  --count N      objects per scene instead of the scene default\n"
+            << "  --size WxH     framebuffer size (1280x720)\n"
+            << "  --output PATH  JSON report file instead of stdout\n"
+            << "  --windowed     render to a visible window\n"
+            << "Scenes, all by default:\n";
+        for (const auto& info : eng::bench::GetStressScenes())
+        {
+            std::cerr << "  " << info.name << " - " << info.description << " (" << info.defaultCount << ")\n";
+        }
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char* arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+            if (std::strcmp(arg, "--frames") == 0 && hasValue)
+            {
+                options.frames = std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(arg, "--warmup") == 0 && hasValue)
+            {
+                options.warmupFrames = std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(arg, "--count") == 0 && hasValue)
+            {
+                options.count = std::atoi(argv[++i]);
+            }
+            else if (std::strcmp(arg, "--size") == 0 && hasValue)
+            {
+                if (std::sscanf(argv[++i], "%dx%d", &options.width, &options.height) != 2)
+                {
+                    return false;
+                }
+            }
+            else if (std::strcmp(arg, "--output") == 0 && hasValue)
+            {
+                options.outputPath = argv[++i];
+            }
+            else if (std::strcmp(arg, "--windowed") == 0)
+            {
+                options.headless = false;
+            }
+            else if (const auto* scene = FindScene(arg))
+            {
+                options.scenes.push_back(scene);
+            }
+            else
+            {
+                std::cerr << "Unknown argument " << arg << std::endl;
+                return false;
+            }
+        }
+
+        if (options.scenes.empty())
+        {
+            for (const auto& info : eng::bench::GetStressScenes())
+            {
+                options.scenes.push_back(&info);
+            }
+        }
+        // GPU times arrive a few frames late, the warmup keeps the last scene's out of the results
+        options.warmupFrames = std::max(options.warmupFrames, static_cast<int>(eng::GpuProfiler::FrameLatency));
+        return options.frames > 0 && options.width > 0 && options.height > 0;
+    }
+}
+
+// Exits with 1 when a scene could not run to the end, the report still holds the finished ones
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    Report report;
+    eng::Engine& engine = eng::Engine::GetInstance();
+    engine.SetApplication(new SceneBench(options, report));
+    engine.SetHeadless(options.headless);
+    engine.SetVSync(false);
+
+    if (engine.Init(options.width, options.height))
+    {
+        engine.Run();
+    }
+    engine.Destroy();
+
+    bool completed = report.scenes.size() == options.scenes.size();
+    for (const SceneResult& scene : report.scenes)
+    {
+        completed = completed && scene.frameMilliseconds.size() == static_cast<size_t>(options.frames);
+    }
+
+    if (options.outputPath.empty())
+    {
+        WriteReport(std::cout, options, report);
+    }
+    else
+    {
+        std::ofstream file(options.outputPath, std::ios::trunc);
+        if (!file)
+        {
+            std::cerr << "ERROR:BENCH_REPORT_OPEN_FAILED: " << options.outputPath << std::endl;
+            return 1;
+        }
+        WriteReport(file, options, report);
+    }
+    return completed ? 0 : 1;
+}
\ No newline at end of file
@@ -0,0 +1,355 @@
+#include "StressScenes.h"
+#include <eng.h>
+#include <algorithm>
+#include <cmath>
+#include <string>
+
+namespace eng
+{
+    namespace bench
+    {
+        namespace
+        {
+            const char* ColorVertexShader = R"(
+                #version 330 core
+                layout (location = 0) in vec3 position;
+                layout (location = 1) in vec3 color;
+
+                uniform float uTime;
+
+                out vec3 vColor;
+
+                void main()
+                {
+                    vColor = color;
+                    vec2 wobble = 0.005 * vec2(sin(uTime + position.y * 40.0), cos(uTime + position.x * 40.0));
+                    gl_Position = vec4(position.xy + wobble, position.z, 1.0);
+                }
+            )";
+
+            const char* ColorFragmentShader = R"(
+                #version 330 core
+                out vec4 FragColor;
+
+                in vec3 vColor;
+
+                void main()
+                {
+                    FragColor = vec4(vColor, 1.0);
+                }
+            )";
+
+            const char* OffsetVertexShader = R"(
+                #version 330 core
+                layout (location = 0) in vec3 position;
+
+                uniform vec2 uOffset;
+                uniform float uScale;
+                uniform float uTime;
+
+                out vec2 vLocal;
+
+                void main()
+                {
+                    vLocal = position.xy;
+                    float pulse = 1.0 + 0.1 * sin(uTime * 3.0 + uOffset.x * 10.0);
+                    gl_Position = vec4(position.xy * uScale * pulse + uOffset, position.z, 1.0);
+                }
+            )";
+
+            // The tint is patched in per program variant
+            const char* OffsetFragmentShader = R"(
+                #version 330 core
+                out vec4 FragColor;
+
+                in vec2 vLocal;
+
+                uniform float uShade;
+
+                const vec3 tint = vec3(TINT);
+
+                void main()
+                {
+                    FragColor = vec4(tint * (uShade + 0.5 * length(vLocal)), 1.0);
+                }
+            )";
+
+            VertexLayout MakeLayout(bool withColor)
+            {
+                VertexLayout layout;
+                layout.elements.push_back({ 0, 3, GL_FLOAT, 0 });
+                if (withColor)
+                {
+                    layout.elements.push_back({ 1, 3, GL_FLOAT, sizeof(float) * 3 });
+                }
+                layout.stride = sizeof(float) * (withColor ? 6 : 3);
+                return layout;
+            }
+
+            // Cells of the smallest square grid covering [-1, 1] that holds count objects
+            int GetGridSide(int count)
+            {
+                return std::max(1, static_cast<int>(std::ceil(std::sqrt(static_cast<double>(count)))));
+            }
+
+            void GetCellCenter(int index, int side, float& x, float& y)
+            {
+                const float cell = 2.0f / side;
+                x = -1.0f + cell * (index % side + 0.5f);
+                y = -1.0f + cell * (index / side + 0.5f);
+            }
+
+            // Every object is a mesh of its own, so each one costs a VAO bind and a draw call
+            class MeshScene : public StressScene
+            {
+            public:
+                bool Init(int count) override
+                {
+                    auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
+                    auto shaderProgram = graphicsAPI.CreateShaderProgram(ColorVertexShader, ColorFragmentShader);
+                    if (!shaderProgram)
+                    {
+                        return false;
+                    }
+                    m_material.SetName("Meshes");
+                    m_material.SetShaderProgram(shaderProgram);
+
+                    const VertexLayout layout = MakeLayout(true);
+                    const std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+                    const int side = GetGridSide(count);
+                    const float halfSize = 0.4f * 2.0f / side;
+                    m_meshes.reserve(count);
+                    for (int i = 0; i < count; ++i)
+                    {
+                        float x = 0.0f;
+                        float y = 0.0f;
+                        GetCellCenter(i, side, x, y);
+                        const float r = static_cast<float>(i % 7) / 6.0f;
+                        const float g = static_cast<float>(i % 11) / 10.0f;
+                        const float b = static_cast<float>(i % 13) / 12.0f;
+                        const std::vector<float> vertices =
+                        {
+                            x + halfSize, y + halfSize, 0.0f, r, g, b,
+                            x - halfSize, y + halfSize, 0.0f, g, b, r,
+                            x - halfSize, y - halfSize, 0.0f, b, r, g,
+                            x + halfSize, y - halfSize, 0.0f, r, b, g
+                        };
+                        m_meshes.push_back(std::make_unique<Mesh>(layout, vertices, indices));
+                    }
+                    return true;
+                }
+
+                void Update(float time) override
+                {
+                    m_material.SetParam("uTime", time);
+                    auto& renderQueue = Engine::GetInstance().GetRenderQueue();
+                    for (auto& mesh : m_meshes)
+                    {
+                        RenderCommand command;
+                        command.mesh = mesh.get();
+                        command.material = &m_material;
+                        renderQueue.Submit(command);
+                    }
+                }
+
+                void Destroy() override
+                {
+                    m_meshes.clear();
+                }
+
+            private:
+                Material m_material;
+                std::vector<std::unique_ptr<Mesh>> m_meshes;
+            };
+
+            // One shared quad drawn with a material per object, placed by material parameters. Consecutive
+            // objects use different programs, so every draw switches program and uploads its uniforms.
+            class MaterialScene : public StressScene
+            {
+            public:
+                static constexpr int ProgramCount = 8;
+
+                bool Init(int count) override
+                {
+                    auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
+                    std::shared_ptr<ShaderProgram> programs[ProgramCount];
+                    for (int i = 0; i < ProgramCount; ++i)
+                    {
+                        const std::string tint = std::to_string(0.3f + 0.1f * (i % 8)) + ", " +
+                            std::to_string(1.0f - 0.1f * i) + ", " + std::to_string(0.2f + 0.1f * ((i * 3) % 8));
+                        std::string fragmentSource = OffsetFragmentShader;
+                        fragmentSource.replace(fragmentSource.find("TINT"), 4, tint);
+                        programs[i] = graphicsAPI.CreateShaderProgram(OffsetVertexShader, fragmentSource);
+                        if (!programs[i])
+                        {
+                            return false;
+                        }
+                    }
+
+                    const std::vector<float> vertices =
+                    {
+                        0.5f, 0.5f, 0.0f,
+                        -0.5f, 0.5f, 0.0f,
+                        -0.5f, -0.5f, 0.0f,
+                        0.5f, -0.5f, 0.0f
+                    };
+                    const std::vector<uint32_t> indices = { 0, 1, 2, 0, 2, 3 };
+                    m_mesh = std::make_unique<Mesh>(MakeLayout(false), vertices, indices);
+
+                    const int side = GetGridSide(count);
+                    m_materials.reserve(count);
+                    for (int i = 0; i < count; ++i)
+                    {
+                        float x = 0.0f;
+                        float y = 0.0f;
+                        GetCellCenter(i, side, x, y);
+                        auto material = std::make_unique<Material>();
+                        material->SetShaderProgram(programs[i % ProgramCount]);
+                        material->SetParam("uOffset", x, y);
+                        material->SetParam("uScale", 1.6f / side);
+                        material->SetParam("uShade", 0.3f + 0.05f * (i % 10));
+                        m_materials.push_back(std::move(material));
+                    }
+                    return true;
+                }
+
+                void Update(float time) override
+                {
+                    auto& renderQueue = Engine::GetInstance().GetRenderQueue();
+                    for (auto& material : m_materials)
+                    {
+                        material->SetParam("uTime", time);
+                        RenderCommand command;
+                        command.mesh = m_mesh.get();
+                        command.material = material.get();
+                        renderQueue.Submit(command);
+                    }
+                }
+
+                void Destroy() override
+                {
+                    m_materials.clear();
+                    m_mesh.reset();
+                }
+
+            private:
+                std::unique_ptr<Mesh> m_mesh;
+                std::vector<std::unique_ptr<Material>> m_materials;
+            };
+
+            // Moving, rotating sprites over a few textures and draw layers plus solid ones
+            class SpriteScene : public StressScene
+            {
+            public:
+                static constexpr uint32_t TextureCount = 4;
+                static constexpr uint32_t TextureSize = 16;
+
+                bool Init(int count) override
+                {
+                    auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
+                    std::vector<uint32_t> pixels(TextureSize * TextureSize);
+                    for (uint32_t t = 0; t < TextureCount; ++t)
+                    {
+                        const uint32_t color = 0xFF000000 | (0x40u << (8 * (t % 3))) | (0xC0u << (8 * ((t + 1) % 3)));
+                        for (uint32_t y = 0; y < TextureSize; ++y)
+                        {
+                            for (uint32_t x = 0; x < TextureSize; ++x)
+                            {
+                                pixels[y * TextureSize + x] = ((x / 4 + y / 4) % 2) ? color : 0xFFFFFFFF;
+                            }
+                        }
+                        m_textures[t] = graphicsAPI.CreateTexture(TextureFormat::RGBA8, TextureSize, TextureSize,
+                            pixels.data());
+                        if (!m_textures[t])
+                        {
+                            return false;
+                        }
+                    }
+
+                    // Fixed seed, every run draws the same scene
+                    uint32_t state = 12345u;
+                    auto random = [&state]()
+                    {
+                        state = state * 1664525u + 1013904223u;
+                        return static_cast<float>(state >> 8) / static_cast<float>(1u << 24);
+                    };
+                    m_sprites.resize(count);
+                    for (int i = 0; i < count; ++i)
+                    {
+                        Moving& sprite = m_sprites[i];
+                        sprite.x = random() * 2.0f - 1.0f;
+                        sprite.y = random() * 2.0f - 1.0f;
+                        sprite.radius = 0.02f + random() * 0.1f;
+                        sprite.speed = 0.5f + random() * 2.0f;
+                        sprite.phase = random() * 6.2831853f;
+                        sprite.size = 0.01f + random() * 0.03f;
+                        sprite.texture = i % (TextureCount + 1) == TextureCount ? -1 : i % (TextureCount + 1);
+                        sprite.drawLayer = static_cast<int16_t>(i % 4);
+                    }
+                    return true;
+                }
+
+                void Update(float time) override
+                {
+                    auto& spriteBatch = Engine::GetInstance().GetSpriteBatch();
+                    Sprite sprite;
+                    for (const Moving& moving : m_sprites)
+                    {
+                        const float angle = moving.phase + moving.speed * time;
+                        sprite.texture = moving.texture < 0 ? nullptr : m_textures[moving.texture].get();
+                        sprite.position[0] = moving.x + moving.radius * std::cos(angle);
+                        sprite.position[1] = moving.y + moving.radius * std::sin(angle);
+                        sprite.size[0] = moving.size;
+                        sprite.size[1] = moving.size;
+                        sprite.rotation = angle;
+                        sprite.color = moving.texture < 0 ? 0xFF3080E0 : 0xFFFFFFFF;
+                        sprite.drawLayer = moving.drawLayer;
+                        spriteBatch.Submit(sprite);
+                    }
+                }
+
+                void Destroy() override
+                {
+                    m_sprites.clear();
+                    for (auto& texture : m_textures)
+                    {
+                        texture.reset();
+                    }
+                }
+
+            private:
+                struct Moving
+                {
+                    float x;
+                    float y;
+                    float radius;
+                    float speed;
+                    float phase;
+                    float size;
+                    int texture; // -1 is a solid sprite
+                    int16_t drawLayer;
+                };
+
+                std::shared_ptr<Texture> m_textures[TextureCount];
+                std::vector<Moving> m_sprites;
+            };
+
+            template <typename T>
+            std::unique_ptr<StressScene> Create()
+            {
+                return std::make_unique<T>();
+            }
+        }
+
+        const std::vector<StressSceneInfo>& GetStressScenes()
+        {
+            static const std::vector<StressSceneInfo> scenes =
+            {
+                { "meshes", "a mesh and draw call per object", 2000, Create<MeshScene> },
+                { "materials", "a material per object, alternating between 8 programs", 1000, Create<MaterialScene> },
+                { "sprites", "moving sprites over 4 textures and 4 layers", 20000, Create<SpriteScene> }
+            };
+            return scenes;
+        }
+    }
+}
\ No newline at end of file
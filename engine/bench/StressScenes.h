@@ -0,0 +1,33 @@
+#pragma once
+#include <memory>
+#include <vector>
+
+namespace eng
+{
+    namespace bench
+    {
+        // Scripted workload of GenXBench. Init and Destroy run with the GL context current, Update once per
+        // frame submits everything the scene draws.
+        class StressScene
+        {
+        public:
+            virtual ~StressScene() = default;
+
+            virtual bool Init(int count) = 0;
+            // Seconds since the scene started, moves things so every frame has something to upload
+            virtual void Update(float time) = 0;
+            virtual void Destroy() = 0;
+        };
+
+        struct StressSceneInfo
+        {
+            const char* name;
+            const char* description;
+            // Objects drawn unless the command line asks for another count
+            int defaultCount;
+            std::unique_ptr<StressScene> (*create)();
+        };
+
+        const std::vector<StressSceneInfo>& GetStressScenes();
+    }
+}
\ No newline at end of file
@@ -2,6 +2,14 @@
 
 namespace eng
 {
+    void Application::FixedUpdate(float)
+    {
+    }
+
+    void Application::LateUpdate()
+    {
+    }
+
     void Application::SetNeedsToBeClosed(bool value)
     {
         m_needsToBeClosed = value;
@@ -6,8 +6,15 @@ namespace eng
     {
     public:
         virtual bool Init() = 0;
+        // Zero or more times per frame at the engine's fixed timestep, before Update. Not called unless a
+        // fixed timestep is set.
+        virtual void FixedUpdate(float fixedDeltaTime);
         // deltaTime in seconds
         virtual void Update(float deltaTime) = 0;
+        // On the main thread right before the frame is submitted, after input was sampled once more (see
+        // InputManager::GetLatestState). With frame pipelining it runs alongside the next frame's Update, so
+        // only render-side state may be touched here.
+        virtual void LateUpdate();
         virtual void Destroy() = 0;
 
         void SetNeedsToBeClosed(bool value);
@@ -1,7 +1,10 @@
 #include "Engine.h"
 #include "Application.h"
+#include "profile/Profiler.h"
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 
 namespace eng
@@ -11,12 +14,36 @@ namespace eng
         auto& inputManager = eng::Engine::GetInstance().GetInputManager();
         if (action == GLFW_PRESS)
         {
-            inputManager.SetKeyPressed(key, true);
+            inputManager.PushKey(key, true);
         }
         else if (action == GLFW_RELEASE)
         {
-            inputManager.SetKeyPressed(key, false);
+            inputManager.PushKey(key, false);
         }
+        eng::Engine::GetInstance().RequestRedraw();
+    }
+
+    void mouseButtonCallback(GLFWwindow*, int button, int action, int)
+    {
+        eng::Engine::GetInstance().GetInputManager().PushMouseButton(button, action == GLFW_PRESS);
+        eng::Engine::GetInstance().RequestRedraw();
+    }
+
+    void cursorPositionCallback(GLFWwindow*, double x, double y)
+    {
+        eng::Engine::GetInstance().GetInputManager().PushMouseMove(static_cast<float>(x), static_cast<float>(y));
+        eng::Engine::GetInstance().RequestRedraw();
+    }
+
+    void scrollCallback(GLFWwindow*, double x, double y)
+    {
+        eng::Engine::GetInstance().GetInputManager().PushScroll(static_cast<float>(x), static_cast<float>(y));
+        eng::Engine::GetInstance().RequestRedraw();
+    }
+
+    void windowRefreshCallback(GLFWwindow*)
+    {
+        eng::Engine::GetInstance().RequestRedraw();
     }
 
     Engine& Engine::GetInstance()
@@ -32,6 +59,17 @@ namespace eng
             return false;
         }
 
+        Profiler::SetThreadName("Main");
+        m_jobSystem.Init();
+        m_taskScheduler.Init(&m_jobSystem);
+
+#ifdef ENG_HEADLESS_OSMESA
+        if (m_headless)
+        {
+            // No display server or GPU needed, GLEW loads its functions from OSMesa in this build
+            glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+        }
+#endif
         if (!glfwInit())
         {
             return false;
@@ -40,6 +78,15 @@ namespace eng
         glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
         glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
         glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+        // Occlusion queries test against the depth of the opaque meshes
+        glfwWindowHint(GLFW_DEPTH_BITS, 24);
+        if (m_headless)
+        {
+            glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+#ifdef ENG_HEADLESS_OSMESA
+            glfwWindowHint(GLFW_CONTEXT_CREATION_API, GLFW_OSMESA_CONTEXT_API);
+#endif
+        }
 
         m_window = glfwCreateWindow(width, height, "GameDevelopmentProject", nullptr, nullptr);
 
@@ -51,8 +98,14 @@ namespace eng
         }
 
         glfwSetKeyCallback(m_window, keyCallback);
+        glfwSetMouseButtonCallback(m_window, mouseButtonCallback);
+        glfwSetCursorPosCallback(m_window, cursorPositionCallback);
+        glfwSetScrollCallback(m_window, scrollCallback);
+        glfwSetWindowRefreshCallback(m_window, windowRefreshCallback);
 
         glfwMakeContextCurrent(m_window);
+        // Nothing to sync to without a display
+        glfwSwapInterval(m_vsync && !m_headless ? 1 : 0);
 
         if (glewInit() != GLEW_OK)
         {
@@ -70,37 +123,291 @@ namespace eng
             return;
         }
 
-        m_lastTimePoint = std::chrono::high_resolution_clock::now();
+        m_lastTimePoint = std::chrono::steady_clock::now();
+        m_framePacer.Reset();
+        RequestRedraw();
         while (!glfwWindowShouldClose(m_window) && !m_application->NeedsToBeClosed())
         {
-            glfwPollEvents();
+            if (m_renderMode == RenderMode::OnDemand && !NeedsRedraw())
+            {
+                WaitForRedraw();
+                continue;
+            }
+
+            ENG_PROFILE_SCOPE("Frame");
+            float deltaTime = InputStage();
+            if (m_framePipelining)
+            {
+                // The frame handed off last iteration renders while the next one is simulated
+                JobCounter simulation;
+                m_jobSystem.Run([this, deltaTime]() { SimulateStage(deltaTime); }, &simulation);
+                CullStage();
+                RecordStage();
+                LateInputStage();
+                SubmitStage();
+                PresentStage();
+                MeasureInputLatency(m_handedOffInputTime);
+                {
+                    ENG_PROFILE_SCOPE("Engine::WaitForSimulation");
+                    m_jobSystem.Wait(simulation);
+                }
+                HandOffStage();
+                m_handedOffInputTime = m_inputManager.GetFrameEventTime();
+            }
+            else
+            {
+                SimulateStage(deltaTime);
+                HandOffStage();
+                CullStage();
+                RecordStage();
+                LateInputStage();
+                SubmitStage();
+                PresentStage();
+                MeasureInputLatency(m_inputManager.GetFrameEventTime());
+            }
+
+            int owed = m_redrawFrames.load(std::memory_order_relaxed);
+            while (owed > 0 && !m_redrawFrames.compare_exchange_weak(owed, owed - 1, std::memory_order_relaxed))
+            {
+            }
+            ENG_PROFILE_SCOPE("FramePacer::Wait");
+            m_framePacer.Wait();
+        }
+    }
+
+    float Engine::InputStage()
+    {
+        ENG_PROFILE_SCOPE("Engine::InputStage");
+        glfwPollEvents();
+        PollGamepads();
+        m_inputManager.BeginFrame();
+
+        auto now = std::chrono::steady_clock::now();
+        float deltaTime = std::chrono::duration<float>(now - m_lastTimePoint).count();
+        m_lastTimePoint = now;
+        m_frameTime = deltaTime;
+
+        // Uploads finished loads before anything is drawn, uses the requests of the last cull
+        m_textureStreamer.Update();
+        return deltaTime;
+    }
+
+    void Engine::SimulateStage(float deltaTime)
+    {
+        ENG_PROFILE_SCOPE("Engine::SimulateStage");
+        m_taskScheduler.Update(deltaTime);
+
+        if (m_fixedTimestep > 0.0f)
+        {
+            m_fixedAccumulator += deltaTime;
+            int steps = 0;
+            while (m_fixedAccumulator >= m_fixedTimestep && steps < m_maxFixedSteps)
+            {
+                m_application->FixedUpdate(m_fixedTimestep);
+                m_fixedAccumulator -= m_fixedTimestep;
+                ++steps;
+            }
+            if (m_fixedAccumulator >= m_fixedTimestep)
+            {
+                m_fixedAccumulator = std::fmod(m_fixedAccumulator, static_cast<double>(m_fixedTimestep));
+            }
+            m_interpolationAlpha = static_cast<float>(m_fixedAccumulator / m_fixedTimestep);
+        }
 
-            auto now = std::chrono::high_resolution_clock::now();
-            float deltaTime = std::chrono::duration<float>(now - m_lastTimePoint).count();
-            m_lastTimePoint = now;
+        m_application->Update(deltaTime);
+    }
 
-            m_application->Update(deltaTime);
+    void Engine::HandOffStage()
+    {
+        ENG_PROFILE_SCOPE("Engine::HandOffStage");
+        m_rederQueue.EndFrame();
+        m_spriteBatch.EndFrame();
+    }
+
+    void Engine::CullStage()
+    {
+        ENG_PROFILE_SCOPE("Engine::CullStage");
+        int width = 0;
+        int height = 0;
+        glfwGetFramebufferSize(m_window, &width, &height);
+        m_rederQueue.SetViewportSize(width, height);
+        m_rederQueue.Cull();
+    }
 
+    void Engine::RecordStage()
+    {
+        ENG_PROFILE_SCOPE("Engine::RecordStage");
+        m_rederQueue.Record();
+        m_spriteBatch.Record();
+    }
+
+    void Engine::SubmitStage()
+    {
+        ENG_PROFILE_SCOPE("Engine::SubmitStage");
+        m_gpuProfiler.BeginFrame();
+        {
+            ENG_PROFILE_GPU_SCOPE(m_gpuProfiler, "Clear");
             m_graphicsAPI.SetClearColor(1.0f, 1.0f, 1.0f, 1.0f);
             m_graphicsAPI.ClearBuffers();
+        }
 
-            m_rederQueue.Draw(m_graphicsAPI);
+        m_rederQueue.Draw(m_graphicsAPI);
+        {
+            ENG_PROFILE_GPU_SCOPE(m_gpuProfiler, "Sprites");
+            m_spriteBatch.Draw(m_graphicsAPI);
+        }
+        if (m_statsOverlayEnabled)
+        {
+            ENG_PROFILE_GPU_SCOPE(m_gpuProfiler, "StatsOverlay");
+            int width = 0;
+            int height = 0;
+            glfwGetFramebufferSize(m_window, &width, &height);
+            m_statsOverlay.Draw(m_graphicsAPI, m_graphicsAPI.GetStats(), m_frameTime * 1000.0,
+                m_gpuProfiler.GetLastFrameTime(), width, height);
+        }
+        m_gpuProfiler.EndFrame();
+    }
 
-            glfwSwapBuffers(m_window);
+    void Engine::LateInputStage()
+    {
+        ENG_PROFILE_SCOPE("Engine::LateInputStage");
+        glfwPollEvents();
+        PollGamepads();
+        m_inputManager.Sample();
+        m_application->LateUpdate();
+    }
+
+    void Engine::PresentStage()
+    {
+        ENG_PROFILE_SCOPE("Engine::PresentStage");
+        glfwSwapBuffers(m_window);
+        if (m_headless)
+        {
+            // No swap chain throttles the loop, so frame times include the frame's rendering
+            glFinish();
+        }
+
+        m_graphicsAPI.EndFrameStats();
+        if (m_renderStatsLog.IsOpen())
+        {
+            m_renderStatsLog.Write(m_frameCount, m_frameTime * 1000.0, m_gpuProfiler.GetLastFrameTime(),
+                m_graphicsAPI.GetStats());
+        }
+        ++m_frameCount;
+    }
+
+    void Engine::PollGamepads()
+    {
+        m_gamepadConnected = false;
+        for (int joystick = GLFW_JOYSTICK_1; joystick < InputState::GamepadCount; ++joystick)
+        {
+            GLFWgamepadstate state;
+            bool changed;
+            if (glfwJoystickIsGamepad(joystick) && glfwGetGamepadState(joystick, &state))
+            {
+                changed = m_inputManager.UpdateGamepad(joystick, state.buttons, state.axes);
+                m_gamepadConnected = true;
+            }
+            else
+            {
+                changed = m_inputManager.UpdateGamepad(joystick, nullptr, nullptr);
+            }
+            if (changed)
+            {
+                RequestRedraw();
+            }
+        }
+    }
+
+    void Engine::MeasureInputLatency(double inputTime)
+    {
+        if (inputTime >= 0.0)
+        {
+            m_inputLatency = static_cast<float>(InputManager::Now() - inputTime);
+        }
+    }
+
+    bool Engine::NeedsRedraw()
+    {
+        if (m_redrawFrames.load(std::memory_order_relaxed) > 0 || m_taskScheduler.HasReadyTasks())
+        {
+            return true;
+        }
+        // Timers count frame time, which includes the time spent waiting here
+        double untilTimer = 0.0;
+        if (m_taskScheduler.GetTimeUntilNextTimer(untilTimer))
+        {
+            auto idle = std::chrono::steady_clock::now() - m_lastTimePoint;
+            return untilTimer <= std::chrono::duration<double>(idle).count();
+        }
+        return false;
+    }
+
+    void Engine::WaitForRedraw()
+    {
+        ENG_PROFILE_SCOPE("Engine::WaitForRedraw");
+        // Finished jobs and gamepads do not post events, so they are polled for
+        const double PollSeconds = 0.01;
+        double timeout = -1.0;
+        double untilTimer = 0.0;
+        if (m_taskScheduler.GetTimeUntilNextTimer(untilTimer))
+        {
+            auto idle = std::chrono::steady_clock::now() - m_lastTimePoint;
+            timeout = std::max(untilTimer - std::chrono::duration<double>(idle).count(), 0.0);
+        }
+        if (m_taskScheduler.HasPendingJobs() || m_gamepadConnected)
+        {
+            timeout = timeout < 0.0 ? PollSeconds : std::min(timeout, PollSeconds);
+        }
+
+        if (timeout < 0.0)
+        {
+            glfwWaitEvents();
         }
+        else
+        {
+            glfwWaitEventsTimeout(timeout);
+        }
+        PollGamepads();
+        // The wait is not a late frame
+        m_framePacer.Reset();
     }
 
     void Engine::Destroy()
     {
         if (m_application)
         {
+            // Suspended tasks may refer to the application
+            m_taskScheduler.Shutdown();
             m_application->Destroy();
             m_application.reset();
+            m_textureStreamer.Shutdown();
+            m_spriteBatch.Shutdown();
+            m_statsOverlay.Shutdown();
+            m_renderStatsLog.Close();
+            m_rederQueue.Shutdown();
+            m_gpuProfiler.Shutdown();
+            m_jobSystem.Shutdown();
             glfwTerminate();
             m_window = nullptr;
         }
     }
 
+    void Engine::SetHeadless(bool headless)
+    {
+        if (m_window)
+        {
+            std::cerr << "ERROR:ENGINE_SET_HEADLESS_AFTER_INIT" << std::endl;
+            return;
+        }
+        m_headless = headless;
+    }
+
+    bool Engine::IsHeadless() const
+    {
+        return m_headless;
+    }
+
     void Engine::SetApplication(Application* app)
     {
         m_application.reset(app);
@@ -125,4 +432,132 @@ namespace eng
     {
         return m_rederQueue;
     }
+
+    TextureStreamer& Engine::GetTextureStreamer()
+    {
+        return m_textureStreamer;
+    }
+
+    SpriteBatch& Engine::GetSpriteBatch()
+    {
+        return m_spriteBatch;
+    }
+
+    JobSystem& Engine::GetJobSystem()
+    {
+        return m_jobSystem;
+    }
+
+    TaskScheduler& Engine::GetTaskScheduler()
+    {
+        return m_taskScheduler;
+    }
+
+    GpuProfiler& Engine::GetGpuProfiler()
+    {
+        return m_gpuProfiler;
+    }
+
+    void Engine::SetFramePipelining(bool enable)
+    {
+        m_framePipelining = enable;
+    }
+
+    bool Engine::IsFramePipelining() const
+    {
+        return m_framePipelining;
+    }
+
+    void Engine::SetFixedTimestep(float seconds, int maxStepsPerFrame)
+    {
+        m_fixedTimestep = seconds > 0.0f ? seconds : 0.0f;
+        m_maxFixedSteps = maxStepsPerFrame > 0 ? maxStepsPerFrame : 1;
+        m_fixedAccumulator = 0.0;
+        m_interpolationAlpha = 0.0f;
+    }
+
+    float Engine::GetFixedTimestep() const
+    {
+        return m_fixedTimestep;
+    }
+
+    float Engine::GetInterpolationAlpha() const
+    {
+        return m_interpolationAlpha;
+    }
+
+    void Engine::SetVSync(bool enable)
+    {
+        m_vsync = enable;
+        if (m_window)
+        {
+            glfwSwapInterval(m_vsync && !m_headless ? 1 : 0);
+        }
+    }
+
+    bool Engine::IsVSync() const
+    {
+        return m_vsync;
+    }
+
+    FramePacer& Engine::GetFramePacer()
+    {
+        return m_framePacer;
+    }
+
+    void Engine::SetRenderMode(RenderMode mode)
+    {
+        m_renderMode = mode;
+        RequestRedraw();
+    }
+
+    RenderMode Engine::GetRenderMode() const
+    {
+        return m_renderMode;
+    }
+
+    float Engine::GetInputLatency() const
+    {
+        return m_inputLatency;
+    }
+
+    void Engine::SetStatsOverlay(bool enable)
+    {
+        m_statsOverlayEnabled = enable;
+        RequestRedraw();
+    }
+
+    bool Engine::IsStatsOverlay() const
+    {
+        return m_statsOverlayEnabled;
+    }
+
+    StatsOverlay& Engine::GetStatsOverlay()
+    {
+        return m_statsOverlay;
+    }
+
+    bool Engine::StartRenderStatsLog(const std::string& path)
+    {
+        return m_renderStatsLog.Open(path);
+    }
+
+    void Engine::StopRenderStatsLog()
+    {
+        m_renderStatsLog.Close();
+    }
+
+    void Engine::RequestRedraw()
+    {
+        // A pipelined frame shows the state simulated one iteration earlier
+        const int frames = m_framePipelining ? 2 : 1;
+        int owed = m_redrawFrames.load(std::memory_order_relaxed);
+        while (owed < frames && !m_redrawFrames.compare_exchange_weak(owed, frames, std::memory_order_relaxed))
+        {
+        }
+        if (m_renderMode == RenderMode::OnDemand && m_window)
+        {
+            glfwPostEmptyEvent();
+        }
+    }
 }
\ No newline at end of file
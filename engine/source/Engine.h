@@ -2,13 +2,32 @@
 #include "input/InputManager.h"
 #include "graphics/GraphicsAPI.h"
 #include "render/RenderQueue.h"
+#include "render/TextureStreamer.h"
+#include "render/SpriteBatch.h"
+#include "render/StatsOverlay.h"
+#include "jobs/JobSystem.h"
+#include "coro/TaskScheduler.h"
+#include "time/FramePacer.h"
+#include "profile/GpuProfiler.h"
+#include <atomic>
 #include <memory>
 #include <chrono>
+#include <string>
 
 struct GLFWwindow;
 namespace eng
 {
     class Application;
+
+    enum class RenderMode
+    {
+        // A frame every loop iteration, limited by vsync and the frame pacer
+        Continuous,
+        // Frames only after input, window refreshes, RequestRedraw or tasks that are due; the loop sleeps in
+        // between
+        OnDemand
+    };
+
     class Engine
     {
     public:
@@ -22,6 +41,11 @@ namespace eng
         Engine& operator=(Engine&&) = delete;
 
     public:
+        // Call before Init. Renders without a visible window: on GLFW's null platform into an OSMesa context
+        // when the engine is built with ENG_HEADLESS_OSMESA, into a hidden window otherwise. Input callbacks
+        // still exist but nothing feeds them.
+        void SetHeadless(bool headless);
+        bool IsHeadless() const;
         bool Init(int width, int height);
         void Run();
         void Destroy();
@@ -31,13 +55,99 @@ namespace eng
         InputManager& GetInputManager();
         GraphicsAPI& GetGraphicsAPI();
         RenderQueue& GetRenderQueue();
+        TextureStreamer& GetTextureStreamer();
+        SpriteBatch& GetSpriteBatch();
+        JobSystem& GetJobSystem();
+        TaskScheduler& GetTaskScheduler();
+        GpuProfiler& GetGpuProfiler();
+
+        // Simulates frame N+1 on the job system while frame N is culled, drawn and presented on the main
+        // thread. Application::Update (and the tasks it resumes) must then stay off GL and the render-side
+        // objects, and frames reach the screen one frame later.
+        void SetFramePipelining(bool enable);
+        bool IsFramePipelining() const;
+
+        // Runs Application::FixedUpdate in steps of this many seconds, 0 turns fixed stepping off. After
+        // maxStepsPerFrame steps the remaining backlog is dropped, so a long stall slows the simulation down
+        // instead of making every following frame slower.
+        void SetFixedTimestep(float seconds, int maxStepsPerFrame = 5);
+        float GetFixedTimestep() const;
+        // How far the frame is into the next fixed step, in [0, 1). Blend the last two simulated states by it
+        // for rendering, see TransformHierarchy::Interpolate.
+        float GetInterpolationAlpha() const;
+
+        // Swap interval 1 or 0, on by default. Main thread only.
+        void SetVSync(bool enable);
+        bool IsVSync() const;
+        // Target frame rate and wait strategy of the loop, applies on top of vsync
+        FramePacer& GetFramePacer();
+        void SetRenderMode(RenderMode mode);
+        RenderMode GetRenderMode() const;
+        // Makes an on-demand loop render again, enough frames for the current state to reach the screen.
+        // Callable from any thread.
+        void RequestRedraw();
+
+        // Seconds from the oldest input event of the last frame that had any to that frame's buffer swap
+        // returning. Photons follow one scanout later, more with triple buffering in the driver.
+        float GetInputLatency() const;
+
+        // Frame times and the last frame's render counters on top of everything else
+        void SetStatsOverlay(bool enable);
+        bool IsStatsOverlay() const;
+        StatsOverlay& GetStatsOverlay();
+        // Appends a CSV row per frame until stopped, see RenderStatsLog
+        bool StartRenderStatsLog(const std::string& path);
+        void StopRenderStatsLog();
 
     private:
+        // Frame stages in the order a single frame passes through them. Only simulate may run off the main
+        // thread, and hand-off needs it to be finished.
+        float InputStage();
+        void SimulateStage(float deltaTime);
+        void HandOffStage();
+        void CullStage();
+        void RecordStage();
+        // Samples input again and runs Application::LateUpdate, as close to submit as possible
+        void LateInputStage();
+        void SubmitStage();
+        void PresentStage();
+        // On-demand mode: whether anything asks for a frame, and sleeping until something might
+        bool NeedsRedraw();
+        void WaitForRedraw();
+        void PollGamepads();
+        void MeasureInputLatency(double inputTime);
+
         std::unique_ptr<Application> m_application;
         std::chrono::steady_clock::time_point m_lastTimePoint;
         GLFWwindow* m_window = nullptr;
         InputManager m_inputManager;
         GraphicsAPI m_graphicsAPI;
         RenderQueue m_rederQueue;
+        TextureStreamer m_textureStreamer;
+        SpriteBatch m_spriteBatch;
+        JobSystem m_jobSystem;
+        TaskScheduler m_taskScheduler;
+        GpuProfiler m_gpuProfiler;
+        bool m_headless = false;
+        bool m_framePipelining = false;
+        float m_fixedTimestep = 0.0f;
+        int m_maxFixedSteps = 5;
+        double m_fixedAccumulator = 0.0;
+        float m_interpolationAlpha = 0.0f;
+        FramePacer m_framePacer;
+        bool m_vsync = true;
+        RenderMode m_renderMode = RenderMode::Continuous;
+        // Frames an on-demand loop still owes
+        std::atomic<int> m_redrawFrames{ 0 };
+        bool m_gamepadConnected = false;
+        // Oldest input of the frame the last hand-off passed to rendering
+        double m_handedOffInputTime = -1.0;
+        float m_inputLatency = 0.0f;
+        StatsOverlay m_statsOverlay;
+        bool m_statsOverlayEnabled = false;
+        RenderStatsLog m_renderStatsLog;
+        uint64_t m_frameCount = 0;
+        // Seconds between the starts of the last two frames
+        float m_frameTime = 0.0f;
     };
 }
\ No newline at end of file
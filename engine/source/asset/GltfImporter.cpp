@@ -0,0 +1,575 @@
+#include "asset/GltfImporter.h"
+#include "io/Json.h"
+#include "io/MappedFile.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <stdint.h>
+
+namespace eng
+{
+    namespace
+    {
+        constexpr uint32_t GlbMagic = 0x46546C67; // "glTF"
+        constexpr uint32_t GlbChunkJson = 0x4E4F534A;
+        constexpr uint32_t GlbChunkBin = 0x004E4942;
+
+        constexpr int ComponentByte = 5120;
+        constexpr int ComponentUnsignedByte = 5121;
+        constexpr int ComponentShort = 5122;
+        constexpr int ComponentUnsignedShort = 5123;
+        constexpr int ComponentUnsignedInt = 5125;
+        constexpr int ComponentFloat = 5126;
+
+        constexpr int ModeTriangles = 4;
+
+        constexpr size_t MaxByteStride = 252;
+        // Imported indices are 32-bit
+        constexpr size_t MaxElements = UINT32_MAX;
+
+        struct BufferData
+        {
+            const uint8_t* data = nullptr;
+            size_t size = 0;
+        };
+
+        struct Accessor
+        {
+            const uint8_t* data = nullptr;
+            size_t count = 0;
+            size_t stride = 0;
+            int componentType = 0;
+            int components = 0;
+            bool normalized = false;
+        };
+
+        struct Primitive
+        {
+            Accessor position;
+            Accessor normal;
+            Accessor texCoord;
+            Accessor indices;
+            bool hasNormal = false;
+            bool hasTexCoord = false;
+            bool hasIndices = false;
+            size_t vertexBase = 0;
+            size_t indexBase = 0;
+        };
+
+        struct GltfDocument
+        {
+            JsonValue json;
+            std::vector<BufferData> buffers;
+            // Keeps external .bin files mapped and decoded data URIs alive while importing
+            std::vector<std::unique_ptr<MappedFile>> mappedFiles;
+            std::vector<std::vector<uint8_t>> decodedBuffers;
+        };
+
+        size_t ComponentSize(int componentType)
+        {
+            switch (componentType)
+            {
+            case ComponentByte:
+            case ComponentUnsignedByte:
+                return 1;
+            case ComponentShort:
+            case ComponentUnsignedShort:
+                return 2;
+            case ComponentUnsignedInt:
+            case ComponentFloat:
+                return 4;
+            default:
+                return 0;
+            }
+        }
+
+        // Written so that untrusted offsets and lengths cannot wrap around
+        bool IsInRange(size_t offset, size_t length, size_t size)
+        {
+            return offset <= size && length <= size - offset;
+        }
+
+        // Counts, offsets and indices must be non-negative integers, anything else cannot be cast to size_t
+        bool ReadSize(const JsonValue& value, size_t max, size_t& out)
+        {
+            // Past 2^53 doubles skip integers, and max itself may not be representable
+            constexpr double MaxExactInteger = 9007199254740992.0;
+            const double number = value.AsNumber(-1.0);
+            if (!(number >= 0.0) || number > std::min(static_cast<double>(max), MaxExactInteger)
+                || number != std::floor(number))
+            {
+                return false;
+            }
+            out = static_cast<size_t>(number);
+            return true;
+        }
+
+        int ComponentCount(const std::string& type)
+        {
+            if (type == "SCALAR") return 1;
+            if (type == "VEC2") return 2;
+            if (type == "VEC3") return 3;
+            if (type == "VEC4") return 4;
+            return 0;
+        }
+
+        bool DecodeBase64(const char* text, size_t length, std::vector<uint8_t>& out)
+        {
+            auto decode = [](char c) -> int
+            {
+                if (c >= 'A' && c <= 'Z') return c - 'A';
+                if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+                if (c >= '0' && c <= '9') return c - '0' + 52;
+                if (c == '+' || c == '-') return 62;
+                if (c == '/' || c == '_') return 63;
+                return -1;
+            };
+
+            out.clear();
+            out.reserve(length / 4 * 3);
+            uint32_t bits = 0;
+            int bitCount = 0;
+            for (size_t i = 0; i < length && text[i] != '='; ++i)
+            {
+                int value = decode(text[i]);
+                if (value < 0)
+                {
+                    return false;
+                }
+                bits = (bits << 6) | static_cast<uint32_t>(value);
+                bitCount += 6;
+                if (bitCount >= 8)
+                {
+                    bitCount -= 8;
+                    out.push_back(static_cast<uint8_t>((bits >> bitCount) & 0xFF));
+                }
+            }
+            return true;
+        }
+
+        std::string DirectoryOf(const std::string& path)
+        {
+            auto slash = path.find_last_of("/\\");
+            return slash == std::string::npos ? std::string() : path.substr(0, slash + 1);
+        }
+
+        bool LoadBuffers(GltfDocument& doc, const std::string& directory, const BufferData& glbChunk)
+        {
+            const JsonValue& buffers = doc.json["buffers"];
+            for (size_t i = 0; i < buffers.Size(); ++i)
+            {
+                const JsonValue& buffer = buffers[i];
+                const std::string& uri = buffer["uri"].AsString();
+                size_t byteLength = 0;
+                if (!ReadSize(buffer["byteLength"], SIZE_MAX, byteLength))
+                {
+                    return false;
+                }
+                BufferData data;
+
+                if (uri.empty())
+                {
+                    // Only the first buffer of a .glb may omit its uri and refer to the BIN chunk
+                    if (i != 0 || !glbChunk.data)
+                    {
+                        return false;
+                    }
+                    data = glbChunk;
+                }
+                else if (uri.compare(0, 5, "data:") == 0)
+                {
+                    auto comma = uri.find(";base64,");
+                    if (comma == std::string::npos)
+                    {
+                        return false;
+                    }
+                    doc.decodedBuffers.emplace_back();
+                    auto& decoded = doc.decodedBuffers.back();
+                    if (!DecodeBase64(uri.data() + comma + 8, uri.size() - comma - 8, decoded))
+                    {
+                        return false;
+                    }
+                    data.data = decoded.data();
+                    data.size = decoded.size();
+                }
+                else
+                {
+                    auto file = std::make_unique<MappedFile>();
+                    if (!file->Open(directory + uri))
+                    {
+                        return false;
+                    }
+                    data.data = file->GetData();
+                    data.size = file->GetSize();
+                    doc.mappedFiles.push_back(std::move(file));
+                }
+
+                if (data.size < byteLength)
+                {
+                    return false;
+                }
+                doc.buffers.push_back(data);
+            }
+            return true;
+        }
+
+        bool ResolveAccessor(const GltfDocument& doc, const JsonValue& index, Accessor& out)
+        {
+            size_t accessorIndex = 0;
+            if (!ReadSize(index, SIZE_MAX, accessorIndex))
+            {
+                return false;
+            }
+            const JsonValue& accessor = doc.json["accessors"][accessorIndex];
+            size_t componentType = 0;
+            if (!accessor.IsObject() || !ReadSize(accessor["count"], MaxElements, out.count)
+                || !ReadSize(accessor["componentType"], ComponentFloat, componentType))
+            {
+                return false;
+            }
+
+            out.componentType = static_cast<int>(componentType);
+            out.components = ComponentCount(accessor["type"].AsString());
+            out.normalized = accessor["normalized"].AsBool();
+
+            size_t elementSize = ComponentSize(out.componentType) * out.components;
+            if (elementSize == 0)
+            {
+                return false;
+            }
+
+            // Sparse-only accessors without a buffer view are not supported
+            size_t viewIndex = 0;
+            if (!ReadSize(accessor["bufferView"], SIZE_MAX, viewIndex))
+            {
+                return false;
+            }
+            const JsonValue& view = doc.json["bufferViews"][viewIndex];
+            size_t bufferIndex = 0;
+            if (!ReadSize(view["buffer"], SIZE_MAX, bufferIndex) || bufferIndex >= doc.buffers.size())
+            {
+                return false;
+            }
+
+            size_t viewOffset = 0;
+            size_t viewLength = 0;
+            size_t accessorOffset = 0;
+            if ((view.Has("byteOffset") && !ReadSize(view["byteOffset"], SIZE_MAX, viewOffset))
+                || !ReadSize(view["byteLength"], SIZE_MAX, viewLength)
+                || (accessor.Has("byteOffset") && !ReadSize(accessor["byteOffset"], SIZE_MAX, accessorOffset)))
+            {
+                return false;
+            }
+
+            out.stride = elementSize;
+            if (view.Has("byteStride") && (!ReadSize(view["byteStride"], MaxByteStride, out.stride)
+                || out.stride < elementSize))
+            {
+                return false;
+            }
+
+            const BufferData& buffer = doc.buffers[bufferIndex];
+            if (!IsInRange(viewOffset, viewLength, buffer.size) || accessorOffset > viewLength)
+            {
+                return false;
+            }
+
+            // The last element needs elementSize bytes, every one before it a full stride
+            const size_t available = viewLength - accessorOffset;
+            if (out.count > 0 && (elementSize > available || out.count - 1 > (available - elementSize) / out.stride))
+            {
+                return false;
+            }
+
+            out.data = buffer.data + viewOffset + accessorOffset;
+            return true;
+        }
+
+        float ReadComponent(const uint8_t* src, int componentType, bool normalized)
+        {
+            switch (componentType)
+            {
+            case ComponentFloat:
+            {
+                float value;
+                memcpy(&value, src, sizeof(value));
+                return value;
+            }
+            case ComponentUnsignedByte:
+                return normalized ? *src / 255.0f : static_cast<float>(*src);
+            case ComponentByte:
+            {
+                float value = static_cast<float>(static_cast<int8_t>(*src));
+                return normalized ? std::max(value / 127.0f, -1.0f) : value;
+            }
+            case ComponentUnsignedShort:
+            {
+                uint16_t value;
+                memcpy(&value, src, sizeof(value));
+                return normalized ? value / 65535.0f : static_cast<float>(value);
+            }
+            case ComponentShort:
+            {
+                int16_t value;
+                memcpy(&value, src, sizeof(value));
+                return normalized ? std::max(value / 32767.0f, -1.0f) : static_cast<float>(value);
+            }
+            default:
+                return 0.0f;
+            }
+        }
+
+        void ReadElement(const Accessor& accessor, size_t index, int components, float* dst)
+        {
+            const uint8_t* src = accessor.data + accessor.stride * index;
+            size_t componentSize = ComponentSize(accessor.componentType);
+            for (int c = 0; c < components; ++c)
+            {
+                dst[c] = c < accessor.components
+                    ? ReadComponent(src + c * componentSize, accessor.componentType, accessor.normalized)
+                    : 0.0f;
+            }
+        }
+
+        uint32_t ReadIndex(const Accessor& accessor, size_t index)
+        {
+            const uint8_t* src = accessor.data + accessor.stride * index;
+            switch (accessor.componentType)
+            {
+            case ComponentUnsignedByte:
+                return *src;
+            case ComponentUnsignedShort:
+            {
+                uint16_t value;
+                memcpy(&value, src, sizeof(value));
+                return value;
+            }
+            default:
+            {
+                uint32_t value;
+                memcpy(&value, src, sizeof(value));
+                return value;
+            }
+            }
+        }
+
+        bool ParseContainer(const uint8_t* data, size_t size, GltfDocument& doc, BufferData& binChunk)
+        {
+            const char* jsonText = reinterpret_cast<const char*>(data);
+            size_t jsonLength = size;
+
+            uint32_t magic = 0;
+            if (size >= 12)
+            {
+                memcpy(&magic, data, sizeof(magic));
+            }
+
+            if (magic == GlbMagic)
+            {
+                uint32_t version = 0;
+                memcpy(&version, data + 4, sizeof(version));
+                if (version != 2)
+                {
+                    return false;
+                }
+
+                jsonText = nullptr;
+                size_t offset = 12;
+                while (offset + 8 <= size)
+                {
+                    uint32_t chunkLength = 0;
+                    uint32_t chunkType = 0;
+                    memcpy(&chunkLength, data + offset, sizeof(chunkLength));
+                    memcpy(&chunkType, data + offset + 4, sizeof(chunkType));
+                    offset += 8;
+                    if (!IsInRange(offset, chunkLength, size))
+                    {
+                        return false;
+                    }
+                    if (chunkType == GlbChunkJson && !jsonText)
+                    {
+                        jsonText = reinterpret_cast<const char*>(data + offset);
+                        jsonLength = chunkLength;
+                    }
+                    else if (chunkType == GlbChunkBin && !binChunk.data)
+                    {
+                        binChunk.data = data + offset;
+                        binChunk.size = chunkLength;
+                    }
+                    offset += (chunkLength + 3) & ~3u;
+                }
+                if (!jsonText)
+                {
+                    return false;
+                }
+            }
+
+            std::string error;
+            if (!JsonValue::Parse(jsonText, jsonLength, doc.json, &error))
+            {
+                std::cerr << "ERROR:GLTF_JSON_PARSE_FAILED: " << error << std::endl;
+                return false;
+            }
+            return doc.json["asset"]["version"].AsString().compare(0, 2, "2.") == 0;
+        }
+    }
+
+    bool ImportGltf(const std::string& path, ImportedMesh& out)
+    {
+        out = ImportedMesh();
+
+        MappedFile file;
+        if (!file.Open(path))
+        {
+            return false;
+        }
+
+        GltfDocument doc;
+        BufferData binChunk;
+        if (!ParseContainer(file.GetData(), file.GetSize(), doc, binChunk))
+        {
+            std::cerr << "ERROR:GLTF_INVALID_CONTAINER: " << path << std::endl;
+            return false;
+        }
+
+        if (!LoadBuffers(doc, DirectoryOf(path), binChunk))
+        {
+            std::cerr << "ERROR:GLTF_BUFFER_LOAD_FAILED: " << path << std::endl;
+            return false;
+        }
+
+        std::vector<Primitive> primitives;
+        size_t vertexCount = 0;
+        size_t indexCount = 0;
+        bool hasNormals = false;
+        bool hasTexCoords = false;
+
+        const JsonValue& meshes = doc.json["meshes"];
+        for (size_t m = 0; m < meshes.Size(); ++m)
+        {
+            const JsonValue& meshPrimitives = meshes[m]["primitives"];
+            for (size_t p = 0; p < meshPrimitives.Size(); ++p)
+            {
+                const JsonValue& primitive = meshPrimitives[p];
+                if (primitive["mode"].AsInt(ModeTriangles) != ModeTriangles)
+                {
+                    continue;
+                }
+
+                const JsonValue& attributes = primitive["attributes"];
+                Primitive prim;
+                if (!ResolveAccessor(doc, attributes["POSITION"], prim.position)
+                    || prim.position.componentType != ComponentFloat || prim.position.components != 3)
+                {
+                    std::cerr << "ERROR:GLTF_INVALID_POSITIONS: " << path << std::endl;
+                    return false;
+                }
+
+                prim.hasNormal = attributes.Has("NORMAL")
+                    && ResolveAccessor(doc, attributes["NORMAL"], prim.normal)
+                    && prim.normal.count >= prim.position.count;
+                prim.hasTexCoord = attributes.Has("TEXCOORD_0")
+                    && ResolveAccessor(doc, attributes["TEXCOORD_0"], prim.texCoord)
+                    && prim.texCoord.count >= prim.position.count;
+                // Any other index type would be read with the wrong size in ReadIndex
+                prim.hasIndices = primitive.Has("indices");
+                if (prim.hasIndices && (!ResolveAccessor(doc, primitive["indices"], prim.indices)
+                    || prim.indices.components != 1
+                    || (prim.indices.componentType != ComponentUnsignedByte
+                        && prim.indices.componentType != ComponentUnsignedShort
+                        && prim.indices.componentType != ComponentUnsignedInt)))
+                {
+                    std::cerr << "ERROR:GLTF_INVALID_INDICES: " << path << std::endl;
+                    return false;
+                }
+
+                // Bounds the staging arrays and keeps vertexBase + index within 32 bits
+                const size_t primitiveIndexCount = prim.hasIndices ? prim.indices.count : prim.position.count;
+                if (prim.position.count > MaxElements - vertexCount || primitiveIndexCount > MaxElements - indexCount)
+                {
+                    std::cerr << "ERROR:GLTF_TOO_LARGE: " << path << std::endl;
+                    return false;
+                }
+
+                prim.vertexBase = vertexCount;
+                prim.indexBase = indexCount;
+                vertexCount += prim.position.count;
+                indexCount += primitiveIndexCount;
+                hasNormals |= prim.hasNormal;
+                hasTexCoords |= prim.hasTexCoord;
+                primitives.push_back(prim);
+            }
+        }
+
+        out.layout = ImportedMesh::MakeLayout(hasNormals, hasTexCoords);
+        const size_t floatsPerVertex = out.layout.stride / sizeof(float);
+
+        // Primitives decode in parallel into disjoint ranges of the staging arrays
+        std::vector<float> staging(vertexCount * floatsPerVertex);
+        std::vector<uint32_t> stagingIndices(indexCount);
+        std::vector<uint8_t> valid(primitives.size(), 1);
+
+        RunImportTasks(primitives.size(), [&](size_t i)
+        {
+            const Primitive& prim = primitives[i];
+            for (size_t v = 0; v < prim.position.count; ++v)
+            {
+                float* dst = &staging[(prim.vertexBase + v) * floatsPerVertex];
+                ReadElement(prim.position, v, 3, dst);
+                dst += 3;
+                if (hasNormals)
+                {
+                    if (prim.hasNormal)
+                    {
+                        ReadElement(prim.normal, v, 3, dst);
+                    }
+                    dst += 3;
+                }
+                if (hasTexCoords && prim.hasTexCoord)
+                {
+                    ReadElement(prim.texCoord, v, 2, dst);
+                }
+            }
+
+            uint32_t* indices = &stagingIndices[prim.indexBase];
+            size_t count = prim.hasIndices ? prim.indices.count : prim.position.count;
+            for (size_t n = 0; n < count; ++n)
+            {
+                uint32_t index = prim.hasIndices ? ReadIndex(prim.indices, n) : static_cast<uint32_t>(n);
+                if (index >= prim.position.count)
+                {
+                    valid[i] = 0;
+                    return;
+                }
+                indices[n] = static_cast<uint32_t>(prim.vertexBase) + index;
+            }
+        });
+
+        for (uint8_t ok : valid)
+        {
+            if (!ok)
+            {
+                std::cerr << "ERROR:GLTF_INDEX_OUT_OF_RANGE: " << path << std::endl;
+                return false;
+            }
+        }
+
+        // Weld duplicates across primitives and inside unindexed primitives
+        VertexDeduplicator deduplicator(out.vertices, floatsPerVertex, vertexCount);
+        std::vector<uint32_t> remap(vertexCount);
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            remap[v] = deduplicator.Add(&staging[v * floatsPerVertex]);
+        }
+
+        out.indices.resize(indexCount);
+        for (size_t n = 0; n < indexCount; ++n)
+        {
+            out.indices[n] = remap[stagingIndices[n]];
+        }
+
+        out.ComputeBounds();
+        return true;
+    }
+}
\ No newline at end of file
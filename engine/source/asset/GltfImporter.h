@@ -0,0 +1,9 @@
+#pragma once
+#include "asset/ImportedMesh.h"
+
+namespace eng
+{
+    // glTF 2.0 (.gltf with external or data URI buffers, and binary .glb).
+    // Triangle primitives of every mesh are merged in mesh space; node transforms are not applied.
+    bool ImportGltf(const std::string& path, ImportedMesh& out);
+}
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "asset/ImportedMesh.h"
+#include "Engine.h"
+#include "coro/TaskScheduler.h"
+#include "asset/ObjImporter.h"
+#include "asset/GltfImporter.h"
+#include "render/Mesh.h"
+#include "render/MeshFile.h"
+#include "render/OcclusionCulling.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+namespace eng
+{
+    VertexLayout ImportedMesh::MakeLayout(bool hasNormals, bool hasTexCoords)
+    {
+        VertexLayout layout;
+        uint32_t offset = 0;
+
+        layout.elements.push_back({ ImportPositionLocation, 3, GL_FLOAT, offset });
+        offset += sizeof(float) * 3;
+
+        if (hasNormals)
+        {
+            layout.elements.push_back({ ImportNormalLocation, 3, GL_FLOAT, offset });
+            offset += sizeof(float) * 3;
+        }
+
+        if (hasTexCoords)
+        {
+            layout.elements.push_back({ ImportTexCoordLocation, 2, GL_FLOAT, offset });
+            offset += sizeof(float) * 2;
+        }
+
+        layout.stride = offset;
+        return layout;
+    }
+
+    void ImportedMesh::ComputeBounds()
+    {
+        bounds = BoundingBox();
+        const size_t floatsPerVertex = layout.stride / sizeof(float);
+        if (floatsPerVertex < 3 || vertices.size() < floatsPerVertex)
+        {
+            return;
+        }
+
+        for (int i = 0; i < 3; ++i)
+        {
+            bounds.min[i] = bounds.max[i] = vertices[i];
+        }
+        for (size_t v = 0; v + floatsPerVertex <= vertices.size(); v += floatsPerVertex)
+        {
+            for (int i = 0; i < 3; ++i)
+            {
+                bounds.min[i] = std::min(bounds.min[i], vertices[v + i]);
+                bounds.max[i] = std::max(bounds.max[i], vertices[v + i]);
+            }
+        }
+    }
+
+    std::unique_ptr<Mesh> ImportedMesh::CreateMesh() const
+    {
+        return std::make_unique<Mesh>(layout, vertices.data(), vertices.size() * sizeof(float),
+            indices.data(), indices.size(), &bounds);
+    }
+
+    std::unique_ptr<OccluderMesh> ImportedMesh::CreateOccluder() const
+    {
+        auto occluder = std::make_unique<OccluderMesh>();
+        occluder->indices = indices;
+        occluder->bounds = bounds;
+
+        const size_t floatsPerVertex = layout.stride / sizeof(float);
+        for (auto& element : layout.elements)
+        {
+            if (element.index != ImportPositionLocation || floatsPerVertex == 0)
+            {
+                continue;
+            }
+
+            const size_t vertexCount = vertices.size() / floatsPerVertex;
+            const size_t offset = element.offset / sizeof(float);
+            const size_t components = std::min<size_t>(element.size, 3);
+            occluder->positions.assign(vertexCount * 3, 0.0f);
+            for (size_t i = 0; i < vertexCount; ++i)
+            {
+                for (size_t c = 0; c < components; ++c)
+                {
+                    occluder->positions[i * 3 + c] = vertices[i * floatsPerVertex + offset + c];
+                }
+            }
+        }
+        return occluder;
+    }
+
+    bool ImportedMesh::SaveCooked(const std::string& path) const
+    {
+        return SaveMeshFile(path, layout, vertices.data(), vertices.size() * sizeof(float),
+            indices.data(), indices.size(), bounds);
+    }
+
+    VertexDeduplicator::VertexDeduplicator(std::vector<float>& vertices, size_t floatsPerVertex, size_t expectedVertices)
+        : m_vertices(vertices), m_floatsPerVertex(floatsPerVertex)
+    {
+        size_t capacity = 64;
+        while (capacity < expectedVertices * 2)
+        {
+            capacity *= 2;
+        }
+        m_slots.assign(capacity, UINT32_MAX);
+        m_vertices.reserve(m_vertices.size() + expectedVertices * floatsPerVertex);
+        m_count = m_vertices.size() / floatsPerVertex;
+    }
+
+    uint64_t VertexDeduplicator::Hash(const float* vertex) const
+    {
+        // FNV-1a over the raw bits so -0.0f and 0.0f stay distinct like the source data
+        uint64_t hash = 14695981039346656037ull;
+        const auto* bytes = reinterpret_cast<const uint8_t*>(vertex);
+        for (size_t i = 0; i < m_floatsPerVertex * sizeof(float); ++i)
+        {
+            hash ^= bytes[i];
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+
+    void VertexDeduplicator::Grow()
+    {
+        std::vector<uint32_t> slots(m_slots.size() * 2, UINT32_MAX);
+        const size_t mask = slots.size() - 1;
+        for (uint32_t index : m_slots)
+        {
+            if (index == UINT32_MAX)
+            {
+                continue;
+            }
+            size_t slot = Hash(&m_vertices[index * m_floatsPerVertex]) & mask;
+            while (slots[slot] != UINT32_MAX)
+            {
+                slot = (slot + 1) & mask;
+            }
+            slots[slot] = index;
+        }
+        m_slots.swap(slots);
+    }
+
+    uint32_t VertexDeduplicator::Add(const float* vertex)
+    {
+        if ((m_count + 1) * 2 > m_slots.size())
+        {
+            Grow();
+        }
+
+        const size_t mask = m_slots.size() - 1;
+        const size_t vertexBytes = m_floatsPerVertex * sizeof(float);
+        size_t slot = Hash(vertex) & mask;
+        while (m_slots[slot] != UINT32_MAX)
+        {
+            uint32_t index = m_slots[slot];
+            if (memcmp(&m_vertices[index * m_floatsPerVertex], vertex, vertexBytes) == 0)
+            {
+                return index;
+            }
+            slot = (slot + 1) & mask;
+        }
+
+        uint32_t index = static_cast<uint32_t>(m_count++);
+        m_vertices.insert(m_vertices.end(), vertex, vertex + m_floatsPerVertex);
+        m_slots[slot] = index;
+        return index;
+    }
+
+    void RunImportTasks(size_t taskCount, const std::function<void(size_t)>& task)
+    {
+        Engine::GetInstance().GetJobSystem().ParallelFor(taskCount, [&task](size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; ++i)
+            {
+                task(i);
+            }
+        });
+    }
+
+    bool ImportModel(const std::string& path, ImportedMesh& out)
+    {
+        auto dot = path.find_last_of('.');
+        std::string extension = dot == std::string::npos ? "" : path.substr(dot + 1);
+        std::transform(extension.begin(), extension.end(), extension.begin(),
+            [](unsigned char c) { return static_cast<char>(tolower(c)); });
+
+        if (extension == "obj")
+        {
+            return ImportObj(path, out);
+        }
+        if (extension == "gltf" || extension == "glb")
+        {
+            return ImportGltf(path, out);
+        }
+
+        std::cerr << "ERROR:UNSUPPORTED_MODEL_FORMAT: " << path << std::endl;
+        return false;
+    }
+    Task<std::unique_ptr<ImportedMesh>> ImportModelAsync(std::string path)
+    {
+        auto mesh = std::make_unique<ImportedMesh>();
+        bool imported = false;
+        co_await Engine::GetInstance().GetTaskScheduler().RunJob([&]() { imported = ImportModel(path, *mesh); });
+        if (!imported)
+        {
+            co_return nullptr;
+        }
+        co_return std::move(mesh);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,62 @@
+#pragma once
+#include "coro/Task.h"
+#include "graphics/VertexLayout.h"
+#include "render/Bounds.h"
+#include <functional>
+#include <memory>
+#include <string>
+
+namespace eng
+{
+    class Mesh;
+    struct OccluderMesh;
+
+    // Attribute locations used by every importer
+    constexpr GLuint ImportPositionLocation = 0;
+    constexpr GLuint ImportNormalLocation = 1;
+    constexpr GLuint ImportTexCoordLocation = 2;
+
+    // Interleaved float vertices and 32-bit indices ready for Mesh or SaveMeshFile
+    struct ImportedMesh
+    {
+        VertexLayout layout;
+        std::vector<float> vertices;
+        std::vector<uint32_t> indices;
+        BoundingBox bounds;
+
+        static VertexLayout MakeLayout(bool hasNormals, bool hasTexCoords);
+
+        void ComputeBounds();
+        std::unique_ptr<Mesh> CreateMesh() const;
+        // Positions and indices only, for the CPU occlusion culler
+        std::unique_ptr<OccluderMesh> CreateOccluder() const;
+        bool SaveCooked(const std::string& path) const;
+    };
+
+    // Welds identical vertices using an open addressing table over the vertex bytes
+    class VertexDeduplicator
+    {
+    public:
+        VertexDeduplicator(std::vector<float>& vertices, size_t floatsPerVertex, size_t expectedVertices = 0);
+
+        uint32_t Add(const float* vertex);
+
+    private:
+        void Grow();
+        uint64_t Hash(const float* vertex) const;
+
+        std::vector<float>& m_vertices;
+        std::vector<uint32_t> m_slots;
+        size_t m_floatsPerVertex = 0;
+        size_t m_count = 0;
+    };
+
+    // Runs task(0..taskCount-1) on the engine's job system and waits for completion
+    void RunImportTasks(size_t taskCount, const std::function<void(size_t)>& task);
+
+    // Picks the importer from the file extension (.obj, .gltf, .glb)
+    bool ImportModel(const std::string& path, ImportedMesh& out);
+    // ImportModel on the job system, the awaiting task resumes on the frame after it finished. nullptr on
+    // failure.
+    Task<std::unique_ptr<ImportedMesh>> ImportModelAsync(std::string path);
+}
\ No newline at end of file
@@ -0,0 +1,395 @@
+#include "asset/ObjImporter.h"
+#include "io/MappedFile.h"
+#include <algorithm>
+#include <iostream>
+
+namespace eng
+{
+    namespace
+    {
+        constexpr size_t MinChunkSize = 1 << 20;
+
+        struct ObjCorner
+        {
+            int32_t position = -1;
+            int32_t texCoord = -1;
+            int32_t normal = -1;
+        };
+
+        struct ObjCounts
+        {
+            size_t positions = 0;
+            size_t texCoords = 0;
+            size_t normals = 0;
+        };
+
+        struct ObjChunk
+        {
+            const char* begin = nullptr;
+            const char* end = nullptr;
+            ObjCounts counts;
+            ObjCounts base;
+            std::vector<ObjCorner> corners;
+            bool valid = true;
+        };
+
+        bool IsSpace(char c)
+        {
+            return c == ' ' || c == '\t' || c == '\r';
+        }
+
+        const char* SkipSpaces(const char* p, const char* end)
+        {
+            while (p < end && IsSpace(*p))
+            {
+                ++p;
+            }
+            return p;
+        }
+
+        const char* NextLine(const char* p, const char* end)
+        {
+            while (p < end && *p != '\n')
+            {
+                ++p;
+            }
+            return p < end ? p + 1 : end;
+        }
+
+        // Locale independent and considerably faster than strtof for the plain decimals OBJ uses
+        bool ParseFloat(const char*& p, const char* end, float& out)
+        {
+            p = SkipSpaces(p, end);
+            bool negative = false;
+            if (p < end && (*p == '-' || *p == '+'))
+            {
+                negative = *p == '-';
+                ++p;
+            }
+
+            double value = 0.0;
+            bool digits = false;
+            while (p < end && *p >= '0' && *p <= '9')
+            {
+                value = value * 10.0 + (*p++ - '0');
+                digits = true;
+            }
+            if (p < end && *p == '.')
+            {
+                ++p;
+                double scale = 0.1;
+                while (p < end && *p >= '0' && *p <= '9')
+                {
+                    value += (*p++ - '0') * scale;
+                    scale *= 0.1;
+                    digits = true;
+                }
+            }
+            if (!digits)
+            {
+                return false;
+            }
+            if (p < end && (*p == 'e' || *p == 'E'))
+            {
+                ++p;
+                bool negativeExponent = false;
+                if (p < end && (*p == '-' || *p == '+'))
+                {
+                    negativeExponent = *p == '-';
+                    ++p;
+                }
+                int exponent = 0;
+                while (p < end && *p >= '0' && *p <= '9')
+                {
+                    exponent = std::min(exponent * 10 + (*p++ - '0'), 400);
+                }
+                double power = 1.0;
+                double base = 10.0;
+                while (exponent > 0)
+                {
+                    if (exponent & 1)
+                    {
+                        power *= base;
+                    }
+                    base *= base;
+                    exponent >>= 1;
+                }
+                value = negativeExponent ? value / power : value * power;
+            }
+
+            out = static_cast<float>(negative ? -value : value);
+            return true;
+        }
+
+        bool ParseInt(const char*& p, const char* end, int64_t& out)
+        {
+            bool negative = false;
+            if (p < end && (*p == '-' || *p == '+'))
+            {
+                negative = *p == '-';
+                ++p;
+            }
+            if (p >= end || *p < '0' || *p > '9')
+            {
+                return false;
+            }
+            int64_t value = 0;
+            while (p < end && *p >= '0' && *p <= '9')
+            {
+                const int digit = *p++ - '0';
+                if (value > (INT64_MAX - digit) / 10)
+                {
+                    return false;
+                }
+                value = value * 10 + digit;
+            }
+            out = negative ? -value : value;
+            return true;
+        }
+
+        // OBJ indices are 1-based, negative values count back from the current element. INT32_MIN for indices
+        // that are 0, reach before the first element or do not fit an int32_t
+        int32_t ResolveIndex(int64_t index, size_t countSoFar)
+        {
+            int64_t resolved = -1;
+            if (index > 0)
+            {
+                resolved = index - 1;
+            }
+            else if (index < 0 && static_cast<uint64_t>(-index) <= countSoFar)
+            {
+                resolved = static_cast<int64_t>(countSoFar) + index;
+            }
+            return resolved >= 0 && resolved <= INT32_MAX ? static_cast<int32_t>(resolved) : INT32_MIN;
+        }
+
+        void CountChunk(ObjChunk& chunk)
+        {
+            const char* p = chunk.begin;
+            while (p < chunk.end)
+            {
+                const char* line = SkipSpaces(p, chunk.end);
+                if (line + 1 < chunk.end && line[0] == 'v')
+                {
+                    if (IsSpace(line[1]))
+                    {
+                        ++chunk.counts.positions;
+                    }
+                    else if (line[1] == 't')
+                    {
+                        ++chunk.counts.texCoords;
+                    }
+                    else if (line[1] == 'n')
+                    {
+                        ++chunk.counts.normals;
+                    }
+                }
+                p = NextLine(line, chunk.end);
+            }
+        }
+
+        void ParseChunk(ObjChunk& chunk, std::vector<float>& positions, std::vector<float>& texCoords,
+            std::vector<float>& normals)
+        {
+            ObjCounts cursor = chunk.base;
+            std::vector<ObjCorner> polygon;
+
+            const char* p = chunk.begin;
+            while (p < chunk.end && chunk.valid)
+            {
+                const char* line = SkipSpaces(p, chunk.end);
+                const char* lineEnd = line;
+                while (lineEnd < chunk.end && *lineEnd != '\n')
+                {
+                    ++lineEnd;
+                }
+                p = lineEnd < chunk.end ? lineEnd + 1 : chunk.end;
+
+                if (lineEnd - line < 2)
+                {
+                    continue;
+                }
+
+                const char* q = line + 1;
+                if (line[0] == 'v' && IsSpace(line[1]))
+                {
+                    float* dst = &positions[cursor.positions++ * 3];
+                    chunk.valid = ParseFloat(q, lineEnd, dst[0]) && ParseFloat(q, lineEnd, dst[1])
+                        && ParseFloat(q, lineEnd, dst[2]);
+                }
+                else if (line[0] == 'v' && line[1] == 't')
+                {
+                    ++q;
+                    float* dst = &texCoords[cursor.texCoords++ * 2];
+                    chunk.valid = ParseFloat(q, lineEnd, dst[0]);
+                    if (!ParseFloat(q, lineEnd, dst[1]))
+                    {
+                        dst[1] = 0.0f;
+                    }
+                }
+                else if (line[0] == 'v' && line[1] == 'n')
+                {
+                    ++q;
+                    float* dst = &normals[cursor.normals++ * 3];
+                    chunk.valid = ParseFloat(q, lineEnd, dst[0]) && ParseFloat(q, lineEnd, dst[1])
+                        && ParseFloat(q, lineEnd, dst[2]);
+                }
+                else if (line[0] == 'f' && IsSpace(line[1]))
+                {
+                    polygon.clear();
+                    while (true)
+                    {
+                        q = SkipSpaces(q, lineEnd);
+                        if (q >= lineEnd || *q == '#')
+                        {
+                            break;
+                        }
+
+                        ObjCorner corner;
+                        int64_t index = 0;
+                        if (!ParseInt(q, lineEnd, index))
+                        {
+                            chunk.valid = false;
+                            break;
+                        }
+                        corner.position = ResolveIndex(index, cursor.positions);
+                        if (q < lineEnd && *q == '/')
+                        {
+                            ++q;
+                            if (q < lineEnd && *q != '/')
+                            {
+                                chunk.valid &= ParseInt(q, lineEnd, index);
+                                corner.texCoord = ResolveIndex(index, cursor.texCoords);
+                            }
+                            if (q < lineEnd && *q == '/')
+                            {
+                                ++q;
+                                chunk.valid &= ParseInt(q, lineEnd, index);
+                                corner.normal = ResolveIndex(index, cursor.normals);
+                            }
+                        }
+                        polygon.push_back(corner);
+                    }
+
+                    for (size_t i = 2; i < polygon.size(); ++i)
+                    {
+                        chunk.corners.push_back(polygon[0]);
+                        chunk.corners.push_back(polygon[i - 1]);
+                        chunk.corners.push_back(polygon[i]);
+                    }
+                }
+            }
+        }
+    }
+
+    bool ImportObjFromMemory(const char* data, size_t size, ImportedMesh& out)
+    {
+        out = ImportedMesh();
+
+        // Split on line boundaries so every chunk can be tokenized independently
+        std::vector<ObjChunk> chunks;
+        size_t chunkCount = std::max<size_t>(1, size / MinChunkSize);
+        size_t chunkSize = size / chunkCount + 1;
+        const char* end = data + size;
+        const char* begin = data;
+        while (begin < end)
+        {
+            const char* chunkEnd = begin + std::min(chunkSize, static_cast<size_t>(end - begin));
+            chunkEnd = chunkEnd < end ? NextLine(chunkEnd, end) : end;
+            ObjChunk chunk;
+            chunk.begin = begin;
+            chunk.end = chunkEnd;
+            chunks.push_back(std::move(chunk));
+            begin = chunkEnd;
+        }
+
+        // Pass 1 counts elements so pass 2 can write them straight to their final slot
+        RunImportTasks(chunks.size(), [&](size_t i) { CountChunk(chunks[i]); });
+
+        ObjCounts total;
+        for (auto& chunk : chunks)
+        {
+            chunk.base = total;
+            total.positions += chunk.counts.positions;
+            total.texCoords += chunk.counts.texCoords;
+            total.normals += chunk.counts.normals;
+        }
+
+        std::vector<float> positions(total.positions * 3);
+        std::vector<float> texCoords(total.texCoords * 2);
+        std::vector<float> normals(total.normals * 3);
+
+        RunImportTasks(chunks.size(), [&](size_t i) { ParseChunk(chunks[i], positions, texCoords, normals); });
+
+        size_t cornerCount = 0;
+        for (auto& chunk : chunks)
+        {
+            if (!chunk.valid)
+            {
+                std::cerr << "ERROR:OBJ_PARSE_FAILED" << std::endl;
+                return false;
+            }
+            cornerCount += chunk.corners.size();
+        }
+
+        const bool hasTexCoords = total.texCoords > 0;
+        const bool hasNormals = total.normals > 0;
+        out.layout = ImportedMesh::MakeLayout(hasNormals, hasTexCoords);
+        const size_t floatsPerVertex = out.layout.stride / sizeof(float);
+
+        VertexDeduplicator deduplicator(out.vertices, floatsPerVertex, cornerCount / 4);
+        out.indices.reserve(cornerCount);
+
+        float vertex[8] = {};
+        for (auto& chunk : chunks)
+        {
+            for (auto& corner : chunk.corners)
+            {
+                if (corner.position < 0 || static_cast<size_t>(corner.position) >= total.positions
+                    || corner.texCoord >= static_cast<int64_t>(total.texCoords) || corner.texCoord < -1
+                    || corner.normal >= static_cast<int64_t>(total.normals) || corner.normal < -1)
+                {
+                    std::cerr << "ERROR:OBJ_INDEX_OUT_OF_RANGE" << std::endl;
+                    return false;
+                }
+
+                size_t offset = 0;
+                const float* position = &positions[static_cast<size_t>(corner.position) * 3];
+                vertex[offset++] = position[0];
+                vertex[offset++] = position[1];
+                vertex[offset++] = position[2];
+                if (hasNormals)
+                {
+                    const float* normal = corner.normal >= 0
+                        ? &normals[static_cast<size_t>(corner.normal) * 3] : nullptr;
+                    vertex[offset++] = normal ? normal[0] : 0.0f;
+                    vertex[offset++] = normal ? normal[1] : 0.0f;
+                    vertex[offset++] = normal ? normal[2] : 0.0f;
+                }
+                if (hasTexCoords)
+                {
+                    const float* texCoord = corner.texCoord >= 0
+                        ? &texCoords[static_cast<size_t>(corner.texCoord) * 2] : nullptr;
+                    vertex[offset++] = texCoord ? texCoord[0] : 0.0f;
+                    vertex[offset++] = texCoord ? texCoord[1] : 0.0f;
+                }
+                out.indices.push_back(deduplicator.Add(vertex));
+            }
+            // Release each chunk as soon as it is consumed to keep peak memory down
+            std::vector<ObjCorner>().swap(chunk.corners);
+        }
+
+        out.ComputeBounds();
+        return true;
+    }
+
+    bool ImportObj(const std::string& path, ImportedMesh& out)
+    {
+        MappedFile file;
+        if (!file.Open(path))
+        {
+            return false;
+        }
+        return ImportObjFromMemory(reinterpret_cast<const char*>(file.GetData()), file.GetSize(), out);
+    }
+}
\ No newline at end of file
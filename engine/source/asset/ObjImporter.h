@@ -0,0 +1,9 @@
+#pragma once
+#include "asset/ImportedMesh.h"
+
+namespace eng
+{
+    // Wavefront OBJ (v/vt/vn/f). Polygons are fan triangulated, all groups merge into one mesh.
+    bool ImportObj(const std::string& path, ImportedMesh& out);
+    bool ImportObjFromMemory(const char* data, size_t size, ImportedMesh& out);
+}
\ No newline at end of file
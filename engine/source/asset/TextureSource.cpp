@@ -0,0 +1,161 @@
+#include "asset/TextureSource.h"
+#include "graphics/MipGenerator.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace eng
+{
+    size_t TextureSource::GetMipSize(uint32_t level) const
+    {
+        return size_t(std::max(1u, GetWidth() >> level)) * std::max(1u, GetHeight() >> level)
+            * GetBytesPerPixel(GetFormat());
+    }
+
+    MemoryTextureSource::MemoryTextureSource(TextureFormat format, uint32_t width, uint32_t height, const void* pixels)
+        : m_format(format), m_width(width), m_height(height)
+    {
+        const uint32_t bytesPerPixel = GetBytesPerPixel(format);
+        const uint32_t levels = GetMipLevelCount(width, height);
+        m_mips.resize(levels);
+
+        const auto* source = static_cast<const uint8_t*>(pixels);
+        m_mips[0].assign(source, source + size_t(width) * height * bytesPerPixel);
+        for (uint32_t level = 1; level < levels; ++level)
+        {
+            uint32_t parentWidth = std::max(1u, width >> (level - 1));
+            uint32_t parentHeight = std::max(1u, height >> (level - 1));
+            m_mips[level].resize(GetMipSize(level));
+            DownsampleMip(m_mips[level - 1].data(), parentWidth, parentHeight, bytesPerPixel, m_mips[level].data());
+        }
+    }
+
+    TextureFormat MemoryTextureSource::GetFormat() const
+    {
+        return m_format;
+    }
+
+    uint32_t MemoryTextureSource::GetWidth() const
+    {
+        return m_width;
+    }
+
+    uint32_t MemoryTextureSource::GetHeight() const
+    {
+        return m_height;
+    }
+
+    uint32_t MemoryTextureSource::GetMipLevels() const
+    {
+        return static_cast<uint32_t>(m_mips.size());
+    }
+
+    bool MemoryTextureSource::ReadMip(uint32_t level, std::vector<uint8_t>& out) const
+    {
+        if (level >= m_mips.size())
+        {
+            return false;
+        }
+        out = m_mips[level];
+        return true;
+    }
+
+    bool SaveTextureFile(const std::string& path, TextureFormat format, uint32_t width, uint32_t height,
+        const void* pixels)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            std::cerr << "ERROR:TEXTURE_FILE_WRITE_FAILED: " << path << std::endl;
+            return false;
+        }
+
+        MemoryTextureSource source(format, width, height, pixels);
+
+        TextureFileHeader header;
+        header.format = static_cast<uint32_t>(format);
+        header.width = width;
+        header.height = height;
+        header.mipLevels = source.GetMipLevels();
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+        std::vector<uint8_t> mip;
+        for (uint32_t level = 0; level < header.mipLevels; ++level)
+        {
+            source.ReadMip(level, mip);
+            file.write(reinterpret_cast<const char*>(mip.data()), static_cast<std::streamsize>(mip.size()));
+        }
+
+        return static_cast<bool>(file);
+    }
+
+    bool MappedTextureSource::Open(const std::string& path)
+    {
+        if (!m_file.Open(path))
+        {
+            return false;
+        }
+
+        if (m_file.GetSize() < sizeof(TextureFileHeader))
+        {
+            std::cerr << "ERROR:TEXTURE_FILE_TRUNCATED: " << path << std::endl;
+            return false;
+        }
+
+        memcpy(&m_header, m_file.GetData(), sizeof(m_header));
+        if (m_header.magic != TextureFileMagic || m_header.version != TextureFileVersion
+            || m_header.format > static_cast<uint32_t>(TextureFormat::RGBA8)
+            || m_header.width == 0 || m_header.height == 0
+            || m_header.mipLevels == 0 || m_header.mipLevels > GetMipLevelCount(m_header.width, m_header.height))
+        {
+            std::cerr << "ERROR:TEXTURE_FILE_BAD_HEADER: " << path << std::endl;
+            return false;
+        }
+
+        m_mipOffsets.clear();
+        size_t offset = sizeof(TextureFileHeader);
+        for (uint32_t level = 0; level < m_header.mipLevels; ++level)
+        {
+            m_mipOffsets.push_back(offset);
+            offset += GetMipSize(level);
+        }
+        if (offset > m_file.GetSize())
+        {
+            std::cerr << "ERROR:TEXTURE_FILE_TRUNCATED: " << path << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    TextureFormat MappedTextureSource::GetFormat() const
+    {
+        return static_cast<TextureFormat>(m_header.format);
+    }
+
+    uint32_t MappedTextureSource::GetWidth() const
+    {
+        return m_header.width;
+    }
+
+    uint32_t MappedTextureSource::GetHeight() const
+    {
+        return m_header.height;
+    }
+
+    uint32_t MappedTextureSource::GetMipLevels() const
+    {
+        return m_header.mipLevels;
+    }
+
+    bool MappedTextureSource::ReadMip(uint32_t level, std::vector<uint8_t>& out) const
+    {
+        if (level >= m_mipOffsets.size())
+        {
+            return false;
+        }
+        const uint8_t* data = m_file.GetData() + m_mipOffsets[level];
+        out.assign(data, data + GetMipSize(level));
+        return true;
+    }
+}
\ No newline at end of file
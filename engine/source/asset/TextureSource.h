@@ -0,0 +1,77 @@
+#pragma once
+#include "graphics/Texture.h"
+#include "io/MappedFile.h"
+#include <string>
+#include <vector>
+
+namespace eng
+{
+    // Provides mip levels of a texture on demand. ReadMip may be called from the streaming thread.
+    class TextureSource
+    {
+    public:
+        virtual ~TextureSource() = default;
+
+        virtual TextureFormat GetFormat() const = 0;
+        virtual uint32_t GetWidth() const = 0;
+        virtual uint32_t GetHeight() const = 0;
+        virtual uint32_t GetMipLevels() const = 0;
+        virtual bool ReadMip(uint32_t level, std::vector<uint8_t>& out) const = 0;
+
+        size_t GetMipSize(uint32_t level) const;
+    };
+
+    // Full mip chain kept in system memory, built on the CPU from level 0
+    class MemoryTextureSource : public TextureSource
+    {
+    public:
+        MemoryTextureSource(TextureFormat format, uint32_t width, uint32_t height, const void* pixels);
+
+        TextureFormat GetFormat() const override;
+        uint32_t GetWidth() const override;
+        uint32_t GetHeight() const override;
+        uint32_t GetMipLevels() const override;
+        bool ReadMip(uint32_t level, std::vector<uint8_t>& out) const override;
+
+    private:
+        TextureFormat m_format;
+        uint32_t m_width;
+        uint32_t m_height;
+        std::vector<std::vector<uint8_t>> m_mips;
+    };
+
+    // Cooked texture: TextureFileHeader followed by every mip level, largest first
+    constexpr uint32_t TextureFileMagic = 0x54584758; // "XGXT"
+    constexpr uint32_t TextureFileVersion = 1;
+
+    struct TextureFileHeader
+    {
+        uint32_t magic = TextureFileMagic;
+        uint32_t version = TextureFileVersion;
+        uint32_t format = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        uint32_t mipLevels = 0;
+    };
+
+    bool SaveTextureFile(const std::string& path, TextureFormat format, uint32_t width, uint32_t height,
+        const void* pixels);
+
+    // Maps a cooked texture; reading a level touches only that level's pages
+    class MappedTextureSource : public TextureSource
+    {
+    public:
+        bool Open(const std::string& path);
+
+        TextureFormat GetFormat() const override;
+        uint32_t GetWidth() const override;
+        uint32_t GetHeight() const override;
+        uint32_t GetMipLevels() const override;
+        bool ReadMip(uint32_t level, std::vector<uint8_t>& out) const override;
+
+    private:
+        MappedFile m_file;
+        TextureFileHeader m_header;
+        std::vector<size_t> m_mipOffsets;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,99 @@
+#include "coro/FramePool.h"
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+
+namespace eng
+{
+    namespace
+    {
+        constexpr size_t SizeClassCount = 7;
+        constexpr size_t SlabBytes = 64 * 1024;
+
+        static_assert(MinPooledFrameBytes << (SizeClassCount - 1) == MaxPooledFrameBytes,
+            "Size classes must cover the pooled range");
+
+        struct FreeFrame
+        {
+            FreeFrame* next;
+        };
+
+        // Slabs are only ever added, so frames stay valid whichever thread's list they end up on
+        struct SlabStore
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<unsigned char[]>> slabs;
+        };
+
+        SlabStore& GetSlabStore()
+        {
+            static SlabStore store;
+            return store;
+        }
+
+        thread_local FreeFrame* t_freeFrames[SizeClassCount] = {};
+
+        size_t GetSizeClass(size_t bytes)
+        {
+            size_t sizeClass = 0;
+            size_t classBytes = MinPooledFrameBytes;
+            while (classBytes < bytes)
+            {
+                classBytes <<= 1;
+                ++sizeClass;
+            }
+            return sizeClass;
+        }
+
+        void Refill(size_t sizeClass)
+        {
+            const size_t frameBytes = MinPooledFrameBytes << sizeClass;
+            unsigned char* slab = new unsigned char[SlabBytes];
+            {
+                SlabStore& store = GetSlabStore();
+                std::lock_guard<std::mutex> lock(store.mutex);
+                store.slabs.emplace_back(slab);
+            }
+
+            FreeFrame*& head = t_freeFrames[sizeClass];
+            for (size_t offset = SlabBytes; offset >= frameBytes; offset -= frameBytes)
+            {
+                FreeFrame* frame = reinterpret_cast<FreeFrame*>(slab + offset - frameBytes);
+                frame->next = head;
+                head = frame;
+            }
+        }
+    }
+
+    void* AllocateCoroutineFrame(size_t bytes)
+    {
+        if (bytes > MaxPooledFrameBytes)
+        {
+            return ::operator new(bytes);
+        }
+
+        const size_t sizeClass = GetSizeClass(bytes);
+        if (!t_freeFrames[sizeClass])
+        {
+            Refill(sizeClass);
+        }
+        FreeFrame* frame = t_freeFrames[sizeClass];
+        t_freeFrames[sizeClass] = frame->next;
+        return frame;
+    }
+
+    void FreeCoroutineFrame(void* frame, size_t bytes)
+    {
+        if (bytes > MaxPooledFrameBytes)
+        {
+            ::operator delete(frame);
+            return;
+        }
+
+        const size_t sizeClass = GetSizeClass(bytes);
+        FreeFrame* freeFrame = static_cast<FreeFrame*>(frame);
+        freeFrame->next = t_freeFrames[sizeClass];
+        t_freeFrames[sizeClass] = freeFrame;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,15 @@
+#pragma once
+#include <stddef.h>
+
+namespace eng
+{
+    // Coroutine frames up to MaxPooledFrameBytes come from per-thread free lists in power of two size classes,
+    // carved out of shared slabs that are kept for the lifetime of the process. A frame may be freed on
+    // another thread than the one that allocated it. Larger frames go to the heap.
+    constexpr size_t MinPooledFrameBytes = 64;
+    constexpr size_t MaxPooledFrameBytes = 4096;
+
+    void* AllocateCoroutineFrame(size_t bytes);
+    // bytes must match the allocation
+    void FreeCoroutineFrame(void* frame, size_t bytes);
+}
\ No newline at end of file
@@ -0,0 +1,146 @@
+#pragma once
+#include "coro/FramePool.h"
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+namespace eng
+{
+    template <typename T>
+    class Task;
+
+    namespace detail
+    {
+        struct TaskPromiseBase
+        {
+            struct FinalAwaiter
+            {
+                bool await_ready() const noexcept { return false; }
+
+                // Continues the awaiting task directly, a task nobody awaits stays suspended until its owner
+                // destroys it
+                template <typename Promise>
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept
+                {
+                    std::coroutine_handle<> continuation = handle.promise().continuation;
+                    return continuation ? continuation : std::noop_coroutine();
+                }
+
+                void await_resume() const noexcept {}
+            };
+
+            static void* operator new(size_t bytes) { return AllocateCoroutineFrame(bytes); }
+            static void operator delete(void* frame, size_t bytes) { FreeCoroutineFrame(frame, bytes); }
+
+            std::suspend_always initial_suspend() const noexcept { return {}; }
+            FinalAwaiter final_suspend() const noexcept { return {}; }
+            // The engine does not use exceptions, one escaping a task is a bug
+            void unhandled_exception() const noexcept { std::terminate(); }
+
+            std::coroutine_handle<> continuation;
+        };
+
+        template <typename T>
+        struct TaskPromise : TaskPromiseBase
+        {
+            Task<T> get_return_object();
+
+            template <typename Value>
+            void return_value(Value&& value)
+            {
+                result.emplace(std::forward<Value>(value));
+            }
+
+            std::optional<T> result;
+        };
+
+        template <>
+        struct TaskPromise<void> : TaskPromiseBase
+        {
+            Task<void> get_return_object();
+            void return_void() const noexcept {}
+        };
+    }
+
+    // A coroutine that starts when first awaited (or handed to TaskScheduler::Spawn) and resumes its awaiter
+    // when it returns. Owns its frame, destroying the task destroys a suspended coroutine along with it.
+    template <typename T = void>
+    class [[nodiscard]] Task
+    {
+    public:
+        using promise_type = detail::TaskPromise<T>;
+
+        Task() = default;
+        explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+        Task(const Task&) = delete;
+        Task& operator=(const Task&) = delete;
+        Task(Task&& other) noexcept : m_handle(std::exchange(other.m_handle, nullptr)) {}
+        Task& operator=(Task&& other) noexcept
+        {
+            if (this != &other)
+            {
+                Reset();
+                m_handle = std::exchange(other.m_handle, nullptr);
+            }
+            return *this;
+        }
+        ~Task() { Reset(); }
+
+        bool IsValid() const { return static_cast<bool>(m_handle); }
+        bool IsDone() const { return !m_handle || m_handle.done(); }
+        std::coroutine_handle<promise_type> GetHandle() const { return m_handle; }
+
+        void Reset()
+        {
+            if (m_handle)
+            {
+                m_handle.destroy();
+                m_handle = nullptr;
+            }
+        }
+
+        auto operator co_await() const noexcept
+        {
+            struct Awaiter
+            {
+                std::coroutine_handle<promise_type> handle;
+
+                bool await_ready() const noexcept { return !handle || handle.done(); }
+
+                std::coroutine_handle<> await_suspend(std::coroutine_handle<> awaiting) const noexcept
+                {
+                    handle.promise().continuation = awaiting;
+                    return handle;
+                }
+
+                T await_resume() const
+                {
+                    if constexpr (!std::is_void_v<T>)
+                    {
+                        return std::move(*handle.promise().result);
+                    }
+                }
+            };
+            return Awaiter{ m_handle };
+        }
+
+    private:
+        std::coroutine_handle<promise_type> m_handle;
+    };
+
+    namespace detail
+    {
+        template <typename T>
+        Task<T> TaskPromise<T>::get_return_object()
+        {
+            return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+        }
+
+        inline Task<void> TaskPromise<void>::get_return_object()
+        {
+            return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,177 @@
+#include "coro/TaskScheduler.h"
+#include "profile/Profiler.h"
+#include <algorithm>
+
+namespace eng
+{
+    namespace
+    {
+        // Min-heap on expiry time
+        struct TimerLater
+        {
+            template <typename Timer>
+            bool operator()(const Timer& a, const Timer& b) const
+            {
+                return a.time != b.time ? a.time > b.time : a.order > b.order;
+            }
+        };
+    }
+
+    TaskScheduler::~TaskScheduler()
+    {
+        Shutdown();
+    }
+
+    void TaskScheduler::Init(JobSystem* jobSystem)
+    {
+        m_jobSystem = jobSystem;
+    }
+
+    void TaskScheduler::Shutdown()
+    {
+        // Jobs started by RunJob reference their suspended frames
+        for (const CounterWait& wait : m_counterWaits)
+        {
+            if (m_jobSystem)
+            {
+                m_jobSystem->Wait(*wait.counter);
+            }
+        }
+        m_nextFrame.clear();
+        m_resuming.clear();
+        m_timers.clear();
+        m_counterWaits.clear();
+        m_readyCounterWaits.clear();
+        m_tasks.clear();
+    }
+
+    void TaskScheduler::Spawn(Task<void> task)
+    {
+        if (!task.IsValid())
+        {
+            return;
+        }
+        task.GetHandle().resume();
+        if (!task.IsDone())
+        {
+            m_tasks.push_back(std::move(task));
+        }
+    }
+
+    void TaskScheduler::Update(float deltaTime)
+    {
+        ENG_PROFILE_SCOPE("TaskScheduler::Update");
+        m_time += deltaTime;
+        ++m_frame;
+
+        // Swapped out first, so a task awaiting the next frame again waits for the next Update
+        m_resuming.swap(m_nextFrame);
+        for (std::coroutine_handle<> handle : m_resuming)
+        {
+            handle.resume();
+        }
+        m_resuming.clear();
+
+        while (!m_timers.empty() && m_timers.front().time <= m_time)
+        {
+            std::pop_heap(m_timers.begin(), m_timers.end(), TimerLater());
+            std::coroutine_handle<> handle = m_timers.back().handle;
+            m_timers.pop_back();
+            handle.resume();
+        }
+
+        for (size_t i = 0; i < m_counterWaits.size();)
+        {
+            if (m_counterWaits[i].counter->IsDone())
+            {
+                m_readyCounterWaits.push_back(m_counterWaits[i]);
+                m_counterWaits[i] = m_counterWaits.back();
+                m_counterWaits.pop_back();
+            }
+            else
+            {
+                ++i;
+            }
+        }
+        for (const CounterWait& wait : m_readyCounterWaits)
+        {
+            // Returns at once for a finished counter, see CounterAwaiter
+            if (m_jobSystem)
+            {
+                m_jobSystem->Wait(*wait.counter);
+            }
+            wait.handle.resume();
+        }
+        m_readyCounterWaits.clear();
+
+        ReapFinishedTasks();
+    }
+
+    size_t TaskScheduler::GetTaskCount() const
+    {
+        return m_tasks.size();
+    }
+
+    double TaskScheduler::GetTime() const
+    {
+        return m_time;
+    }
+
+    uint64_t TaskScheduler::GetFrame() const
+    {
+        return m_frame;
+    }
+
+    bool TaskScheduler::HasReadyTasks() const
+    {
+        if (!m_nextFrame.empty())
+        {
+            return true;
+        }
+        for (const CounterWait& wait : m_counterWaits)
+        {
+            if (wait.counter->IsDone())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool TaskScheduler::HasPendingJobs() const
+    {
+        return !m_counterWaits.empty();
+    }
+
+    bool TaskScheduler::GetTimeUntilNextTimer(double& seconds) const
+    {
+        if (m_timers.empty())
+        {
+            return false;
+        }
+        seconds = m_timers.front().time - m_time;
+        return true;
+    }
+
+    void TaskScheduler::AddTimer(float seconds, std::coroutine_handle<> handle)
+    {
+        m_timers.push_back({ m_time + seconds, m_timerOrder++, handle });
+        std::push_heap(m_timers.begin(), m_timers.end(), TimerLater());
+    }
+
+    void TaskScheduler::ReapFinishedTasks()
+    {
+        for (size_t i = 0; i < m_tasks.size();)
+        {
+            if (m_tasks[i].IsDone())
+            {
+                m_tasks[i] = std::move(m_tasks.back());
+                m_tasks.pop_back();
+            }
+            else
+            {
+                ++i;
+            }
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,158 @@
+#pragma once
+#include "coro/Task.h"
+#include "jobs/JobSystem.h"
+#include <stdint.h>
+#include <coroutine>
+#include <utility>
+#include <vector>
+
+namespace eng
+{
+    // Runs spawned tasks on the thread that calls Update, once per frame in the simulate stage: the main thread,
+    // or a job worker with frame pipelining. Tasks suspend on the awaitables below and Update resumes the ones that
+    // are ready. Not thread-safe: use it from one thread at a time, from the simulate stage while a frame runs.
+    class TaskScheduler
+    {
+    public:
+        TaskScheduler() = default;
+        TaskScheduler(const TaskScheduler&) = delete;
+        TaskScheduler& operator=(const TaskScheduler&) = delete;
+        ~TaskScheduler();
+
+        // Without a job system RunJob runs the function inline
+        void Init(JobSystem* jobSystem);
+        // Destroys the tasks that are still suspended
+        void Shutdown();
+
+        // Starts the task right away, it runs until its first suspension
+        void Spawn(Task<void> task);
+        void Update(float deltaTime);
+
+        size_t GetTaskCount() const;
+        // Seconds accumulated through Update
+        double GetTime() const;
+        uint64_t GetFrame() const;
+        // Whether a task waits for the next frame or for a job that already finished
+        bool HasReadyTasks() const;
+        // Whether a task waits for a job at all, finished or not
+        bool HasPendingJobs() const;
+        // Frame time left until the earliest timer expires, false without timers
+        bool GetTimeUntilNextTimer(double& seconds) const;
+
+        struct NextFrameAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+            void await_suspend(std::coroutine_handle<> handle) { scheduler.m_nextFrame.push_back(handle); }
+            void await_resume() const noexcept {}
+
+            TaskScheduler& scheduler;
+        };
+
+        struct DelayAwaiter
+        {
+            bool await_ready() const noexcept { return seconds <= 0.0f; }
+            void await_suspend(std::coroutine_handle<> handle) { scheduler.AddTimer(seconds, handle); }
+            void await_resume() const noexcept {}
+
+            TaskScheduler& scheduler;
+            float seconds;
+        };
+
+        struct CounterAwaiter
+        {
+            bool await_ready() const
+            {
+                if (!counter.IsDone())
+                {
+                    return false;
+                }
+                // The job that finished the counter may still hold it, the awaiting task is free to destroy
+                // it once this returns
+                if (scheduler.m_jobSystem)
+                {
+                    scheduler.m_jobSystem->Wait(counter);
+                }
+                return true;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                scheduler.m_counterWaits.push_back({ &counter, handle });
+            }
+            void await_resume() const noexcept {}
+
+            TaskScheduler& scheduler;
+            JobCounter& counter;
+        };
+
+        template <typename Func>
+        struct JobAwaiter
+        {
+            bool await_ready()
+            {
+                if (scheduler.m_jobSystem)
+                {
+                    return false;
+                }
+                function();
+                return true;
+            }
+
+            void await_suspend(std::coroutine_handle<> handle)
+            {
+                // The awaiter lives in the suspended frame, so the job only needs a pointer to it
+                scheduler.m_jobSystem->RunOnFiber([this]() { function(); }, &counter);
+                scheduler.m_counterWaits.push_back({ &counter, handle });
+            }
+
+            void await_resume() const noexcept {}
+
+            TaskScheduler& scheduler;
+            Func function;
+            JobCounter counter;
+        };
+
+        // Resumes on the next Update
+        NextFrameAwaiter NextFrame() { return { *this }; }
+        // Resumes on the first Update at least seconds of frame time later
+        DelayAwaiter Delay(float seconds) { return { *this, seconds }; }
+        // Resumes on the first Update after the counter reached zero
+        CounterAwaiter WaitFor(JobCounter& counter) { return { *this, counter }; }
+        // Runs func on the job system (on a fiber, so it may wait itself) and resumes on the first Update after
+        // it finished
+        template <typename Func>
+        JobAwaiter<std::decay_t<Func>> RunJob(Func&& func)
+        {
+            return { *this, std::forward<Func>(func), {} };
+        }
+
+    private:
+        struct Timer
+        {
+            double time;
+            // Keeps timers that expire together in the order they were started
+            uint64_t order;
+            std::coroutine_handle<> handle;
+        };
+
+        struct CounterWait
+        {
+            JobCounter* counter;
+            std::coroutine_handle<> handle;
+        };
+
+        void AddTimer(float seconds, std::coroutine_handle<> handle);
+        void ReapFinishedTasks();
+
+        JobSystem* m_jobSystem = nullptr;
+        std::vector<Task<void>> m_tasks;
+        std::vector<std::coroutine_handle<>> m_nextFrame;
+        std::vector<std::coroutine_handle<>> m_resuming;
+        std::vector<Timer> m_timers;
+        std::vector<CounterWait> m_counterWaits;
+        std::vector<CounterWait> m_readyCounterWaits;
+        double m_time = 0.0;
+        uint64_t m_frame = 0;
+        uint64_t m_timerOrder = 0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "ecs/Archetype.h"
+#include <algorithm>
+
+namespace eng
+{
+    namespace
+    {
+        // Chunks are cache line aligned so columns with alignment up to 64 can be placed by offset alone
+        constexpr size_t ChunkAlignment = 64;
+
+        size_t AlignUp(size_t value, size_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+    }
+
+    Archetype::Archetype(ComponentMask mask) : m_mask(mask)
+    {
+        std::fill(std::begin(m_columnOfType), std::end(m_columnOfType), int8_t(-1));
+        size_t rowBytes = sizeof(Entity);
+        for (ComponentTypeId type = 0; type < MaxComponentTypes; ++type)
+        {
+            if (mask & (ComponentMask(1) << type))
+            {
+                m_columnOfType[type] = static_cast<int8_t>(m_columns.size());
+                m_columns.push_back({ type, GetComponentInfo(type), 0 });
+                rowBytes += m_columns.back().info.size;
+            }
+        }
+
+        // Start from the unpadded estimate and shrink until the aligned layout fits. A row larger than a
+        // chunk gets a chunk of its own.
+        auto layoutBytes = [this](size_t capacity)
+        {
+            size_t offset = sizeof(Entity) * capacity;
+            for (Column& column : m_columns)
+            {
+                offset = AlignUp(offset, std::max<size_t>(column.info.alignment, 1));
+                column.offset = offset;
+                offset += column.info.size * capacity;
+            }
+            return offset;
+        };
+        m_chunkCapacity = std::max<size_t>(ChunkBytes / rowBytes, 1);
+        while (m_chunkCapacity > 1 && layoutBytes(m_chunkCapacity) > ChunkBytes)
+        {
+            --m_chunkCapacity;
+        }
+        m_chunkBytes = AlignUp(std::max(layoutBytes(m_chunkCapacity), ChunkBytes), ChunkAlignment);
+    }
+
+    Archetype::~Archetype()
+    {
+        for (uint32_t row = 0; row < m_count; ++row)
+        {
+            const RowAddress address = GetRowAddress(row);
+            for (size_t column = 0; column < m_columns.size(); ++column)
+            {
+                DestroyComponent(m_columns[column].info, GetComponent(address, static_cast<int>(column)));
+            }
+        }
+        for (uint8_t* chunk : m_chunks)
+        {
+            ::operator delete(chunk, std::align_val_t(ChunkAlignment));
+        }
+    }
+
+    uint32_t Archetype::AddRow(Entity entity)
+    {
+        const size_t chunk = m_count / m_chunkCapacity;
+        if (chunk == m_chunks.size())
+        {
+            m_chunks.push_back(static_cast<uint8_t*>(::operator new(m_chunkBytes, std::align_val_t(ChunkAlignment))));
+        }
+        const uint32_t row = static_cast<uint32_t>(m_count++);
+        GetEntities(chunk)[row % m_chunkCapacity] = entity;
+        return row;
+    }
+
+    Entity Archetype::RemoveRow(uint32_t row, bool destroyComponents)
+    {
+        const uint32_t last = static_cast<uint32_t>(m_count - 1);
+        const RowAddress address = GetRowAddress(row);
+        if (destroyComponents)
+        {
+            for (size_t column = 0; column < m_columns.size(); ++column)
+            {
+                DestroyComponent(m_columns[column].info, GetComponent(address, static_cast<int>(column)));
+            }
+        }
+
+        Entity moved = NullEntity;
+        if (row != last)
+        {
+            const RowAddress lastAddress = GetRowAddress(last);
+            for (size_t column = 0; column < m_columns.size(); ++column)
+            {
+                const ComponentInfo& info = m_columns[column].info;
+                void* lastValue = GetComponent(lastAddress, static_cast<int>(column));
+                MoveComponent(info, GetComponent(address, static_cast<int>(column)), lastValue);
+                DestroyComponent(info, lastValue);
+            }
+            moved = reinterpret_cast<Entity*>(lastAddress.chunk)[lastAddress.index];
+            reinterpret_cast<Entity*>(address.chunk)[address.index] = moved;
+        }
+        --m_count;
+        return moved;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,95 @@
+#pragma once
+#include "ecs/Component.h"
+#include "ecs/Entity.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace eng
+{
+    // All entities with exactly one set of component types. Rows are packed into fixed size chunks, each
+    // holding the entity handles followed by one array per component, so a system touching two components
+    // streams two contiguous arrays. Rows stay dense: removing one moves the last row into the hole.
+    class Archetype
+    {
+    public:
+        static constexpr size_t ChunkBytes = 16 * 1024;
+
+        explicit Archetype(ComponentMask mask);
+        ~Archetype();
+        Archetype(const Archetype&) = delete;
+        Archetype& operator=(const Archetype&) = delete;
+
+        ComponentMask GetMask() const { return m_mask; }
+        size_t GetCount() const { return m_count; }
+
+        // -1 when the type is not part of this archetype
+        int GetColumn(ComponentTypeId type) const { return m_columnOfType[type]; }
+        size_t GetColumnCount() const { return m_columns.size(); }
+        ComponentTypeId GetColumnType(int column) const { return m_columns[column].type; }
+
+        size_t GetChunkCapacity() const { return m_chunkCapacity; }
+        size_t GetChunkCount() const { return (m_count + m_chunkCapacity - 1) / m_chunkCapacity; }
+        size_t GetChunkSize(size_t chunk) const
+        {
+            const size_t remaining = m_count - chunk * m_chunkCapacity;
+            return remaining < m_chunkCapacity ? remaining : m_chunkCapacity;
+        }
+        Entity* GetEntities(size_t chunk) { return reinterpret_cast<Entity*>(m_chunks[chunk]); }
+        void* GetColumnData(size_t chunk, int column) { return m_chunks[chunk] + m_columns[column].offset; }
+
+        // Chunk and slot of a row, resolved once by callers touching several of its components
+        struct RowAddress
+        {
+            uint8_t* chunk;
+            size_t index;
+        };
+        RowAddress GetRowAddress(uint32_t row) const
+        {
+            return { m_chunks[row / m_chunkCapacity], row % m_chunkCapacity };
+        }
+        void* GetComponent(const RowAddress& address, int column) const
+        {
+            const Column& info = m_columns[column];
+            return address.chunk + info.offset + info.info.size * address.index;
+        }
+        void* GetComponent(uint32_t row, int column) const { return GetComponent(GetRowAddress(row), column); }
+        Entity GetEntity(uint32_t row) const
+        {
+            const RowAddress address = GetRowAddress(row);
+            return reinterpret_cast<const Entity*>(address.chunk)[address.index];
+        }
+
+        // Appends a row for the entity with its components left unconstructed
+        uint32_t AddRow(Entity entity);
+        // Fills the hole with the last row and returns the entity that now lives at row, NullEntity when
+        // the removed row was the last. Components are destroyed first unless the caller moved them out.
+        Entity RemoveRow(uint32_t row, bool destroyComponents);
+
+        // Cached neighbours one component away, filled in by the world on first use
+        Archetype* GetAddEdge(ComponentTypeId type) const { return m_addEdges[type]; }
+        Archetype* GetRemoveEdge(ComponentTypeId type) const { return m_removeEdges[type]; }
+        void SetAddEdge(ComponentTypeId type, Archetype* archetype) { m_addEdges[type] = archetype; }
+        void SetRemoveEdge(ComponentTypeId type, Archetype* archetype) { m_removeEdges[type] = archetype; }
+
+    private:
+        struct Column
+        {
+            ComponentTypeId type;
+            ComponentInfo info;
+            size_t offset;
+        };
+
+        ComponentMask m_mask = 0;
+        std::vector<Column> m_columns;
+        int8_t m_columnOfType[MaxComponentTypes];
+        Archetype* m_addEdges[MaxComponentTypes] = {};
+        Archetype* m_removeEdges[MaxComponentTypes] = {};
+
+        // Chunks past the used ones are kept for reuse, add/remove churn does not hit the allocator
+        std::vector<uint8_t*> m_chunks;
+        size_t m_chunkCapacity = 0;
+        size_t m_chunkBytes = ChunkBytes;
+        size_t m_count = 0;
+    };
+}
\ No newline at end of file
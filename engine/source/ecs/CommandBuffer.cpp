@@ -0,0 +1,113 @@
+#include "ecs/CommandBuffer.h"
+#include "ecs/World.h"
+#include <algorithm>
+
+namespace eng
+{
+    namespace
+    {
+        constexpr size_t BlockAlignment = 64;
+    }
+
+    CommandBuffer::~CommandBuffer()
+    {
+        Clear();
+        for (const Block& block : m_blocks)
+        {
+            ::operator delete(block.data, std::align_val_t(BlockAlignment));
+        }
+    }
+
+    Entity CommandBuffer::CreateEntity()
+    {
+        Entity placeholder = { m_pendingCount++, PendingGeneration };
+        Push(CommandType::Create, placeholder);
+        return placeholder;
+    }
+
+    void CommandBuffer::DestroyEntity(Entity entity)
+    {
+        Push(CommandType::Destroy, entity);
+    }
+
+    void CommandBuffer::Playback(World& world)
+    {
+        m_created.assign(m_pendingCount, NullEntity);
+        for (const Command& command : m_commands)
+        {
+            Entity entity = command.entity;
+            if (entity.generation == PendingGeneration)
+            {
+                entity = command.type == CommandType::Create ? world.CreateEntity() : m_created[entity.index];
+            }
+
+            switch (command.type)
+            {
+            case CommandType::Create:
+                m_created[command.entity.index] = entity;
+                break;
+            case CommandType::Destroy:
+                world.DestroyEntity(entity);
+                break;
+            case CommandType::Add:
+                world.AddComponent(entity, command.component, command.value);
+                break;
+            case CommandType::Remove:
+                world.RemoveComponent(entity, command.component);
+                break;
+            }
+        }
+        Clear();
+    }
+
+    void CommandBuffer::Clear()
+    {
+        // Played back values were moved from, unplayed ones still own resources; both need destroying
+        for (const Command& command : m_commands)
+        {
+            if (command.type == CommandType::Add)
+            {
+                DestroyComponent(GetComponentInfo(command.component), command.value);
+            }
+        }
+        m_commands.clear();
+        m_block = 0;
+        m_blockOffset = 0;
+        m_pendingCount = 0;
+    }
+
+    void* CommandBuffer::Allocate(size_t size, size_t alignment)
+    {
+        size = std::max<size_t>(size, 1);
+        while (true)
+        {
+            if (m_block < m_blocks.size())
+            {
+                const size_t offset = (m_blockOffset + alignment - 1) & ~(alignment - 1);
+                if (offset + size <= m_blocks[m_block].size)
+                {
+                    m_blockOffset = offset + size;
+                    return m_blocks[m_block].data + offset;
+                }
+                if (m_blockOffset > 0 || size <= m_blocks[m_block].size)
+                {
+                    ++m_block;
+                    m_blockOffset = 0;
+                    continue;
+                }
+            }
+
+            // Out of blocks, or a value bigger than the next spare one: give it a block that fits
+            const size_t blockSize = std::max(BlockBytes, size);
+            Block block = { static_cast<uint8_t*>(::operator new(blockSize, std::align_val_t(BlockAlignment))),
+                blockSize };
+            m_blocks.insert(m_blocks.begin() + m_block, block);
+            m_blockOffset = 0;
+        }
+    }
+
+    void CommandBuffer::Push(CommandType type, Entity entity, ComponentTypeId component, void* value)
+    {
+        m_commands.push_back({ type, component, entity, value });
+    }
+}
\ No newline at end of file
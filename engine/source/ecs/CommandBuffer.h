@@ -0,0 +1,88 @@
+#pragma once
+#include "ecs/Component.h"
+#include "ecs/Entity.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace eng
+{
+    class World;
+
+    // Structural changes recorded while queries iterate and applied in order by Playback. Component values
+    // live in an arena owned by the buffer until then, so recording does not allocate once it has warmed
+    // up. Use one buffer per thread.
+    class CommandBuffer
+    {
+    public:
+        CommandBuffer() = default;
+        ~CommandBuffer();
+        CommandBuffer(const CommandBuffer&) = delete;
+        CommandBuffer& operator=(const CommandBuffer&) = delete;
+
+        // A placeholder that later commands of this buffer can target, it becomes a real entity on Playback
+        Entity CreateEntity();
+        void DestroyEntity(Entity entity);
+        template <typename T>
+        void AddComponent(Entity entity, T&& value);
+        template <typename T>
+        void RemoveComponent(Entity entity);
+
+        // Commands on entities that died before their turn are skipped. Leaves the buffer empty.
+        void Playback(World& world);
+        void Clear();
+        bool IsEmpty() const { return m_commands.empty(); }
+
+    private:
+        enum class CommandType : uint8_t
+        {
+            Create,
+            Destroy,
+            Add,
+            Remove
+        };
+
+        struct Command
+        {
+            CommandType type;
+            ComponentTypeId component;
+            Entity entity;
+            void* value;
+        };
+
+        struct Block
+        {
+            uint8_t* data;
+            size_t size;
+        };
+
+        static constexpr size_t BlockBytes = 16 * 1024;
+        // Placeholders carry this generation, which a live entity never reaches in practice
+        static constexpr uint32_t PendingGeneration = ~0u;
+
+        void* Allocate(size_t size, size_t alignment);
+        void Push(CommandType type, Entity entity, ComponentTypeId component = 0, void* value = nullptr);
+
+        std::vector<Command> m_commands;
+        std::vector<Block> m_blocks;
+        size_t m_block = 0;
+        size_t m_blockOffset = 0;
+        uint32_t m_pendingCount = 0;
+        std::vector<Entity> m_created;
+    };
+
+    template <typename T>
+    void CommandBuffer::AddComponent(Entity entity, T&& value)
+    {
+        using Type = std::decay_t<T>;
+        void* storage = Allocate(sizeof(Type), alignof(Type));
+        new (storage) Type(std::forward<T>(value));
+        Push(CommandType::Add, entity, GetComponentType<Type>(), storage);
+    }
+
+    template <typename T>
+    void CommandBuffer::RemoveComponent(Entity entity)
+    {
+        Push(CommandType::Remove, entity, GetComponentType<T>());
+    }
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#include "ecs/Component.h"
+#include <cstdlib>
+#include <iostream>
+#include <mutex>
+
+namespace eng
+{
+    namespace
+    {
+        // A fixed array so references returned by GetComponentInfo stay valid while other types register
+        ComponentInfo g_componentInfos[MaxComponentTypes];
+        ComponentTypeId g_componentTypeCount = 0;
+        std::mutex g_componentTypeMutex;
+    }
+
+    ComponentTypeId RegisterComponentType(const ComponentInfo& info)
+    {
+        std::lock_guard<std::mutex> lock(g_componentTypeMutex);
+        if (g_componentTypeCount == MaxComponentTypes)
+        {
+            std::cerr << "ERROR: more than " << MaxComponentTypes << " component types registered" << std::endl;
+            std::abort();
+        }
+        g_componentInfos[g_componentTypeCount] = info;
+        return g_componentTypeCount++;
+    }
+
+    const ComponentInfo& GetComponentInfo(ComponentTypeId type)
+    {
+        return g_componentInfos[type];
+    }
+}
\ No newline at end of file
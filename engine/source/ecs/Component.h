@@ -0,0 +1,86 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+namespace eng
+{
+    using ComponentTypeId = uint32_t;
+    // One bit per component type, which is what limits a world to 64 types
+    using ComponentMask = uint64_t;
+    static constexpr ComponentTypeId MaxComponentTypes = 64;
+
+    // How storage moves and destroys values of a type it only knows by id. Trivially copyable types leave
+    // the functions null and are moved with memcpy. Empty types are tags: they take part in masks but have
+    // no storage.
+    struct ComponentInfo
+    {
+        size_t size = 0;
+        size_t alignment = 1;
+        void (*moveConstruct)(void* destination, void* source) = nullptr;
+        void (*destroy)(void* value) = nullptr;
+    };
+
+    ComponentTypeId RegisterComponentType(const ComponentInfo& info);
+    const ComponentInfo& GetComponentInfo(ComponentTypeId type);
+
+    template <typename T>
+    ComponentInfo MakeComponentInfo()
+    {
+        static_assert(std::is_move_constructible<T>::value, "Components must be move constructible");
+        ComponentInfo info;
+        info.size = std::is_empty<T>::value ? 0 : sizeof(T);
+        info.alignment = alignof(T);
+        if (!std::is_trivially_copyable<T>::value)
+        {
+            info.moveConstruct = [](void* destination, void* source)
+            {
+                new (destination) T(std::move(*static_cast<T*>(source)));
+            };
+            info.destroy = [](void* value)
+            {
+                static_cast<T*>(value)->~T();
+            };
+        }
+        return info;
+    }
+
+    // Ids are handed out on first use, so they differ between runs and must not be serialized
+    template <typename T>
+    ComponentTypeId GetComponentType()
+    {
+        static const ComponentTypeId type = RegisterComponentType(MakeComponentInfo<T>());
+        return type;
+    }
+
+    template <typename... Ts>
+    ComponentMask ComponentMaskOf()
+    {
+        ComponentMask mask = 0;
+        ((mask |= ComponentMask(1) << GetComponentType<Ts>()), ...);
+        return mask;
+    }
+
+    inline void MoveComponent(const ComponentInfo& info, void* destination, void* source)
+    {
+        if (info.moveConstruct)
+        {
+            info.moveConstruct(destination, source);
+        }
+        else if (info.size > 0)
+        {
+            memcpy(destination, source, info.size);
+        }
+    }
+
+    inline void DestroyComponent(const ComponentInfo& info, void* value)
+    {
+        if (info.destroy)
+        {
+            info.destroy(value);
+        }
+    }
+}
\ No newline at end of file
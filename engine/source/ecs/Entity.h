@@ -0,0 +1,19 @@
+#pragma once
+#include <stdint.h>
+
+namespace eng
+{
+    // Index into the world's entity table plus the generation it had when handed out, so a handle to a
+    // destroyed entity never resolves to the one reusing its index
+    struct Entity
+    {
+        uint32_t index = ~0u;
+        uint32_t generation = 0;
+
+        bool IsNull() const { return index == ~0u; }
+        bool operator==(const Entity& other) const { return index == other.index && generation == other.generation; }
+        bool operator!=(const Entity& other) const { return !(*this == other); }
+    };
+
+    static constexpr Entity NullEntity = {};
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#include "ecs/Query.h"
+#include "ecs/World.h"
+#include <iostream>
+
+namespace eng
+{
+    Query::Query(World& world, ComponentMask required, ComponentMask excluded)
+        : m_world(world), m_required(required), m_excluded(excluded)
+    {
+    }
+
+    size_t Query::GetEntityCount() const
+    {
+        size_t count = 0;
+        for (const Archetype* archetype : m_archetypes)
+        {
+            count += archetype->GetCount();
+        }
+        return count;
+    }
+
+    bool Query::Matches(ComponentMask mask) const
+    {
+        return (mask & m_required) == m_required && (mask & m_excluded) == 0;
+    }
+
+    bool Query::BeginIteration(ComponentMask components)
+    {
+        if ((components & m_required) != components)
+        {
+            std::cerr << "ERROR: query iterates components it does not require" << std::endl;
+            return false;
+        }
+        ++m_world.m_iterationDepth;
+        return true;
+    }
+
+    void Query::EndIteration()
+    {
+        --m_world.m_iterationDepth;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,89 @@
+#pragma once
+#include "ecs/Archetype.h"
+#include <array>
+#include <utility>
+#include <vector>
+
+namespace eng
+{
+    class World;
+
+    // Entities having every component in one mask and none in another. The matching archetypes are found
+    // once and kept up to date by the world as new archetypes appear, so iterating costs nothing per
+    // archetype that does not match.
+    class Query
+    {
+    public:
+        ComponentMask GetRequired() const { return m_required; }
+        ComponentMask GetExcluded() const { return m_excluded; }
+        const std::vector<Archetype*>& GetArchetypes() const { return m_archetypes; }
+        size_t GetEntityCount() const;
+
+        // func(size_t count, const Entity* entities, Ts*... components) once per chunk: the contiguous
+        // arrays a vectorized loop wants. Every T has to be one of the required components.
+        template <typename... Ts, typename Func>
+        void ForEachChunk(Func&& func);
+
+        // func(Ts&... components) once per entity
+        template <typename... Ts, typename Func>
+        void ForEach(Func&& func);
+
+    private:
+        friend class World;
+
+        Query(World& world, ComponentMask required, ComponentMask excluded);
+        bool Matches(ComponentMask mask) const;
+        // Structural changes are refused while an iteration is running
+        bool BeginIteration(ComponentMask components);
+        void EndIteration();
+
+        template <typename... Ts, typename Func, size_t... Indices>
+        static void CallChunk(Func& func, Archetype* archetype, size_t chunk,
+            const std::array<int, sizeof...(Ts)>& columns, std::index_sequence<Indices...>)
+        {
+            func(archetype->GetChunkSize(chunk), static_cast<const Entity*>(archetype->GetEntities(chunk)),
+                static_cast<Ts*>(archetype->GetColumnData(chunk, columns[Indices]))...);
+        }
+
+        World& m_world;
+        ComponentMask m_required = 0;
+        ComponentMask m_excluded = 0;
+        std::vector<Archetype*> m_archetypes;
+    };
+
+    template <typename... Ts, typename Func>
+    void Query::ForEachChunk(Func&& func)
+    {
+        static_assert((!std::is_empty<Ts>::value && ...), "Tags have no storage to iterate, require them instead");
+        if (!BeginIteration(ComponentMaskOf<Ts...>()))
+        {
+            return;
+        }
+        for (Archetype* archetype : m_archetypes)
+        {
+            if (archetype->GetCount() == 0)
+            {
+                continue;
+            }
+            const std::array<int, sizeof...(Ts)> columns = { archetype->GetColumn(GetComponentType<Ts>())... };
+            const size_t chunkCount = archetype->GetChunkCount();
+            for (size_t chunk = 0; chunk < chunkCount; ++chunk)
+            {
+                CallChunk<Ts...>(func, archetype, chunk, columns, std::index_sequence_for<Ts...>());
+            }
+        }
+        EndIteration();
+    }
+
+    template <typename... Ts, typename Func>
+    void Query::ForEach(Func&& func)
+    {
+        ForEachChunk<Ts...>([&func](size_t count, const Entity*, Ts*... components)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                func(components[i]...);
+            }
+        });
+    }
+}
\ No newline at end of file
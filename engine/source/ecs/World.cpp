@@ -0,0 +1,227 @@
+#include "ecs/World.h"
+#include <iostream>
+
+namespace eng
+{
+    World::World()
+    {
+        m_emptyArchetype = GetArchetype(0);
+    }
+
+    World::~World() = default;
+
+    Entity World::CreateEntity()
+    {
+        if (!CanChangeStructure())
+        {
+            return NullEntity;
+        }
+        uint32_t row = 0;
+        return CreateEntity(m_emptyArchetype, row);
+    }
+
+    Entity World::CreateEntity(Archetype* archetype, uint32_t& row)
+    {
+        uint32_t index = 0;
+        if (!m_freeEntities.empty())
+        {
+            index = m_freeEntities.back();
+            m_freeEntities.pop_back();
+        }
+        else
+        {
+            index = static_cast<uint32_t>(m_entities.size());
+            m_entities.emplace_back();
+        }
+
+        EntityRecord& record = m_entities[index];
+        Entity entity = { index, record.generation };
+        row = archetype->AddRow(entity);
+        record.archetype = archetype;
+        record.row = row;
+        ++m_entityCount;
+        return entity;
+    }
+
+    bool World::DestroyEntity(Entity entity)
+    {
+        if (!CanChangeStructure() || !IsAlive(entity))
+        {
+            return false;
+        }
+
+        EntityRecord& record = m_entities[entity.index];
+        Entity moved = record.archetype->RemoveRow(record.row, true);
+        if (!moved.IsNull())
+        {
+            m_entities[moved.index].row = record.row;
+        }
+        record.archetype = nullptr;
+        ++record.generation;
+        m_freeEntities.push_back(entity.index);
+        --m_entityCount;
+        return true;
+    }
+
+    bool World::IsAlive(Entity entity) const
+    {
+        return entity.index < m_entities.size() && m_entities[entity.index].archetype != nullptr
+            && m_entities[entity.index].generation == entity.generation;
+    }
+
+    bool World::AddComponent(Entity entity, ComponentTypeId type, void* value)
+    {
+        if (!CanChangeStructure() || !IsAlive(entity))
+        {
+            return false;
+        }
+
+        EntityRecord& record = m_entities[entity.index];
+        const ComponentInfo& info = GetComponentInfo(type);
+        int column = record.archetype->GetColumn(type);
+        if (column >= 0)
+        {
+            void* existing = record.archetype->GetComponent(record.row, column);
+            DestroyComponent(info, existing);
+            MoveComponent(info, existing, value);
+            return true;
+        }
+
+        Archetype* target = record.archetype->GetAddEdge(type);
+        if (!target)
+        {
+            target = GetArchetype(record.archetype->GetMask() | (ComponentMask(1) << type));
+            record.archetype->SetAddEdge(type, target);
+            target->SetRemoveEdge(type, record.archetype);
+        }
+        MoveEntity(entity, target);
+        MoveComponent(info, target->GetComponent(record.row, target->GetColumn(type)), value);
+        return true;
+    }
+
+    bool World::RemoveComponent(Entity entity, ComponentTypeId type)
+    {
+        if (!CanChangeStructure() || !IsAlive(entity))
+        {
+            return false;
+        }
+
+        EntityRecord& record = m_entities[entity.index];
+        if (record.archetype->GetColumn(type) < 0)
+        {
+            return false;
+        }
+
+        Archetype* target = record.archetype->GetRemoveEdge(type);
+        if (!target)
+        {
+            target = GetArchetype(record.archetype->GetMask() & ~(ComponentMask(1) << type));
+            record.archetype->SetRemoveEdge(type, target);
+            target->SetAddEdge(type, record.archetype);
+        }
+        MoveEntity(entity, target);
+        return true;
+    }
+
+    void* World::GetComponent(Entity entity, ComponentTypeId type)
+    {
+        if (!IsAlive(entity))
+        {
+            return nullptr;
+        }
+        const EntityRecord& record = m_entities[entity.index];
+        int column = record.archetype->GetColumn(type);
+        return column >= 0 ? record.archetype->GetComponent(record.row, column) : nullptr;
+    }
+
+    bool World::HasComponent(Entity entity, ComponentTypeId type) const
+    {
+        return IsAlive(entity) && (m_entities[entity.index].archetype->GetMask() & (ComponentMask(1) << type)) != 0;
+    }
+
+    Query& World::CreateQuery(ComponentMask required, ComponentMask excluded)
+    {
+        m_queries.push_back(std::unique_ptr<Query>(new Query(*this, required, excluded)));
+        Query& query = *m_queries.back();
+        for (const auto& archetype : m_archetypes)
+        {
+            if (query.Matches(archetype->GetMask()))
+            {
+                query.m_archetypes.push_back(archetype.get());
+            }
+        }
+        return query;
+    }
+
+    size_t World::GetEntityCount() const
+    {
+        return m_entityCount;
+    }
+
+    size_t World::GetArchetypeCount() const
+    {
+        return m_archetypes.size();
+    }
+
+    bool World::CanChangeStructure() const
+    {
+        if (m_iterationDepth > 0)
+        {
+            std::cerr << "ERROR: structural change while a query is iterating, use a CommandBuffer" << std::endl;
+            return false;
+        }
+        return true;
+    }
+
+    Archetype* World::GetArchetype(ComponentMask mask)
+    {
+        auto found = m_archetypeOfMask.find(mask);
+        if (found != m_archetypeOfMask.end())
+        {
+            return found->second;
+        }
+
+        m_archetypes.push_back(std::make_unique<Archetype>(mask));
+        Archetype* archetype = m_archetypes.back().get();
+        m_archetypeOfMask.emplace(mask, archetype);
+        for (const auto& query : m_queries)
+        {
+            if (query->Matches(mask))
+            {
+                query->m_archetypes.push_back(archetype);
+            }
+        }
+        return archetype;
+    }
+
+    void World::MoveEntity(Entity entity, Archetype* target)
+    {
+        EntityRecord& record = m_entities[entity.index];
+        Archetype* source = record.archetype;
+        const uint32_t sourceRow = record.row;
+        const uint32_t targetRow = target->AddRow(entity);
+        const Archetype::RowAddress sourceAddress = source->GetRowAddress(sourceRow);
+        const Archetype::RowAddress targetAddress = target->GetRowAddress(targetRow);
+
+        for (size_t column = 0; column < source->GetColumnCount(); ++column)
+        {
+            const ComponentTypeId type = source->GetColumnType(static_cast<int>(column));
+            const ComponentInfo& info = GetComponentInfo(type);
+            void* value = source->GetComponent(sourceAddress, static_cast<int>(column));
+            const int targetColumn = target->GetColumn(type);
+            if (targetColumn >= 0)
+            {
+                MoveComponent(info, target->GetComponent(targetAddress, targetColumn), value);
+            }
+            DestroyComponent(info, value);
+        }
+
+        Entity moved = source->RemoveRow(sourceRow, false);
+        if (!moved.IsNull())
+        {
+            m_entities[moved.index].row = sourceRow;
+        }
+        record.archetype = target;
+        record.row = targetRow;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+#include "ecs/Archetype.h"
+#include "ecs/Query.h"
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace eng
+{
+    // Owns entities and their components, grouped into archetypes by component set. Adding or removing a
+    // component moves the entity to the neighbouring archetype; those moves, creation and destruction are
+    // refused while a query iterates, record them into a CommandBuffer and play it back afterwards.
+    class World
+    {
+    public:
+        World();
+        ~World();
+        World(const World&) = delete;
+        World& operator=(const World&) = delete;
+
+        Entity CreateEntity();
+        // Creates the entity directly in its final archetype, no intermediate moves
+        template <typename... Ts>
+        Entity CreateEntity(Ts&&... components);
+        bool DestroyEntity(Entity entity);
+        bool IsAlive(Entity entity) const;
+
+        // Replaces the value when the entity already has the component
+        template <typename T>
+        bool AddComponent(Entity entity, T&& value);
+        template <typename T>
+        bool RemoveComponent(Entity entity);
+        // nullptr when the entity is dead or lacks the component. Valid until the next structural change.
+        template <typename T>
+        T* GetComponent(Entity entity);
+        template <typename T>
+        bool HasComponent(Entity entity) const;
+
+        // Type erased forms, used by command buffers. The value is moved from, the caller still destroys it.
+        bool AddComponent(Entity entity, ComponentTypeId type, void* value);
+        bool RemoveComponent(Entity entity, ComponentTypeId type);
+        void* GetComponent(Entity entity, ComponentTypeId type);
+        bool HasComponent(Entity entity, ComponentTypeId type) const;
+
+        // The world owns the query, create it once and keep the reference
+        Query& CreateQuery(ComponentMask required, ComponentMask excluded = 0);
+        template <typename... Ts>
+        Query& CreateQuery(ComponentMask excluded = 0);
+
+        size_t GetEntityCount() const;
+        size_t GetArchetypeCount() const;
+
+    private:
+        friend class Query;
+
+        struct EntityRecord
+        {
+            Archetype* archetype = nullptr;
+            uint32_t row = 0;
+            uint32_t generation = 0;
+        };
+
+        bool CanChangeStructure() const;
+        Archetype* GetArchetype(ComponentMask mask);
+        Entity CreateEntity(Archetype* archetype, uint32_t& row);
+        // Moves the components both archetypes share and destroys the rest
+        void MoveEntity(Entity entity, Archetype* target);
+
+        std::vector<EntityRecord> m_entities;
+        std::vector<uint32_t> m_freeEntities;
+        size_t m_entityCount = 0;
+        std::vector<std::unique_ptr<Archetype>> m_archetypes;
+        std::unordered_map<ComponentMask, Archetype*> m_archetypeOfMask;
+        Archetype* m_emptyArchetype = nullptr;
+        std::vector<std::unique_ptr<Query>> m_queries;
+        int m_iterationDepth = 0;
+    };
+
+    template <typename... Ts>
+    Entity World::CreateEntity(Ts&&... components)
+    {
+        if (!CanChangeStructure())
+        {
+            return NullEntity;
+        }
+        Archetype* archetype = GetArchetype(ComponentMaskOf<std::decay_t<Ts>...>());
+        uint32_t row = 0;
+        Entity entity = CreateEntity(archetype, row);
+        const Archetype::RowAddress address = archetype->GetRowAddress(row);
+        (new (archetype->GetComponent(address, archetype->GetColumn(GetComponentType<std::decay_t<Ts>>())))
+            std::decay_t<Ts>(std::forward<Ts>(components)), ...);
+        return entity;
+    }
+
+    template <typename T>
+    bool World::AddComponent(Entity entity, T&& value)
+    {
+        std::decay_t<T> local(std::forward<T>(value));
+        return AddComponent(entity, GetComponentType<std::decay_t<T>>(), &local);
+    }
+
+    template <typename T>
+    bool World::RemoveComponent(Entity entity)
+    {
+        return RemoveComponent(entity, GetComponentType<T>());
+    }
+
+    template <typename T>
+    T* World::GetComponent(Entity entity)
+    {
+        static_assert(!std::is_empty<T>::value, "Tags have no storage, use HasComponent");
+        return static_cast<T*>(GetComponent(entity, GetComponentType<T>()));
+    }
+
+    template <typename T>
+    bool World::HasComponent(Entity entity) const
+    {
+        return HasComponent(entity, GetComponentType<T>());
+    }
+
+    template <typename... Ts>
+    Query& World::CreateQuery(ComponentMask excluded)
+    {
+        return CreateQuery(ComponentMaskOf<Ts...>(), excluded);
+    }
+}
\ No newline at end of file
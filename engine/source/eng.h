@@ -3,9 +3,42 @@
 #include "Application.h"
 #include "Engine.h"
 #include "input/InputManager.h"
+#include "io/MappedFile.h"
+#include "io/Json.h"
 #include "graphics/ShaderProgram.h"
 #include "graphics/GraphicsAPI.h"
+#include "math/Vector.h"
+#include "math/Quaternion.h"
+#include "math/Matrix.h"
+#include "math/Aabb.h"
+#include "math/BatchMath.h"
 #include "graphics/VertexLayout.h"
+#include "graphics/Texture.h"
+#include "graphics/Sampler.h"
+#include "graphics/RenderStats.h"
 #include "render/Material.h"
 #include "render/Mesh.h"
-#include "render/RenderQueue.h"
\ No newline at end of file
+#include "render/MeshFile.h"
+#include "render/RenderQueue.h"
+#include "render/FrustumCulling.h"
+#include "render/BoundingVolumeHierarchy.h"
+#include "render/OcclusionCulling.h"
+#include "render/OcclusionQueries.h"
+#include "render/GpuCulling.h"
+#include "scene/TransformHierarchy.h"
+#include "ecs/World.h"
+#include "ecs/CommandBuffer.h"
+#include "jobs/JobSystem.h"
+#include "coro/Task.h"
+#include "coro/TaskScheduler.h"
+#include "time/FramePacer.h"
+#include "profile/Profiler.h"
+#include "profile/GpuProfiler.h"
+#include "render/TextureStreamer.h"
+#include "render/TextureAtlas.h"
+#include "render/SpriteBatch.h"
+#include "render/StatsOverlay.h"
+#include "asset/ImportedMesh.h"
+#include "asset/ObjImporter.h"
+#include "asset/GltfImporter.h"
+#include "asset/TextureSource.h"
\ No newline at end of file
@@ -2,6 +2,8 @@
 #include "graphics/ShaderProgram.h"
 #include "render/Material.h"
 #include "render/Mesh.h"
+#include "profile/Profiler.h"
+#include <algorithm>
 #include <iostream>
 
 namespace eng
@@ -9,6 +11,7 @@ namespace eng
     std::shared_ptr<ShaderProgram> GraphicsAPI::CreateShaderProgram(const std::string& vertexSource,
         const std::string& fragmentSource)
     {
+        ENG_PROFILE_SCOPE("GraphicsAPI::CreateShaderProgram");
         GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
         const char* vertexShaderCStr = vertexSource.c_str();
         glShaderSource(vertexShader, 1, &vertexShaderCStr, nullptr);
@@ -58,26 +61,238 @@ namespace eng
         return std::make_shared<ShaderProgram>(shaderProgramID);
     }
 
+    std::shared_ptr<ShaderProgram> GraphicsAPI::CreateComputeProgram(const std::string& computeSource)
+    {
+        if (!GLEW_VERSION_4_3 && !GLEW_ARB_compute_shader)
+        {
+            return nullptr;
+        }
+
+        GLuint computeShader = glCreateShader(GL_COMPUTE_SHADER);
+        const char* computeShaderCStr = computeSource.c_str();
+        glShaderSource(computeShader, 1, &computeShaderCStr, nullptr);
+        glCompileShader(computeShader);
+
+        GLint success;
+        glGetShaderiv(computeShader, GL_COMPILE_STATUS, &success);
+        if (!success)
+        {
+            char infoLog[512];
+            glGetShaderInfoLog(computeShader, 512, nullptr, infoLog);
+            std::cerr << "ERROR:COMPUTE_SHADER_COMPILATION_FAILED: " << infoLog << std::endl;
+            glDeleteShader(computeShader);
+            return nullptr;
+        }
+
+        GLuint shaderProgramID = glCreateProgram();
+        glAttachShader(shaderProgramID, computeShader);
+        glLinkProgram(shaderProgramID);
+        glDeleteShader(computeShader);
+
+        glGetProgramiv(shaderProgramID, GL_LINK_STATUS, &success);
+        if (!success)
+        {
+            char infoLog[512];
+            glGetProgramInfoLog(shaderProgramID, 512, nullptr, infoLog);
+            std::cerr << "ERROR:SHADER_PROGRAM_LINKING_FAILED: " << infoLog << std::endl;
+            glDeleteProgram(shaderProgramID);
+            return nullptr;
+        }
+
+        return std::make_shared<ShaderProgram>(shaderProgramID);
+    }
+
     GLuint GraphicsAPI::CreateVertexBuffer(const std::vector<float>& vertices)
+    {
+        return CreateVertexBuffer(vertices.data(), vertices.size() * sizeof(float));
+    }
+
+    GLuint GraphicsAPI::CreateIndexBuffer(const std::vector<uint32_t>& indices)
+    {
+        return CreateIndexBuffer(indices.data(), indices.size());
+    }
+
+    GLuint GraphicsAPI::CreateVertexBuffer(const void* data, size_t size)
     {
         GLuint VBO = 0;
         glGenBuffers(1, &VBO);
         glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_STATIC_DRAW);
+        glBufferData(GL_ARRAY_BUFFER, size, data, GL_STATIC_DRAW);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
+        m_frameStats.Add(RenderCounter::BytesUploaded, data ? size : 0);
         return VBO;
     }
 
-    GLuint GraphicsAPI::CreateIndexBuffer(const std::vector<uint32_t>& indices)
+    GLuint GraphicsAPI::CreateIndexBuffer(const uint32_t* indices, size_t count)
     {
         GLuint EBO = 0;
         glGenBuffers(1, &EBO);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, count * sizeof(uint32_t), indices, GL_STATIC_DRAW);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+        m_frameStats.Add(RenderCounter::BytesUploaded, indices ? count * sizeof(uint32_t) : 0);
         return EBO;
     }
 
+    GLenum GraphicsAPI::GetInternalFormat(TextureFormat format)
+    {
+        switch (format)
+        {
+        case TextureFormat::R8:
+            return GL_R8;
+        case TextureFormat::RG8:
+            return GL_RG8;
+        case TextureFormat::RGBA8:
+        default:
+            return GL_RGBA8;
+        }
+    }
+
+    GLenum GraphicsAPI::GetPixelFormat(TextureFormat format)
+    {
+        switch (format)
+        {
+        case TextureFormat::R8:
+            return GL_RED;
+        case TextureFormat::RG8:
+            return GL_RG;
+        case TextureFormat::RGBA8:
+        default:
+            return GL_RGBA;
+        }
+    }
+
+    std::shared_ptr<Texture> GraphicsAPI::CreateTexture(TextureFormat format, uint32_t width, uint32_t height,
+        uint32_t mipLevels)
+    {
+        if (width == 0 || height == 0)
+        {
+            return nullptr;
+        }
+
+        uint32_t maxLevels = GetMipLevelCount(width, height);
+        mipLevels = mipLevels == 0 ? maxLevels : std::min(mipLevels, maxLevels);
+
+        GLuint textureID = CreateTextureStorage(format, width, height, mipLevels);
+        return std::make_shared<Texture>(textureID, format, width, height, mipLevels);
+    }
+
+    GLuint GraphicsAPI::CreateTextureStorage(TextureFormat format, uint32_t width, uint32_t height, uint32_t mipLevels)
+    {
+        GLuint textureID = 0;
+        glGenTextures(1, &textureID);
+        BindTextureID(0, GL_TEXTURE_2D, textureID);
+
+        if (GLEW_ARB_texture_storage)
+        {
+            // Immutable storage lets the driver skip per-level completeness validation
+            glTexStorage2D(GL_TEXTURE_2D, mipLevels, GetInternalFormat(format), width, height);
+        }
+        else
+        {
+            for (uint32_t level = 0; level < mipLevels; ++level)
+            {
+                glTexImage2D(GL_TEXTURE_2D, level, GetInternalFormat(format),
+                    std::max(1u, width >> level), std::max(1u, height >> level), 0,
+                    GetPixelFormat(format), GL_UNSIGNED_BYTE, nullptr);
+            }
+        }
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipLevels - 1);
+
+        return textureID;
+    }
+
+    std::shared_ptr<Texture> GraphicsAPI::CreateTexture(TextureFormat format, uint32_t width, uint32_t height,
+        const void* pixels, bool generateMips)
+    {
+        auto texture = CreateTexture(format, width, height, generateMips ? 0 : 1);
+        if (texture && pixels)
+        {
+            texture->UploadWithMips(pixels);
+        }
+        return texture;
+    }
+
+    std::shared_ptr<Texture> GraphicsAPI::CreateTextureArray(TextureFormat format, uint32_t width, uint32_t height,
+        uint32_t layers, const void* pixels, bool generateMips)
+    {
+        if (width == 0 || height == 0 || layers == 0)
+        {
+            return nullptr;
+        }
+
+        uint32_t mipLevels = generateMips ? GetMipLevelCount(width, height) : 1;
+
+        GLuint textureID = 0;
+        glGenTextures(1, &textureID);
+        BindTextureID(0, GL_TEXTURE_2D_ARRAY, textureID);
+
+        if (GLEW_ARB_texture_storage)
+        {
+            glTexStorage3D(GL_TEXTURE_2D_ARRAY, mipLevels, GetInternalFormat(format), width, height, layers);
+        }
+        else
+        {
+            for (uint32_t level = 0; level < mipLevels; ++level)
+            {
+                glTexImage3D(GL_TEXTURE_2D_ARRAY, level, GetInternalFormat(format),
+                    std::max(1u, width >> level), std::max(1u, height >> level), layers, 0,
+                    GetPixelFormat(format), GL_UNSIGNED_BYTE, nullptr);
+            }
+        }
+        glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAX_LEVEL, mipLevels - 1);
+
+        auto texture = std::make_shared<Texture>(textureID, format, width, height, mipLevels,
+            GL_TEXTURE_2D_ARRAY, layers);
+        if (pixels)
+        {
+            texture->UploadWithMips(pixels);
+        }
+        return texture;
+    }
+
+    GLuint GraphicsAPI::GetSampler(const SamplerDesc& desc)
+    {
+        uint64_t key = desc.GetKey();
+        auto it = m_samplerCache.find(key);
+        if (it != m_samplerCache.end())
+        {
+            return it->second;
+        }
+
+        static const GLenum filters[] =
+        {
+            GL_NEAREST,
+            GL_LINEAR,
+            GL_NEAREST_MIPMAP_NEAREST,
+            GL_LINEAR_MIPMAP_NEAREST,
+            GL_NEAREST_MIPMAP_LINEAR,
+            GL_LINEAR_MIPMAP_LINEAR
+        };
+        static const GLenum wraps[] =
+        {
+            GL_REPEAT,
+            GL_MIRRORED_REPEAT,
+            GL_CLAMP_TO_EDGE
+        };
+
+        GLuint sampler = 0;
+        glGenSamplers(1, &sampler);
+        glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, filters[static_cast<int>(desc.minFilter)]);
+        // Magnification has no mip levels to pick from
+        glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER,
+            desc.magFilter == TextureFilter::Nearest ? GL_NEAREST : GL_LINEAR);
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, wraps[static_cast<int>(desc.wrapS)]);
+        glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, wraps[static_cast<int>(desc.wrapT)]);
+        if (desc.maxAnisotropy > 1 && GLEW_EXT_texture_filter_anisotropic)
+        {
+            glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY_EXT, desc.maxAnisotropy);
+        }
+
+        m_samplerCache[key] = sampler;
+        return sampler;
+    }
+
     void GraphicsAPI::SetClearColor(float r, float g, float b, float a)
     {
         glClearColor(r, g, b, a);
@@ -85,7 +300,20 @@ namespace eng
 
     void GraphicsAPI::ClearBuffers()
     {
-        glClear(GL_COLOR_BUFFER_BIT);
+        glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    }
+
+    void GraphicsAPI::SetDepthTest(bool enable)
+    {
+        if (enable)
+        {
+            glEnable(GL_DEPTH_TEST);
+            glDepthFunc(GL_LEQUAL);
+        }
+        else
+        {
+            glDisable(GL_DEPTH_TEST);
+        }
     }
 
     void GraphicsAPI::BindShaderProgram(ShaderProgram* shaderProgram)
@@ -109,6 +337,7 @@ namespace eng
         if (mesh)
         {
             mesh->Bind();
+            m_frameStats.Add(RenderCounter::VertexArrayBinds);
         }
     }
 
@@ -117,6 +346,91 @@ namespace eng
         if (mesh)
         {
             mesh->Draw();
+            m_frameStats.Add(RenderCounter::DrawCalls);
+            m_frameStats.Add(RenderCounter::Instances);
+            m_frameStats.Add(RenderCounter::Triangles, mesh->GetCurrentTriangleCount());
+        }
+    }
+
+    void GraphicsAPI::SetActiveTextureUnit(uint32_t unit)
+    {
+        if (m_activeTextureUnit != unit)
+        {
+            glActiveTexture(GL_TEXTURE0 + unit);
+            m_activeTextureUnit = unit;
         }
     }
+
+    void GraphicsAPI::BindTexture(uint32_t unit, Texture* texture)
+    {
+        if (texture)
+        {
+            BindTextureID(unit, texture->GetTarget(), texture->GetID());
+        }
+        else
+        {
+            BindTextureID(unit, GL_TEXTURE_2D, 0);
+        }
+    }
+
+    void GraphicsAPI::BindTextureID(uint32_t unit, GLenum target, GLuint textureID)
+    {
+        if (unit >= MaxTextureUnits)
+        {
+            return;
+        }
+
+        auto& bound = target == GL_TEXTURE_2D_ARRAY ? m_boundTextureArrays[unit] : m_boundTextures[unit];
+        if (bound == textureID)
+        {
+            return;
+        }
+
+        SetActiveTextureUnit(unit);
+        glBindTexture(target, textureID);
+        bound = textureID;
+        m_frameStats.Add(RenderCounter::TextureBinds);
+    }
+
+    void GraphicsAPI::BindSampler(uint32_t unit, GLuint sampler)
+    {
+        if (unit >= MaxTextureUnits || m_boundSamplers[unit] == sampler)
+        {
+            return;
+        }
+
+        glBindSampler(unit, sampler);
+        m_boundSamplers[unit] = sampler;
+    }
+
+    void GraphicsAPI::OnTextureDestroyed(GLuint textureID)
+    {
+        // GL unbinds deleted textures, the cache has to forget them too or a reused name would be skipped
+        for (auto* bindings : { &m_boundTextures, &m_boundTextureArrays })
+        {
+            for (auto& bound : *bindings)
+            {
+                if (bound == textureID)
+                {
+                    bound = 0;
+                }
+            }
+        }
+    }
+
+    RenderStats& GraphicsAPI::GetFrameStats()
+    {
+        return m_frameStats;
+    }
+
+    const RenderStats& GraphicsAPI::GetStats() const
+    {
+        return m_stats;
+    }
+
+    void GraphicsAPI::EndFrameStats()
+    {
+        m_stats = m_frameStats;
+        m_frameStats.Reset();
+    }
 }
\ No newline at end of file
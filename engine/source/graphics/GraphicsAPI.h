@@ -1,8 +1,13 @@
 #pragma once
+#include <array>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <GL/glew.h>
+#include "graphics/Sampler.h"
+#include "graphics/Texture.h"
+#include "graphics/RenderStats.h"
 
 namespace eng
 {
@@ -13,17 +18,65 @@ namespace eng
     class GraphicsAPI
     {
     public:
+        static constexpr uint32_t MaxTextureUnits = 16;
+
         std::shared_ptr<ShaderProgram> CreateShaderProgram(const std::string& vertexSource, 
             const std::string& fragmentSource);
+        // Needs GL 4.3 or ARB_compute_shader, returns null when unsupported
+        std::shared_ptr<ShaderProgram> CreateComputeProgram(const std::string& computeSource);
         GLuint CreateVertexBuffer(const std::vector<float>& vertices);
         GLuint CreateIndexBuffer(const std::vector<uint32_t>& indices);
+        GLuint CreateVertexBuffer(const void* data, size_t size);
+        GLuint CreateIndexBuffer(const uint32_t* indices, size_t count);
+        // mipLevels == 0 allocates the full chain
+        std::shared_ptr<Texture> CreateTexture(TextureFormat format, uint32_t width, uint32_t height,
+            uint32_t mipLevels = 0);
+        std::shared_ptr<Texture> CreateTexture(TextureFormat format, uint32_t width, uint32_t height,
+            const void* pixels, bool generateMips = true);
+        // Layers are tightly packed one after another in pixels
+        std::shared_ptr<Texture> CreateTextureArray(TextureFormat format, uint32_t width, uint32_t height,
+            uint32_t layers, const void* pixels, bool generateMips = true);
+        // Allocates immutable storage for a new GL texture and leaves it bound to unit 0
+        GLuint CreateTextureStorage(TextureFormat format, uint32_t width, uint32_t height, uint32_t mipLevels);
+        // Sampler objects are shared between all users of the same state
+        GLuint GetSampler(const SamplerDesc& desc);
+
+        static GLenum GetInternalFormat(TextureFormat format);
+        static GLenum GetPixelFormat(TextureFormat format);
 
         void SetClearColor(float r, float g, float b, float a);
+        // Color and depth
         void ClearBuffers();
+        // GL_LEQUAL, so coplanar draws still land in submission order
+        void SetDepthTest(bool enable);
 
         void BindShaderProgram(ShaderProgram* shaderProgram);
         void BindMaterial(Material* material);
         void BindMesh(Mesh* mesh);
         void DrawMesh(Mesh* mesh);
+        // Skips the GL call when the unit already has this texture/sampler
+        void BindTexture(uint32_t unit, Texture* texture);
+        void BindSampler(uint32_t unit, GLuint sampler);
+        void OnTextureDestroyed(GLuint textureID);
+
+        // Counters of the frame in progress, code issuing GL calls of its own adds to them
+        RenderStats& GetFrameStats();
+        // Counters of the last finished frame
+        const RenderStats& GetStats() const;
+        // Publishes the frame's counters and starts counting the next frame
+        void EndFrameStats();
+
+    private:
+        void SetActiveTextureUnit(uint32_t unit);
+        void BindTextureID(uint32_t unit, GLenum target, GLuint textureID);
+
+        std::unordered_map<uint64_t, GLuint> m_samplerCache;
+        // Each unit has independent GL_TEXTURE_2D and GL_TEXTURE_2D_ARRAY bindings
+        std::array<GLuint, MaxTextureUnits> m_boundTextures = {};
+        std::array<GLuint, MaxTextureUnits> m_boundTextureArrays = {};
+        std::array<GLuint, MaxTextureUnits> m_boundSamplers = {};
+        uint32_t m_activeTextureUnit = 0;
+        RenderStats m_frameStats;
+        RenderStats m_stats;
     };
 }
\ No newline at end of file
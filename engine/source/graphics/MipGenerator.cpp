@@ -0,0 +1,96 @@
+#include "graphics/MipGenerator.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ENG_MIP_SSE2 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define ENG_MIP_NEON 1
+#endif
+
+namespace eng
+{
+    namespace
+    {
+        // Handles output pixels [begin, end) of one row
+        void DownsampleRowScalar(const uint8_t* row0, const uint8_t* row1, uint32_t width, uint32_t bytesPerPixel,
+            uint32_t begin, uint32_t end, uint8_t* destination)
+        {
+            for (uint32_t x = begin; x < end; ++x)
+            {
+                uint32_t x0 = std::min(x * 2, width - 1);
+                uint32_t x1 = std::min(x * 2 + 1, width - 1);
+                for (uint32_t c = 0; c < bytesPerPixel; ++c)
+                {
+                    uint32_t sum = row0[x0 * bytesPerPixel + c] + row0[x1 * bytesPerPixel + c]
+                        + row1[x0 * bytesPerPixel + c] + row1[x1 * bytesPerPixel + c];
+                    destination[x * bytesPerPixel + c] = static_cast<uint8_t>((sum + 2) >> 2);
+                }
+            }
+        }
+
+        // Returns how many output RGBA pixels were written
+        uint32_t DownsampleRowRGBA(const uint8_t* row0, const uint8_t* row1, uint32_t outWidth, uint8_t* destination)
+        {
+            uint32_t x = 0;
+#if defined(ENG_MIP_SSE2)
+            const __m128i zero = _mm_setzero_si128();
+            const __m128i rounding = _mm_set1_epi16(2);
+            // 4 source pixels of each row produce 2 output pixels
+            for (; x + 2 <= outWidth; x += 2)
+            {
+                __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row0 + x * 8));
+                __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row1 + x * 8));
+                __m128i low = _mm_add_epi16(_mm_unpacklo_epi8(a, zero), _mm_unpacklo_epi8(b, zero));
+                __m128i high = _mm_add_epi16(_mm_unpackhi_epi8(a, zero), _mm_unpackhi_epi8(b, zero));
+                low = _mm_add_epi16(low, _mm_srli_si128(low, 8));
+                high = _mm_add_epi16(high, _mm_srli_si128(high, 8));
+                __m128i sum = _mm_add_epi16(_mm_unpacklo_epi64(low, high), rounding);
+                __m128i result = _mm_packus_epi16(_mm_srli_epi16(sum, 2), zero);
+                _mm_storel_epi64(reinterpret_cast<__m128i*>(destination + x * 4), result);
+            }
+#elif defined(ENG_MIP_NEON)
+            for (; x + 2 <= outWidth; x += 2)
+            {
+                uint8x16_t a = vld1q_u8(row0 + x * 8);
+                uint8x16_t b = vld1q_u8(row1 + x * 8);
+                uint16x8_t low = vaddl_u8(vget_low_u8(a), vget_low_u8(b));
+                uint16x8_t high = vaddl_u8(vget_high_u8(a), vget_high_u8(b));
+                uint16x4_t first = vadd_u16(vget_low_u16(low), vget_high_u16(low));
+                uint16x4_t second = vadd_u16(vget_low_u16(high), vget_high_u16(high));
+                vst1_u8(destination + x * 4, vrshrn_n_u16(vcombine_u16(first, second), 2));
+            }
+#else
+            (void)row0;
+            (void)row1;
+            (void)outWidth;
+            (void)destination;
+#endif
+            return x;
+        }
+    }
+
+    void DownsampleMip(const uint8_t* source, uint32_t width, uint32_t height, uint32_t bytesPerPixel,
+        uint8_t* destination)
+    {
+        const uint32_t outWidth = std::max(1u, width >> 1);
+        const uint32_t outHeight = std::max(1u, height >> 1);
+        const size_t rowPitch = size_t(width) * bytesPerPixel;
+
+        for (uint32_t y = 0; y < outHeight; ++y)
+        {
+            const uint8_t* row0 = source + std::min(y * 2, height - 1) * rowPitch;
+            const uint8_t* row1 = source + std::min(y * 2 + 1, height - 1) * rowPitch;
+            uint8_t* out = destination + size_t(y) * outWidth * bytesPerPixel;
+
+            uint32_t done = 0;
+            // The vector path reads 2 source pixels per output pixel, so it must stop before a clamped odd edge
+            if (bytesPerPixel == 4 && width >= 2)
+            {
+                done = DownsampleRowRGBA(row0, row1, width / 2, out);
+            }
+            DownsampleRowScalar(row0, row1, width, bytesPerPixel, done, outWidth, out);
+        }
+    }
+}
\ No newline at end of file
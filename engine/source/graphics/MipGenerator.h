@@ -0,0 +1,10 @@
+#pragma once
+#include <stdint.h>
+
+namespace eng
+{
+    // 2x2 box filter of a tightly packed 8-bit image into the next mip level.
+    // Odd edges reuse the last row/column. RGBA8 takes an SSE2/NEON path when available.
+    void DownsampleMip(const uint8_t* source, uint32_t width, uint32_t height, uint32_t bytesPerPixel,
+        uint8_t* destination);
+}
\ No newline at end of file
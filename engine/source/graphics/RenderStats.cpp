@@ -0,0 +1,75 @@
+#include "graphics/RenderStats.h"
+#include <iostream>
+
+namespace eng
+{
+    const char* RenderStats::GetName(RenderCounter counter)
+    {
+        static const char* names[] =
+        {
+            "draw_calls",
+            "instances",
+            "triangles",
+            "program_binds",
+            "vertex_array_binds",
+            "texture_binds",
+            "uniform_uploads",
+            "bytes_uploaded",
+            "compute_dispatches",
+            "commands_submitted",
+            "commands_culled",
+            "commands_occluded",
+            "sprites"
+        };
+        static_assert(sizeof(names) / sizeof(names[0]) == CounterCount, "Every counter needs a name");
+        const size_t index = static_cast<size_t>(counter);
+        return index < CounterCount ? names[index] : "";
+    }
+
+    bool RenderStatsLog::Open(const std::string& path)
+    {
+        Close();
+        m_file.open(path, std::ios::trunc);
+        if (!m_file)
+        {
+            std::cerr << "ERROR:RENDER_STATS_LOG_OPEN_FAILED: " << path << std::endl;
+            return false;
+        }
+
+        m_file << "frame,frame_ms,gpu_ms";
+        for (size_t i = 0; i < RenderStats::CounterCount; ++i)
+        {
+            m_file << ',' << RenderStats::GetName(static_cast<RenderCounter>(i));
+        }
+        m_file << '\n';
+        return true;
+    }
+
+    void RenderStatsLog::Close()
+    {
+        if (m_file.is_open())
+        {
+            m_file.close();
+        }
+    }
+
+    bool RenderStatsLog::IsOpen() const
+    {
+        return m_file.is_open();
+    }
+
+    void RenderStatsLog::Write(uint64_t frame, double frameMilliseconds, double gpuMilliseconds,
+        const RenderStats& stats)
+    {
+        if (!m_file.is_open())
+        {
+            return;
+        }
+        m_file << frame << ',' << frameMilliseconds << ',' << gpuMilliseconds;
+        for (uint64_t value : stats.counters)
+        {
+            m_file << ',' << value;
+        }
+        m_file << '\n';
+    }
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <array>
+#include <fstream>
+#include <string>
+
+namespace eng
+{
+    enum class RenderCounter
+    {
+        DrawCalls,
+        // Indirect draws count every slot they were given, culled or not
+        Instances,
+        Triangles,
+        ProgramBinds,
+        VertexArrayBinds,
+        TextureBinds,
+        UniformUploads,
+        BytesUploaded,
+        ComputeDispatches,
+        CommandsSubmitted,
+        // Includes the occluded ones
+        CommandsCulled,
+        CommandsOccluded,
+        Sprites,
+        Count
+    };
+
+    // Counters of one frame, collected by GraphicsAPI and everything that issues GL calls
+    struct RenderStats
+    {
+        static constexpr size_t CounterCount = static_cast<size_t>(RenderCounter::Count);
+
+        void Add(RenderCounter counter, uint64_t amount = 1) { counters[static_cast<size_t>(counter)] += amount; }
+        uint64_t Get(RenderCounter counter) const { return counters[static_cast<size_t>(counter)]; }
+        void Reset() { counters.fill(0); }
+
+        // snake_case, used as CSV and JSON keys
+        static const char* GetName(RenderCounter counter);
+
+        std::array<uint64_t, CounterCount> counters = {};
+    };
+
+    // One CSV row per frame: frame number, CPU and GPU frame time, then every counter
+    class RenderStatsLog
+    {
+    public:
+        bool Open(const std::string& path);
+        void Close();
+        bool IsOpen() const;
+        void Write(uint64_t frame, double frameMilliseconds, double gpuMilliseconds, const RenderStats& stats);
+
+    private:
+        std::ofstream m_file;
+    };
+}
\ No newline at end of file
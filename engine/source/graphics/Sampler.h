@@ -0,0 +1,41 @@
+#pragma once
+#include <stdint.h>
+
+namespace eng
+{
+    enum class TextureFilter : uint8_t
+    {
+        Nearest,
+        Linear,
+        NearestMipmapNearest,
+        LinearMipmapNearest,
+        NearestMipmapLinear,
+        LinearMipmapLinear
+    };
+
+    enum class TextureWrap : uint8_t
+    {
+        Repeat,
+        MirroredRepeat,
+        ClampToEdge
+    };
+
+    struct SamplerDesc
+    {
+        TextureFilter minFilter = TextureFilter::LinearMipmapLinear;
+        TextureFilter magFilter = TextureFilter::Linear;
+        TextureWrap wrapS = TextureWrap::Repeat;
+        TextureWrap wrapT = TextureWrap::Repeat;
+        uint8_t maxAnisotropy = 1;
+
+        // Packs every field, so equal keys mean identical sampler state
+        uint64_t GetKey() const
+        {
+            return uint64_t(minFilter)
+                | (uint64_t(magFilter) << 8)
+                | (uint64_t(wrapS) << 16)
+                | (uint64_t(wrapT) << 24)
+                | (uint64_t(maxAnisotropy) << 32);
+        }
+    };
+}
\ No newline at end of file
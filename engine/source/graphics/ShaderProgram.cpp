@@ -1,7 +1,18 @@
 #include "graphics/ShaderProgram.h"
+#include "math/Matrix.h"
+#include "graphics/GraphicsAPI.h"
+#include "Engine.h"
 
 namespace eng
 {
+    namespace
+    {
+        void CountUniformUpload()
+        {
+            Engine::GetInstance().GetGraphicsAPI().GetFrameStats().Add(RenderCounter::UniformUploads);
+        }
+    }
+
     ShaderProgram::ShaderProgram(GLuint shaderProgramID) : m_shaderProgramID(shaderProgramID)
     {
     }
@@ -14,6 +25,7 @@ namespace eng
     void ShaderProgram::Bind()
     {
         glUseProgram(m_shaderProgramID);
+        Engine::GetInstance().GetGraphicsAPI().GetFrameStats().Add(RenderCounter::ProgramBinds);
     }
 
     GLint ShaderProgram::GetUniformLocation(const std::string& name)
@@ -32,11 +44,56 @@ namespace eng
     {
         auto location = GetUniformLocation(name);
         glUniform1f(location, value);
+        CountUniformUpload();
     }
 
     void ShaderProgram::SetUniform(const std::string& name, float v0, float v1)
     {
         auto location = GetUniformLocation(name);
         glUniform2f(location, v0, v1);
+        CountUniformUpload();
+    }
+
+    void ShaderProgram::SetUniform(const std::string& name, float v0, float v1, float v2)
+    {
+        auto location = GetUniformLocation(name);
+        glUniform3f(location, v0, v1, v2);
+        CountUniformUpload();
+    }
+
+    void ShaderProgram::SetUniformMatrix4(const std::string& name, const float* matrix)
+    {
+        auto location = GetUniformLocation(name);
+        glUniformMatrix4fv(location, 1, GL_FALSE, matrix);
+        CountUniformUpload();
+    }
+
+    void ShaderProgram::SetUniform(const std::string& name, int value)
+    {
+        auto location = GetUniformLocation(name);
+        glUniform1i(location, value);
+        CountUniformUpload();
+    }
+
+    void ShaderProgram::SetUniform(const std::string& name, const Vec2& value)
+    {
+        SetUniform(name, value.x, value.y);
+    }
+
+    void ShaderProgram::SetUniform(const std::string& name, const Vec3& value)
+    {
+        SetUniform(name, value.x, value.y, value.z);
+    }
+
+    void ShaderProgram::SetUniform(const std::string& name, const Vec4& value)
+    {
+        auto location = GetUniformLocation(name);
+        glUniform4f(location, value.x, value.y, value.z, value.w);
+        CountUniformUpload();
+    }
+
+    void ShaderProgram::SetUniform(const std::string& name, const Mat4& value)
+    {
+        SetUniformMatrix4(name, value.Data());
     }
 }
\ No newline at end of file
@@ -5,6 +5,11 @@
 
 namespace eng
 {
+    struct Vec2;
+    struct Vec3;
+    struct Vec4;
+    struct Mat4;
+
     class ShaderProgram
     {
     public:
@@ -18,6 +23,14 @@ namespace eng
         GLint GetUniformLocation(const std::string& name);
         void SetUniform(const std::string& name, float value);
         void SetUniform(const std::string& name, float v0, float v1);
+        void SetUniform(const std::string& name, float v0, float v1, float v2);
+        // Column-major 4x4
+        void SetUniformMatrix4(const std::string& name, const float* matrix);
+        void SetUniform(const std::string& name, int value);
+        void SetUniform(const std::string& name, const Vec2& value);
+        void SetUniform(const std::string& name, const Vec3& value);
+        void SetUniform(const std::string& name, const Vec4& value);
+        void SetUniform(const std::string& name, const Mat4& value);
 
     private:
         std::unordered_map<std::string, GLint> m_uniformLocationCache;
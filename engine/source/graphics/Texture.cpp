@@ -0,0 +1,192 @@
+#include "graphics/Texture.h"
+#include "graphics/GraphicsAPI.h"
+#include "graphics/MipGenerator.h"
+#include "Engine.h"
+#include <algorithm>
+#include <vector>
+
+namespace eng
+{
+    uint32_t GetBytesPerPixel(TextureFormat format)
+    {
+        switch (format)
+        {
+        case TextureFormat::R8:
+            return 1;
+        case TextureFormat::RG8:
+            return 2;
+        case TextureFormat::RGBA8:
+        default:
+            return 4;
+        }
+    }
+
+    uint32_t GetMipLevelCount(uint32_t width, uint32_t height)
+    {
+        uint32_t levels = 1;
+        uint32_t size = std::max(width, height);
+        while (size > 1)
+        {
+            size >>= 1;
+            ++levels;
+        }
+        return levels;
+    }
+
+    Texture::Texture(GLuint textureID, TextureFormat format, uint32_t width, uint32_t height, uint32_t mipLevels,
+        GLenum target, uint32_t layers)
+        : m_textureID(textureID), m_target(target), m_layers(layers), m_format(format), m_width(width),
+        m_height(height), m_mipLevels(mipLevels)
+    {
+    }
+
+    Texture::~Texture()
+    {
+        Release();
+    }
+
+    void Texture::Release()
+    {
+        Engine::GetInstance().GetGraphicsAPI().OnTextureDestroyed(m_textureID);
+        glDeleteTextures(1, &m_textureID);
+        m_textureID = 0;
+    }
+
+    void Texture::ReplaceStorage(GLuint textureID, uint32_t width, uint32_t height, uint32_t mipLevels)
+    {
+        Release();
+        m_textureID = textureID;
+        m_width = width;
+        m_height = height;
+        m_mipLevels = mipLevels;
+    }
+
+    void Texture::Upload(uint32_t level, const void* pixels)
+    {
+        if (level >= m_mipLevels)
+        {
+            return;
+        }
+
+        auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
+        graphicsAPI.BindTexture(0, this);
+
+        GLsizei width = std::max(1u, m_width >> level);
+        GLsizei height = std::max(1u, m_height >> level);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        if (m_target == GL_TEXTURE_2D_ARRAY)
+        {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, 0, 0, 0, width, height, m_layers,
+                GraphicsAPI::GetPixelFormat(m_format), GL_UNSIGNED_BYTE, pixels);
+        }
+        else
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, level, 0, 0, width, height,
+                GraphicsAPI::GetPixelFormat(m_format), GL_UNSIGNED_BYTE, pixels);
+        }
+        graphicsAPI.GetFrameStats().Add(RenderCounter::BytesUploaded,
+            uint64_t(width) * height * m_layers * GetBytesPerPixel(m_format));
+    }
+
+    void Texture::UploadRegion(uint32_t level, uint32_t layer, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+        const void* pixels)
+    {
+        if (level >= m_mipLevels || layer >= m_layers)
+        {
+            return;
+        }
+
+        auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
+        graphicsAPI.BindTexture(0, this);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        if (m_target == GL_TEXTURE_2D_ARRAY)
+        {
+            glTexSubImage3D(GL_TEXTURE_2D_ARRAY, level, x, y, layer, width, height, 1,
+                GraphicsAPI::GetPixelFormat(m_format), GL_UNSIGNED_BYTE, pixels);
+        }
+        else
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, level, x, y, width, height,
+                GraphicsAPI::GetPixelFormat(m_format), GL_UNSIGNED_BYTE, pixels);
+        }
+        graphicsAPI.GetFrameStats().Add(RenderCounter::BytesUploaded,
+            uint64_t(width) * height * GetBytesPerPixel(m_format));
+    }
+
+    void Texture::UploadWithMips(const void* pixels)
+    {
+        const uint32_t bytesPerPixel = GetBytesPerPixel(m_format);
+        const size_t layerSize = size_t(m_width) * m_height * bytesPerPixel;
+
+        for (uint32_t layer = 0; layer < m_layers; ++layer)
+        {
+            const uint8_t* source = static_cast<const uint8_t*>(pixels) + layer * layerSize;
+            UploadRegion(0, layer, 0, 0, m_width, m_height, source);
+
+            std::vector<uint8_t> levels[2];
+            uint32_t width = m_width;
+            uint32_t height = m_height;
+
+            for (uint32_t level = 1; level < m_mipLevels; ++level)
+            {
+                uint32_t mipWidth = std::max(1u, width >> 1);
+                uint32_t mipHeight = std::max(1u, height >> 1);
+                auto& target = levels[level & 1];
+                target.resize(size_t(mipWidth) * mipHeight * bytesPerPixel);
+
+                DownsampleMip(source, width, height, bytesPerPixel, target.data());
+                UploadRegion(level, layer, 0, 0, mipWidth, mipHeight, target.data());
+
+                source = target.data();
+                width = mipWidth;
+                height = mipHeight;
+            }
+        }
+    }
+
+    GLuint Texture::GetID() const
+    {
+        return m_textureID;
+    }
+
+    GLenum Texture::GetTarget() const
+    {
+        return m_target;
+    }
+
+    uint32_t Texture::GetLayers() const
+    {
+        return m_layers;
+    }
+
+    TextureFormat Texture::GetFormat() const
+    {
+        return m_format;
+    }
+
+    uint32_t Texture::GetWidth() const
+    {
+        return m_width;
+    }
+
+    uint32_t Texture::GetHeight() const
+    {
+        return m_height;
+    }
+
+    uint32_t Texture::GetMipLevels() const
+    {
+        return m_mipLevels;
+    }
+
+    int32_t Texture::GetStreamingHandle() const
+    {
+        return m_streamingHandle;
+    }
+
+    void Texture::SetStreamingHandle(int32_t handle)
+    {
+        m_streamingHandle = handle;
+    }
+}
\ No newline at end of file
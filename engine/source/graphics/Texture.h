@@ -0,0 +1,63 @@
+#pragma once
+#include <GL/glew.h>
+#include <stdint.h>
+
+namespace eng
+{
+    enum class TextureFormat
+    {
+        R8,
+        RG8,
+        RGBA8
+    };
+
+    uint32_t GetBytesPerPixel(TextureFormat format);
+    uint32_t GetMipLevelCount(uint32_t width, uint32_t height);
+
+    class Texture
+    {
+    public:
+        Texture() = delete;
+        Texture(const Texture&) = delete;
+        Texture& operator=(const Texture&) = delete;
+        Texture(GLuint textureID, TextureFormat format, uint32_t width, uint32_t height, uint32_t mipLevels,
+            GLenum target = GL_TEXTURE_2D, uint32_t layers = 1);
+        ~Texture();
+
+        // Replaces a whole mip level (of every layer for arrays), pixels are tightly packed
+        void Upload(uint32_t level, const void* pixels);
+        // Replaces a rectangle of one mip level of one layer
+        void UploadRegion(uint32_t level, uint32_t layer, uint32_t x, uint32_t y, uint32_t width, uint32_t height,
+            const void* pixels);
+        // Builds the rest of the chain on the CPU from level 0 and uploads every level
+        void UploadWithMips(const void* pixels);
+
+        // Swaps in new GL storage (e.g. a different resident mip range), the old texture is deleted
+        void ReplaceStorage(GLuint textureID, uint32_t width, uint32_t height, uint32_t mipLevels);
+
+        GLuint GetID() const;
+        // GL_TEXTURE_2D or GL_TEXTURE_2D_ARRAY
+        GLenum GetTarget() const;
+        uint32_t GetLayers() const;
+        TextureFormat GetFormat() const;
+        uint32_t GetWidth() const;
+        uint32_t GetHeight() const;
+        uint32_t GetMipLevels() const;
+
+        // Index of the texture inside the TextureStreamer, -1 when not streamed
+        int32_t GetStreamingHandle() const;
+        void SetStreamingHandle(int32_t handle);
+
+    private:
+        void Release();
+
+        GLuint m_textureID = 0;
+        GLenum m_target = GL_TEXTURE_2D;
+        uint32_t m_layers = 1;
+        TextureFormat m_format = TextureFormat::RGBA8;
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+        uint32_t m_mipLevels = 1;
+        int32_t m_streamingHandle = -1;
+    };
+}
\ No newline at end of file
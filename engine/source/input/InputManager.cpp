@@ -1,23 +1,323 @@
 #include "input/InputManager.h"
+#include <chrono>
 
 namespace eng
 {
-    void InputManager::SetKeyPressed(int key, bool pressed)
+    bool InputState::IsGamepadConnected(int gamepad) const
     {
-        if (key < 0 || key >= static_cast<int>(m_keys.size()))
+        return gamepad >= 0 && gamepad < GamepadCount && gamepads[gamepad].connected;
+    }
+
+    bool InputState::IsGamepadButtonDown(int gamepad, int button) const
+    {
+        return IsGamepadConnected(gamepad) && Button(gamepads[gamepad].buttons.data(), GamepadButtonCount, button,
+            Down);
+    }
+
+    bool InputState::WasGamepadButtonPressed(int gamepad, int button) const
+    {
+        return IsGamepadConnected(gamepad) && Button(gamepads[gamepad].buttons.data(), GamepadButtonCount, button,
+            Pressed);
+    }
+
+    bool InputState::WasGamepadButtonReleased(int gamepad, int button) const
+    {
+        // A gamepad unplugged this frame still reports what it released
+        return gamepad >= 0 && gamepad < GamepadCount
+            && Button(gamepads[gamepad].buttons.data(), GamepadButtonCount, button, Released);
+    }
+
+    float InputState::GetGamepadAxis(int gamepad, int axis) const
+    {
+        if (!IsGamepadConnected(gamepad) || axis < 0 || axis >= GamepadAxisCount)
+        {
+            return 0.0f;
+        }
+        return gamepads[gamepad].axes[axis];
+    }
+
+    namespace
+    {
+        void ApplyButton(uint8_t& button, bool pressed, bool trackEdges)
+        {
+            if (pressed)
+            {
+                button |= InputState::Down | (trackEdges ? InputState::Pressed : 0);
+            }
+            else
+            {
+                button &= ~InputState::Down;
+                button |= trackEdges ? InputState::Released : 0;
+            }
+        }
+    }
+
+    void InputState::Apply(const InputEvent& event, bool trackEdges)
+    {
+        switch (event.type)
+        {
+        case InputEventType::Key:
+            if (event.code >= 0 && event.code < KeyCount)
+            {
+                ApplyButton(keys[event.code], event.pressed, trackEdges);
+            }
+            break;
+        case InputEventType::MouseButton:
+            if (event.code >= 0 && event.code < MouseButtonCount)
+            {
+                ApplyButton(mouseButtons[event.code], event.pressed, trackEdges);
+            }
+            break;
+        case InputEventType::MouseMove:
+            if (trackEdges)
+            {
+                mouseDeltaX += event.x - mouseX;
+                mouseDeltaY += event.y - mouseY;
+            }
+            mouseX = event.x;
+            mouseY = event.y;
+            break;
+        case InputEventType::MouseScroll:
+            if (trackEdges)
+            {
+                scrollX += event.x;
+                scrollY += event.y;
+            }
+            break;
+        case InputEventType::GamepadConnected:
+        case InputEventType::GamepadDisconnected:
+            if (event.device < GamepadCount)
+            {
+                Gamepad& gamepad = gamepads[event.device];
+                gamepad.connected = event.type == InputEventType::GamepadConnected;
+                for (uint8_t& button : gamepad.buttons)
+                {
+                    if (button & Down)
+                    {
+                        ApplyButton(button, false, trackEdges);
+                    }
+                }
+                gamepad.axes.fill(0.0f);
+            }
+            break;
+        case InputEventType::GamepadButton:
+            if (event.device < GamepadCount && event.code >= 0 && event.code < GamepadButtonCount)
+            {
+                ApplyButton(gamepads[event.device].buttons[event.code], event.pressed, trackEdges);
+            }
+            break;
+        case InputEventType::GamepadAxis:
+            if (event.device < GamepadCount && event.code >= 0 && event.code < GamepadAxisCount)
+            {
+                gamepads[event.device].axes[event.code] = event.x;
+            }
+            break;
+        }
+    }
+
+    void InputState::ClearEdges()
+    {
+        const uint8_t held = Down;
+        for (uint8_t& key : keys)
+        {
+            key &= held;
+        }
+        for (uint8_t& button : mouseButtons)
+        {
+            button &= held;
+        }
+        for (Gamepad& gamepad : gamepads)
+        {
+            for (uint8_t& button : gamepad.buttons)
+            {
+                button &= held;
+            }
+        }
+        mouseDeltaX = 0.0f;
+        mouseDeltaY = 0.0f;
+        scrollX = 0.0f;
+        scrollY = 0.0f;
+    }
+
+    double InputManager::Now()
+    {
+        return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    void InputManager::PushKey(int key, bool pressed)
+    {
+        InputEvent event;
+        event.type = InputEventType::Key;
+        event.code = key;
+        event.pressed = pressed;
+        PushEvent(event);
+    }
+
+    void InputManager::PushMouseButton(int button, bool pressed)
+    {
+        InputEvent event;
+        event.type = InputEventType::MouseButton;
+        event.code = button;
+        event.pressed = pressed;
+        PushEvent(event);
+    }
+
+    void InputManager::PushMouseMove(float x, float y)
+    {
+        InputEvent event;
+        event.type = InputEventType::MouseMove;
+        event.x = x;
+        event.y = y;
+        PushEvent(event);
+    }
+
+    void InputManager::PushScroll(float x, float y)
+    {
+        InputEvent event;
+        event.type = InputEventType::MouseScroll;
+        event.x = x;
+        event.y = y;
+        PushEvent(event);
+    }
+
+    void InputManager::PushEvent(const InputEvent& event)
+    {
+        InputEvent stamped = event;
+        if (stamped.time <= 0.0)
+        {
+            stamped.time = Now();
+        }
+        if (!m_queue.Push(stamped))
         {
-            return;
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
         }
-        m_keys[key] = pressed;
     }
 
-    bool InputManager::IsKeyPressed(int key)
+    bool InputManager::UpdateGamepad(int gamepad, const unsigned char* buttons, const float* axes)
     {
-        if (key < 0 || key >= static_cast<int>(m_keys.size()))
+        if (gamepad < 0 || gamepad >= InputState::GamepadCount)
         {
             return false;
         }
 
-        return m_keys[key];
+        InputState::Gamepad& polled = m_polledGamepads[gamepad];
+        InputEvent event;
+        event.time = Now();
+        event.device = static_cast<uint8_t>(gamepad);
+        const bool connected = buttons && axes;
+        bool changed = false;
+        if (connected != polled.connected)
+        {
+            event.type = connected ? InputEventType::GamepadConnected : InputEventType::GamepadDisconnected;
+            PushEvent(event);
+            polled = InputState::Gamepad();
+            polled.connected = connected;
+            changed = true;
+            if (!connected)
+            {
+                return true;
+            }
+        }
+        else if (!connected)
+        {
+            return false;
+        }
+
+        event.type = InputEventType::GamepadButton;
+        for (int i = 0; i < InputState::GamepadButtonCount; ++i)
+        {
+            const bool pressed = buttons[i] != 0;
+            if (pressed != ((polled.buttons[i] & InputState::Down) != 0))
+            {
+                polled.buttons[i] = pressed ? InputState::Down : 0;
+                event.code = i;
+                event.pressed = pressed;
+                PushEvent(event);
+                changed = true;
+            }
+        }
+        event.type = InputEventType::GamepadAxis;
+        event.pressed = false;
+        for (int i = 0; i < InputState::GamepadAxisCount; ++i)
+        {
+            if (axes[i] != polled.axes[i])
+            {
+                polled.axes[i] = axes[i];
+                event.code = i;
+                event.x = axes[i];
+                PushEvent(event);
+                changed = true;
+            }
+        }
+        return changed;
+    }
+
+    size_t InputManager::GetDroppedEventCount() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    const InputState& InputManager::GetState() const
+    {
+        return m_frame;
+    }
+
+    bool InputManager::IsKeyDown(int key) const
+    {
+        return m_frame.IsKeyDown(key);
+    }
+
+    bool InputManager::WasKeyPressed(int key) const
+    {
+        return m_frame.WasKeyPressed(key);
+    }
+
+    bool InputManager::WasKeyReleased(int key) const
+    {
+        return m_frame.WasKeyReleased(key);
+    }
+
+    const std::vector<InputEvent>& InputManager::GetFrameEvents() const
+    {
+        return m_frameEvents;
+    }
+
+    double InputManager::GetFrameEventTime() const
+    {
+        return m_frameEventTime;
+    }
+
+    const InputState& InputManager::GetLatestState() const
+    {
+        return m_latest;
+    }
+
+    void InputManager::BeginFrame()
+    {
+        Sample();
+
+        m_frame.ClearEdges();
+        m_frameEventTime = -1.0;
+        for (const InputEvent& event : m_pendingEvents)
+        {
+            m_frame.Apply(event, true);
+            // Producers on several threads may queue slightly out of timestamp order
+            if (m_frameEventTime < 0.0 || event.time < m_frameEventTime)
+            {
+                m_frameEventTime = event.time;
+            }
+        }
+        m_frameEvents.swap(m_pendingEvents);
+        m_pendingEvents.clear();
+    }
+
+    void InputManager::Sample()
+    {
+        InputEvent event;
+        while (m_queue.Pop(event))
+        {
+            m_latest.Apply(event, false);
+            m_pendingEvents.push_back(event);
+        }
     }
 }
\ No newline at end of file
@@ -1,8 +1,80 @@
 #pragma once
+#include "input/InputQueue.h"
 #include <array>
+#include <atomic>
+#include <vector>
 
 namespace eng
 {
+    // Buttons report held state plus the edges of one frame, so a press and release between two frames still
+    // shows as pressed and released
+    struct InputState
+    {
+        static constexpr int KeyCount = 512;
+        static constexpr int MouseButtonCount = 8;
+        static constexpr int GamepadCount = 16;
+        static constexpr int GamepadButtonCount = 15;
+        static constexpr int GamepadAxisCount = 6;
+
+        enum ButtonFlags : uint8_t
+        {
+            Down = 1,
+            Pressed = 2,
+            Released = 4
+        };
+
+        struct Gamepad
+        {
+            bool connected = false;
+            std::array<uint8_t, GamepadButtonCount> buttons = {};
+            std::array<float, GamepadAxisCount> axes = {};
+        };
+
+        bool IsKeyDown(int key) const { return Button(keys.data(), KeyCount, key, Down); }
+        bool WasKeyPressed(int key) const { return Button(keys.data(), KeyCount, key, Pressed); }
+        bool WasKeyReleased(int key) const { return Button(keys.data(), KeyCount, key, Released); }
+        bool IsMouseButtonDown(int button) const { return Button(mouseButtons.data(), MouseButtonCount, button, Down); }
+        bool WasMouseButtonPressed(int button) const
+        {
+            return Button(mouseButtons.data(), MouseButtonCount, button, Pressed);
+        }
+        bool WasMouseButtonReleased(int button) const
+        {
+            return Button(mouseButtons.data(), MouseButtonCount, button, Released);
+        }
+        bool IsGamepadConnected(int gamepad) const;
+        bool IsGamepadButtonDown(int gamepad, int button) const;
+        bool WasGamepadButtonPressed(int gamepad, int button) const;
+        bool WasGamepadButtonReleased(int gamepad, int button) const;
+        // 0 for unknown gamepads and axes
+        float GetGamepadAxis(int gamepad, int axis) const;
+
+        // Applies one event, edges and deltas only add up when trackEdges is set
+        void Apply(const InputEvent& event, bool trackEdges);
+        // Keeps held state, forgets edges and deltas
+        void ClearEdges();
+
+        std::array<uint8_t, KeyCount> keys = {};
+        std::array<uint8_t, MouseButtonCount> mouseButtons = {};
+        float mouseX = 0.0f;
+        float mouseY = 0.0f;
+        float mouseDeltaX = 0.0f;
+        float mouseDeltaY = 0.0f;
+        float scrollX = 0.0f;
+        float scrollY = 0.0f;
+        std::array<Gamepad, GamepadCount> gamepads;
+
+    private:
+        static bool Button(const uint8_t* buttons, int count, int index, uint8_t flag)
+        {
+            return index >= 0 && index < count && (buttons[index] & flag) != 0;
+        }
+    };
+
+    // Window callbacks and pollers push timestamped events into a lock-free queue, from any thread. The input
+    // stage turns the events since the last frame into the frame's state, which stays fixed while the frame
+    // is simulated. The main thread can sample again later in the frame (Engine does so right before submit)
+    // for state that has to be as fresh as possible when rendering.
     class InputManager
     {
     private:
@@ -13,11 +85,51 @@ namespace eng
         InputManager& operator=(InputManager&&) = delete;
 
     public:
-        void SetKeyPressed(int key, bool pressed);
-        bool IsKeyPressed(int key);
+        // Steady clock seconds, the time base of event timestamps
+        static double Now();
+
+        // Producers, callable from any thread
+        void PushKey(int key, bool pressed);
+        void PushMouseButton(int button, bool pressed);
+        void PushMouseMove(float x, float y);
+        void PushScroll(float x, float y);
+        void PushEvent(const InputEvent& event);
+        // Polled gamepads report their whole state, events are pushed for what changed since the last call.
+        // buttons and axes are nullptr for a disconnected gamepad. One polling thread only. Returns whether
+        // anything changed.
+        bool UpdateGamepad(int gamepad, const unsigned char* buttons, const float* axes);
+        size_t GetDroppedEventCount() const;
+
+        // State as of the start of the frame, stable while the frame is simulated. Read edges in Update:
+        // FixedUpdate may run several times, or not at all, in one frame.
+        const InputState& GetState() const;
+        bool IsKeyDown(int key) const;
+        bool WasKeyPressed(int key) const;
+        bool WasKeyReleased(int key) const;
+        // The events that make up this frame's state, in the order they were queued
+        const std::vector<InputEvent>& GetFrameEvents() const;
+        // Timestamp of the oldest event in this frame, negative without events
+        double GetFrameEventTime() const;
+
+        // Main thread only: held state including events sampled after the frame began. Those events become
+        // part of the next frame's edges.
+        const InputState& GetLatestState() const;
 
     private:
-        std::array<bool, 256> m_keys = { false };
+        // Input stage: moves the queued and late sampled events into the frame state
+        void BeginFrame();
+        // Drains the queue into the latest state
+        void Sample();
+
+        InputQueue m_queue;
+        std::atomic<size_t> m_dropped{ 0 };
+        std::array<InputState::Gamepad, InputState::GamepadCount> m_polledGamepads;
+
+        InputState m_latest;
+        std::vector<InputEvent> m_pendingEvents;
+        InputState m_frame;
+        std::vector<InputEvent> m_frameEvents;
+        double m_frameEventTime = -1.0;
         friend class Engine;
     };
 }
\ No newline at end of file
@@ -0,0 +1,112 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+
+namespace eng
+{
+    enum class InputEventType : uint8_t
+    {
+        Key,
+        MouseButton,
+        MouseMove,
+        MouseScroll,
+        GamepadConnected,
+        GamepadDisconnected,
+        GamepadButton,
+        GamepadAxis
+    };
+
+    struct InputEvent
+    {
+        // Seconds on the steady clock, see InputManager::Now
+        double time = 0.0;
+        InputEventType type = InputEventType::Key;
+        // Gamepad index
+        uint8_t device = 0;
+        bool pressed = false;
+        // Key, button or axis
+        int code = 0;
+        // Cursor position, scroll offset, or the axis value in x
+        float x = 0.0f;
+        float y = 0.0f;
+    };
+
+    // Bounded queue any number of threads push into and one thread pops from. Every slot carries a sequence
+    // number, so pushes only contend on the tail index and never wait for each other.
+    class InputQueue
+    {
+    public:
+        static constexpr size_t Capacity = 1024;
+
+        InputQueue() : m_slots(new Slot[Capacity])
+        {
+            for (size_t i = 0; i < Capacity; ++i)
+            {
+                m_slots[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        InputQueue(const InputQueue&) = delete;
+        InputQueue& operator=(const InputQueue&) = delete;
+
+        // false when the consumer fell a whole capacity behind, the event is dropped
+        bool Push(const InputEvent& event)
+        {
+            size_t position = m_tail.load(std::memory_order_relaxed);
+            Slot* slot;
+            while (true)
+            {
+                slot = &m_slots[position & (Capacity - 1)];
+                const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+                const intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+                if (difference == 0)
+                {
+                    if (m_tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+                    {
+                        break;
+                    }
+                }
+                else if (difference < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = m_tail.load(std::memory_order_relaxed);
+                }
+            }
+            slot->event = event;
+            slot->sequence.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Consumer thread only
+        bool Pop(InputEvent& event)
+        {
+            Slot& slot = m_slots[m_head & (Capacity - 1)];
+            if (slot.sequence.load(std::memory_order_acquire) != m_head + 1)
+            {
+                return false;
+            }
+            event = slot.event;
+            slot.sequence.store(m_head + Capacity, std::memory_order_release);
+            ++m_head;
+            return true;
+        }
+
+    private:
+        static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+        struct Slot
+        {
+            std::atomic<size_t> sequence;
+            InputEvent event;
+        };
+
+        std::unique_ptr<Slot[]> m_slots;
+        alignas(64) std::atomic<size_t> m_tail{ 0 };
+        alignas(64) size_t m_head = 0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,418 @@
+#include "io/Json.h"
+#include <charconv>
+#include <climits>
+#include <cstring>
+#include <system_error>
+#include <stdint.h>
+
+namespace eng
+{
+    class JsonParser
+    {
+    public:
+        JsonParser(const char* text, size_t length) : m_cur(text), m_end(text + length)
+        {
+        }
+
+        bool ParseDocument(JsonValue& out)
+        {
+            if (!ParseValue(out, 0))
+            {
+                return false;
+            }
+            SkipWhitespace();
+            return m_cur == m_end || Fail("Trailing characters");
+        }
+
+        const char* GetError() const
+        {
+            return m_error;
+        }
+
+    private:
+        static constexpr int MaxDepth = 256;
+
+        bool Fail(const char* message)
+        {
+            m_error = message;
+            return false;
+        }
+
+        void SkipWhitespace()
+        {
+            while (m_cur < m_end && (*m_cur == ' ' || *m_cur == '\t' || *m_cur == '\n' || *m_cur == '\r'))
+            {
+                ++m_cur;
+            }
+        }
+
+        bool Match(const char* literal)
+        {
+            size_t length = strlen(literal);
+            if (static_cast<size_t>(m_end - m_cur) < length || memcmp(m_cur, literal, length) != 0)
+            {
+                return false;
+            }
+            m_cur += length;
+            return true;
+        }
+
+        bool ParseValue(JsonValue& out, int depth)
+        {
+            if (depth > MaxDepth)
+            {
+                return Fail("Nesting too deep");
+            }
+
+            SkipWhitespace();
+            if (m_cur >= m_end)
+            {
+                return Fail("Unexpected end of input");
+            }
+
+            switch (*m_cur)
+            {
+            case '{':
+                return ParseObject(out, depth);
+            case '[':
+                return ParseArray(out, depth);
+            case '"':
+                out.m_type = JsonValue::Type::String;
+                return ParseString(out.m_string);
+            case 't':
+                out.m_type = JsonValue::Type::Bool;
+                out.m_bool = true;
+                return Match("true") || Fail("Invalid literal");
+            case 'f':
+                out.m_type = JsonValue::Type::Bool;
+                out.m_bool = false;
+                return Match("false") || Fail("Invalid literal");
+            case 'n':
+                out.m_type = JsonValue::Type::Null;
+                return Match("null") || Fail("Invalid literal");
+            default:
+                return ParseNumber(out);
+            }
+        }
+
+        bool ParseNumber(JsonValue& out)
+        {
+            // from_chars always uses '.', unlike strtod it does not depend on the C locale
+            const char* begin = m_cur;
+            while (m_cur < m_end && *m_cur != '\0' && strchr("+-0123456789.eE", *m_cur))
+            {
+                ++m_cur;
+            }
+
+            auto result = std::from_chars(begin, m_cur, out.m_number);
+            out.m_type = JsonValue::Type::Number;
+            return (begin != m_cur && result.ec == std::errc() && result.ptr == m_cur) || Fail("Invalid number");
+        }
+
+        static void AppendUtf8(std::string& out, uint32_t codepoint)
+        {
+            if (codepoint < 0x80)
+            {
+                out += static_cast<char>(codepoint);
+            }
+            else if (codepoint < 0x800)
+            {
+                out += static_cast<char>(0xC0 | (codepoint >> 6));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            }
+            else if (codepoint < 0x10000)
+            {
+                out += static_cast<char>(0xE0 | (codepoint >> 12));
+                out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            }
+            else
+            {
+                out += static_cast<char>(0xF0 | (codepoint >> 18));
+                out += static_cast<char>(0x80 | ((codepoint >> 12) & 0x3F));
+                out += static_cast<char>(0x80 | ((codepoint >> 6) & 0x3F));
+                out += static_cast<char>(0x80 | (codepoint & 0x3F));
+            }
+        }
+
+        bool ParseHex4(uint32_t& out)
+        {
+            if (m_end - m_cur < 4)
+            {
+                return Fail("Invalid escape");
+            }
+            out = 0;
+            for (int i = 0; i < 4; ++i)
+            {
+                char c = *m_cur++;
+                out <<= 4;
+                if (c >= '0' && c <= '9') out |= c - '0';
+                else if (c >= 'a' && c <= 'f') out |= c - 'a' + 10;
+                else if (c >= 'A' && c <= 'F') out |= c - 'A' + 10;
+                else return Fail("Invalid escape");
+            }
+            return true;
+        }
+
+        bool ParseString(std::string& out)
+        {
+            ++m_cur; // opening quote
+            out.clear();
+            while (m_cur < m_end)
+            {
+                char c = *m_cur++;
+                if (c == '"')
+                {
+                    return true;
+                }
+                if (c != '\\')
+                {
+                    out += c;
+                    continue;
+                }
+                if (m_cur >= m_end)
+                {
+                    break;
+                }
+                char escape = *m_cur++;
+                switch (escape)
+                {
+                case '"': out += '"'; break;
+                case '\\': out += '\\'; break;
+                case '/': out += '/'; break;
+                case 'b': out += '\b'; break;
+                case 'f': out += '\f'; break;
+                case 'n': out += '\n'; break;
+                case 'r': out += '\r'; break;
+                case 't': out += '\t'; break;
+                case 'u':
+                {
+                    uint32_t codepoint = 0;
+                    if (!ParseHex4(codepoint))
+                    {
+                        return false;
+                    }
+                    if (codepoint >= 0xD800 && codepoint <= 0xDBFF && Match("\\u"))
+                    {
+                        uint32_t low = 0;
+                        if (!ParseHex4(low))
+                        {
+                            return false;
+                        }
+                        codepoint = 0x10000 + ((codepoint - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    AppendUtf8(out, codepoint);
+                    break;
+                }
+                default:
+                    return Fail("Invalid escape");
+                }
+            }
+            return Fail("Unterminated string");
+        }
+
+        bool ParseArray(JsonValue& out, int depth)
+        {
+            ++m_cur;
+            out.m_type = JsonValue::Type::Array;
+            SkipWhitespace();
+            if (m_cur < m_end && *m_cur == ']')
+            {
+                ++m_cur;
+                return true;
+            }
+            while (true)
+            {
+                out.m_array.emplace_back();
+                if (!ParseValue(out.m_array.back(), depth + 1))
+                {
+                    return false;
+                }
+                SkipWhitespace();
+                if (m_cur < m_end && *m_cur == ',')
+                {
+                    ++m_cur;
+                    continue;
+                }
+                if (m_cur < m_end && *m_cur == ']')
+                {
+                    ++m_cur;
+                    return true;
+                }
+                return Fail("Expected ',' or ']'");
+            }
+        }
+
+        bool ParseObject(JsonValue& out, int depth)
+        {
+            ++m_cur;
+            out.m_type = JsonValue::Type::Object;
+            SkipWhitespace();
+            if (m_cur < m_end && *m_cur == '}')
+            {
+                ++m_cur;
+                return true;
+            }
+            while (true)
+            {
+                SkipWhitespace();
+                if (m_cur >= m_end || *m_cur != '"')
+                {
+                    return Fail("Expected member name");
+                }
+                out.m_object.emplace_back();
+                auto& member = out.m_object.back();
+                if (!ParseString(member.first))
+                {
+                    return false;
+                }
+                SkipWhitespace();
+                if (m_cur >= m_end || *m_cur != ':')
+                {
+                    return Fail("Expected ':'");
+                }
+                ++m_cur;
+                if (!ParseValue(member.second, depth + 1))
+                {
+                    return false;
+                }
+                SkipWhitespace();
+                if (m_cur < m_end && *m_cur == ',')
+                {
+                    ++m_cur;
+                    continue;
+                }
+                if (m_cur < m_end && *m_cur == '}')
+                {
+                    ++m_cur;
+                    return true;
+                }
+                return Fail("Expected ',' or '}'");
+            }
+        }
+
+        const char* m_cur;
+        const char* m_end;
+        const char* m_error = "";
+    };
+
+    bool JsonValue::Parse(const char* text, size_t length, JsonValue& out, std::string* error)
+    {
+        out = JsonValue();
+        JsonParser parser(text, length);
+        if (!parser.ParseDocument(out))
+        {
+            if (error)
+            {
+                *error = parser.GetError();
+            }
+            return false;
+        }
+        return true;
+    }
+
+    JsonValue::Type JsonValue::GetType() const
+    {
+        return m_type;
+    }
+
+    bool JsonValue::IsNull() const
+    {
+        return m_type == Type::Null;
+    }
+
+    bool JsonValue::IsNumber() const
+    {
+        return m_type == Type::Number;
+    }
+
+    bool JsonValue::IsString() const
+    {
+        return m_type == Type::String;
+    }
+
+    bool JsonValue::IsArray() const
+    {
+        return m_type == Type::Array;
+    }
+
+    bool JsonValue::IsObject() const
+    {
+        return m_type == Type::Object;
+    }
+
+    bool JsonValue::AsBool(bool fallback) const
+    {
+        return m_type == Type::Bool ? m_bool : fallback;
+    }
+
+    double JsonValue::AsNumber(double fallback) const
+    {
+        return m_type == Type::Number ? m_number : fallback;
+    }
+
+    int JsonValue::AsInt(int fallback) const
+    {
+        // Casting a double outside the int range is undefined
+        if (m_type != Type::Number || !(m_number >= INT_MIN && m_number <= INT_MAX))
+        {
+            return fallback;
+        }
+        return static_cast<int>(m_number);
+    }
+
+    const std::string& JsonValue::AsString() const
+    {
+        static const std::string empty;
+        return m_type == Type::String ? m_string : empty;
+    }
+
+    size_t JsonValue::Size() const
+    {
+        if (m_type == Type::Array)
+        {
+            return m_array.size();
+        }
+        if (m_type == Type::Object)
+        {
+            return m_object.size();
+        }
+        return 0;
+    }
+
+    const JsonValue& JsonValue::operator[](size_t index) const
+    {
+        static const JsonValue null;
+        if (m_type != Type::Array || index >= m_array.size())
+        {
+            return null;
+        }
+        return m_array[index];
+    }
+
+    const JsonValue& JsonValue::operator[](const std::string& key) const
+    {
+        static const JsonValue null;
+        if (m_type == Type::Object)
+        {
+            for (auto& member : m_object)
+            {
+                if (member.first == key)
+                {
+                    return member.second;
+                }
+            }
+        }
+        return null;
+    }
+
+    bool JsonValue::Has(const std::string& key) const
+    {
+        return !(*this)[key].IsNull();
+    }
+
+    const std::vector<std::pair<std::string, JsonValue>>& JsonValue::GetMembers() const
+    {
+        return m_object;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,54 @@
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace eng
+{
+    // Minimal DOM for the JSON documents the engine reads (glTF headers, configs)
+    class JsonValue
+    {
+    public:
+        enum class Type
+        {
+            Null,
+            Bool,
+            Number,
+            String,
+            Array,
+            Object
+        };
+
+        static bool Parse(const char* text, size_t length, JsonValue& out, std::string* error = nullptr);
+
+        Type GetType() const;
+        bool IsNull() const;
+        bool IsNumber() const;
+        bool IsString() const;
+        bool IsArray() const;
+        bool IsObject() const;
+
+        bool AsBool(bool fallback = false) const;
+        double AsNumber(double fallback = 0.0) const;
+        // Numbers outside the int range also yield the fallback
+        int AsInt(int fallback = 0) const;
+        const std::string& AsString() const;
+
+        size_t Size() const;
+        // Out of range or missing members yield a shared null value
+        const JsonValue& operator[](size_t index) const;
+        const JsonValue& operator[](const std::string& key) const;
+        bool Has(const std::string& key) const;
+        const std::vector<std::pair<std::string, JsonValue>>& GetMembers() const;
+
+    private:
+        friend class JsonParser;
+
+        Type m_type = Type::Null;
+        bool m_bool = false;
+        double m_number = 0.0;
+        std::string m_string;
+        std::vector<JsonValue> m_array;
+        std::vector<std::pair<std::string, JsonValue>> m_object;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#pragma once
+#include <string>
+#include <stddef.h>
+#include <stdint.h>
+
+namespace eng
+{
+    // Read-only memory mapping of a whole file.
+    class MappedFile
+    {
+    public:
+        MappedFile() = default;
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+        ~MappedFile();
+
+        bool Open(const std::string& path);
+        void Close();
+
+        bool IsOpen() const;
+        const uint8_t* GetData() const;
+        size_t GetSize() const;
+
+    private:
+        const uint8_t* m_data = nullptr;
+        size_t m_size = 0;
+#if defined(_WIN32)
+        void* m_fileHandle = nullptr;
+        void* m_mappingHandle = nullptr;
+#endif
+    };
+}
\ No newline at end of file
@@ -0,0 +1,182 @@
+#include "jobs/Fiber.h"
+#include <stdint.h>
+#include <iostream>
+
+#if defined(ENG_FIBER_WINDOWS)
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+#if defined(ENG_FIBER_X86_64)
+// Callee saved registers, MXCSR and the x87 control word go on the old stack, then the stack pointers are
+// exchanged. The first switch into a fiber "returns" into eng_fiber_start, which calls entry(argument) from
+// r13 and r12.
+asm(R"(
+    .text
+    .globl eng_switch_fiber_context
+    .type eng_switch_fiber_context, @function
+eng_switch_fiber_context:
+    pushq %rbp
+    pushq %rbx
+    pushq %r12
+    pushq %r13
+    pushq %r14
+    pushq %r15
+    subq $8, %rsp
+    stmxcsr (%rsp)
+    fnstcw 4(%rsp)
+    movq %rsp, (%rdi)
+    movq %rsi, %rsp
+    ldmxcsr (%rsp)
+    fldcw 4(%rsp)
+    addq $8, %rsp
+    popq %r15
+    popq %r14
+    popq %r13
+    popq %r12
+    popq %rbx
+    popq %rbp
+    ret
+    .size eng_switch_fiber_context, .-eng_switch_fiber_context
+
+    .globl eng_fiber_start
+    .type eng_fiber_start, @function
+eng_fiber_start:
+    movq %r12, %rdi
+    callq *%r13
+    ud2
+    .size eng_fiber_start, .-eng_fiber_start
+)");
+
+extern "C" void eng_switch_fiber_context(void** from, void* to);
+extern "C" void eng_fiber_start();
+#endif
+
+namespace eng
+{
+#if !defined(ENG_FIBER_WINDOWS)
+    namespace
+    {
+        // Stack memory with an inaccessible page below it, so an overflow faults instead of corrupting the
+        // neighbouring fiber
+        void* AllocateStack(size_t& stackBytes)
+        {
+            const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            stackBytes = (stackBytes + page - 1) / page * page;
+            void* memory = mmap(nullptr, stackBytes + page, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS,
+                -1, 0);
+            if (memory == MAP_FAILED)
+            {
+                return nullptr;
+            }
+            mprotect(memory, page, PROT_NONE);
+            return static_cast<uint8_t*>(memory) + page;
+        }
+
+        void FreeStack(void* stack, size_t stackBytes)
+        {
+            const size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+            munmap(static_cast<uint8_t*>(stack) - page, stackBytes + page);
+        }
+
+#if defined(ENG_FIBER_UCONTEXT)
+        // makecontext only passes ints, the pointers travel in halves
+        void UcontextStart(unsigned int entryLow, unsigned int entryHigh, unsigned int argumentLow,
+            unsigned int argumentHigh)
+        {
+            auto entry = reinterpret_cast<FiberEntry>((uintptr_t(entryHigh) << 32) | entryLow);
+            auto argument = reinterpret_cast<void*>((uintptr_t(argumentHigh) << 32) | argumentLow);
+            entry(argument);
+        }
+#endif
+    }
+#endif
+
+    bool CreateFiberContext(FiberContext& context, size_t stackBytes, FiberEntry entry, void* argument)
+    {
+#if defined(ENG_FIBER_WINDOWS)
+        context.fiber = CreateFiber(stackBytes, reinterpret_cast<LPFIBER_START_ROUTINE>(entry), argument);
+        if (!context.fiber)
+        {
+            std::cerr << "ERROR: CreateFiber failed" << std::endl;
+            return false;
+        }
+        return true;
+#else
+        context.stackBytes = stackBytes;
+        context.stack = AllocateStack(context.stackBytes);
+        if (!context.stack)
+        {
+            std::cerr << "ERROR: could not allocate a fiber stack" << std::endl;
+            return false;
+        }
+
+#if defined(ENG_FIBER_X86_64)
+        // Frame popped by the first switch: control words, r15 r14 r13 r12 rbx rbp, return address
+        uintptr_t top = (reinterpret_cast<uintptr_t>(context.stack) + context.stackBytes) & ~uintptr_t(15);
+        uint64_t* frame = reinterpret_cast<uint64_t*>(top - 80);
+        frame[0] = 0x1F80 | (uint64_t(0x037F) << 32);
+        frame[1] = 0;
+        frame[2] = 0;
+        frame[3] = reinterpret_cast<uint64_t>(entry);
+        frame[4] = reinterpret_cast<uint64_t>(argument);
+        frame[5] = 0;
+        frame[6] = 0;
+        frame[7] = reinterpret_cast<uint64_t>(&eng_fiber_start);
+        context.stackPointer = frame;
+#else
+        getcontext(&context.context);
+        context.context.uc_stack.ss_sp = context.stack;
+        context.context.uc_stack.ss_size = context.stackBytes;
+        context.context.uc_link = nullptr;
+        const uintptr_t entryBits = reinterpret_cast<uintptr_t>(entry);
+        const uintptr_t argumentBits = reinterpret_cast<uintptr_t>(argument);
+        makecontext(&context.context, reinterpret_cast<void (*)()>(&UcontextStart), 4,
+            static_cast<unsigned int>(entryBits), static_cast<unsigned int>(uint64_t(entryBits) >> 32),
+            static_cast<unsigned int>(argumentBits), static_cast<unsigned int>(uint64_t(argumentBits) >> 32));
+#endif
+        return true;
+#endif
+    }
+
+    void DestroyFiberContext(FiberContext& context)
+    {
+#if defined(ENG_FIBER_WINDOWS)
+        if (context.fiber)
+        {
+            DeleteFiber(context.fiber);
+            context.fiber = nullptr;
+        }
+#else
+        if (context.stack)
+        {
+            FreeStack(context.stack, context.stackBytes);
+            context.stack = nullptr;
+        }
+#endif
+    }
+
+    void PrepareThreadFiberContext(FiberContext& context)
+    {
+#if defined(ENG_FIBER_WINDOWS)
+        context.fiber = IsThreadAFiber() ? GetCurrentFiber() : ConvertThreadToFiber(nullptr);
+#else
+        // Filled in by the first switch away from the thread
+        (void)context;
+#endif
+    }
+
+    void SwitchFiberContext(FiberContext& from, FiberContext& to)
+    {
+#if defined(ENG_FIBER_WINDOWS)
+        (void)from;
+        SwitchToFiber(to.fiber);
+#elif defined(ENG_FIBER_X86_64)
+        eng_switch_fiber_context(&from.stackPointer, to.stackPointer);
+#else
+        swapcontext(&from.context, &to.context);
+#endif
+    }
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+#include <stddef.h>
+
+#if defined(_WIN32)
+#define ENG_FIBER_WINDOWS
+#elif defined(__x86_64__) && defined(__ELF__)
+#define ENG_FIBER_X86_64
+#else
+#define ENG_FIBER_UCONTEXT
+#include <ucontext.h>
+#endif
+
+namespace eng
+{
+    // A saved execution context with its own stack. Threads get one too (PrepareThreadFiberContext) so they
+    // can switch into a fiber and be switched back to.
+    struct FiberContext
+    {
+#if defined(ENG_FIBER_WINDOWS)
+        void* fiber = nullptr;
+#elif defined(ENG_FIBER_X86_64)
+        void* stackPointer = nullptr;
+        void* stack = nullptr;
+        size_t stackBytes = 0;
+#else
+        ucontext_t context;
+        void* stack = nullptr;
+        size_t stackBytes = 0;
+#endif
+    };
+
+    using FiberEntry = void (*)(void* argument);
+
+    // The stack gets a guard page below it where the platform allows. entry must never return, it switches
+    // away instead.
+    bool CreateFiberContext(FiberContext& context, size_t stackBytes, FiberEntry entry, void* argument);
+    void DestroyFiberContext(FiberContext& context);
+    // Makes the calling thread a valid switch source and target
+    void PrepareThreadFiberContext(FiberContext& context);
+    // Saves the current context into from and resumes to
+    void SwitchFiberContext(FiberContext& from, FiberContext& to);
+}
\ No newline at end of file
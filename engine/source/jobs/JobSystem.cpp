@@ -0,0 +1,483 @@
+#include "jobs/JobSystem.h"
+#include "profile/Profiler.h"
+
+#if defined(_MSC_VER)
+#define ENG_NOINLINE __declspec(noinline)
+#else
+#define ENG_NOINLINE __attribute__((noinline))
+#endif
+
+namespace eng
+{
+    namespace
+    {
+        struct ThreadData
+        {
+            const JobSystem* system = nullptr;
+            int threadIndex = -1;
+            uint32_t externalRandom = 0x9E3779B9u;
+            FiberContext schedulerContext;
+            bool schedulerPrepared = false;
+            JobFiber* fiber = nullptr;
+        };
+
+        thread_local ThreadData t_thread;
+
+        // A fiber may continue on another thread after a switch, so the address of the thread locals must be
+        // looked up again every time instead of being kept by the compiler
+        ENG_NOINLINE ThreadData& CurrentThread()
+        {
+#if !defined(_MSC_VER)
+            asm volatile("");
+#endif
+            return t_thread;
+        }
+
+        uint32_t NextRandom(uint32_t& state)
+        {
+            state ^= state << 13;
+            state ^= state >> 17;
+            state ^= state << 5;
+            return state;
+        }
+    }
+
+    JobSystem::~JobSystem()
+    {
+        Shutdown();
+    }
+
+    bool JobSystem::Init(size_t workerCount, size_t fiberCount)
+    {
+        if (m_running)
+        {
+            return true;
+        }
+
+        if (workerCount == 0)
+        {
+            const unsigned int cores = std::thread::hardware_concurrency();
+            workerCount = cores > 1 ? cores - 1 : 0;
+        }
+
+        m_threads.clear();
+        for (size_t i = 0; i <= workerCount; ++i)
+        {
+            m_threads.push_back(std::make_unique<ThreadState>());
+            m_threads.back()->random = static_cast<uint32_t>(i * 2654435761u + 1);
+        }
+
+        m_fibers.clear();
+        m_freeFibers.clear();
+        for (size_t i = 0; i < fiberCount; ++i)
+        {
+            auto fiber = std::make_unique<JobFiber>();
+            fiber->system = this;
+            fiber->resumeJob.resume = fiber.get();
+            if (!CreateFiberContext(fiber->context, FiberStackBytes, &JobSystem::FiberMain, fiber.get()))
+            {
+                // Fiber jobs run as plain jobs once the pool is empty, fewer fibers only costs concurrency
+                break;
+            }
+            m_freeFibers.push_back(fiber.get());
+            m_fibers.push_back(std::move(fiber));
+        }
+
+        ThreadData& thread = CurrentThread();
+        thread.system = this;
+        thread.threadIndex = 0;
+        m_running = true;
+        for (size_t i = 1; i <= workerCount; ++i)
+        {
+            m_workers.emplace_back(&JobSystem::WorkerLoop, this, static_cast<int>(i));
+        }
+        return true;
+    }
+
+    void JobSystem::Shutdown()
+    {
+        if (!m_running)
+        {
+            return;
+        }
+
+        m_running = false;
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_sleepCondition.notify_all();
+        }
+        for (auto& worker : m_workers)
+        {
+            worker.join();
+        }
+        m_workers.clear();
+        m_threads.clear();
+        {
+            std::lock_guard<std::mutex> lock(m_injectedMutex);
+            for (Job* job : m_injected)
+            {
+                if (job->heap)
+                {
+                    delete job;
+                }
+            }
+            m_injected.clear();
+            m_injectedCount = 0;
+        }
+        for (auto& fiber : m_fibers)
+        {
+            DestroyFiberContext(fiber->context);
+        }
+        m_fibers.clear();
+        m_freeFibers.clear();
+
+        ThreadData& thread = CurrentThread();
+        if (thread.system == this)
+        {
+            thread.system = nullptr;
+            thread.threadIndex = -1;
+        }
+    }
+
+    size_t JobSystem::GetThreadCount() const
+    {
+        return m_running ? m_threads.size() : 1;
+    }
+
+    void JobSystem::Wait(JobCounter& counter)
+    {
+        JobFiber* fiber = CurrentThread().fiber;
+        if (fiber && fiber->system == this)
+        {
+            // Parked on the counter by the thread once the switch completed, see ResumeFiber
+            if (!counter.IsDone())
+            {
+                fiber->waitingOn = &counter;
+                fiber->state = JobFiber::State::Waiting;
+                SwitchFiberContext(fiber->context, *fiber->returnContext);
+            }
+            std::lock_guard<std::mutex> lock(counter.m_mutex);
+            return;
+        }
+
+        while (!counter.IsDone())
+        {
+            if (!RunOneJob())
+            {
+                std::this_thread::yield();
+            }
+        }
+        // The job that signalled zero may still be inside the counter's lock, the counter must not be
+        // destroyed before it leaves
+        std::lock_guard<std::mutex> lock(counter.m_mutex);
+    }
+
+    bool JobSystem::IsInFiber() const
+    {
+        JobFiber* fiber = CurrentThread().fiber;
+        return fiber && fiber->system == this;
+    }
+
+    int JobSystem::GetThreadIndex() const
+    {
+        const ThreadData& thread = CurrentThread();
+        return thread.system == this ? thread.threadIndex : -1;
+    }
+
+    Job* JobSystem::AllocateJob()
+    {
+        if (!m_running)
+        {
+            return nullptr;
+        }
+
+        const int index = GetThreadIndex();
+        if (index < 0)
+        {
+            Job* job = new Job;
+            job->heap = true;
+            return job;
+        }
+
+        // A slot is free again once its job ran. If the ring wrapped onto a job still queued, the new one
+        // runs inline instead of waiting.
+        ThreadState& state = *m_threads[index];
+        Job& job = state.jobs[state.nextJob & (JobsPerThread - 1)];
+        if (job.busy.load(std::memory_order_acquire))
+        {
+            return nullptr;
+        }
+        ++state.nextJob;
+        job.busy.store(true, std::memory_order_relaxed);
+        job.next = nullptr;
+        return &job;
+    }
+
+    void JobSystem::Submit(Job* job, JobCounter* dependency)
+    {
+        if (dependency)
+        {
+            Park(job, *dependency);
+            return;
+        }
+        Push(job);
+    }
+
+    void JobSystem::Park(Job* job, JobCounter& counter)
+    {
+        {
+            std::lock_guard<std::mutex> lock(counter.m_mutex);
+            if (counter.m_value.load(std::memory_order_acquire) > 0)
+            {
+                job->next = counter.m_waiting;
+                counter.m_waiting = job;
+                return;
+            }
+        }
+        Push(job);
+    }
+
+    void JobSystem::Push(Job* job)
+    {
+        // A full deque spills into the shared queue. Running the job inline instead could resume a fiber from
+        // inside another one.
+        const int index = GetThreadIndex();
+        if (index < 0 || !m_threads[index]->deque.Push(job))
+        {
+            std::lock_guard<std::mutex> lock(m_injectedMutex);
+            m_injected.push_back(job);
+            m_injectedCount.fetch_add(1, std::memory_order_relaxed);
+        }
+        WakeWorker();
+    }
+
+    void JobSystem::Execute(Job* job)
+    {
+        if (job->resume)
+        {
+            ResumeFiber(job->resume);
+            return;
+        }
+        // A fiber job started from inside a fiber runs on that fiber, it can suspend there just as well
+        if (job->onFiber && !CurrentThread().fiber)
+        {
+            if (JobFiber* fiber = AcquireFiber())
+            {
+                fiber->job = job;
+                ResumeFiber(fiber);
+                return;
+            }
+        }
+        RunJob(job);
+    }
+
+    void JobSystem::RunJob(Job* job)
+    {
+        ENG_PROFILE_SCOPE("Job");
+        job->invoke(*job);
+        JobCounter* counter = job->counter;
+        if (job->heap)
+        {
+            delete job;
+        }
+        else
+        {
+            job->busy.store(false, std::memory_order_release);
+        }
+        if (counter)
+        {
+            Signal(counter);
+        }
+    }
+
+    void JobSystem::Signal(JobCounter* counter)
+    {
+        Job* released = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(counter->m_mutex);
+            if (counter->m_value.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                released = counter->m_waiting;
+                counter->m_waiting = nullptr;
+            }
+        }
+        while (released)
+        {
+            Job* next = released->next;
+            released->next = nullptr;
+            Push(released);
+            released = next;
+        }
+    }
+
+    JobFiber* JobSystem::AcquireFiber()
+    {
+        std::lock_guard<std::mutex> lock(m_freeFibersMutex);
+        if (m_freeFibers.empty())
+        {
+            return nullptr;
+        }
+        JobFiber* fiber = m_freeFibers.back();
+        m_freeFibers.pop_back();
+        return fiber;
+    }
+
+    void JobSystem::ResumeFiber(JobFiber* fiber)
+    {
+        ThreadData& thread = CurrentThread();
+        if (!thread.schedulerPrepared)
+        {
+            PrepareThreadFiberContext(thread.schedulerContext);
+            thread.schedulerPrepared = true;
+        }
+        thread.fiber = fiber;
+        fiber->returnContext = &thread.schedulerContext;
+        fiber->state = JobFiber::State::Running;
+        SwitchFiberContext(thread.schedulerContext, fiber->context);
+
+        // Back on this thread's own stack, the fiber finished or is suspended and nothing else can see it yet
+        thread.fiber = nullptr;
+        if (fiber->state == JobFiber::State::Finished)
+        {
+            std::lock_guard<std::mutex> lock(m_freeFibersMutex);
+            m_freeFibers.push_back(fiber);
+        }
+        else
+        {
+            JobCounter* counter = fiber->waitingOn;
+            fiber->waitingOn = nullptr;
+            Park(&fiber->resumeJob, *counter);
+        }
+    }
+
+    void JobSystem::FiberMain(void* argument)
+    {
+        JobFiber* fiber = static_cast<JobFiber*>(argument);
+        for (;;)
+        {
+            fiber->system->RunJob(fiber->job);
+            fiber->job = nullptr;
+            fiber->state = JobFiber::State::Finished;
+            SwitchFiberContext(fiber->context, *fiber->returnContext);
+        }
+    }
+
+    Job* JobSystem::FindJob(int threadIndex)
+    {
+        if (threadIndex >= 0)
+        {
+            if (Job* job = m_threads[threadIndex]->deque.Pop())
+            {
+                return job;
+            }
+        }
+
+        if (m_injectedCount.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard<std::mutex> lock(m_injectedMutex);
+            if (!m_injected.empty())
+            {
+                Job* job = m_injected.front();
+                m_injected.pop_front();
+                m_injectedCount.fetch_sub(1, std::memory_order_relaxed);
+                return job;
+            }
+        }
+
+        // Start at a random victim so thieves spread over the threads instead of all hitting thread 0
+        const size_t threadCount = m_threads.size();
+        uint32_t& random = threadIndex >= 0 ? m_threads[threadIndex]->random : CurrentThread().externalRandom;
+        const size_t start = NextRandom(random) % threadCount;
+        for (size_t i = 0; i < threadCount; ++i)
+        {
+            const size_t victim = (start + i) % threadCount;
+            if (static_cast<int>(victim) == threadIndex)
+            {
+                continue;
+            }
+            if (Job* job = m_threads[victim]->deque.Steal())
+            {
+                return job;
+            }
+        }
+        return nullptr;
+    }
+
+    bool JobSystem::RunOneJob()
+    {
+        if (!m_running)
+        {
+            return false;
+        }
+        Job* job = FindJob(GetThreadIndex());
+        if (!job)
+        {
+            return false;
+        }
+        Execute(job);
+        return true;
+    }
+
+    bool JobSystem::HasQueuedJobs() const
+    {
+        if (m_injectedCount.load(std::memory_order_relaxed) > 0)
+        {
+            return true;
+        }
+        for (const auto& thread : m_threads)
+        {
+            if (!thread->deque.IsEmpty())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void JobSystem::WorkerLoop(int threadIndex)
+    {
+        ThreadData& thread = CurrentThread();
+        thread.system = this;
+        thread.threadIndex = threadIndex;
+        Profiler::SetThreadName("Worker " + std::to_string(threadIndex));
+
+        // Spin briefly before sleeping, frames submit work in bursts
+        const int spinsBeforeSleep = 64;
+        int idle = 0;
+        while (m_running.load(std::memory_order_acquire))
+        {
+            if (RunOneJob())
+            {
+                idle = 0;
+                continue;
+            }
+            if (++idle < spinsBeforeSleep)
+            {
+                std::this_thread::yield();
+                continue;
+            }
+
+            // Pairs with the fence in WakeWorker: either the submitter sees this worker asleep or the worker
+            // sees the job
+            std::unique_lock<std::mutex> lock(m_sleepMutex);
+            m_sleepingWorkers.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!HasQueuedJobs() && m_running.load(std::memory_order_acquire))
+            {
+                m_sleepCondition.wait(lock);
+            }
+            m_sleepingWorkers.fetch_sub(1, std::memory_order_relaxed);
+            idle = 0;
+        }
+    }
+
+    void JobSystem::WakeWorker()
+    {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleepingWorkers.load(std::memory_order_relaxed) > 0)
+        {
+            std::lock_guard<std::mutex> lock(m_sleepMutex);
+            m_sleepCondition.notify_one();
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,249 @@
+#pragma once
+#include "jobs/Fiber.h"
+#include "jobs/WorkStealingDeque.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace eng
+{
+    class JobCounter;
+    class JobSystem;
+    struct JobFiber;
+
+    struct alignas(64) Job
+    {
+        // Captures are stored inline, larger state has to be captured by pointer
+        static constexpr size_t StorageBytes = 64;
+
+        void (*invoke)(Job& job) = nullptr;
+        JobCounter* counter = nullptr;
+        // Next job held back by the same dependency
+        Job* next = nullptr;
+        // Set on the job a suspended fiber queues to be picked up again
+        JobFiber* resume = nullptr;
+        std::atomic<bool> busy{ false };
+        bool heap = false;
+        bool onFiber = false;
+        alignas(16) unsigned char storage[StorageBytes];
+    };
+
+    // A pooled fiber and the job it runs
+    struct JobFiber
+    {
+        enum class State
+        {
+            Running,
+            Waiting,
+            Finished
+        };
+
+        FiberContext context;
+        // The thread that switched in, control goes back there on suspend and on finish
+        FiberContext* returnContext = nullptr;
+        JobSystem* system = nullptr;
+        Job* job = nullptr;
+        JobCounter* waitingOn = nullptr;
+        // Queued in place of the fiber once the counter it waits on is done
+        Job resumeJob;
+        State state = State::Finished;
+    };
+
+    // Number of unfinished jobs signalling it. Jobs can wait on a counter (helping with other work meanwhile)
+    // or be held back until one reaches zero. Must outlive the jobs that signal or depend on it.
+    class JobCounter
+    {
+    public:
+        JobCounter() = default;
+        JobCounter(const JobCounter&) = delete;
+        JobCounter& operator=(const JobCounter&) = delete;
+
+        bool IsDone() const { return m_value.load(std::memory_order_acquire) == 0; }
+
+    private:
+        friend class JobSystem;
+
+        std::atomic<int> m_value{ 0 };
+        // Guards the held back jobs and the transition to zero
+        std::mutex m_mutex;
+        Job* m_waiting = nullptr;
+    };
+
+    // One thread per core, each owning a work-stealing deque. The thread that called Init is thread 0 and runs
+    // jobs whenever it waits. Other threads may submit and wait too, their jobs go through a shared queue.
+    // Without Init every job runs inline on the submitting thread.
+    //
+    // Jobs started with RunOnFiber get a stack of their own from a preallocated pool. When such a job waits,
+    // its fiber is parked on the counter and the thread goes on with other work; once the counter reaches
+    // zero any thread picks the fiber up again. Other jobs wait by running queued jobs on their own stack,
+    // which ties them to the thread and nests their stacks.
+    class JobSystem
+    {
+    public:
+        static constexpr size_t DefaultFiberCount = 128;
+        static constexpr size_t FiberStackBytes = 128 * 1024;
+
+        ~JobSystem();
+
+        // workerCount 0 uses one worker per remaining core
+        bool Init(size_t workerCount = 0, size_t fiberCount = DefaultFiberCount);
+        // Jobs still queued are dropped, wait on their counters first
+        void Shutdown();
+        // Threads running jobs, including the one that called Init
+        size_t GetThreadCount() const;
+
+        // counter is incremented now and decremented when the job finishes. The job is held back until
+        // dependency reaches zero, so submit the jobs it counts first: a dependency already at zero releases
+        // it immediately.
+        template <typename Func>
+        void Run(Func&& func, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+        // Same, on a fiber of its own so waits inside it suspend instead of blocking the thread. Runs like a
+        // plain job when all fibers are in use.
+        template <typename Func>
+        void RunOnFiber(Func&& func, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+        // Suspends the calling fiber, or runs other jobs on this thread, until the counter reaches zero
+        void Wait(JobCounter& counter);
+        bool IsInFiber() const;
+
+        // func(begin, end) over [0, count) split into a few chunks per thread, no smaller than minGrain, and
+        // waits for all of them. The calling thread takes the first chunk.
+        template <typename Func>
+        void ParallelFor(size_t count, Func&& func, size_t minGrain = 1);
+
+    private:
+        static constexpr size_t JobsPerThread = 4096;
+
+        struct ThreadState
+        {
+            ThreadState() : deque(JobsPerThread), jobs(new Job[JobsPerThread]) {}
+
+            WorkStealingDeque<Job> deque;
+            std::unique_ptr<Job[]> jobs;
+            size_t nextJob = 0;
+            uint32_t random = 0;
+        };
+
+        // -1 for threads that are not part of this system
+        int GetThreadIndex() const;
+        // nullptr when the ring of this thread is exhausted, the caller then runs the job inline
+        Job* AllocateJob();
+        template <typename Func>
+        void Start(Func&& func, JobCounter* counter, JobCounter* dependency, bool onFiber);
+        void Submit(Job* job, JobCounter* dependency);
+        // Held back on the counter, or queued right away when it already reached zero
+        void Park(Job* job, JobCounter& counter);
+        void Push(Job* job);
+        void Execute(Job* job);
+        // Runs the job's function on the current stack and signals its counter
+        void RunJob(Job* job);
+        void Signal(JobCounter* counter);
+        JobFiber* AcquireFiber();
+        void ResumeFiber(JobFiber* fiber);
+        static void FiberMain(void* argument);
+        Job* FindJob(int threadIndex);
+        bool RunOneJob();
+        bool HasQueuedJobs() const;
+        void WorkerLoop(int threadIndex);
+        void WakeWorker();
+
+        std::vector<std::unique_ptr<ThreadState>> m_threads;
+        std::vector<std::thread> m_workers;
+        std::atomic<bool> m_running{ false };
+
+        std::mutex m_injectedMutex;
+        std::deque<Job*> m_injected;
+        std::atomic<size_t> m_injectedCount{ 0 };
+
+        std::mutex m_sleepMutex;
+        std::condition_variable m_sleepCondition;
+        std::atomic<int> m_sleepingWorkers{ 0 };
+
+        std::vector<std::unique_ptr<JobFiber>> m_fibers;
+        std::mutex m_freeFibersMutex;
+        std::vector<JobFiber*> m_freeFibers;
+    };
+
+    template <typename Func>
+    void JobSystem::Run(Func&& func, JobCounter* counter, JobCounter* dependency)
+    {
+        Start(std::forward<Func>(func), counter, dependency, false);
+    }
+
+    template <typename Func>
+    void JobSystem::RunOnFiber(Func&& func, JobCounter* counter, JobCounter* dependency)
+    {
+        Start(std::forward<Func>(func), counter, dependency, true);
+    }
+
+    template <typename Func>
+    void JobSystem::Start(Func&& func, JobCounter* counter, JobCounter* dependency, bool onFiber)
+    {
+        using Function = std::decay_t<Func>;
+        static_assert(sizeof(Function) <= Job::StorageBytes && alignof(Function) <= 16,
+            "Job captures too large, capture a pointer to the data instead");
+
+        Job* job = AllocateJob();
+        if (!job)
+        {
+            if (dependency)
+            {
+                Wait(*dependency);
+            }
+            func();
+            return;
+        }
+
+        new (job->storage) Function(std::forward<Func>(func));
+        job->invoke = [](Job& self)
+        {
+            Function& function = *reinterpret_cast<Function*>(self.storage);
+            function();
+            function.~Function();
+        };
+        job->counter = counter;
+        job->resume = nullptr;
+        job->onFiber = onFiber;
+        if (counter)
+        {
+            counter->m_value.fetch_add(1, std::memory_order_relaxed);
+        }
+        Submit(job, dependency);
+    }
+
+    template <typename Func>
+    void JobSystem::ParallelFor(size_t count, Func&& func, size_t minGrain)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+
+        // Four chunks per thread leaves stealing room to even out uneven chunks
+        const size_t chunkTarget = GetThreadCount() * 4;
+        const size_t grain = std::max(std::max<size_t>(minGrain, 1), (count + chunkTarget - 1) / chunkTarget);
+        if (grain >= count)
+        {
+            func(size_t(0), count);
+            return;
+        }
+
+        JobCounter counter;
+        for (size_t begin = grain; begin < count; begin += grain)
+        {
+            const size_t end = std::min(count, begin + grain);
+            Run([&func, begin, end]() { func(begin, end); }, &counter);
+        }
+        func(size_t(0), grain);
+        Wait(counter);
+    }
+}
\ No newline at end of file
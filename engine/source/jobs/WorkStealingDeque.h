@@ -0,0 +1,91 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+#include <memory>
+
+namespace eng
+{
+    // Chase-Lev deque with the memory orders of Le et al. 2013. The owning thread pushes and pops at the
+    // bottom, other threads steal from the top; only the last element is contended. Fixed capacity, Push
+    // fails when full and the caller runs the item itself.
+    template <typename T>
+    class WorkStealingDeque
+    {
+    public:
+        // capacity must be a power of two
+        explicit WorkStealingDeque(size_t capacity)
+            : m_items(new std::atomic<T*>[capacity]), m_mask(static_cast<int64_t>(capacity) - 1)
+        {
+        }
+
+        bool Push(T* item)
+        {
+            const int64_t bottom = m_bottom.load(std::memory_order_relaxed);
+            const int64_t top = m_top.load(std::memory_order_acquire);
+            if (bottom - top > m_mask)
+            {
+                return false;
+            }
+            m_items[bottom & m_mask].store(item, std::memory_order_relaxed);
+            m_bottom.store(bottom + 1, std::memory_order_release);
+            return true;
+        }
+
+        T* Pop()
+        {
+            const int64_t bottom = m_bottom.load(std::memory_order_relaxed) - 1;
+            m_bottom.store(bottom, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            int64_t top = m_top.load(std::memory_order_relaxed);
+            if (top > bottom)
+            {
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+                return nullptr;
+            }
+
+            T* item = m_items[bottom & m_mask].load(std::memory_order_relaxed);
+            if (top == bottom)
+            {
+                // Last element, race the thieves for it
+                if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst,
+                    std::memory_order_relaxed))
+                {
+                    item = nullptr;
+                }
+                m_bottom.store(bottom + 1, std::memory_order_relaxed);
+            }
+            return item;
+        }
+
+        T* Steal()
+        {
+            int64_t top = m_top.load(std::memory_order_acquire);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            const int64_t bottom = m_bottom.load(std::memory_order_acquire);
+            if (top >= bottom)
+            {
+                return nullptr;
+            }
+
+            T* item = m_items[top & m_mask].load(std::memory_order_relaxed);
+            if (!m_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+            {
+                return nullptr;
+            }
+            return item;
+        }
+
+        bool IsEmpty() const
+        {
+            return m_top.load(std::memory_order_acquire) >= m_bottom.load(std::memory_order_acquire);
+        }
+
+    private:
+        // Owner and thieves write different ends, keep them off each other's cache line
+        alignas(64) std::atomic<int64_t> m_top{ 0 };
+        alignas(64) std::atomic<int64_t> m_bottom{ 0 };
+        std::unique_ptr<std::atomic<T*>[]> m_items;
+        int64_t m_mask;
+    };
+}
\ No newline at end of file
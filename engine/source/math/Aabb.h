@@ -0,0 +1,58 @@
+#pragma once
+#include "math/Matrix.h"
+
+namespace eng
+{
+    // Axis aligned box, default constructed empty (min > max) so Expand can start from it
+    struct Aabb
+    {
+        Vec3 min = Vec3(1e30f);
+        Vec3 max = Vec3(-1e30f);
+
+        constexpr Aabb() = default;
+        constexpr Aabb(const Vec3& min, const Vec3& max) : min(min), max(max) {}
+
+        bool IsEmpty() const { return min.x > max.x || min.y > max.y || min.z > max.z; }
+        Vec3 Center() const { return (min + max) * 0.5f; }
+        Vec3 Extent() const { return (max - min) * 0.5f; }
+        float SurfaceArea() const
+        {
+            Vec3 size = max - min;
+            return 2.0f * (size.x * size.y + size.y * size.z + size.z * size.x);
+        }
+
+        void Expand(const Vec3& point)
+        {
+            min = Min(min, point);
+            max = Max(max, point);
+        }
+
+        void Expand(const Aabb& box)
+        {
+            min = Min(min, box.min);
+            max = Max(max, box.max);
+        }
+
+        bool Contains(const Vec3& point) const
+        {
+            return point.x >= min.x && point.x <= max.x && point.y >= min.y && point.y <= max.y
+                && point.z >= min.z && point.z <= max.z;
+        }
+
+        bool Intersects(const Aabb& box) const
+        {
+            return min.x <= box.max.x && max.x >= box.min.x && min.y <= box.max.y && max.y >= box.min.y
+                && min.z <= box.max.z && max.z >= box.min.z;
+        }
+    };
+
+    // World box of a transformed box: the extent projected through |M| (Arvo)
+    inline Aabb Transform(const Mat4& m, const Aabb& box)
+    {
+        const Vec3 center = TransformPoint(m, box.Center());
+        const Vec3 extent = box.Extent();
+        const Vec3 worldExtent = Abs(m.columns[0].XYZ()) * extent.x + Abs(m.columns[1].XYZ()) * extent.y
+            + Abs(m.columns[2].XYZ()) * extent.z;
+        return Aabb(center - worldExtent, center + worldExtent);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,261 @@
+#include "math/BatchMath.h"
+
+#if defined(ENG_MATH_SSE)
+#if defined(_MSC_VER) && !defined(__clang__)
+#define ENG_TARGET_AVX2
+#else
+#define ENG_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace eng
+{
+    namespace
+    {
+        SimdPath DetectBatchMathPath()
+        {
+#if defined(ENG_MATH_SSE)
+            return CpuSupportsAVX2() ? SimdPath::AVX2 : SimdPath::SSE;
+#elif defined(ENG_MATH_NEON)
+            return SimdPath::NEON;
+#else
+            return SimdPath::Scalar;
+#endif
+        }
+
+        SimdPath& ActivePath()
+        {
+            static SimdPath path = DetectBatchMathPath();
+            return path;
+        }
+
+        void TransformPointsScalar(const Mat4& m, const Vec3* points, Vec3* out, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i] = scalar::Transform(m, Vec4(points[i], 1.0f)).XYZ();
+            }
+        }
+
+        void TransformPointsScalar(const Mat4& m, const float* x, const float* y, const float* z, float* outX,
+            float* outY, float* outZ, size_t begin, size_t end)
+        {
+            const float* c = m.Data();
+            for (size_t i = begin; i < end; ++i)
+            {
+                const float px = x[i];
+                const float py = y[i];
+                const float pz = z[i];
+                outX[i] = c[0] * px + c[4] * py + c[8] * pz + c[12];
+                outY[i] = c[1] * px + c[5] * py + c[9] * pz + c[13];
+                outZ[i] = c[2] * px + c[6] * py + c[10] * pz + c[14];
+            }
+        }
+
+        void MultiplyMatricesScalar(const Mat4* a, size_t aStride, const Mat4* b, Mat4* out, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i] = scalar::Multiply(a[i * aStride], b[i]);
+            }
+        }
+
+#if defined(ENG_MATH_SSE) || defined(ENG_MATH_NEON)
+        void MultiplyMatricesVector(const Mat4* a, size_t aStride, const Mat4* b, Mat4* out, size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                out[i] = a[i * aStride] * b[i];
+            }
+        }
+#endif
+
+#if defined(ENG_MATH_SSE)
+        // Columns stay in registers, each point is three broadcasts and a 12-byte store
+        void TransformPointsSSE(const Mat4& m, const Vec3* points, Vec3* out, size_t count)
+        {
+            const __m128 c0 = _mm_load_ps(m.Data());
+            const __m128 c1 = _mm_load_ps(m.Data() + 4);
+            const __m128 c2 = _mm_load_ps(m.Data() + 8);
+            const __m128 c3 = _mm_load_ps(m.Data() + 12);
+            for (size_t i = 0; i < count; ++i)
+            {
+                const Vec3 point = points[i];
+                __m128 value = _mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(point.x)), c3);
+                value = _mm_add_ps(value, _mm_mul_ps(c1, _mm_set1_ps(point.y)));
+                value = _mm_add_ps(value, _mm_mul_ps(c2, _mm_set1_ps(point.z)));
+                float* target = &out[i].x;
+                _mm_storel_pi(reinterpret_cast<__m64*>(target), value);
+                _mm_store_ss(target + 2, _mm_movehl_ps(value, value));
+            }
+        }
+
+        void TransformPointsSSE(const Mat4& m, const float* x, const float* y, const float* z, float* outX,
+            float* outY, float* outZ, size_t count)
+        {
+            const float* c = m.Data();
+            const size_t blocks = count & ~size_t(3);
+            for (size_t i = 0; i < blocks; i += 4)
+            {
+                const __m128 px = _mm_loadu_ps(x + i);
+                const __m128 py = _mm_loadu_ps(y + i);
+                const __m128 pz = _mm_loadu_ps(z + i);
+                for (int row = 0; row < 3; ++row)
+                {
+                    __m128 value = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(c[row]), px), _mm_set1_ps(c[12 + row]));
+                    value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(c[4 + row]), py));
+                    value = _mm_add_ps(value, _mm_mul_ps(_mm_set1_ps(c[8 + row]), pz));
+                    _mm_storeu_ps((row == 0 ? outX : row == 1 ? outY : outZ) + i, value);
+                }
+            }
+            TransformPointsScalar(m, x, y, z, outX, outY, outZ, blocks, count);
+        }
+
+        ENG_TARGET_AVX2 void TransformPointsAVX2(const Mat4& m, const float* x, const float* y, const float* z,
+            float* outX, float* outY, float* outZ, size_t count)
+        {
+            const float* c = m.Data();
+            const size_t blocks = count & ~size_t(7);
+            for (size_t i = 0; i < blocks; i += 8)
+            {
+                const __m256 px = _mm256_loadu_ps(x + i);
+                const __m256 py = _mm256_loadu_ps(y + i);
+                const __m256 pz = _mm256_loadu_ps(z + i);
+                for (int row = 0; row < 3; ++row)
+                {
+                    __m256 value = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(c[row]), px),
+                        _mm256_set1_ps(c[12 + row]));
+                    value = _mm256_add_ps(value, _mm256_mul_ps(_mm256_set1_ps(c[4 + row]), py));
+                    value = _mm256_add_ps(value, _mm256_mul_ps(_mm256_set1_ps(c[8 + row]), pz));
+                    _mm256_storeu_ps((row == 0 ? outX : row == 1 ? outY : outZ) + i, value);
+                }
+            }
+            TransformPointsScalar(m, x, y, z, outX, outY, outZ, blocks, count);
+        }
+
+        // Two output columns per 256-bit register: the columns of a are duplicated into both lanes and
+        // an in-lane permute broadcasts the matching element of each b column
+        ENG_TARGET_AVX2 void MultiplyMatricesAVX2(const Mat4* a, size_t aStride, const Mat4* b, Mat4* out,
+            size_t count)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                const float* left = a[i * aStride].Data();
+                const __m256 a0 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left));
+                const __m256 a1 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left + 4));
+                const __m256 a2 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left + 8));
+                const __m256 a3 = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(left + 12));
+                const float* right = b[i].Data();
+                float* result = out[i].Data();
+                const __m256 b01 = _mm256_loadu_ps(right);
+                const __m256 b23 = _mm256_loadu_ps(right + 8);
+
+                __m256 r01 = _mm256_mul_ps(a0, _mm256_permute_ps(b01, 0x00));
+                __m256 r23 = _mm256_mul_ps(a0, _mm256_permute_ps(b23, 0x00));
+                r01 = _mm256_add_ps(r01, _mm256_mul_ps(a1, _mm256_permute_ps(b01, 0x55)));
+                r23 = _mm256_add_ps(r23, _mm256_mul_ps(a1, _mm256_permute_ps(b23, 0x55)));
+                r01 = _mm256_add_ps(r01, _mm256_mul_ps(a2, _mm256_permute_ps(b01, 0xAA)));
+                r23 = _mm256_add_ps(r23, _mm256_mul_ps(a2, _mm256_permute_ps(b23, 0xAA)));
+                r01 = _mm256_add_ps(r01, _mm256_mul_ps(a3, _mm256_permute_ps(b01, 0xFF)));
+                r23 = _mm256_add_ps(r23, _mm256_mul_ps(a3, _mm256_permute_ps(b23, 0xFF)));
+                _mm256_storeu_ps(result, r01);
+                _mm256_storeu_ps(result + 8, r23);
+            }
+        }
+#endif
+
+        void MultiplyMatrices(const Mat4* a, size_t aStride, const Mat4* b, Mat4* out, size_t count)
+        {
+            switch (ActivePath())
+            {
+#if defined(ENG_MATH_SSE)
+            case SimdPath::AVX2:
+                MultiplyMatricesAVX2(a, aStride, b, out, count);
+                return;
+            case SimdPath::SSE:
+                MultiplyMatricesVector(a, aStride, b, out, count);
+                return;
+#elif defined(ENG_MATH_NEON)
+            case SimdPath::NEON:
+                MultiplyMatricesVector(a, aStride, b, out, count);
+                return;
+#endif
+            default:
+                MultiplyMatricesScalar(a, aStride, b, out, count);
+                return;
+            }
+        }
+    }
+
+    SimdPath GetBatchMathPath()
+    {
+        return ActivePath();
+    }
+
+    void SetBatchMathPath(SimdPath path)
+    {
+        if (path == SimdPath::AVX2 && !CpuSupportsAVX2())
+        {
+            return;
+        }
+#if defined(ENG_MATH_SSE)
+        if (path == SimdPath::NEON)
+        {
+            return;
+        }
+#elif defined(ENG_MATH_NEON)
+        if (path != SimdPath::Scalar && path != SimdPath::NEON)
+        {
+            return;
+        }
+#else
+        if (path != SimdPath::Scalar)
+        {
+            return;
+        }
+#endif
+        ActivePath() = path;
+    }
+
+    void TransformPoints(const Mat4& matrix, const Vec3* points, Vec3* out, size_t count)
+    {
+        // Three-float records leave nothing for 8-wide lanes to gain over one point per SSE register
+#if defined(ENG_MATH_SSE)
+        if (ActivePath() != SimdPath::Scalar)
+        {
+            TransformPointsSSE(matrix, points, out, count);
+            return;
+        }
+#endif
+        TransformPointsScalar(matrix, points, out, count);
+    }
+
+    void TransformPoints(const Mat4& matrix, const float* x, const float* y, const float* z, float* outX,
+        float* outY, float* outZ, size_t count)
+    {
+        switch (ActivePath())
+        {
+#if defined(ENG_MATH_SSE)
+        case SimdPath::AVX2:
+            TransformPointsAVX2(matrix, x, y, z, outX, outY, outZ, count);
+            return;
+        case SimdPath::SSE:
+            TransformPointsSSE(matrix, x, y, z, outX, outY, outZ, count);
+            return;
+#endif
+        default:
+            TransformPointsScalar(matrix, x, y, z, outX, outY, outZ, 0, count);
+            return;
+        }
+    }
+
+    void MultiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count)
+    {
+        MultiplyMatrices(a, 1, b, out, count);
+    }
+
+    void MultiplyMatrices(const Mat4& parent, const Mat4* b, Mat4* out, size_t count)
+    {
+        MultiplyMatrices(&parent, 0, b, out, count);
+    }
+}
\ No newline at end of file
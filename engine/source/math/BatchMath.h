@@ -0,0 +1,22 @@
+#pragma once
+#include "math/Matrix.h"
+#include "math/Simd.h"
+#include <stddef.h>
+
+namespace eng
+{
+    // Best path for this CPU unless overridden (benchmarks compare paths). Only affects the batch kernels,
+    // the inline types are fixed at compile time.
+    SimdPath GetBatchMathPath();
+    void SetBatchMathPath(SimdPath path);
+
+    // out[i] = matrix * (points[i], 1) without the perspective divide. out may alias points.
+    void TransformPoints(const Mat4& matrix, const Vec3* points, Vec3* out, size_t count);
+    // Same on structure-of-arrays input, the layout the 8-wide path wants
+    void TransformPoints(const Mat4& matrix, const float* x, const float* y, const float* z, float* outX,
+        float* outY, float* outZ, size_t count);
+    // out[i] = a[i] * b[i]
+    void MultiplyMatrices(const Mat4* a, const Mat4* b, Mat4* out, size_t count);
+    // out[i] = parent * b[i], e.g. placing the instances of one object
+    void MultiplyMatrices(const Mat4& parent, const Mat4* b, Mat4* out, size_t count);
+}
\ No newline at end of file
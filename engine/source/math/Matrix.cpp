@@ -0,0 +1,211 @@
+#include "math/Matrix.h"
+#include <algorithm>
+#include <cmath>
+
+namespace eng
+{
+    Mat3 Mat3::FromQuat(const Quat& q)
+    {
+        const float xx = q.x * q.x;
+        const float yy = q.y * q.y;
+        const float zz = q.z * q.z;
+        const float xy = q.x * q.y;
+        const float xz = q.x * q.z;
+        const float yz = q.y * q.z;
+        const float wx = q.w * q.x;
+        const float wy = q.w * q.y;
+        const float wz = q.w * q.z;
+
+        Mat3 result;
+        result.columns[0] = Vec3(1.0f - 2.0f * (yy + zz), 2.0f * (xy + wz), 2.0f * (xz - wy));
+        result.columns[1] = Vec3(2.0f * (xy - wz), 1.0f - 2.0f * (xx + zz), 2.0f * (yz + wx));
+        result.columns[2] = Vec3(2.0f * (xz + wy), 2.0f * (yz - wx), 1.0f - 2.0f * (xx + yy));
+        return result;
+    }
+
+    Mat4 Mat4::FromData(const float* values)
+    {
+        Mat4 result;
+        std::copy(values, values + 16, result.Data());
+        return result;
+    }
+
+    Mat4 Mat4::Translation(const Vec3& translation)
+    {
+        Mat4 result;
+        result.columns[3] = Vec4(translation, 1.0f);
+        return result;
+    }
+
+    Mat4 Mat4::Scale(const Vec3& scale)
+    {
+        Mat4 result;
+        result.columns[0].x = scale.x;
+        result.columns[1].y = scale.y;
+        result.columns[2].z = scale.z;
+        return result;
+    }
+
+    Mat4 Mat4::Rotation(const Quat& rotation)
+    {
+        return Compose(Vec3(0.0f), rotation, Vec3(1.0f));
+    }
+
+    Mat4 Mat4::Compose(const Vec3& translation, const Quat& rotation, const Vec3& scale)
+    {
+        Mat3 basis = Mat3::FromQuat(rotation);
+        Mat4 result;
+        result.columns[0] = Vec4(basis.columns[0] * scale.x, 0.0f);
+        result.columns[1] = Vec4(basis.columns[1] * scale.y, 0.0f);
+        result.columns[2] = Vec4(basis.columns[2] * scale.z, 0.0f);
+        result.columns[3] = Vec4(translation, 1.0f);
+        return result;
+    }
+
+    Mat4 Mat4::Perspective(float fovY, float aspect, float nearPlane, float farPlane)
+    {
+        const float f = 1.0f / std::tan(fovY * 0.5f);
+        Mat4 result;
+        result.columns[0] = Vec4(f / aspect, 0.0f, 0.0f, 0.0f);
+        result.columns[1] = Vec4(0.0f, f, 0.0f, 0.0f);
+        result.columns[2] = Vec4(0.0f, 0.0f, (farPlane + nearPlane) / (nearPlane - farPlane), -1.0f);
+        result.columns[3] = Vec4(0.0f, 0.0f, 2.0f * farPlane * nearPlane / (nearPlane - farPlane), 0.0f);
+        return result;
+    }
+
+    Mat4 Mat4::Orthographic(float left, float right, float bottom, float top, float nearPlane, float farPlane)
+    {
+        Mat4 result;
+        result.columns[0] = Vec4(2.0f / (right - left), 0.0f, 0.0f, 0.0f);
+        result.columns[1] = Vec4(0.0f, 2.0f / (top - bottom), 0.0f, 0.0f);
+        result.columns[2] = Vec4(0.0f, 0.0f, -2.0f / (farPlane - nearPlane), 0.0f);
+        result.columns[3] = Vec4(-(right + left) / (right - left), -(top + bottom) / (top - bottom),
+            -(farPlane + nearPlane) / (farPlane - nearPlane), 1.0f);
+        return result;
+    }
+
+    Mat4 Mat4::LookAt(const Vec3& eye, const Vec3& target, const Vec3& up)
+    {
+        const Vec3 forward = Normalize(target - eye);
+        const Vec3 side = Normalize(Cross(forward, up));
+        const Vec3 cameraUp = Cross(side, forward);
+
+        Mat4 result;
+        result.columns[0] = Vec4(side.x, cameraUp.x, -forward.x, 0.0f);
+        result.columns[1] = Vec4(side.y, cameraUp.y, -forward.y, 0.0f);
+        result.columns[2] = Vec4(side.z, cameraUp.z, -forward.z, 0.0f);
+        result.columns[3] = Vec4(-Dot(side, eye), -Dot(cameraUp, eye), Dot(forward, eye), 1.0f);
+        return result;
+    }
+
+    Mat3 operator*(const Mat3& a, const Mat3& b)
+    {
+        Mat3 result;
+        for (int column = 0; column < 3; ++column)
+        {
+            result.columns[column] = a * b.columns[column];
+        }
+        return result;
+    }
+
+    Vec3 operator*(const Mat3& m, const Vec3& v)
+    {
+        return m.columns[0] * v.x + m.columns[1] * v.y + m.columns[2] * v.z;
+    }
+
+    Mat3 Transpose(const Mat3& m)
+    {
+        Mat3 result;
+        result.columns[0] = Vec3(m.columns[0].x, m.columns[1].x, m.columns[2].x);
+        result.columns[1] = Vec3(m.columns[0].y, m.columns[1].y, m.columns[2].y);
+        result.columns[2] = Vec3(m.columns[0].z, m.columns[1].z, m.columns[2].z);
+        return result;
+    }
+
+    Mat3 Inverse(const Mat3& m)
+    {
+        // Rows of the inverse are the cross products of the columns, scaled by 1 / determinant
+        const Vec3 r0 = Cross(m.columns[1], m.columns[2]);
+        const Vec3 r1 = Cross(m.columns[2], m.columns[0]);
+        const Vec3 r2 = Cross(m.columns[0], m.columns[1]);
+        const float determinant = Dot(m.columns[0], r0);
+        if (std::fabs(determinant) < 1e-12f)
+        {
+            return Mat3();
+        }
+        return Transpose(Mat3{ { r0 / determinant, r1 / determinant, r2 / determinant } });
+    }
+
+    Mat4 Inverse(const Mat4& matrix)
+    {
+        const float* m = matrix.Data();
+        float inverse[16];
+
+        inverse[0] = m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15]
+            + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+        inverse[4] = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15]
+            - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+        inverse[8] = m[4] * m[9] * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15]
+            + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+        inverse[12] = -m[4] * m[9] * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14]
+            - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+        inverse[1] = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15]
+            - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+        inverse[5] = m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15]
+            + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+        inverse[9] = -m[0] * m[9] * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15]
+            - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+        inverse[13] = m[0] * m[9] * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14]
+            + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+        inverse[2] = m[1] * m[6] * m[15] - m[1] * m[7] * m[14] - m[5] * m[2] * m[15]
+            + m[5] * m[3] * m[14] + m[13] * m[2] * m[7] - m[13] * m[3] * m[6];
+        inverse[6] = -m[0] * m[6] * m[15] + m[0] * m[7] * m[14] + m[4] * m[2] * m[15]
+            - m[4] * m[3] * m[14] - m[12] * m[2] * m[7] + m[12] * m[3] * m[6];
+        inverse[10] = m[0] * m[5] * m[15] - m[0] * m[7] * m[13] - m[4] * m[1] * m[15]
+            + m[4] * m[3] * m[13] + m[12] * m[1] * m[7] - m[12] * m[3] * m[5];
+        inverse[14] = -m[0] * m[5] * m[14] + m[0] * m[6] * m[13] + m[4] * m[1] * m[14]
+            - m[4] * m[2] * m[13] - m[12] * m[1] * m[6] + m[12] * m[2] * m[5];
+        inverse[3] = -m[1] * m[6] * m[11] + m[1] * m[7] * m[10] + m[5] * m[2] * m[11]
+            - m[5] * m[3] * m[10] - m[9] * m[2] * m[7] + m[9] * m[3] * m[6];
+        inverse[7] = m[0] * m[6] * m[11] - m[0] * m[7] * m[10] - m[4] * m[2] * m[11]
+            + m[4] * m[3] * m[10] + m[8] * m[2] * m[7] - m[8] * m[3] * m[6];
+        inverse[11] = -m[0] * m[5] * m[11] + m[0] * m[7] * m[9] + m[4] * m[1] * m[11]
+            - m[4] * m[3] * m[9] - m[8] * m[1] * m[7] + m[8] * m[3] * m[5];
+        inverse[15] = m[0] * m[5] * m[10] - m[0] * m[6] * m[9] - m[4] * m[1] * m[10]
+            + m[4] * m[2] * m[9] + m[8] * m[1] * m[6] - m[8] * m[2] * m[5];
+
+        const float determinant = m[0] * inverse[0] + m[1] * inverse[4] + m[2] * inverse[8] + m[3] * inverse[12];
+        if (std::fabs(determinant) < 1e-20f)
+        {
+            return Mat4();
+        }
+
+        const float scale = 1.0f / determinant;
+        Mat4 result;
+        float* out = result.Data();
+        for (int i = 0; i < 16; ++i)
+        {
+            out[i] = inverse[i] * scale;
+        }
+        return result;
+    }
+
+    Mat4 InverseAffine(const Mat4& m)
+    {
+        Mat3 basis;
+        for (int column = 0; column < 3; ++column)
+        {
+            basis.columns[column] = m.columns[column].XYZ();
+        }
+        const Mat3 inverseBasis = Inverse(basis);
+        const Vec3 translation = -(inverseBasis * m.columns[3].XYZ());
+
+        Mat4 result;
+        for (int column = 0; column < 3; ++column)
+        {
+            result.columns[column] = Vec4(inverseBasis.columns[column], 0.0f);
+        }
+        result.columns[3] = Vec4(translation, 1.0f);
+        return result;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,165 @@
+#pragma once
+#include "math/Vector.h"
+#include "math/Quaternion.h"
+
+namespace eng
+{
+    // Column-major like GL, columns[c] is column c
+    struct Mat3
+    {
+        Vec3 columns[3] = { Vec3(1.0f, 0.0f, 0.0f), Vec3(0.0f, 1.0f, 0.0f), Vec3(0.0f, 0.0f, 1.0f) };
+
+        static Mat3 Identity() { return Mat3(); }
+        static Mat3 FromQuat(const Quat& q);
+        Vec3& operator[](int column) { return columns[column]; }
+        const Vec3& operator[](int column) const { return columns[column]; }
+        float* Data() { return &columns[0].x; }
+        const float* Data() const { return &columns[0].x; }
+    };
+
+    // Column-major like GL, Data() can go straight to glUniformMatrix4fv without transposing
+    struct alignas(16) Mat4
+    {
+        Vec4 columns[4] =
+        {
+            Vec4(1.0f, 0.0f, 0.0f, 0.0f),
+            Vec4(0.0f, 1.0f, 0.0f, 0.0f),
+            Vec4(0.0f, 0.0f, 1.0f, 0.0f),
+            Vec4(0.0f, 0.0f, 0.0f, 1.0f)
+        };
+
+        static Mat4 Identity() { return Mat4(); }
+        static Mat4 FromData(const float* values);
+        static Mat4 Translation(const Vec3& translation);
+        static Mat4 Scale(const Vec3& scale);
+        static Mat4 Rotation(const Quat& rotation);
+        // Translation * rotation * scale
+        static Mat4 Compose(const Vec3& translation, const Quat& rotation, const Vec3& scale);
+        // GL clip space (z in [-w, w]), fovY in radians
+        static Mat4 Perspective(float fovY, float aspect, float nearPlane, float farPlane);
+        static Mat4 Orthographic(float left, float right, float bottom, float top, float nearPlane, float farPlane);
+        static Mat4 LookAt(const Vec3& eye, const Vec3& target, const Vec3& up);
+
+        Vec4& operator[](int column) { return columns[column]; }
+        const Vec4& operator[](int column) const { return columns[column]; }
+        float* Data() { return &columns[0].x; }
+        const float* Data() const { return &columns[0].x; }
+    };
+
+    Mat3 operator*(const Mat3& a, const Mat3& b);
+    Vec3 operator*(const Mat3& m, const Vec3& v);
+    Mat3 Transpose(const Mat3& m);
+    // Singular matrices return identity
+    Mat3 Inverse(const Mat3& m);
+
+    // General 4x4 inverse, singular matrices return identity
+    Mat4 Inverse(const Mat4& m);
+    // Faster inverse for matrices whose last row is (0, 0, 0, 1)
+    Mat4 InverseAffine(const Mat4& m);
+
+    namespace scalar
+    {
+        inline Vec4 Transform(const Mat4& m, const Vec4& v)
+        {
+            return Add(Add(Mul(m.columns[0], v.x), Mul(m.columns[1], v.y)),
+                Add(Mul(m.columns[2], v.z), Mul(m.columns[3], v.w)));
+        }
+
+        inline Mat4 Multiply(const Mat4& a, const Mat4& b)
+        {
+            Mat4 result;
+            for (int column = 0; column < 4; ++column)
+            {
+                result.columns[column] = Transform(a, b.columns[column]);
+            }
+            return result;
+        }
+
+        inline Mat4 Transpose(const Mat4& m)
+        {
+            Mat4 result;
+            for (int column = 0; column < 4; ++column)
+            {
+                result.columns[column] = Vec4(m.columns[0].Data()[column], m.columns[1].Data()[column],
+                    m.columns[2].Data()[column], m.columns[3].Data()[column]);
+            }
+            return result;
+        }
+    }
+
+#if defined(ENG_MATH_SSE)
+    inline __m128 TransformColumn(const Mat4& m, __m128 v)
+    {
+        __m128 result = _mm_mul_ps(Load(m.columns[0]), _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 0, 0, 0)));
+        result = _mm_add_ps(result, _mm_mul_ps(Load(m.columns[1]), _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1))));
+        result = _mm_add_ps(result, _mm_mul_ps(Load(m.columns[2]), _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2))));
+        return _mm_add_ps(result, _mm_mul_ps(Load(m.columns[3]), _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3))));
+    }
+
+    inline Vec4 operator*(const Mat4& m, const Vec4& v) { return Store(TransformColumn(m, Load(v))); }
+
+    inline Mat4 operator*(const Mat4& a, const Mat4& b)
+    {
+        Mat4 result;
+        for (int column = 0; column < 4; ++column)
+        {
+            _mm_store_ps(result.columns[column].Data(), TransformColumn(a, Load(b.columns[column])));
+        }
+        return result;
+    }
+
+    inline Mat4 Transpose(const Mat4& m)
+    {
+        __m128 c0 = Load(m.columns[0]);
+        __m128 c1 = Load(m.columns[1]);
+        __m128 c2 = Load(m.columns[2]);
+        __m128 c3 = Load(m.columns[3]);
+        _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+        Mat4 result;
+        _mm_store_ps(result.columns[0].Data(), c0);
+        _mm_store_ps(result.columns[1].Data(), c1);
+        _mm_store_ps(result.columns[2].Data(), c2);
+        _mm_store_ps(result.columns[3].Data(), c3);
+        return result;
+    }
+#elif defined(ENG_MATH_NEON)
+    inline float32x4_t TransformColumn(const Mat4& m, float32x4_t v)
+    {
+        float32x4_t result = vmulq_laneq_f32(Load(m.columns[0]), v, 0);
+        result = vfmaq_laneq_f32(result, Load(m.columns[1]), v, 1);
+        result = vfmaq_laneq_f32(result, Load(m.columns[2]), v, 2);
+        return vfmaq_laneq_f32(result, Load(m.columns[3]), v, 3);
+    }
+
+    inline Vec4 operator*(const Mat4& m, const Vec4& v) { return Store(TransformColumn(m, Load(v))); }
+
+    inline Mat4 operator*(const Mat4& a, const Mat4& b)
+    {
+        Mat4 result;
+        for (int column = 0; column < 4; ++column)
+        {
+            vst1q_f32(result.columns[column].Data(), TransformColumn(a, Load(b.columns[column])));
+        }
+        return result;
+    }
+
+    inline Mat4 Transpose(const Mat4& m)
+    {
+        float32x4x4_t columns = vld4q_f32(m.Data());
+        Mat4 result;
+        vst1q_f32(result.columns[0].Data(), columns.val[0]);
+        vst1q_f32(result.columns[1].Data(), columns.val[1]);
+        vst1q_f32(result.columns[2].Data(), columns.val[2]);
+        vst1q_f32(result.columns[3].Data(), columns.val[3]);
+        return result;
+    }
+#else
+    inline Vec4 operator*(const Mat4& m, const Vec4& v) { return scalar::Transform(m, v); }
+    inline Mat4 operator*(const Mat4& a, const Mat4& b) { return scalar::Multiply(a, b); }
+    inline Mat4 Transpose(const Mat4& m) { return scalar::Transpose(m); }
+#endif
+
+    inline Mat4& operator*=(Mat4& a, const Mat4& b) { return a = a * b; }
+    inline Vec3 TransformPoint(const Mat4& m, const Vec3& p) { return (m * Vec4(p, 1.0f)).XYZ(); }
+    inline Vec3 TransformVector(const Mat4& m, const Vec3& v) { return (m * Vec4(v, 0.0f)).XYZ(); }
+}
\ No newline at end of file
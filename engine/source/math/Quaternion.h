@@ -0,0 +1,111 @@
+#pragma once
+#include "math/Vector.h"
+#include <stdint.h>
+
+namespace eng
+{
+    // Unit quaternion (x, y, z, w) for rotations, w is the scalar part
+    struct alignas(16) Quat
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+        float w = 1.0f;
+
+        constexpr Quat() = default;
+        constexpr Quat(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+
+        // Axis must be normalized, angle in radians
+        static Quat FromAxisAngle(const Vec3& axis, float angle)
+        {
+            float s = std::sin(angle * 0.5f);
+            return Quat(axis.x * s, axis.y * s, axis.z * s, std::cos(angle * 0.5f));
+        }
+
+        float* Data() { return &x; }
+        const float* Data() const { return &x; }
+    };
+
+    namespace scalar
+    {
+        inline Quat Multiply(const Quat& a, const Quat& b)
+        {
+            return Quat(
+                a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+                a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+                a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+                a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z);
+        }
+    }
+
+#if defined(ENG_MATH_SSE)
+    // Hamilton product as four broadcast terms, the sign flips are xors on swizzles of b
+    inline Quat operator*(const Quat& a, const Quat& b)
+    {
+        const __m128 qa = _mm_load_ps(&a.x);
+        const __m128 qb = _mm_load_ps(&b.x);
+        const __m128 signX = _mm_castsi128_ps(_mm_set_epi32(INT32_MIN, 0, INT32_MIN, 0));
+        const __m128 signY = _mm_castsi128_ps(_mm_set_epi32(INT32_MIN, INT32_MIN, 0, 0));
+        const __m128 signZ = _mm_castsi128_ps(_mm_set_epi32(INT32_MIN, 0, 0, INT32_MIN));
+
+        __m128 result = _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(3, 3, 3, 3)), qb);
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(0, 0, 0, 0)),
+            _mm_xor_ps(_mm_shuffle_ps(qb, qb, _MM_SHUFFLE(0, 1, 2, 3)), signX)));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(1, 1, 1, 1)),
+            _mm_xor_ps(_mm_shuffle_ps(qb, qb, _MM_SHUFFLE(1, 0, 3, 2)), signY)));
+        result = _mm_add_ps(result, _mm_mul_ps(_mm_shuffle_ps(qa, qa, _MM_SHUFFLE(2, 2, 2, 2)),
+            _mm_xor_ps(_mm_shuffle_ps(qb, qb, _MM_SHUFFLE(2, 3, 0, 1)), signZ)));
+
+        Quat q;
+        _mm_store_ps(&q.x, result);
+        return q;
+    }
+#else
+    inline Quat operator*(const Quat& a, const Quat& b) { return scalar::Multiply(a, b); }
+#endif
+
+    inline Quat& operator*=(Quat& a, const Quat& b) { return a = a * b; }
+    inline Quat Conjugate(const Quat& q) { return Quat(-q.x, -q.y, -q.z, q.w); }
+    inline float Dot(const Quat& a, const Quat& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+    inline Quat Normalize(const Quat& q)
+    {
+        float inverseLength = 1.0f / std::sqrt(Dot(q, q));
+        return Quat(q.x * inverseLength, q.y * inverseLength, q.z * inverseLength, q.w * inverseLength);
+    }
+
+    inline Vec3 Rotate(const Quat& q, const Vec3& v)
+    {
+        // v + 2w(u x v) + 2u x (u x v) with u the vector part
+        const Vec3 u(q.x, q.y, q.z);
+        const Vec3 t = Cross(u, v) * 2.0f;
+        return v + t * q.w + Cross(u, t);
+    }
+
+    // Normalized lerp along the shorter arc, fine for small steps such as animation blending
+    inline Quat Nlerp(const Quat& a, const Quat& b, float t)
+    {
+        float sign = Dot(a, b) < 0.0f ? -1.0f : 1.0f;
+        return Normalize(Quat(a.x + (b.x * sign - a.x) * t, a.y + (b.y * sign - a.y) * t,
+            a.z + (b.z * sign - a.z) * t, a.w + (b.w * sign - a.w) * t));
+    }
+
+    inline Quat Slerp(const Quat& a, const Quat& b, float t)
+    {
+        float cosine = Dot(a, b);
+        float sign = 1.0f;
+        if (cosine < 0.0f)
+        {
+            cosine = -cosine;
+            sign = -1.0f;
+        }
+        if (cosine > 0.9995f)
+        {
+            return Nlerp(a, b, t);
+        }
+        float angle = std::acos(cosine);
+        float inverseSine = 1.0f / std::sin(angle);
+        float wa = std::sin((1.0f - t) * angle) * inverseSine;
+        float wb = std::sin(t * angle) * inverseSine * sign;
+        return Quat(a.x * wa + b.x * wb, a.y * wa + b.y * wb, a.z * wa + b.z * wb, a.w * wa + b.w * wb);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#pragma once
+
+// Instruction set used by the inline math types. x86-64 always has SSE2 and AArch64 always has NEON;
+// defining ENG_MATH_SCALAR forces the scalar reference everywhere.
+#if !defined(ENG_MATH_SCALAR)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define ENG_MATH_SSE 1
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#include <arm_neon.h>
+#define ENG_MATH_NEON 1
+#endif
+#endif
+
+namespace eng
+{
+    enum class SimdPath
+    {
+        Scalar,
+        SSE,
+        AVX2,
+        NEON
+    };
+
+    // Checks the CPU and the OS (saved YMM state), always false off x86
+    bool CpuSupportsAVX2();
+}
\ No newline at end of file
@@ -0,0 +1,178 @@
+#pragma once
+#include "math/Simd.h"
+#include <cmath>
+
+namespace eng
+{
+    struct Vec2
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+
+        constexpr Vec2() = default;
+        constexpr Vec2(float x, float y) : x(x), y(y) {}
+        constexpr explicit Vec2(float value) : x(value), y(value) {}
+    };
+
+    struct Vec3
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+
+        constexpr Vec3() = default;
+        constexpr Vec3(float x, float y, float z) : x(x), y(y), z(z) {}
+        constexpr explicit Vec3(float value) : x(value), y(value), z(value) {}
+
+        float* Data() { return &x; }
+        const float* Data() const { return &x; }
+    };
+
+    // 16 byte aligned so it maps onto one SSE/NEON register
+    struct alignas(16) Vec4
+    {
+        float x = 0.0f;
+        float y = 0.0f;
+        float z = 0.0f;
+        float w = 0.0f;
+
+        constexpr Vec4() = default;
+        constexpr Vec4(float x, float y, float z, float w) : x(x), y(y), z(z), w(w) {}
+        constexpr Vec4(const Vec3& v, float w) : x(v.x), y(v.y), z(v.z), w(w) {}
+        constexpr explicit Vec4(float value) : x(value), y(value), z(value), w(value) {}
+
+        constexpr Vec3 XYZ() const { return Vec3(x, y, z); }
+        float* Data() { return &x; }
+        const float* Data() const { return &x; }
+    };
+
+    inline Vec2 operator+(const Vec2& a, const Vec2& b) { return Vec2(a.x + b.x, a.y + b.y); }
+    inline Vec2 operator-(const Vec2& a, const Vec2& b) { return Vec2(a.x - b.x, a.y - b.y); }
+    inline Vec2 operator-(const Vec2& v) { return Vec2(-v.x, -v.y); }
+    inline Vec2 operator*(const Vec2& a, const Vec2& b) { return Vec2(a.x * b.x, a.y * b.y); }
+    inline Vec2 operator*(const Vec2& v, float s) { return Vec2(v.x * s, v.y * s); }
+    inline Vec2 operator*(float s, const Vec2& v) { return v * s; }
+    inline Vec2 operator/(const Vec2& v, float s) { return v * (1.0f / s); }
+    inline Vec2& operator+=(Vec2& a, const Vec2& b) { return a = a + b; }
+    inline Vec2& operator-=(Vec2& a, const Vec2& b) { return a = a - b; }
+    inline Vec2& operator*=(Vec2& v, float s) { return v = v * s; }
+    inline bool operator==(const Vec2& a, const Vec2& b) { return a.x == b.x && a.y == b.y; }
+    inline bool operator!=(const Vec2& a, const Vec2& b) { return !(a == b); }
+
+    inline float Dot(const Vec2& a, const Vec2& b) { return a.x * b.x + a.y * b.y; }
+    inline float Length(const Vec2& v) { return std::sqrt(Dot(v, v)); }
+    inline Vec2 Normalize(const Vec2& v) { return v / Length(v); }
+
+    inline Vec3 operator+(const Vec3& a, const Vec3& b) { return Vec3(a.x + b.x, a.y + b.y, a.z + b.z); }
+    inline Vec3 operator-(const Vec3& a, const Vec3& b) { return Vec3(a.x - b.x, a.y - b.y, a.z - b.z); }
+    inline Vec3 operator-(const Vec3& v) { return Vec3(-v.x, -v.y, -v.z); }
+    inline Vec3 operator*(const Vec3& a, const Vec3& b) { return Vec3(a.x * b.x, a.y * b.y, a.z * b.z); }
+    inline Vec3 operator*(const Vec3& v, float s) { return Vec3(v.x * s, v.y * s, v.z * s); }
+    inline Vec3 operator*(float s, const Vec3& v) { return v * s; }
+    inline Vec3 operator/(const Vec3& v, float s) { return v * (1.0f / s); }
+    inline Vec3& operator+=(Vec3& a, const Vec3& b) { return a = a + b; }
+    inline Vec3& operator-=(Vec3& a, const Vec3& b) { return a = a - b; }
+    inline Vec3& operator*=(Vec3& v, float s) { return v = v * s; }
+    inline bool operator==(const Vec3& a, const Vec3& b) { return a.x == b.x && a.y == b.y && a.z == b.z; }
+    inline bool operator!=(const Vec3& a, const Vec3& b) { return !(a == b); }
+
+    inline float Dot(const Vec3& a, const Vec3& b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+    inline Vec3 Cross(const Vec3& a, const Vec3& b)
+    {
+        return Vec3(a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x);
+    }
+    inline float LengthSquared(const Vec3& v) { return Dot(v, v); }
+    inline float Length(const Vec3& v) { return std::sqrt(Dot(v, v)); }
+    inline Vec3 Normalize(const Vec3& v) { return v / Length(v); }
+    inline Vec3 Min(const Vec3& a, const Vec3& b)
+    {
+        return Vec3(a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y, a.z < b.z ? a.z : b.z);
+    }
+    inline Vec3 Max(const Vec3& a, const Vec3& b)
+    {
+        return Vec3(a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y, a.z > b.z ? a.z : b.z);
+    }
+    inline Vec3 Abs(const Vec3& v) { return Vec3(std::fabs(v.x), std::fabs(v.y), std::fabs(v.z)); }
+    inline Vec3 Lerp(const Vec3& a, const Vec3& b, float t) { return a + (b - a) * t; }
+
+    // Reference versions of the Vec4 operations, used by ENG_MATH_SCALAR builds and the scalar batch path
+    namespace scalar
+    {
+        inline Vec4 Add(const Vec4& a, const Vec4& b) { return Vec4(a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w); }
+        inline Vec4 Sub(const Vec4& a, const Vec4& b) { return Vec4(a.x - b.x, a.y - b.y, a.z - b.z, a.w - b.w); }
+        inline Vec4 Mul(const Vec4& a, const Vec4& b) { return Vec4(a.x * b.x, a.y * b.y, a.z * b.z, a.w * b.w); }
+        inline Vec4 Mul(const Vec4& v, float s) { return Vec4(v.x * s, v.y * s, v.z * s, v.w * s); }
+        inline Vec4 Min(const Vec4& a, const Vec4& b)
+        {
+            return Vec4(a.x < b.x ? a.x : b.x, a.y < b.y ? a.y : b.y, a.z < b.z ? a.z : b.z, a.w < b.w ? a.w : b.w);
+        }
+        inline Vec4 Max(const Vec4& a, const Vec4& b)
+        {
+            return Vec4(a.x > b.x ? a.x : b.x, a.y > b.y ? a.y : b.y, a.z > b.z ? a.z : b.z, a.w > b.w ? a.w : b.w);
+        }
+        inline float Dot(const Vec4& a, const Vec4& b) { return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w; }
+    }
+
+#if defined(ENG_MATH_SSE)
+    inline __m128 Load(const Vec4& v) { return _mm_load_ps(&v.x); }
+    inline Vec4 Store(__m128 value)
+    {
+        Vec4 result;
+        _mm_store_ps(&result.x, value);
+        return result;
+    }
+
+    inline Vec4 operator+(const Vec4& a, const Vec4& b) { return Store(_mm_add_ps(Load(a), Load(b))); }
+    inline Vec4 operator-(const Vec4& a, const Vec4& b) { return Store(_mm_sub_ps(Load(a), Load(b))); }
+    inline Vec4 operator*(const Vec4& a, const Vec4& b) { return Store(_mm_mul_ps(Load(a), Load(b))); }
+    inline Vec4 operator*(const Vec4& v, float s) { return Store(_mm_mul_ps(Load(v), _mm_set1_ps(s))); }
+    inline Vec4 Min(const Vec4& a, const Vec4& b) { return Store(_mm_min_ps(Load(a), Load(b))); }
+    inline Vec4 Max(const Vec4& a, const Vec4& b) { return Store(_mm_max_ps(Load(a), Load(b))); }
+    inline float Dot(const Vec4& a, const Vec4& b)
+    {
+        __m128 product = _mm_mul_ps(Load(a), Load(b));
+        __m128 pairs = _mm_add_ps(product, _mm_shuffle_ps(product, product, _MM_SHUFFLE(2, 3, 0, 1)));
+        return _mm_cvtss_f32(_mm_add_ss(pairs, _mm_movehl_ps(pairs, pairs)));
+    }
+#elif defined(ENG_MATH_NEON)
+    inline float32x4_t Load(const Vec4& v) { return vld1q_f32(&v.x); }
+    inline Vec4 Store(float32x4_t value)
+    {
+        Vec4 result;
+        vst1q_f32(&result.x, value);
+        return result;
+    }
+
+    inline Vec4 operator+(const Vec4& a, const Vec4& b) { return Store(vaddq_f32(Load(a), Load(b))); }
+    inline Vec4 operator-(const Vec4& a, const Vec4& b) { return Store(vsubq_f32(Load(a), Load(b))); }
+    inline Vec4 operator*(const Vec4& a, const Vec4& b) { return Store(vmulq_f32(Load(a), Load(b))); }
+    inline Vec4 operator*(const Vec4& v, float s) { return Store(vmulq_n_f32(Load(v), s)); }
+    inline Vec4 Min(const Vec4& a, const Vec4& b) { return Store(vminq_f32(Load(a), Load(b))); }
+    inline Vec4 Max(const Vec4& a, const Vec4& b) { return Store(vmaxq_f32(Load(a), Load(b))); }
+    inline float Dot(const Vec4& a, const Vec4& b) { return vaddvq_f32(vmulq_f32(Load(a), Load(b))); }
+#else
+    inline Vec4 operator+(const Vec4& a, const Vec4& b) { return scalar::Add(a, b); }
+    inline Vec4 operator-(const Vec4& a, const Vec4& b) { return scalar::Sub(a, b); }
+    inline Vec4 operator*(const Vec4& a, const Vec4& b) { return scalar::Mul(a, b); }
+    inline Vec4 operator*(const Vec4& v, float s) { return scalar::Mul(v, s); }
+    inline Vec4 Min(const Vec4& a, const Vec4& b) { return scalar::Min(a, b); }
+    inline Vec4 Max(const Vec4& a, const Vec4& b) { return scalar::Max(a, b); }
+    inline float Dot(const Vec4& a, const Vec4& b) { return scalar::Dot(a, b); }
+#endif
+
+    inline Vec4 operator-(const Vec4& v) { return v * -1.0f; }
+    inline Vec4 operator*(float s, const Vec4& v) { return v * s; }
+    inline Vec4 operator/(const Vec4& v, float s) { return v * (1.0f / s); }
+    inline Vec4& operator+=(Vec4& a, const Vec4& b) { return a = a + b; }
+    inline Vec4& operator-=(Vec4& a, const Vec4& b) { return a = a - b; }
+    inline Vec4& operator*=(Vec4& v, float s) { return v = v * s; }
+    inline bool operator==(const Vec4& a, const Vec4& b)
+    {
+        return a.x == b.x && a.y == b.y && a.z == b.z && a.w == b.w;
+    }
+    inline bool operator!=(const Vec4& a, const Vec4& b) { return !(a == b); }
+
+    inline float Length(const Vec4& v) { return std::sqrt(Dot(v, v)); }
+    inline Vec4 Normalize(const Vec4& v) { return v / Length(v); }
+    inline Vec4 Lerp(const Vec4& a, const Vec4& b, float t) { return a + (b - a) * t; }
+}
\ No newline at end of file
@@ -0,0 +1,218 @@
+#include "profile/GpuProfiler.h"
+
+namespace eng
+{
+    namespace
+    {
+        const size_t QueryAllocationBatch = 64;
+    }
+
+    void GpuProfiler::SetEnabled(bool enable)
+    {
+        m_enabled = enable;
+    }
+
+    bool GpuProfiler::IsEnabled() const
+    {
+        return m_enabled;
+    }
+
+    void GpuProfiler::BeginFrame()
+    {
+        if (!m_enabled || m_inFrame || (!m_initialized && !Init()) || !m_supported)
+        {
+            return;
+        }
+
+        // Oldest first, so the newest frame read back is the one whose results stay
+        for (size_t i = 1; i <= FrameLatency; ++i)
+        {
+            Frame& frame = m_frames[(m_frameIndex + i) % FrameLatency];
+            if (frame.pending && ReadFrame(frame))
+            {
+                ReleaseFrame(frame);
+            }
+        }
+
+        m_frameIndex = (m_frameIndex + 1) % FrameLatency;
+        Frame& frame = m_frames[m_frameIndex];
+        if (frame.pending)
+        {
+            ReleaseFrame(frame);
+            ++m_droppedFrames;
+        }
+
+        GLint64 gpuNow = 0;
+        glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+        frame.clockOffset = static_cast<int64_t>(Profiler::Now()) - static_cast<int64_t>(gpuNow);
+        frame.pending = true;
+        m_inFrame = true;
+        BeginScope("GPU Frame");
+    }
+
+    void GpuProfiler::EndFrame()
+    {
+        if (!m_inFrame)
+        {
+            return;
+        }
+        while (!m_openScopes.empty())
+        {
+            EndScope();
+        }
+        m_inFrame = false;
+    }
+
+    void GpuProfiler::BeginScope(const char* name)
+    {
+        if (!m_inFrame)
+        {
+            return;
+        }
+
+        Frame& frame = m_frames[m_frameIndex];
+        if (frame.scopes.size() >= MaxScopesPerFrame)
+        {
+            m_openScopes.push_back(-1);
+            return;
+        }
+        Scope scope;
+        scope.name = name;
+        scope.depth = static_cast<int>(m_openScopes.size());
+        scope.begin = AcquireQuery();
+        scope.end = AcquireQuery();
+        glQueryCounter(scope.begin, GL_TIMESTAMP);
+        m_openScopes.push_back(static_cast<int>(frame.scopes.size()));
+        frame.scopes.push_back(scope);
+    }
+
+    void GpuProfiler::BeginScope(const std::string& name)
+    {
+        if (m_inFrame)
+        {
+            BeginScope(Profiler::InternName(name));
+        }
+    }
+
+    void GpuProfiler::EndScope()
+    {
+        if (!m_inFrame || m_openScopes.empty())
+        {
+            return;
+        }
+
+        const int index = m_openScopes.back();
+        m_openScopes.pop_back();
+        if (index >= 0)
+        {
+            glQueryCounter(m_frames[m_frameIndex].scopes[index].end, GL_TIMESTAMP);
+        }
+    }
+
+    void GpuProfiler::Shutdown()
+    {
+        if (!m_allQueries.empty())
+        {
+            glDeleteQueries(static_cast<GLsizei>(m_allQueries.size()), m_allQueries.data());
+        }
+        m_allQueries.clear();
+        m_freeQueries.clear();
+        for (Frame& frame : m_frames)
+        {
+            frame.scopes.clear();
+            frame.pending = false;
+        }
+        m_openScopes.clear();
+        m_results.clear();
+        m_inFrame = false;
+        m_initialized = false;
+    }
+
+    const std::vector<GpuProfiler::Result>& GpuProfiler::GetLastResults() const
+    {
+        return m_results;
+    }
+
+    double GpuProfiler::GetLastFrameTime() const
+    {
+        return m_lastFrameTime;
+    }
+
+    size_t GpuProfiler::GetDroppedFrameCount() const
+    {
+        return m_droppedFrames;
+    }
+
+    bool GpuProfiler::Init()
+    {
+        m_initialized = true;
+        GLint bits = 0;
+        glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+        m_supported = bits > 0;
+        return m_supported;
+    }
+
+    GLuint GpuProfiler::AcquireQuery()
+    {
+        if (m_freeQueries.empty())
+        {
+            GLuint queries[QueryAllocationBatch];
+            glGenQueries(static_cast<GLsizei>(QueryAllocationBatch), queries);
+            m_freeQueries.insert(m_freeQueries.end(), queries, queries + QueryAllocationBatch);
+            m_allQueries.insert(m_allQueries.end(), queries, queries + QueryAllocationBatch);
+        }
+        GLuint query = m_freeQueries.back();
+        m_freeQueries.pop_back();
+        return query;
+    }
+
+    void GpuProfiler::ReleaseFrame(Frame& frame)
+    {
+        for (const Scope& scope : frame.scopes)
+        {
+            m_freeQueries.push_back(scope.begin);
+            m_freeQueries.push_back(scope.end);
+        }
+        frame.scopes.clear();
+        frame.pending = false;
+    }
+
+    bool GpuProfiler::ReadFrame(Frame& frame)
+    {
+        if (frame.scopes.empty())
+        {
+            return true;
+        }
+
+        // Timestamps complete in submission order, the frame scope ends last
+        GLint available = 0;
+        glGetQueryObjectiv(frame.scopes.front().end, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+        {
+            return false;
+        }
+
+        if (m_track < 0)
+        {
+            m_track = Profiler::CreateTrack("GPU");
+        }
+        const bool record = Profiler::IsEnabled();
+        m_results.clear();
+        for (const Scope& scope : frame.scopes)
+        {
+            GLuint64 begin = 0;
+            GLuint64 end = 0;
+            glGetQueryObjectui64v(scope.begin, GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(scope.end, GL_QUERY_RESULT, &end);
+            end = end > begin ? end : begin;
+            m_results.push_back({ scope.name, scope.depth, static_cast<double>(end - begin) / 1e6 });
+            if (record)
+            {
+                Profiler::Record(m_track, scope.name, static_cast<uint64_t>(static_cast<int64_t>(begin) +
+                    frame.clockOffset), static_cast<uint64_t>(static_cast<int64_t>(end) + frame.clockOffset));
+            }
+        }
+        m_lastFrameTime = m_results.front().milliseconds;
+        return true;
+    }
+}
\ No newline at end of file
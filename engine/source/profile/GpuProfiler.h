@@ -0,0 +1,116 @@
+#pragma once
+#include "profile/Profiler.h"
+#include <GL/glew.h>
+#include <stdint.h>
+#include <array>
+#include <string>
+#include <vector>
+
+#if !defined(ENG_PROFILER_DISABLED)
+#define ENG_PROFILE_GPU_SCOPE(profiler, name) \
+    ::eng::GpuProfileScope ENG_PROFILE_CONCAT(gpuProfileScope, __LINE__)(profiler, name)
+#else
+#define ENG_PROFILE_GPU_SCOPE(profiler, name) ((void)0)
+#endif
+
+namespace eng
+{
+    // Times nested GPU scopes with GL_TIMESTAMP queries. Every BeginFrame reads back the earlier frames whose
+    // queries the GPU reports available, often the previous one, so the CPU never waits. FrameLatency frames
+    // are kept in flight: a frame still unfinished when its slot comes round again is dropped. Finished scopes
+    // are also recorded on a "GPU" track of the CPU profiler, shifted onto its clock, while that is enabled.
+    // Main thread with the GL context only.
+    class GpuProfiler
+    {
+    public:
+        static constexpr size_t FrameLatency = 4;
+        // Scopes past this many in one frame are not timed
+        static constexpr size_t MaxScopesPerFrame = 256;
+
+        struct Result
+        {
+            const char* name;
+            // 0 for the frame itself
+            int depth;
+            double milliseconds;
+        };
+
+        void SetEnabled(bool enable);
+        bool IsEnabled() const;
+
+        // Around all GPU work of a frame, which is timed as the outermost scope
+        void BeginFrame();
+        void EndFrame();
+        // name must stay valid until the frame is read back, string literals do
+        void BeginScope(const char* name);
+        // For names built at runtime, see Profiler::InternName
+        void BeginScope(const std::string& name);
+        void EndScope();
+        void Shutdown();
+
+        // Scopes of the newest frame read back, in the order they began
+        const std::vector<Result>& GetLastResults() const;
+        // GPU time of that frame in milliseconds
+        double GetLastFrameTime() const;
+        size_t GetDroppedFrameCount() const;
+
+    private:
+        struct Scope
+        {
+            const char* name;
+            int depth;
+            GLuint begin;
+            GLuint end;
+        };
+
+        struct Frame
+        {
+            std::vector<Scope> scopes;
+            // Profiler clock minus GPU clock when the frame began
+            int64_t clockOffset = 0;
+            bool pending = false;
+        };
+
+        bool Init();
+        GLuint AcquireQuery();
+        void ReleaseFrame(Frame& frame);
+        // false while the GPU has not finished the frame
+        bool ReadFrame(Frame& frame);
+
+        std::array<Frame, FrameLatency> m_frames;
+        size_t m_frameIndex = 0;
+        // Scopes of the current frame that have not ended, -1 for the ones not timed
+        std::vector<int> m_openScopes;
+        std::vector<GLuint> m_freeQueries;
+        std::vector<GLuint> m_allQueries;
+        std::vector<Result> m_results;
+        double m_lastFrameTime = 0.0;
+        size_t m_droppedFrames = 0;
+        int m_track = -1;
+        bool m_enabled = false;
+        bool m_inFrame = false;
+        bool m_initialized = false;
+        bool m_supported = false;
+    };
+
+    class GpuProfileScope
+    {
+    public:
+        template <typename Name>
+        GpuProfileScope(GpuProfiler& profiler, const Name& name) : m_profiler(profiler)
+        {
+            m_profiler.BeginScope(name);
+        }
+
+        ~GpuProfileScope()
+        {
+            m_profiler.EndScope();
+        }
+
+        GpuProfileScope(const GpuProfileScope&) = delete;
+        GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+    private:
+        GpuProfiler& m_profiler;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,227 @@
+#include "profile/Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <unordered_set>
+#include <vector>
+
+namespace eng
+{
+    namespace
+    {
+        struct ProfileEvent
+        {
+            const char* name;
+            uint64_t start;
+            uint64_t end;
+        };
+
+        struct ThreadBuffer
+        {
+            ThreadBuffer() : events(new ProfileEvent[Profiler::EventsPerThread]) {}
+
+            std::unique_ptr<ProfileEvent[]> events;
+            // Total recorded, the ring holds the newest EventsPerThread of them
+            std::atomic<uint64_t> count{ 0 };
+            std::string name;
+            uint32_t id = 0;
+        };
+
+        // Buffers outlive their threads so spans of finished workers still export
+        struct Registry
+        {
+            std::mutex mutex;
+            std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+            std::unordered_set<std::string> names;
+        };
+
+        Registry& GetRegistry()
+        {
+            static Registry registry;
+            return registry;
+        }
+
+        thread_local ThreadBuffer* t_buffer = nullptr;
+
+        // Expects the registry to be locked
+        ThreadBuffer* AddBuffer(Registry& registry)
+        {
+            registry.buffers.push_back(std::make_unique<ThreadBuffer>());
+            ThreadBuffer* buffer = registry.buffers.back().get();
+            buffer->id = static_cast<uint32_t>(registry.buffers.size());
+            return buffer;
+        }
+
+        ThreadBuffer& GetThreadBuffer()
+        {
+            if (!t_buffer)
+            {
+                Registry& registry = GetRegistry();
+                std::lock_guard<std::mutex> lock(registry.mutex);
+                t_buffer = AddBuffer(registry);
+            }
+            return *t_buffer;
+        }
+
+        void RecordInto(ThreadBuffer& buffer, const char* name, uint64_t start, uint64_t end)
+        {
+            const uint64_t index = buffer.count.load(std::memory_order_relaxed);
+            buffer.events[index % Profiler::EventsPerThread] = { name, start, end };
+            buffer.count.store(index + 1, std::memory_order_release);
+        }
+
+        // Nanosecond precision without going through floating point
+        void WriteMicroseconds(std::ostream& out, uint64_t nanoseconds)
+        {
+            const uint64_t fraction = nanoseconds % 1000;
+            out << nanoseconds / 1000 << '.' << fraction / 100 << fraction / 10 % 10 << fraction % 10;
+        }
+
+        void WriteJsonString(std::ostream& out, const char* text)
+        {
+            out << '"';
+            for (const char* c = text; *c; ++c)
+            {
+                const unsigned char character = static_cast<unsigned char>(*c);
+                if (character == '"' || character == '\\')
+                {
+                    out << '\\' << *c;
+                }
+                else if (character < 0x20)
+                {
+                    const char* hex = "0123456789abcdef";
+                    out << "\\u00" << hex[character >> 4] << hex[character & 15];
+                }
+                else
+                {
+                    out << *c;
+                }
+            }
+            out << '"';
+        }
+    }
+
+    void Profiler::SetEnabled(bool enable)
+    {
+        s_enabled.store(enable, std::memory_order_relaxed);
+    }
+
+    uint64_t Profiler::Now()
+    {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void Profiler::Record(const char* name, uint64_t start, uint64_t end)
+    {
+        RecordInto(GetThreadBuffer(), name, start, end);
+    }
+
+    void Profiler::SetThreadName(const std::string& name)
+    {
+        ThreadBuffer& buffer = GetThreadBuffer();
+        std::lock_guard<std::mutex> lock(GetRegistry().mutex);
+        buffer.name = name;
+    }
+
+    int Profiler::CreateTrack(const std::string& name)
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        ThreadBuffer* buffer = AddBuffer(registry);
+        buffer->name = name;
+        return static_cast<int>(registry.buffers.size() - 1);
+    }
+
+    void Profiler::Record(int track, const char* name, uint64_t start, uint64_t end)
+    {
+        ThreadBuffer* buffer;
+        {
+            // Growing the registry moves the pointers, not the buffers
+            Registry& registry = GetRegistry();
+            std::lock_guard<std::mutex> lock(registry.mutex);
+            if (track < 0 || track >= static_cast<int>(registry.buffers.size()))
+            {
+                return;
+            }
+            buffer = registry.buffers[track].get();
+        }
+        RecordInto(*buffer, name, start, end);
+    }
+
+    const char* Profiler::InternName(const std::string& name)
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        return registry.names.insert(name).first->c_str();
+    }
+
+    bool Profiler::ExportChromeTrace(const std::string& path)
+    {
+        std::ofstream file(path, std::ios::trunc);
+        if (!file)
+        {
+            std::cerr << "ERROR:PROFILER_TRACE_WRITE_FAILED: " << path << std::endl;
+            return false;
+        }
+
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+
+        // Timestamps are written relative to the oldest span, in microseconds
+        uint64_t base = UINT64_MAX;
+        for (auto& buffer : registry.buffers)
+        {
+            const uint64_t count = buffer->count.load(std::memory_order_acquire);
+            const uint64_t first = count > EventsPerThread ? count - EventsPerThread : 0;
+            for (uint64_t i = first; i < count; ++i)
+            {
+                base = std::min(base, buffer->events[i % EventsPerThread].start);
+            }
+        }
+
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        for (auto& buffer : registry.buffers)
+        {
+            if (!buffer->name.empty())
+            {
+                file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":"
+                    << buffer->id << ",\"args\":{\"name\":";
+                WriteJsonString(file, buffer->name.c_str());
+                file << "}}";
+                first = false;
+            }
+
+            const uint64_t count = buffer->count.load(std::memory_order_acquire);
+            const uint64_t begin = count > EventsPerThread ? count - EventsPerThread : 0;
+            for (uint64_t i = begin; i < count; ++i)
+            {
+                const ProfileEvent& event = buffer->events[i % EventsPerThread];
+                file << (first ? "" : ",\n") << "{\"name\":";
+                WriteJsonString(file, event.name);
+                file << ",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->id << ",\"ts\":";
+                WriteMicroseconds(file, event.start - base);
+                file << ",\"dur\":";
+                WriteMicroseconds(file, event.end - event.start);
+                file << '}';
+                first = false;
+            }
+        }
+        file << "\n]}\n";
+        return static_cast<bool>(file);
+    }
+
+    void Profiler::Clear()
+    {
+        Registry& registry = GetRegistry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (auto& buffer : registry.buffers)
+        {
+            buffer->count.store(0, std::memory_order_relaxed);
+        }
+    }
+}
\ No newline at end of file
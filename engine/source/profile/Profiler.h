@@ -0,0 +1,81 @@
+#pragma once
+#include <stdint.h>
+#include <atomic>
+#include <string>
+
+// Define ENG_PROFILER_DISABLED to compile the markers out entirely. Otherwise a marker costs one relaxed load
+// while the profiler is off.
+#if !defined(ENG_PROFILER_DISABLED)
+#define ENG_PROFILE_CONCAT_INNER(a, b) a##b
+#define ENG_PROFILE_CONCAT(a, b) ENG_PROFILE_CONCAT_INNER(a, b)
+#define ENG_PROFILE_SCOPE(name) ::eng::ProfileScope ENG_PROFILE_CONCAT(profileScope, __LINE__)(name)
+#define ENG_PROFILE_FUNCTION() ENG_PROFILE_SCOPE(__func__)
+#else
+#define ENG_PROFILE_SCOPE(name) ((void)0)
+#define ENG_PROFILE_FUNCTION() ((void)0)
+#endif
+
+namespace eng
+{
+    // Every thread records timed spans into a ring buffer of its own, so recording takes no locks and only the
+    // newest EventsPerThread spans of each thread are kept. Spans of a fiber or task that moved threads while
+    // open land on the thread that closed them.
+    class Profiler
+    {
+    public:
+        static constexpr size_t EventsPerThread = 64 * 1024;
+
+        static void SetEnabled(bool enable);
+        static bool IsEnabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+        // Nanoseconds on the steady clock
+        static uint64_t Now();
+        // name must stay valid until the trace is exported, string literals do
+        static void Record(const char* name, uint64_t start, uint64_t end);
+        // Shown for the calling thread in the trace
+        static void SetThreadName(const std::string& name);
+
+        // A timeline of its own for spans that do not belong to a thread, such as GPU work. Only one thread
+        // may record into a track at a time.
+        static int CreateTrack(const std::string& name);
+        static void Record(int track, const char* name, uint64_t start, uint64_t end);
+        // A copy of name that stays valid for the rest of the process, for names built at runtime
+        static const char* InternName(const std::string& name);
+
+        // Writes the buffered spans as Chrome trace event JSON, which chrome://tracing and Perfetto load.
+        // Threads recording meanwhile may lose their oldest spans from the export.
+        static bool ExportChromeTrace(const std::string& path);
+        // Drops the recorded spans of all threads. Call while no thread records.
+        static void Clear();
+
+    private:
+        static inline std::atomic<bool> s_enabled{ false };
+    };
+
+    class ProfileScope
+    {
+    public:
+        explicit ProfileScope(const char* name) : m_name(Profiler::IsEnabled() ? name : nullptr)
+        {
+            if (m_name)
+            {
+                m_start = Profiler::Now();
+            }
+        }
+
+        ~ProfileScope()
+        {
+            if (m_name)
+            {
+                Profiler::Record(m_name, m_start, Profiler::Now());
+            }
+        }
+
+        ProfileScope(const ProfileScope&) = delete;
+        ProfileScope& operator=(const ProfileScope&) = delete;
+
+    private:
+        const char* m_name;
+        uint64_t m_start = 0;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,932 @@
+#include "render/BoundingVolumeHierarchy.h"
+#include <algorithm>
+#include <cmath>
+
+namespace eng
+{
+    namespace
+    {
+        const int BinCount = 16;
+
+        BoundingBox Union(const BoundingBox& a, const BoundingBox& b)
+        {
+            BoundingBox result;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                result.min[axis] = std::min(a.min[axis], b.min[axis]);
+                result.max[axis] = std::max(a.max[axis], b.max[axis]);
+            }
+            return result;
+        }
+
+        // Half the surface area, the factor cancels out in every SAH comparison
+        float Area(const BoundingBox& box)
+        {
+            float dx = box.max[0] - box.min[0];
+            float dy = box.max[1] - box.min[1];
+            float dz = box.max[2] - box.min[2];
+            return dx * dy + dy * dz + dz * dx;
+        }
+
+        bool Overlaps(const BoundingBox& a, const BoundingBox& b)
+        {
+            return a.min[0] <= b.max[0] && a.max[0] >= b.min[0]
+                && a.min[1] <= b.max[1] && a.max[1] >= b.min[1]
+                && a.min[2] <= b.max[2] && a.max[2] >= b.min[2];
+        }
+
+        bool Equals(const BoundingBox& a, const BoundingBox& b)
+        {
+            return a.min[0] == b.min[0] && a.min[1] == b.min[1] && a.min[2] == b.min[2]
+                && a.max[0] == b.max[0] && a.max[1] == b.max[1] && a.max[2] == b.max[2];
+        }
+
+        BoundingBox EmptyBox()
+        {
+            BoundingBox box;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                box.min[axis] = 1e30f;
+                box.max[axis] = -1e30f;
+            }
+            return box;
+        }
+
+        float Centroid(const BoundingBox& box, int axis)
+        {
+            return (box.min[axis] + box.max[axis]) * 0.5f;
+        }
+
+        struct RayData
+        {
+            float origin[3];
+            float inverseDirection[3];
+        };
+
+        RayData PrepareRay(const Ray& ray)
+        {
+            RayData data;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                data.origin[axis] = ray.origin[axis];
+                float d = ray.direction[axis];
+                data.inverseDirection[axis] = d != 0.0f ? 1.0f / d : (std::signbit(d) ? -1e30f : 1e30f);
+            }
+            return data;
+        }
+
+        // Slab test, returns the entry distance or a negative value on a miss
+        float IntersectBox(const RayData& ray, const BoundingBox& box, float maxDistance)
+        {
+            float tMin = 0.0f;
+            float tMax = maxDistance;
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                float t1 = (box.min[axis] - ray.origin[axis]) * ray.inverseDirection[axis];
+                float t2 = (box.max[axis] - ray.origin[axis]) * ray.inverseDirection[axis];
+                tMin = std::max(tMin, std::min(t1, t2));
+                tMax = std::min(tMax, std::max(t1, t2));
+            }
+            return tMin <= tMax ? tMin : -1.0f;
+        }
+    }
+
+    void BoundingVolumeHierarchy::Build(const BoundingBox* boxes, const uint32_t* userData, size_t count)
+    {
+        Clear();
+        if (count == 0)
+        {
+            return;
+        }
+
+        m_leaves.resize(count);
+        m_leafBoxes.assign(boxes, boxes + count);
+        std::vector<int32_t> proxies(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            m_leaves[i].userData = userData ? userData[i] : static_cast<uint32_t>(i);
+            m_leaves[i].alive = true;
+            proxies[i] = static_cast<int32_t>(i);
+        }
+        m_proxyCount = count;
+
+        m_nodes.reserve(count - 1);
+        m_root = BuildRange(boxes, proxies.data(), count, NullNode);
+    }
+
+    void BoundingVolumeHierarchy::Clear()
+    {
+        m_nodes.clear();
+        m_leaves.clear();
+        m_leafBoxes.clear();
+        m_root = NullNode;
+        m_rootBox = BoundingBox();
+        m_freeNodes = NullNode;
+        m_freeLeaves = NullNode;
+        m_proxyCount = 0;
+        m_movedLeaves.clear();
+        m_refitAll = false;
+        m_ordered = true;
+        m_optimizeCursor = 0;
+    }
+
+    int32_t BoundingVolumeHierarchy::Insert(const BoundingBox& box, uint32_t userData)
+    {
+        int32_t proxy;
+        if (m_freeLeaves != NullNode)
+        {
+            proxy = m_freeLeaves;
+            m_freeLeaves = m_leaves[proxy].parentSlot;
+        }
+        else
+        {
+            proxy = static_cast<int32_t>(m_leaves.size());
+            m_leaves.emplace_back();
+            m_leafBoxes.emplace_back();
+        }
+
+        m_leafBoxes[proxy] = box;
+        m_leaves[proxy] = Leaf();
+        m_leaves[proxy].userData = userData;
+        m_leaves[proxy].alive = true;
+        ++m_proxyCount;
+        InsertLeaf(proxy, box);
+        return proxy;
+    }
+
+    void BoundingVolumeHierarchy::Remove(int32_t proxy)
+    {
+        if (proxy < 0 || proxy >= static_cast<int32_t>(m_leaves.size()) || !m_leaves[proxy].alive)
+        {
+            return;
+        }
+
+        if (m_leaves[proxy].moved)
+        {
+            m_movedLeaves.erase(std::find(m_movedLeaves.begin(), m_movedLeaves.end(), proxy));
+        }
+        RemoveLeaf(proxy);
+        m_leaves[proxy] = Leaf();
+        m_leaves[proxy].parentSlot = m_freeLeaves;
+        m_freeLeaves = proxy;
+        --m_proxyCount;
+    }
+
+    void BoundingVolumeHierarchy::Update(int32_t proxy, const BoundingBox& box)
+    {
+        m_leafBoxes[proxy] = box;
+        if (m_refitAll)
+        {
+            return;
+        }
+        Leaf& leaf = m_leaves[proxy];
+        if (!leaf.moved)
+        {
+            leaf.moved = true;
+            m_movedLeaves.push_back(proxy);
+            // Past this many moved leaves the full pass wins, so the remaining updates skip the bookkeeping
+            m_refitAll = m_movedLeaves.size() * 8 >= m_proxyCount;
+        }
+    }
+
+    void BoundingVolumeHierarchy::Update(const int32_t* proxies, const BoundingBox* boxes, size_t count)
+    {
+        size_t i = 0;
+        for (; i < count && !m_refitAll; ++i)
+        {
+            Update(proxies[i], boxes[i]);
+        }
+        BoundingBox* leafBoxes = m_leafBoxes.data();
+        for (; i < count; ++i)
+        {
+            leafBoxes[proxies[i]] = boxes[i];
+        }
+    }
+
+    void BoundingVolumeHierarchy::Refit()
+    {
+        if (!m_refitAll && m_movedLeaves.empty())
+        {
+            return;
+        }
+
+        // Few moved leaves: walk each path up and stop once a box stops changing.
+        // Many moved leaves: one backwards pass over all nodes, gathering every leaf box, beats the scattered walks.
+        if (!m_refitAll)
+        {
+            for (int32_t proxy : m_movedLeaves)
+            {
+                int32_t slot = m_leaves[proxy].parentSlot;
+                GetSlotBox(slot) = m_leafBoxes[proxy];
+                while (slot != NullNode)
+                {
+                    const Node& node = m_nodes[slot >> 1];
+                    BoundingBox box = Union(node.childBoxes[0], node.childBoxes[1]);
+                    BoundingBox& target = GetSlotBox(node.parentSlot);
+                    if (Equals(box, target))
+                    {
+                        break;
+                    }
+                    target = box;
+                    slot = node.parentSlot;
+                }
+            }
+        }
+        else
+        {
+            if (!m_ordered)
+            {
+                Linearize();
+            }
+            // Children sit at higher indices, so they are final by the time their parent pulls their unions
+            Node* nodes = m_nodes.data();
+            const BoundingBox* leafBoxes = m_leafBoxes.data();
+            for (size_t i = m_nodes.size(); i-- > 0;)
+            {
+                Node& node = nodes[i];
+                if (node.children[0] == UnusedNode)
+                {
+                    continue;
+                }
+                for (int c = 0; c < 2; ++c)
+                {
+                    const int32_t child = node.children[c];
+                    if (IsLeaf(child))
+                    {
+                        node.childBoxes[c] = leafBoxes[~child];
+                    }
+                    else
+                    {
+                        node.childBoxes[c] = Union(nodes[child].childBoxes[0], nodes[child].childBoxes[1]);
+                    }
+                }
+            }
+            if (m_proxyCount > 0)
+            {
+                m_rootBox = IsLeaf(m_root) ? leafBoxes[~m_root]
+                                           : Union(nodes[m_root].childBoxes[0], nodes[m_root].childBoxes[1]);
+            }
+        }
+
+        for (int32_t proxy : m_movedLeaves)
+        {
+            m_leaves[proxy].moved = false;
+        }
+        m_movedLeaves.clear();
+        m_refitAll = false;
+    }
+
+    void BoundingVolumeHierarchy::Optimize(size_t maxNodes)
+    {
+        const size_t nodeCount = m_nodes.size();
+        maxNodes = std::min(maxNodes, nodeCount);
+        for (size_t i = 0; i < maxNodes; ++i)
+        {
+            if (m_optimizeCursor >= nodeCount)
+            {
+                m_optimizeCursor = 0;
+            }
+            int32_t index = static_cast<int32_t>(m_optimizeCursor++);
+            if (m_nodes[index].children[0] != UnusedNode)
+            {
+                Rotate(index);
+            }
+        }
+    }
+
+    size_t BoundingVolumeHierarchy::QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& results) const
+    {
+        const size_t start = results.size();
+        if (m_proxyCount == 0)
+        {
+            return 0;
+        }
+
+        float absPlanes[6][3];
+        for (int p = 0; p < 6; ++p)
+        {
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                absPlanes[p][axis] = std::fabs(frustum.planes[p][axis]);
+            }
+        }
+
+        // Returns the planes the box still straddles, or -1 when it is outside
+        auto classify = [&](const BoundingBox& box, int32_t mask)
+        {
+            float center[3];
+            float extent[3];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                center[axis] = (box.min[axis] + box.max[axis]) * 0.5f;
+                extent[axis] = (box.max[axis] - box.min[axis]) * 0.5f;
+            }
+            for (int p = 0; p < 6; ++p)
+            {
+                if ((mask & (1 << p)) == 0)
+                {
+                    continue;
+                }
+                const float* plane = frustum.planes[p];
+                float distance = plane[0] * center[0] + plane[1] * center[1] + plane[2] * center[2] + plane[3];
+                float reach = absPlanes[p][0] * extent[0] + absPlanes[p][1] * extent[1] + absPlanes[p][2] * extent[2];
+                if (distance + reach < 0.0f)
+                {
+                    return -1;
+                }
+                if (distance - reach >= 0.0f)
+                {
+                    mask &= ~(1 << p);
+                }
+            }
+            return mask;
+        };
+
+        // Fully inside subtrees are collected without any further plane tests
+        std::vector<std::pair<int32_t, int32_t>> stack;
+        std::vector<int32_t> collectStack;
+        stack.reserve(64);
+        int32_t rootMask = classify(m_rootBox, 0x3F);
+        if (rootMask >= 0)
+        {
+            stack.push_back({ m_root, rootMask });
+        }
+        while (!stack.empty())
+        {
+            auto [reference, mask] = stack.back();
+            stack.pop_back();
+
+            if (IsLeaf(reference))
+            {
+                results.push_back(m_leaves[~reference].userData);
+                continue;
+            }
+            if (mask == 0)
+            {
+                CollectLeaves(reference, results, collectStack);
+                continue;
+            }
+
+            const Node& node = m_nodes[reference];
+            for (int c = 0; c < 2; ++c)
+            {
+                int32_t childMask = classify(node.childBoxes[c], mask);
+                if (childMask >= 0)
+                {
+                    stack.push_back({ node.children[c], childMask });
+                }
+            }
+        }
+        return results.size() - start;
+    }
+
+    size_t BoundingVolumeHierarchy::QueryBox(const BoundingBox& box, std::vector<uint32_t>& results) const
+    {
+        const size_t start = results.size();
+        if (m_proxyCount == 0 || !Overlaps(m_rootBox, box))
+        {
+            return 0;
+        }
+
+        std::vector<int32_t> stack;
+        stack.reserve(64);
+        stack.push_back(m_root);
+        while (!stack.empty())
+        {
+            int32_t reference = stack.back();
+            stack.pop_back();
+            if (IsLeaf(reference))
+            {
+                results.push_back(m_leaves[~reference].userData);
+                continue;
+            }
+
+            const Node& node = m_nodes[reference];
+            for (int c = 0; c < 2; ++c)
+            {
+                if (Overlaps(node.childBoxes[c], box))
+                {
+                    stack.push_back(node.children[c]);
+                }
+            }
+        }
+        return results.size() - start;
+    }
+
+    bool BoundingVolumeHierarchy::RayCast(const Ray& ray, RayHit& hit) const
+    {
+        std::vector<int32_t> stack;
+        return RayCast(ray, hit, stack);
+    }
+
+    void BoundingVolumeHierarchy::RayCast(const Ray* rays, size_t count, RayHit* hits) const
+    {
+        std::vector<int32_t> stack;
+        for (size_t i = 0; i < count; ++i)
+        {
+            RayCast(rays[i], hits[i], stack);
+        }
+    }
+
+    const BoundingBox& BoundingVolumeHierarchy::GetBounds(int32_t proxy) const
+    {
+        return m_leafBoxes[proxy];
+    }
+
+    uint32_t BoundingVolumeHierarchy::GetUserData(int32_t proxy) const
+    {
+        return m_leaves[proxy].userData;
+    }
+
+    size_t BoundingVolumeHierarchy::GetProxyCount() const
+    {
+        return m_proxyCount;
+    }
+
+    float BoundingVolumeHierarchy::ComputeCost() const
+    {
+        float rootArea = Area(m_rootBox);
+        if (m_proxyCount == 0 || rootArea <= 0.0f)
+        {
+            return 0.0f;
+        }
+
+        float total = 0.0f;
+        for (const auto& node : m_nodes)
+        {
+            if (node.children[0] != UnusedNode)
+            {
+                total += Area(Union(node.childBoxes[0], node.childBoxes[1]));
+            }
+        }
+        return total / rootArea;
+    }
+
+    BoundingBox& BoundingVolumeHierarchy::GetSlotBox(int32_t parentSlot)
+    {
+        return parentSlot == NullNode ? m_rootBox : m_nodes[parentSlot >> 1].childBoxes[parentSlot & 1];
+    }
+
+    const BoundingBox& BoundingVolumeHierarchy::GetSlotBox(int32_t parentSlot) const
+    {
+        return parentSlot == NullNode ? m_rootBox : m_nodes[parentSlot >> 1].childBoxes[parentSlot & 1];
+    }
+
+    int32_t BoundingVolumeHierarchy::GetParentSlot(int32_t reference) const
+    {
+        return IsLeaf(reference) ? m_leaves[~reference].parentSlot : m_nodes[reference].parentSlot;
+    }
+
+    void BoundingVolumeHierarchy::SetParentSlot(int32_t reference, int32_t parentSlot)
+    {
+        if (IsLeaf(reference))
+        {
+            m_leaves[~reference].parentSlot = parentSlot;
+        }
+        else
+        {
+            m_nodes[reference].parentSlot = parentSlot;
+        }
+    }
+
+    bool BoundingVolumeHierarchy::IsOrdered(int32_t parent, int32_t child) const
+    {
+        return parent == NullNode || IsLeaf(child) || parent < child;
+    }
+
+    int32_t BoundingVolumeHierarchy::AllocateNode()
+    {
+        int32_t index;
+        if (m_freeNodes != NullNode)
+        {
+            index = m_freeNodes;
+            m_freeNodes = m_nodes[index].parentSlot;
+        }
+        else
+        {
+            index = static_cast<int32_t>(m_nodes.size());
+            m_nodes.emplace_back();
+        }
+        m_nodes[index] = Node();
+        return index;
+    }
+
+    void BoundingVolumeHierarchy::ReleaseNode(int32_t index)
+    {
+        m_nodes[index] = Node();
+        m_nodes[index].parentSlot = m_freeNodes;
+        m_freeNodes = index;
+    }
+
+    void BoundingVolumeHierarchy::InsertLeaf(int32_t proxy, const BoundingBox& box)
+    {
+        const int32_t leaf = ~proxy;
+        if (m_proxyCount == 1)
+        {
+            m_root = leaf;
+            m_rootBox = box;
+            m_leaves[proxy].parentSlot = NullNode;
+            return;
+        }
+
+        // Greedy descent with the inherited SAH cost of enlarging every ancestor on the way down
+        int32_t sibling = m_root;
+        BoundingBox siblingBox = m_rootBox;
+        while (!IsLeaf(sibling))
+        {
+            const Node& node = m_nodes[sibling];
+            float area = Area(siblingBox);
+            float combinedArea = Area(Union(siblingBox, box));
+            float cost = 2.0f * combinedArea;
+            float inheritance = 2.0f * (combinedArea - area);
+
+            float childCost[2];
+            for (int c = 0; c < 2; ++c)
+            {
+                float enlarged = Area(Union(node.childBoxes[c], box));
+                childCost[c] = (IsLeaf(node.children[c]) ? enlarged : enlarged - Area(node.childBoxes[c]))
+                    + inheritance;
+            }
+
+            if (cost < childCost[0] && cost < childCost[1])
+            {
+                break;
+            }
+            int c = childCost[0] < childCost[1] ? 0 : 1;
+            siblingBox = node.childBoxes[c];
+            sibling = node.children[c];
+        }
+
+        const int32_t oldSlot = GetParentSlot(sibling);
+        const int32_t newParent = AllocateNode();
+        Node& parent = m_nodes[newParent];
+        parent.children[0] = sibling;
+        parent.children[1] = leaf;
+        parent.childBoxes[0] = siblingBox;
+        parent.childBoxes[1] = box;
+        parent.parentSlot = oldSlot;
+        SetParentSlot(sibling, newParent * 2);
+        m_leaves[proxy].parentSlot = newParent * 2 + 1;
+        GetSlotBox(oldSlot) = Union(siblingBox, box);
+
+        const int32_t grandParent = oldSlot == NullNode ? NullNode : oldSlot >> 1;
+        if (grandParent == NullNode)
+        {
+            m_root = newParent;
+        }
+        else
+        {
+            m_nodes[grandParent].children[oldSlot & 1] = newParent;
+        }
+        m_ordered = m_ordered && IsOrdered(grandParent, newParent) && IsOrdered(newParent, sibling);
+
+        FixUpwards(grandParent);
+    }
+
+    void BoundingVolumeHierarchy::RemoveLeaf(int32_t proxy)
+    {
+        const int32_t slot = m_leaves[proxy].parentSlot;
+        if (slot == NullNode)
+        {
+            m_root = NullNode;
+            m_rootBox = BoundingBox();
+            return;
+        }
+
+        // The sibling takes the parent's place, grandParent < parent < sibling keeps the index order intact
+        const int32_t parent = slot >> 1;
+        const Node& parentNode = m_nodes[parent];
+        const int32_t sibling = parentNode.children[(slot & 1) ^ 1];
+        const BoundingBox siblingBox = parentNode.childBoxes[(slot & 1) ^ 1];
+        const int32_t grandSlot = parentNode.parentSlot;
+
+        if (grandSlot == NullNode)
+        {
+            m_root = sibling;
+        }
+        else
+        {
+            m_nodes[grandSlot >> 1].children[grandSlot & 1] = sibling;
+        }
+        GetSlotBox(grandSlot) = siblingBox;
+        SetParentSlot(sibling, grandSlot);
+        ReleaseNode(parent);
+        FixUpwards(grandSlot == NullNode ? NullNode : grandSlot >> 1);
+    }
+
+    int32_t BoundingVolumeHierarchy::BuildRange(const BoundingBox* boxes, int32_t* proxies, size_t count,
+        int32_t parentSlot)
+    {
+        if (count == 1)
+        {
+            m_leaves[proxies[0]].parentSlot = parentSlot;
+            GetSlotBox(parentSlot) = boxes[proxies[0]];
+            return ~proxies[0];
+        }
+
+        BoundingBox centroidBounds = EmptyBox();
+        for (size_t i = 0; i < count; ++i)
+        {
+            const BoundingBox& box = boxes[proxies[i]];
+            for (int axis = 0; axis < 3; ++axis)
+            {
+                float c = Centroid(box, axis);
+                centroidBounds.min[axis] = std::min(centroidBounds.min[axis], c);
+                centroidBounds.max[axis] = std::max(centroidBounds.max[axis], c);
+            }
+        }
+
+        int axis = 0;
+        for (int a = 1; a < 3; ++a)
+        {
+            if (centroidBounds.max[a] - centroidBounds.min[a] > centroidBounds.max[axis] - centroidBounds.min[axis])
+            {
+                axis = a;
+            }
+        }
+
+        size_t split = count / 2;
+        const float axisMin = centroidBounds.min[axis];
+        const float axisExtent = centroidBounds.max[axis] - axisMin;
+        if (axisExtent > 0.0f)
+        {
+            const float binScale = BinCount / axisExtent;
+            auto binOf = [&](int32_t proxy)
+            {
+                int bin = static_cast<int>((Centroid(boxes[proxy], axis) - axisMin) * binScale);
+                return std::min(bin, BinCount - 1);
+            };
+
+            BoundingBox binBoxes[BinCount];
+            size_t binCounts[BinCount] = {};
+            for (auto& box : binBoxes)
+            {
+                box = EmptyBox();
+            }
+            for (size_t i = 0; i < count; ++i)
+            {
+                int bin = binOf(proxies[i]);
+                binBoxes[bin] = Union(binBoxes[bin], boxes[proxies[i]]);
+                ++binCounts[bin];
+            }
+
+            // Sweep from the right to get the area and count of every right partition
+            float rightArea[BinCount];
+            size_t rightCount[BinCount];
+            BoundingBox accumulated = EmptyBox();
+            size_t accumulatedCount = 0;
+            for (int i = BinCount - 1; i > 0; --i)
+            {
+                accumulated = Union(accumulated, binBoxes[i]);
+                accumulatedCount += binCounts[i];
+                rightArea[i] = accumulatedCount > 0 ? Area(accumulated) : 0.0f;
+                rightCount[i] = accumulatedCount;
+            }
+
+            float bestCost = 1e30f;
+            int bestSplit = -1;
+            accumulated = EmptyBox();
+            accumulatedCount = 0;
+            for (int i = 0; i < BinCount - 1; ++i)
+            {
+                accumulated = Union(accumulated, binBoxes[i]);
+                accumulatedCount += binCounts[i];
+                if (accumulatedCount == 0 || rightCount[i + 1] == 0)
+                {
+                    continue;
+                }
+                float cost = Area(accumulated) * accumulatedCount + rightArea[i + 1] * rightCount[i + 1];
+                if (cost < bestCost)
+                {
+                    bestCost = cost;
+                    bestSplit = i;
+                }
+            }
+
+            if (bestSplit >= 0)
+            {
+                int32_t* middle = std::partition(proxies, proxies + count,
+                    [&](int32_t proxy) { return binOf(proxy) <= bestSplit; });
+                split = static_cast<size_t>(middle - proxies);
+            }
+        }
+
+        // Degenerate bins (all centroids in one place) fall back to a median split
+        if (split == 0 || split == count)
+        {
+            split = count / 2;
+            std::nth_element(proxies, proxies + split, proxies + count, [&](int32_t a, int32_t b)
+                {
+                    return Centroid(boxes[a], axis) < Centroid(boxes[b], axis);
+                });
+        }
+
+        // Parents are allocated before their children so the index order holds from the start
+        const int32_t index = AllocateNode();
+        m_nodes[index].parentSlot = parentSlot;
+        const int32_t child0 = BuildRange(boxes, proxies, split, index * 2);
+        const int32_t child1 = BuildRange(boxes, proxies + split, count - split, index * 2 + 1);
+        Node& node = m_nodes[index];
+        node.children[0] = child0;
+        node.children[1] = child1;
+        GetSlotBox(parentSlot) = Union(node.childBoxes[0], node.childBoxes[1]);
+        return index;
+    }
+
+    void BoundingVolumeHierarchy::FixUpwards(int32_t index)
+    {
+        while (index != NullNode)
+        {
+            const Node& node = m_nodes[index];
+            GetSlotBox(node.parentSlot) = Union(node.childBoxes[0], node.childBoxes[1]);
+            Rotate(index);
+            int32_t slot = m_nodes[index].parentSlot;
+            index = slot == NullNode ? NullNode : slot >> 1;
+        }
+    }
+
+    // Kopta et al. style rotation: swap a child with a grandchild on the other side when that shrinks the
+    // intermediate node. The rotated node's own box never changes, so ancestors stay valid.
+    void BoundingVolumeHierarchy::Rotate(int32_t index)
+    {
+        Node& node = m_nodes[index];
+        float bestGain = 0.0f;
+        int bestSide = -1;
+        int bestGrandChild = -1;
+
+        for (int side = 0; side < 2; ++side)
+        {
+            const int32_t lower = node.children[side];
+            const int32_t other = node.children[1 - side];
+            // other moves below lower, skip rotations that would break the index order
+            if (IsLeaf(lower) || (m_ordered && !IsOrdered(lower, other)))
+            {
+                continue;
+            }
+            const Node& lowerNode = m_nodes[lower];
+            const float currentArea = Area(node.childBoxes[side]);
+            for (int g = 0; g < 2; ++g)
+            {
+                // other takes the place of grandchild g, which moves up next to lower
+                float newArea = Area(Union(node.childBoxes[1 - side], lowerNode.childBoxes[1 - g]));
+                float gain = currentArea - newArea;
+                if (gain > bestGain)
+                {
+                    bestGain = gain;
+                    bestSide = side;
+                    bestGrandChild = g;
+                }
+            }
+        }
+
+        if (bestSide < 0)
+        {
+            return;
+        }
+
+        const int32_t lower = node.children[bestSide];
+        const int32_t other = node.children[1 - bestSide];
+        const BoundingBox otherBox = node.childBoxes[1 - bestSide];
+        Node& lowerNode = m_nodes[lower];
+        const int32_t moveUp = lowerNode.children[bestGrandChild];
+        const BoundingBox moveUpBox = lowerNode.childBoxes[bestGrandChild];
+
+        lowerNode.children[bestGrandChild] = other;
+        lowerNode.childBoxes[bestGrandChild] = otherBox;
+        SetParentSlot(other, lower * 2 + bestGrandChild);
+
+        node.children[1 - bestSide] = moveUp;
+        node.childBoxes[1 - bestSide] = moveUpBox;
+        node.childBoxes[bestSide] = Union(lowerNode.childBoxes[0], lowerNode.childBoxes[1]);
+        SetParentSlot(moveUp, index * 2 + 1 - bestSide);
+    }
+
+    // Renumbers the nodes in depth-first order, which restores the index order and puts the first child
+    // right after its parent in memory
+    void BoundingVolumeHierarchy::Linearize()
+    {
+        std::vector<Node> nodes;
+        nodes.reserve(m_proxyCount);
+
+        if (m_proxyCount > 0 && !IsLeaf(m_root))
+        {
+            // Pairs of (old index, new parent slot)
+            std::vector<std::pair<int32_t, int32_t>> stack = { { m_root, NullNode } };
+            while (!stack.empty())
+            {
+                auto [oldIndex, parentSlot] = stack.back();
+                stack.pop_back();
+
+                const int32_t newIndex = static_cast<int32_t>(nodes.size());
+                nodes.push_back(m_nodes[oldIndex]);
+                nodes[newIndex].parentSlot = parentSlot;
+                if (parentSlot == NullNode)
+                {
+                    m_root = newIndex;
+                }
+                else
+                {
+                    nodes[parentSlot >> 1].children[parentSlot & 1] = newIndex;
+                }
+
+                for (int c = 1; c >= 0; --c)
+                {
+                    int32_t child = m_nodes[oldIndex].children[c];
+                    if (IsLeaf(child))
+                    {
+                        m_leaves[~child].parentSlot = newIndex * 2 + c;
+                    }
+                    else
+                    {
+                        stack.push_back({ child, newIndex * 2 + c });
+                    }
+                }
+            }
+        }
+
+        m_nodes = std::move(nodes);
+        m_freeNodes = NullNode;
+        m_ordered = true;
+        m_optimizeCursor = 0;
+    }
+
+    void BoundingVolumeHierarchy::CollectLeaves(int32_t reference, std::vector<uint32_t>& results,
+        std::vector<int32_t>& stack) const
+    {
+        stack.clear();
+        stack.push_back(reference);
+        while (!stack.empty())
+        {
+            int32_t current = stack.back();
+            stack.pop_back();
+            if (IsLeaf(current))
+            {
+                results.push_back(m_leaves[~current].userData);
+            }
+            else
+            {
+                stack.push_back(m_nodes[current].children[0]);
+                stack.push_back(m_nodes[current].children[1]);
+            }
+        }
+    }
+
+    bool BoundingVolumeHierarchy::RayCast(const Ray& ray, RayHit& hit, std::vector<int32_t>& stack) const
+    {
+        hit = RayHit();
+        if (m_proxyCount == 0)
+        {
+            return false;
+        }
+
+        const RayData data = PrepareRay(ray);
+        float closest = ray.maxDistance;
+        float rootDistance = IntersectBox(data, m_rootBox, closest);
+        if (rootDistance < 0.0f)
+        {
+            return false;
+        }
+        if (IsLeaf(m_root))
+        {
+            hit.proxy = ~m_root;
+            hit.userData = m_leaves[~m_root].userData;
+            hit.distance = rootDistance;
+            return true;
+        }
+
+        stack.clear();
+        stack.push_back(m_root);
+        while (!stack.empty())
+        {
+            const Node& node = m_nodes[stack.back()];
+            stack.pop_back();
+
+            float distances[2];
+            for (int c = 0; c < 2; ++c)
+            {
+                distances[c] = IntersectBox(data, node.childBoxes[c], closest);
+                if (distances[c] >= 0.0f && IsLeaf(node.children[c]))
+                {
+                    closest = distances[c];
+                    hit.proxy = ~node.children[c];
+                    hit.userData = m_leaves[hit.proxy].userData;
+                    hit.distance = distances[c];
+                    distances[c] = -1.0f;
+                }
+            }
+
+            // Visit the nearer child first so the farther one is usually pruned by the closer hit
+            int nearSide = distances[1] >= 0.0f && (distances[0] < 0.0f || distances[1] < distances[0]) ? 1 : 0;
+            int farSide = 1 - nearSide;
+            if (distances[farSide] >= 0.0f && distances[farSide] <= closest)
+            {
+                stack.push_back(node.children[farSide]);
+            }
+            if (distances[nearSide] >= 0.0f && distances[nearSide] <= closest)
+            {
+                stack.push_back(node.children[nearSide]);
+            }
+        }
+        return hit.proxy != NullNode;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,115 @@
+#pragma once
+#include "render/Bounds.h"
+#include "render/FrustumCulling.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace eng
+{
+    struct Ray
+    {
+        float origin[3] = { 0.0f, 0.0f, 0.0f };
+        float direction[3] = { 0.0f, 0.0f, -1.0f };
+        float maxDistance = 1e30f;
+    };
+
+    struct RayHit
+    {
+        int32_t proxy = -1;
+        uint32_t userData = 0;
+        // Distance along the ray to the entry point of the hit box
+        float distance = 0.0f;
+    };
+
+    // Dynamic binary BVH over object bounds. Proxies returned by Insert/Build stay valid until removed.
+    // Moving objects only rewrites leaf boxes; Refit then updates the ancestors once per frame.
+    class BoundingVolumeHierarchy
+    {
+    public:
+        static constexpr int32_t NullNode = -1;
+
+        // Rebuilds the whole tree top-down with a binned SAH. Proxy i refers to boxes[i].
+        void Build(const BoundingBox* boxes, const uint32_t* userData, size_t count);
+        void Clear();
+
+        int32_t Insert(const BoundingBox& box, uint32_t userData);
+        void Remove(int32_t proxy);
+        // Only stores the new box, call Refit before querying
+        void Update(int32_t proxy, const BoundingBox& box);
+        // Same as calling Update for each pair, cheaper once most proxies move
+        void Update(const int32_t* proxies, const BoundingBox* boxes, size_t count);
+        void Refit();
+        // Tries up to maxNodes tree rotations that lower the SAH cost, resuming where the last call stopped
+        void Optimize(size_t maxNodes);
+
+        size_t QueryFrustum(const Frustum& frustum, std::vector<uint32_t>& results) const;
+        size_t QueryBox(const BoundingBox& box, std::vector<uint32_t>& results) const;
+        // Nearest box hit, false if the ray misses everything
+        bool RayCast(const Ray& ray, RayHit& hit) const;
+        // Writes one hit per ray, proxy is NullNode for misses
+        void RayCast(const Ray* rays, size_t count, RayHit* hits) const;
+
+        const BoundingBox& GetBounds(int32_t proxy) const;
+        uint32_t GetUserData(int32_t proxy) const;
+        size_t GetProxyCount() const;
+        // Sum of internal node surface areas relative to the root, lower is better
+        float ComputeCost() const;
+
+    private:
+        static constexpr int32_t UnusedNode = INT32_MIN;
+
+        // Every node stores the boxes of its two children, so a refit streams through the node array and
+        // queries test both children from one cache line. Child references are internal node indices when
+        // >= 0 and ~proxy for leaves. Parent slots are parentIndex * 2 + childSide, NullNode for the root.
+        struct alignas(64) Node
+        {
+            BoundingBox childBoxes[2];
+            int32_t children[2] = { UnusedNode, UnusedNode };
+            int32_t parentSlot = NullNode;
+        };
+
+        struct Leaf
+        {
+            int32_t parentSlot = NullNode;
+            uint32_t userData = 0;
+            bool moved = false;
+            bool alive = false;
+        };
+
+        static bool IsLeaf(int32_t reference) { return reference < 0; }
+
+        BoundingBox& GetSlotBox(int32_t parentSlot);
+        const BoundingBox& GetSlotBox(int32_t parentSlot) const;
+        int32_t GetParentSlot(int32_t reference) const;
+        void SetParentSlot(int32_t reference, int32_t parentSlot);
+        bool IsOrdered(int32_t parent, int32_t child) const;
+        int32_t AllocateNode();
+        void ReleaseNode(int32_t index);
+        void InsertLeaf(int32_t proxy, const BoundingBox& box);
+        void RemoveLeaf(int32_t proxy);
+        int32_t BuildRange(const BoundingBox* boxes, int32_t* proxies, size_t count, int32_t parentSlot);
+        void FixUpwards(int32_t index);
+        void Rotate(int32_t index);
+        void Linearize();
+        void CollectLeaves(int32_t reference, std::vector<uint32_t>& results, std::vector<int32_t>& stack) const;
+        bool RayCast(const Ray& ray, RayHit& hit, std::vector<int32_t>& stack) const;
+
+        std::vector<Node> m_nodes;
+        std::vector<Leaf> m_leaves;
+        // Indexed by proxy so Update writes stay sequential, gathered into the nodes by Refit
+        std::vector<BoundingBox> m_leafBoxes;
+        int32_t m_root = NullNode;
+        BoundingBox m_rootBox;
+        int32_t m_freeNodes = NullNode;
+        int32_t m_freeLeaves = NullNode;
+        size_t m_proxyCount = 0;
+        std::vector<int32_t> m_movedLeaves;
+        // Set once enough leaves moved that Refit will do the full pass, later updates then only store boxes
+        bool m_refitAll = false;
+        // While every node has a lower index than its internal children a full refit is one backwards pass
+        // over m_nodes. Inserts that break this re-linearize the nodes on the next full refit.
+        bool m_ordered = true;
+        size_t m_optimizeCursor = 0;
+    };
+}
\ No newline at end of file
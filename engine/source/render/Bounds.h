@@ -0,0 +1,16 @@
+#pragma once
+
+namespace eng
+{
+    struct BoundingBox
+    {
+        float min[3] = { 0.0f, 0.0f, 0.0f };
+        float max[3] = { 0.0f, 0.0f, 0.0f };
+    };
+
+    struct BoundingSphere
+    {
+        float center[3] = { 0.0f, 0.0f, 0.0f };
+        float radius = 0.0f;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,381 @@
+#include "render/FrustumCulling.h"
+#include "math/Simd.h"
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <immintrin.h>
+#define ENG_CULL_X86 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#define ENG_TARGET_AVX2
+#else
+#define ENG_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace eng
+{
+    namespace
+    {
+        CullingPath DetectCullingPath()
+        {
+#if defined(ENG_CULL_X86)
+            return CpuSupportsAVX2() ? CullingPath::AVX2 : CullingPath::SSE;
+#else
+            return CullingPath::Scalar;
+#endif
+        }
+
+        CullingPath& ActivePath()
+        {
+            static CullingPath path = DetectCullingPath();
+            return path;
+        }
+
+        size_t CullBoxesScalar(const Frustum& frustum, const CullingBounds& bounds, size_t begin, size_t end,
+            uint8_t* visible)
+        {
+            size_t visibleCount = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                bool inside = true;
+                for (int p = 0; p < 6 && inside; ++p)
+                {
+                    const float* plane = frustum.planes[p];
+                    float distance = plane[0] * bounds.centerX[i] + plane[1] * bounds.centerY[i]
+                        + plane[2] * bounds.centerZ[i] + plane[3];
+                    float reach = std::fabs(plane[0]) * bounds.extentX[i] + std::fabs(plane[1]) * bounds.extentY[i]
+                        + std::fabs(plane[2]) * bounds.extentZ[i];
+                    inside = distance + reach >= 0.0f;
+                }
+                visible[i] = inside ? 1 : 0;
+                visibleCount += visible[i];
+            }
+            return visibleCount;
+        }
+
+        size_t CullSpheresScalar(const Frustum& frustum, const float* x, const float* y, const float* z,
+            const float* radius, size_t begin, size_t end, uint8_t* visible)
+        {
+            size_t visibleCount = 0;
+            for (size_t i = begin; i < end; ++i)
+            {
+                bool inside = true;
+                for (int p = 0; p < 6 && inside; ++p)
+                {
+                    const float* plane = frustum.planes[p];
+                    inside = plane[0] * x[i] + plane[1] * y[i] + plane[2] * z[i] + plane[3] >= -radius[i];
+                }
+                visible[i] = inside ? 1 : 0;
+                visibleCount += visible[i];
+            }
+            return visibleCount;
+        }
+
+#if defined(ENG_CULL_X86)
+        size_t CountBits(unsigned mask)
+        {
+            size_t count = 0;
+            for (; mask != 0; mask &= mask - 1)
+            {
+                ++count;
+            }
+            return count;
+        }
+
+        void WriteMask(int mask, int lanes, uint8_t* visible)
+        {
+            for (int lane = 0; lane < lanes; ++lane)
+            {
+                visible[lane] = static_cast<uint8_t>((mask >> lane) & 1);
+            }
+        }
+
+        size_t CullBoxesSSE(const Frustum& frustum, const CullingBounds& bounds, size_t count, uint8_t* visible)
+        {
+            const __m128 signMask = _mm_set1_ps(-0.0f);
+            const __m128 zero = _mm_setzero_ps();
+            size_t visibleCount = 0;
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 cx = _mm_loadu_ps(&bounds.centerX[i]);
+                __m128 cy = _mm_loadu_ps(&bounds.centerY[i]);
+                __m128 cz = _mm_loadu_ps(&bounds.centerZ[i]);
+                __m128 ex = _mm_loadu_ps(&bounds.extentX[i]);
+                __m128 ey = _mm_loadu_ps(&bounds.extentY[i]);
+                __m128 ez = _mm_loadu_ps(&bounds.extentZ[i]);
+                __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (int p = 0; p < 6; ++p)
+                {
+                    const float* plane = frustum.planes[p];
+                    __m128 nx = _mm_set1_ps(plane[0]);
+                    __m128 ny = _mm_set1_ps(plane[1]);
+                    __m128 nz = _mm_set1_ps(plane[2]);
+                    __m128 distance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, cx), _mm_mul_ps(ny, cy)),
+                        _mm_add_ps(_mm_mul_ps(nz, cz), _mm_set1_ps(plane[3])));
+                    __m128 reach = _mm_add_ps(_mm_add_ps(
+                        _mm_mul_ps(_mm_andnot_ps(signMask, nx), ex),
+                        _mm_mul_ps(_mm_andnot_ps(signMask, ny), ey)),
+                        _mm_mul_ps(_mm_andnot_ps(signMask, nz), ez));
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(distance, reach), zero));
+                }
+                int mask = _mm_movemask_ps(inside);
+                WriteMask(mask, 4, visible + i);
+                visibleCount += CountBits(static_cast<unsigned>(mask));
+            }
+            return visibleCount + CullBoxesScalar(frustum, bounds, i, count, visible);
+        }
+
+        ENG_TARGET_AVX2 size_t CullBoxesAVX2(const Frustum& frustum, const CullingBounds& bounds, size_t count,
+            uint8_t* visible)
+        {
+            const __m256 signMask = _mm256_set1_ps(-0.0f);
+            const __m256 zero = _mm256_setzero_ps();
+            size_t visibleCount = 0;
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 cx = _mm256_loadu_ps(&bounds.centerX[i]);
+                __m256 cy = _mm256_loadu_ps(&bounds.centerY[i]);
+                __m256 cz = _mm256_loadu_ps(&bounds.centerZ[i]);
+                __m256 ex = _mm256_loadu_ps(&bounds.extentX[i]);
+                __m256 ey = _mm256_loadu_ps(&bounds.extentY[i]);
+                __m256 ez = _mm256_loadu_ps(&bounds.extentZ[i]);
+                __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+                for (int p = 0; p < 6; ++p)
+                {
+                    const float* plane = frustum.planes[p];
+                    __m256 nx = _mm256_set1_ps(plane[0]);
+                    __m256 ny = _mm256_set1_ps(plane[1]);
+                    __m256 nz = _mm256_set1_ps(plane[2]);
+                    __m256 distance = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, cx), _mm256_mul_ps(ny, cy)),
+                        _mm256_add_ps(_mm256_mul_ps(nz, cz), _mm256_set1_ps(plane[3])));
+                    __m256 reach = _mm256_add_ps(_mm256_add_ps(
+                        _mm256_mul_ps(_mm256_andnot_ps(signMask, nx), ex),
+                        _mm256_mul_ps(_mm256_andnot_ps(signMask, ny), ey)),
+                        _mm256_mul_ps(_mm256_andnot_ps(signMask, nz), ez));
+                    inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(distance, reach), zero, _CMP_GE_OQ));
+                }
+                int mask = _mm256_movemask_ps(inside);
+                WriteMask(mask, 8, visible + i);
+                visibleCount += CountBits(static_cast<unsigned>(mask));
+            }
+            return visibleCount + CullBoxesScalar(frustum, bounds, i, count, visible);
+        }
+
+        size_t CullSpheresSSE(const Frustum& frustum, const float* x, const float* y, const float* z,
+            const float* radius, size_t count, uint8_t* visible)
+        {
+            size_t visibleCount = 0;
+            size_t i = 0;
+            for (; i + 4 <= count; i += 4)
+            {
+                __m128 cx = _mm_loadu_ps(x + i);
+                __m128 cy = _mm_loadu_ps(y + i);
+                __m128 cz = _mm_loadu_ps(z + i);
+                __m128 negativeRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+                __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+                for (int p = 0; p < 6; ++p)
+                {
+                    const float* plane = frustum.planes[p];
+                    __m128 distance = _mm_add_ps(
+                        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[0]), cx), _mm_mul_ps(_mm_set1_ps(plane[1]), cy)),
+                        _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane[2]), cz), _mm_set1_ps(plane[3])));
+                    inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negativeRadius));
+                }
+                int mask = _mm_movemask_ps(inside);
+                WriteMask(mask, 4, visible + i);
+                visibleCount += CountBits(static_cast<unsigned>(mask));
+            }
+            return visibleCount + CullSpheresScalar(frustum, x, y, z, radius, i, count, visible);
+        }
+
+        ENG_TARGET_AVX2 size_t CullSpheresAVX2(const Frustum& frustum, const float* x, const float* y,
+            const float* z, const float* radius, size_t count, uint8_t* visible)
+        {
+            size_t visibleCount = 0;
+            size_t i = 0;
+            for (; i + 8 <= count; i += 8)
+            {
+                __m256 cx = _mm256_loadu_ps(x + i);
+                __m256 cy = _mm256_loadu_ps(y + i);
+                __m256 cz = _mm256_loadu_ps(z + i);
+                __m256 negativeRadius = _mm256_sub_ps(_mm256_setzero_ps(), _mm256_loadu_ps(radius + i));
+                __m256 inside = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+                for (int p = 0; p < 6; ++p)
+                {
+                    const float* plane = frustum.planes[p];
+                    __m256 distance = _mm256_add_ps(
+                        _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane[0]), cx),
+                            _mm256_mul_ps(_mm256_set1_ps(plane[1]), cy)),
+                        _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane[2]), cz), _mm256_set1_ps(plane[3])));
+                    inside = _mm256_and_ps(inside, _mm256_cmp_ps(distance, negativeRadius, _CMP_GE_OQ));
+                }
+                int mask = _mm256_movemask_ps(inside);
+                WriteMask(mask, 8, visible + i);
+                visibleCount += CountBits(static_cast<unsigned>(mask));
+            }
+            return visibleCount + CullSpheresScalar(frustum, x, y, z, radius, i, count, visible);
+        }
+#endif
+    }
+
+    Frustum Frustum::FromViewProjection(const float* m)
+    {
+        // Gribb/Hartmann: planes are sums/differences of the matrix rows (m is column-major)
+        auto row = [m](int r, int c) { return m[c * 4 + r]; };
+
+        Frustum frustum;
+        for (int i = 0; i < 3; ++i)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                frustum.planes[i * 2][c] = row(3, c) + row(i, c);
+                frustum.planes[i * 2 + 1][c] = row(3, c) - row(i, c);
+            }
+        }
+
+        for (auto& plane : frustum.planes)
+        {
+            float length = std::sqrt(plane[0] * plane[0] + plane[1] * plane[1] + plane[2] * plane[2]);
+            if (length > 0.0f)
+            {
+                for (int c = 0; c < 4; ++c)
+                {
+                    plane[c] /= length;
+                }
+            }
+        }
+        return frustum;
+    }
+
+    void CullingBounds::Clear()
+    {
+        centerX.clear();
+        centerY.clear();
+        centerZ.clear();
+        extentX.clear();
+        extentY.clear();
+        extentZ.clear();
+    }
+
+    void CullingBounds::Reserve(size_t count)
+    {
+        centerX.reserve(count);
+        centerY.reserve(count);
+        centerZ.reserve(count);
+        extentX.reserve(count);
+        extentY.reserve(count);
+        extentZ.reserve(count);
+    }
+
+    size_t CullingBounds::Size() const
+    {
+        return centerX.size();
+    }
+
+    void CullingBounds::Add(const BoundingBox& box)
+    {
+        centerX.push_back((box.min[0] + box.max[0]) * 0.5f);
+        centerY.push_back((box.min[1] + box.max[1]) * 0.5f);
+        centerZ.push_back((box.min[2] + box.max[2]) * 0.5f);
+        extentX.push_back((box.max[0] - box.min[0]) * 0.5f);
+        extentY.push_back((box.max[1] - box.min[1]) * 0.5f);
+        extentZ.push_back((box.max[2] - box.min[2]) * 0.5f);
+    }
+
+    void CullingBounds::Add(const BoundingBox& box, const float* matrix)
+    {
+        centerX.push_back(0.0f);
+        centerY.push_back(0.0f);
+        centerZ.push_back(0.0f);
+        extentX.push_back(0.0f);
+        extentY.push_back(0.0f);
+        extentZ.push_back(0.0f);
+        Set(Size() - 1, box, matrix);
+    }
+
+    void CullingBounds::Set(size_t index, const BoundingBox& box, const float* m)
+    {
+        float center[3];
+        float extent[3];
+        for (int i = 0; i < 3; ++i)
+        {
+            center[i] = (box.min[i] + box.max[i]) * 0.5f;
+            extent[i] = (box.max[i] - box.min[i]) * 0.5f;
+        }
+
+        // Arvo: the world extent along each axis is the extent projected through |M|
+        float worldCenter[3];
+        float worldExtent[3];
+        for (int r = 0; r < 3; ++r)
+        {
+            worldCenter[r] = m[12 + r];
+            worldExtent[r] = 0.0f;
+            for (int c = 0; c < 3; ++c)
+            {
+                worldCenter[r] += m[c * 4 + r] * center[c];
+                worldExtent[r] += std::fabs(m[c * 4 + r]) * extent[c];
+            }
+        }
+
+        centerX[index] = worldCenter[0];
+        centerY[index] = worldCenter[1];
+        centerZ[index] = worldCenter[2];
+        extentX[index] = worldExtent[0];
+        extentY[index] = worldExtent[1];
+        extentZ[index] = worldExtent[2];
+    }
+
+    CullingPath GetCullingPath()
+    {
+        return ActivePath();
+    }
+
+    void SetCullingPath(CullingPath path)
+    {
+        if (path == CullingPath::AVX2 && !CpuSupportsAVX2())
+        {
+            return;
+        }
+#if !defined(ENG_CULL_X86)
+        if (path != CullingPath::Scalar)
+        {
+            return;
+        }
+#endif
+        ActivePath() = path;
+    }
+
+    size_t CullBoxes(const Frustum& frustum, const CullingBounds& bounds, uint8_t* visible)
+    {
+        const size_t count = bounds.Size();
+        switch (ActivePath())
+        {
+#if defined(ENG_CULL_X86)
+        case CullingPath::AVX2:
+            return CullBoxesAVX2(frustum, bounds, count, visible);
+        case CullingPath::SSE:
+            return CullBoxesSSE(frustum, bounds, count, visible);
+#endif
+        default:
+            return CullBoxesScalar(frustum, bounds, 0, count, visible);
+        }
+    }
+
+    size_t CullSpheres(const Frustum& frustum, const float* centerX, const float* centerY, const float* centerZ,
+        const float* radius, size_t count, uint8_t* visible)
+    {
+        switch (ActivePath())
+        {
+#if defined(ENG_CULL_X86)
+        case CullingPath::AVX2:
+            return CullSpheresAVX2(frustum, centerX, centerY, centerZ, radius, count, visible);
+        case CullingPath::SSE:
+            return CullSpheresSSE(frustum, centerX, centerY, centerZ, radius, count, visible);
+#endif
+        default:
+            return CullSpheresScalar(frustum, centerX, centerY, centerZ, radius, 0, count, visible);
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#include "render/Bounds.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace eng
+{
+    // Planes as (nx, ny, nz, d) with normals pointing inside, dot(n, p) + d >= 0 means inside
+    struct Frustum
+    {
+        float planes[6][4] = {};
+
+        // Column-major view-projection matrix as used by GL
+        static Frustum FromViewProjection(const float* matrix);
+    };
+
+    // Structure-of-arrays bounds so the culling kernels can load 4/8 objects per instruction
+    struct CullingBounds
+    {
+        std::vector<float> centerX;
+        std::vector<float> centerY;
+        std::vector<float> centerZ;
+        std::vector<float> extentX;
+        std::vector<float> extentY;
+        std::vector<float> extentZ;
+
+        void Clear();
+        void Reserve(size_t count);
+        size_t Size() const;
+        void Add(const BoundingBox& box);
+        // Transforms the box by a column-major 4x4 matrix into a world space box
+        void Add(const BoundingBox& box, const float* matrix);
+        void Set(size_t index, const BoundingBox& box, const float* matrix);
+    };
+
+    enum class CullingPath
+    {
+        Scalar,
+        SSE,
+        AVX2
+    };
+
+    // Best path for this CPU unless overridden (benchmarks compare paths)
+    CullingPath GetCullingPath();
+    void SetCullingPath(CullingPath path);
+
+    // Writes 1/0 per box into visible and returns the number of visible boxes
+    size_t CullBoxes(const Frustum& frustum, const CullingBounds& bounds, uint8_t* visible);
+    size_t CullSpheres(const Frustum& frustum, const float* centerX, const float* centerY, const float* centerZ,
+        const float* radius, size_t count, uint8_t* visible);
+}
\ No newline at end of file
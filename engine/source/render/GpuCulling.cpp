@@ -0,0 +1,603 @@
+#include "render/GpuCulling.h"
+#include "render/Mesh.h"
+#include "render/OcclusionCulling.h"
+#include "graphics/GraphicsAPI.h"
+#include "graphics/ShaderProgram.h"
+#include "profile/Profiler.h"
+#include <algorithm>
+
+namespace eng
+{
+    namespace
+    {
+        // Mirrors OcclusionCuller::IsVisible so both paths agree on what is hidden
+        const char* CullComputeSource = R"(
+            #version 430 core
+            layout (local_size_x = 64) in;
+
+            struct DrawCommand
+            {
+                uint count;
+                uint instanceCount;
+                uint firstIndex;
+                int baseVertex;
+                uint baseInstance;
+            };
+
+            layout (std430, binding = 0) readonly buffer InstanceBounds { vec4 bounds[]; };
+            layout (std430, binding = 1) writeonly buffer DrawCommands { DrawCommand commands[]; };
+            layout (std430, binding = 2) buffer DrawCount { uint drawCount; };
+            // Per level (offset into depth, width, height, unused)
+            layout (std430, binding = 3) readonly buffer DepthHierarchy { ivec4 levels[16]; float depth[]; };
+
+            uniform mat4 uViewProjection;
+            uniform int uInstanceCount;
+            uniform int uIndexCount;
+            uniform int uFirstIndex;
+            uniform int uCompact;
+            uniform int uCull;
+            uniform int uLevelCount;
+
+            const float MinClipW = 1e-5;
+            const int MaxTestTexels = 4;
+
+            bool IsVisible(vec3 center, vec3 extent)
+            {
+                vec4 clipCenter = uViewProjection * vec4(center, 1.0);
+                vec4 axisX = uViewProjection[0] * extent.x;
+                vec4 axisY = uViewProjection[1] * extent.y;
+                vec4 axisZ = uViewProjection[2] * extent.z;
+
+                uint outside = 63u;
+                bool behind = false;
+                vec3 rectMin = vec3(1e30);
+                vec3 rectMax = vec3(-1e30);
+                for (int corner = 0; corner < 8; ++corner)
+                {
+                    vec4 clip = clipCenter + axisX * ((corner & 1) != 0 ? 1.0 : -1.0)
+                        + axisY * ((corner & 2) != 0 ? 1.0 : -1.0) + axisZ * ((corner & 4) != 0 ? 1.0 : -1.0);
+
+                    // Hidden by the frustum only when every corner is outside the same clip plane
+                    uint planes = 0u;
+                    planes |= clip.x < -clip.w ? 1u : 0u;
+                    planes |= clip.x > clip.w ? 2u : 0u;
+                    planes |= clip.y < -clip.w ? 4u : 0u;
+                    planes |= clip.y > clip.w ? 8u : 0u;
+                    planes |= clip.z < -clip.w ? 16u : 0u;
+                    planes |= clip.z > clip.w ? 32u : 0u;
+                    outside &= planes;
+
+                    if (clip.w <= MinClipW || clip.z + clip.w < 0.0)
+                    {
+                        behind = true;
+                        continue;
+                    }
+                    vec3 ndc = clip.xyz / clip.w;
+                    rectMin = min(rectMin, ndc);
+                    rectMax = max(rectMax, ndc);
+                }
+
+                if (outside != 0u)
+                {
+                    return false;
+                }
+                if (uLevelCount == 0 || behind)
+                {
+                    return true;
+                }
+
+                ivec2 size = levels[0].yz;
+                ivec2 p0 = min(size - 1, ivec2(max(vec2(0.0), (rectMin.xy * 0.5 + 0.5) * vec2(size))));
+                ivec2 p1 = min(size - 1, ivec2(max(vec2(0.0), (rectMax.xy * 0.5 + 0.5) * vec2(size))));
+
+                int level = 0;
+                while (level + 1 < uLevelCount && (p1.x - p0.x >= MaxTestTexels || p1.y - p0.y >= MaxTestTexels))
+                {
+                    p0 >>= 1;
+                    p1 >>= 1;
+                    ++level;
+                }
+
+                float minDepth = rectMin.z * 0.5 + 0.5;
+                int offset = levels[level].x;
+                int width = levels[level].y;
+                for (int y = p0.y; y <= p1.y; ++y)
+                {
+                    for (int x = p0.x; x <= p1.x; ++x)
+                    {
+                        if (depth[offset + y * width + x] >= minDepth)
+                        {
+                            return true;
+                        }
+                    }
+                }
+                return false;
+            }
+
+            void main()
+            {
+                uint index = gl_GlobalInvocationID.x;
+                if (index >= uint(uInstanceCount))
+                {
+                    return;
+                }
+
+                bool visible = uCull == 0 || IsVisible(bounds[index * 2u].xyz, bounds[index * 2u + 1u].xyz);
+                if (uCompact != 0)
+                {
+                    if (visible)
+                    {
+                        uint slot = atomicAdd(drawCount, 1u);
+                        commands[slot] = DrawCommand(uint(uIndexCount), 1u, uint(uFirstIndex), 0, index);
+                    }
+                }
+                else
+                {
+                    commands[index] = DrawCommand(uint(uIndexCount), visible ? 1u : 0u, uint(uFirstIndex), 0, index);
+                }
+            }
+        )";
+
+        struct DrawElementsIndirectCommand
+        {
+            uint32_t count;
+            uint32_t instanceCount;
+            uint32_t firstIndex;
+            int32_t baseVertex;
+            uint32_t baseInstance;
+        };
+
+        const GLuint WorkGroupSize = 64;
+        const int MaxHierarchyLevels = 16;
+        const size_t HierarchyHeaderSize = MaxHierarchyLevels * 4 * sizeof(int32_t);
+        const size_t TransformSize = 16 * sizeof(float);
+        const size_t BoundsSize = 8 * sizeof(float);
+        const size_t MinInstanceCapacity = 64;
+    }
+
+    GpuInstanceBatch::GpuInstanceBatch(Mesh* mesh, Material* material)
+        : m_mesh(mesh), m_material(material)
+    {
+    }
+
+    GpuInstanceBatch::~GpuInstanceBatch()
+    {
+        if (m_transformBuffer)
+        {
+            glDeleteBuffers(1, &m_transformBuffer);
+        }
+        if (m_boundsBuffer)
+        {
+            glDeleteBuffers(1, &m_boundsBuffer);
+        }
+        if (m_commandBuffer)
+        {
+            glDeleteBuffers(1, &m_commandBuffer);
+        }
+    }
+
+    uint32_t GpuInstanceBatch::Add(const float* transform)
+    {
+        size_t index = GetCount();
+        m_transforms.insert(m_transforms.end(), transform, transform + 16);
+        ExtendRange(m_changedBegin, m_changedEnd, index, index + 1);
+        return static_cast<uint32_t>(index);
+    }
+
+    void GpuInstanceBatch::SetTransform(uint32_t instance, const float* transform)
+    {
+        if (instance >= GetCount())
+        {
+            return;
+        }
+        std::copy(transform, transform + 16, &m_transforms[static_cast<size_t>(instance) * 16]);
+        ExtendRange(m_changedBegin, m_changedEnd, instance, instance + 1);
+    }
+
+    void GpuInstanceBatch::Clear()
+    {
+        m_transforms.clear();
+        m_changedBegin = 0;
+        m_changedEnd = 0;
+    }
+
+    size_t GpuInstanceBatch::GetCount() const
+    {
+        return m_transforms.size() / 16;
+    }
+
+    Mesh* GpuInstanceBatch::GetMesh() const
+    {
+        return m_mesh;
+    }
+
+    Material* GpuInstanceBatch::GetMaterial() const
+    {
+        return m_material;
+    }
+
+    void GpuInstanceBatch::Publish()
+    {
+        const size_t count = GetCount();
+        // Only Clear shrinks a batch, everything added since then is in the changed range
+        if (count < m_bounds.Size())
+        {
+            m_bounds.Clear();
+        }
+        m_renderTransforms.resize(m_transforms.size());
+
+        const size_t first = m_changedBegin;
+        const size_t last = std::min(m_changedEnd, count);
+        const BoundingBox box = m_mesh ? m_mesh->GetBounds() : BoundingBox();
+        for (size_t i = first; i < last; ++i)
+        {
+            const float* transform = &m_transforms[i * 16];
+            std::copy(transform, transform + 16, &m_renderTransforms[i * 16]);
+            if (i < m_bounds.Size())
+            {
+                m_bounds.Set(i, box, transform);
+            }
+            else
+            {
+                m_bounds.Add(box, transform);
+            }
+        }
+        if (first < last)
+        {
+            ExtendRange(m_dirtyBegin, m_dirtyEnd, first, last);
+        }
+        m_changedBegin = 0;
+        m_changedEnd = 0;
+    }
+
+    size_t GpuInstanceBatch::GetRenderCount() const
+    {
+        return m_bounds.Size();
+    }
+
+    void GpuInstanceBatch::ExtendRange(size_t& begin, size_t& end, size_t first, size_t last)
+    {
+        if (begin == end)
+        {
+            begin = first;
+            end = last;
+        }
+        else
+        {
+            begin = std::min(begin, first);
+            end = std::max(end, last);
+        }
+    }
+
+    void GpuCuller::BeginFrame(GraphicsAPI& graphicsAPI, const float* viewProjection,
+        const OcclusionCuller* hierarchy)
+    {
+        m_cpuCulled = 0;
+        m_hasViewProjection = viewProjection != nullptr;
+        m_hierarchy = m_hasViewProjection ? hierarchy : nullptr;
+        if (m_hasViewProjection)
+        {
+            std::copy(viewProjection, viewProjection + 16, m_viewProjection);
+            m_frustum = Frustum::FromViewProjection(viewProjection);
+        }
+
+        if (!m_initialized && !InitResources(graphicsAPI))
+        {
+            return;
+        }
+
+        m_hierarchyLevels = 0;
+        if (m_path != GpuCullingPath::Cpu && m_hierarchy)
+        {
+            UploadHierarchy(*m_hierarchy);
+            graphicsAPI.GetFrameStats().Add(RenderCounter::BytesUploaded, m_uploadedBytes);
+            m_uploadedBytes = 0;
+        }
+    }
+
+    void GpuCuller::Draw(GraphicsAPI& graphicsAPI, GpuInstanceBatch& batch)
+    {
+        ENG_PROFILE_SCOPE("GpuCuller::Draw");
+        if (batch.GetRenderCount() == 0 || !batch.m_mesh || !m_initialized
+            || batch.m_mesh->GetCurrentIndexRange().indexCount == 0)
+        {
+            return;
+        }
+
+        if (m_path == GpuCullingPath::Cpu)
+        {
+            DrawCpu(graphicsAPI, batch);
+        }
+        else
+        {
+            DrawCompute(graphicsAPI, batch);
+        }
+    }
+
+    void GpuCuller::Shutdown()
+    {
+        if (m_countBuffer)
+        {
+            glDeleteBuffers(1, &m_countBuffer);
+            glDeleteBuffers(1, &m_hierarchyBuffer);
+        }
+        m_countBuffer = 0;
+        m_hierarchyBuffer = 0;
+        m_hierarchyCapacity = 0;
+        m_cullProgram.reset();
+        m_path = GpuCullingPath::Cpu;
+        m_initialized = false;
+    }
+
+    GpuCullingPath GpuCuller::GetPath() const
+    {
+        return m_path;
+    }
+
+    size_t GpuCuller::GetCpuCulledCount() const
+    {
+        return m_cpuCulled;
+    }
+
+    bool GpuCuller::InitResources(GraphicsAPI& graphicsAPI)
+    {
+        m_initialized = true;
+        m_path = GpuCullingPath::Cpu;
+
+        const bool storageBuffers = GLEW_VERSION_4_3 || GLEW_ARB_shader_storage_buffer_object;
+        const bool multiDrawIndirect = GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect;
+        if (!storageBuffers || !multiDrawIndirect)
+        {
+            return true;
+        }
+
+        m_cullProgram = graphicsAPI.CreateComputeProgram(CullComputeSource);
+        if (!m_cullProgram)
+        {
+            return true;
+        }
+
+        glGenBuffers(1, &m_countBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_countBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(uint32_t), nullptr, GL_DYNAMIC_DRAW);
+
+        m_hierarchyCapacity = HierarchyHeaderSize;
+        glGenBuffers(1, &m_hierarchyBuffer);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_hierarchyBuffer);
+        glBufferData(GL_SHADER_STORAGE_BUFFER, m_hierarchyCapacity, nullptr, GL_DYNAMIC_DRAW);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        m_path = (GLEW_VERSION_4_6 || GLEW_ARB_indirect_parameters)
+            ? GpuCullingPath::ComputeIndirectCount : GpuCullingPath::ComputeIndirect;
+        return true;
+    }
+
+    void GpuCuller::UploadHierarchy(const OcclusionCuller& hierarchy)
+    {
+        // The finest levels are kept, a capped pyramid only means more texels per test
+        const int levelCount = static_cast<int>(std::min<size_t>(hierarchy.GetLevelCount(), MaxHierarchyLevels));
+        int32_t header[MaxHierarchyLevels][4] = {};
+        size_t depthCount = 0;
+        for (int level = 0; level < levelCount; ++level)
+        {
+            header[level][0] = static_cast<int32_t>(depthCount);
+            header[level][1] = hierarchy.GetLevelWidth(level);
+            header[level][2] = hierarchy.GetLevelHeight(level);
+            depthCount += static_cast<size_t>(header[level][1]) * header[level][2];
+        }
+
+        const size_t size = HierarchyHeaderSize + depthCount * sizeof(float);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_hierarchyBuffer);
+        if (size > m_hierarchyCapacity)
+        {
+            m_hierarchyCapacity = size;
+            glBufferData(GL_SHADER_STORAGE_BUFFER, m_hierarchyCapacity, nullptr, GL_DYNAMIC_DRAW);
+        }
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(header), header);
+        m_uploadedBytes += size;
+        for (int level = 0; level < levelCount; ++level)
+        {
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, HierarchyHeaderSize + header[level][0] * sizeof(float),
+                static_cast<size_t>(header[level][1]) * header[level][2] * sizeof(float), hierarchy.GetLevel(level));
+        }
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        m_hierarchyLevels = levelCount;
+    }
+
+    void GpuCuller::UploadInstances(GpuInstanceBatch& batch)
+    {
+        const size_t count = batch.GetRenderCount();
+        if (count > batch.m_capacity || !batch.m_transformBuffer)
+        {
+            batch.m_capacity = std::max(std::max(count, batch.m_capacity * 2), MinInstanceCapacity);
+            if (!batch.m_transformBuffer)
+            {
+                glGenBuffers(1, &batch.m_transformBuffer);
+                glGenBuffers(1, &batch.m_boundsBuffer);
+                glGenBuffers(1, &batch.m_commandBuffer);
+            }
+            glBindBuffer(GL_ARRAY_BUFFER, batch.m_transformBuffer);
+            glBufferData(GL_ARRAY_BUFFER, batch.m_capacity * TransformSize, nullptr, GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch.m_boundsBuffer);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, batch.m_capacity * BoundsSize, nullptr, GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch.m_commandBuffer);
+            glBufferData(GL_SHADER_STORAGE_BUFFER, batch.m_capacity * sizeof(DrawElementsIndirectCommand), nullptr,
+                GL_DYNAMIC_DRAW);
+            batch.m_dirtyBegin = 0;
+            batch.m_dirtyEnd = count;
+        }
+
+        const size_t first = batch.m_dirtyBegin;
+        const size_t last = std::min(batch.m_dirtyEnd, count);
+        if (first < last)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, batch.m_transformBuffer);
+            glBufferSubData(GL_ARRAY_BUFFER, first * TransformSize, (last - first) * TransformSize,
+                &batch.m_renderTransforms[first * 16]);
+
+            const CullingBounds& bounds = batch.m_bounds;
+            m_boundsUpload.resize((last - first) * 8);
+            for (size_t i = first; i < last; ++i)
+            {
+                float* out = &m_boundsUpload[(i - first) * 8];
+                out[0] = bounds.centerX[i];
+                out[1] = bounds.centerY[i];
+                out[2] = bounds.centerZ[i];
+                out[3] = 0.0f;
+                out[4] = bounds.extentX[i];
+                out[5] = bounds.extentY[i];
+                out[6] = bounds.extentZ[i];
+                out[7] = 0.0f;
+            }
+            glBindBuffer(GL_SHADER_STORAGE_BUFFER, batch.m_boundsBuffer);
+            glBufferSubData(GL_SHADER_STORAGE_BUFFER, first * BoundsSize, (last - first) * BoundsSize,
+                m_boundsUpload.data());
+            m_uploadedBytes += (last - first) * (TransformSize + BoundsSize);
+        }
+        batch.m_dirtyBegin = 0;
+        batch.m_dirtyEnd = 0;
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
+    void GpuCuller::BindInstanceAttributes(GpuInstanceBatch& batch)
+    {
+        if (batch.m_attributesBound)
+        {
+            return;
+        }
+
+        // Lives in the mesh VAO, so rebinding the mesh brings the instance stream along
+        batch.m_mesh->Bind();
+        glBindBuffer(GL_ARRAY_BUFFER, batch.m_transformBuffer);
+        for (GLuint column = 0; column < 4; ++column)
+        {
+            glEnableVertexAttribArray(InstanceTransformLocation + column);
+            glVertexAttribPointer(InstanceTransformLocation + column, 4, GL_FLOAT, GL_FALSE,
+                static_cast<GLsizei>(TransformSize), (void*)(uintptr_t)(column * 4 * sizeof(float)));
+            glVertexAttribDivisor(InstanceTransformLocation + column, 1);
+        }
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        batch.m_attributesBound = true;
+    }
+
+    void GpuCuller::DrawCompute(GraphicsAPI& graphicsAPI, GpuInstanceBatch& batch)
+    {
+        UploadInstances(batch);
+        BindInstanceAttributes(batch);
+
+        const size_t count = batch.GetRenderCount();
+        const MeshLod range = batch.m_mesh->GetCurrentIndexRange();
+        const bool compact = m_path == GpuCullingPath::ComputeIndirectCount;
+        const uint32_t zero = 0;
+
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_countBuffer);
+        glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, sizeof(zero), &zero);
+        glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+        graphicsAPI.BindShaderProgram(m_cullProgram.get());
+        m_cullProgram->SetUniformMatrix4("uViewProjection", m_viewProjection);
+        m_cullProgram->SetUniform("uInstanceCount", static_cast<int>(count));
+        m_cullProgram->SetUniform("uIndexCount", static_cast<int>(range.indexCount));
+        m_cullProgram->SetUniform("uFirstIndex", static_cast<int>(range.indexOffset));
+        m_cullProgram->SetUniform("uCompact", compact ? 1 : 0);
+        m_cullProgram->SetUniform("uCull", m_hasViewProjection ? 1 : 0);
+        m_cullProgram->SetUniform("uLevelCount", m_hierarchyLevels);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 0, batch.m_boundsBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 1, batch.m_commandBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 2, m_countBuffer);
+        glBindBufferBase(GL_SHADER_STORAGE_BUFFER, 3, m_hierarchyBuffer);
+        glDispatchCompute(static_cast<GLuint>((count + WorkGroupSize - 1) / WorkGroupSize), 1, 1);
+        glMemoryBarrier(GL_COMMAND_BARRIER_BIT);
+        graphicsAPI.GetFrameStats().Add(RenderCounter::ComputeDispatches);
+
+        graphicsAPI.BindMaterial(batch.m_material);
+        graphicsAPI.BindMesh(batch.m_mesh);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, batch.m_commandBuffer);
+        if (compact)
+        {
+            glBindBuffer(GL_PARAMETER_BUFFER, m_countBuffer);
+            if (GLEW_VERSION_4_6)
+            {
+                glMultiDrawElementsIndirectCount(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, 0,
+                    static_cast<GLsizei>(count), 0);
+            }
+            else
+            {
+                glMultiDrawElementsIndirectCountARB(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, 0,
+                    static_cast<GLsizei>(count), 0);
+            }
+            glBindBuffer(GL_PARAMETER_BUFFER, 0);
+        }
+        else
+        {
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr, static_cast<GLsizei>(count), 0);
+        }
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+        // How many slots survived culling is only known on the GPU
+        RenderStats& stats = graphicsAPI.GetFrameStats();
+        stats.Add(RenderCounter::DrawCalls);
+        stats.Add(RenderCounter::Instances, count);
+        stats.Add(RenderCounter::Triangles, count * (range.indexCount / 3));
+        stats.Add(RenderCounter::BytesUploaded, m_uploadedBytes + sizeof(zero));
+        m_uploadedBytes = 0;
+    }
+
+    void GpuCuller::DrawCpu(GraphicsAPI& graphicsAPI, GpuInstanceBatch& batch)
+    {
+        const size_t count = batch.GetRenderCount();
+        const float* transforms = batch.m_renderTransforms.data();
+        size_t visibleCount = count;
+
+        if (m_hasViewProjection)
+        {
+            m_visible.resize(count);
+            CullBoxes(m_frustum, batch.m_bounds, m_visible.data());
+            if (m_hierarchy)
+            {
+                m_hierarchy->TestBoxes(batch.m_bounds, m_visible.data());
+            }
+
+            m_visibleTransforms.clear();
+            for (size_t i = 0; i < count; ++i)
+            {
+                if (m_visible[i])
+                {
+                    m_visibleTransforms.insert(m_visibleTransforms.end(), &transforms[i * 16], &transforms[i * 16 + 16]);
+                }
+            }
+            visibleCount = m_visibleTransforms.size() / 16;
+            transforms = m_visibleTransforms.data();
+            m_cpuCulled += count - visibleCount;
+        }
+
+        if (visibleCount == 0)
+        {
+            return;
+        }
+
+        // Re-specified every frame so the driver can hand out fresh storage instead of waiting on the GPU
+        if (!batch.m_transformBuffer)
+        {
+            glGenBuffers(1, &batch.m_transformBuffer);
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, batch.m_transformBuffer);
+        glBufferData(GL_ARRAY_BUFFER, visibleCount * TransformSize, transforms, GL_STREAM_DRAW);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        BindInstanceAttributes(batch);
+
+        const MeshLod range = batch.m_mesh->GetCurrentIndexRange();
+        graphicsAPI.BindMaterial(batch.m_material);
+        graphicsAPI.BindMesh(batch.m_mesh);
+        glDrawElementsInstanced(GL_TRIANGLES, static_cast<GLsizei>(range.indexCount), GL_UNSIGNED_INT,
+            (void*)(uintptr_t)(range.indexOffset * sizeof(uint32_t)), static_cast<GLsizei>(visibleCount));
+
+        RenderStats& stats = graphicsAPI.GetFrameStats();
+        stats.Add(RenderCounter::DrawCalls);
+        stats.Add(RenderCounter::Instances, visibleCount);
+        stats.Add(RenderCounter::Triangles, visibleCount * (range.indexCount / 3));
+        stats.Add(RenderCounter::BytesUploaded, visibleCount * TransformSize);
+    }
+}
\ No newline at end of file
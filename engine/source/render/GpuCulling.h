@@ -0,0 +1,129 @@
+#pragma once
+#include "render/Bounds.h"
+#include "render/FrustumCulling.h"
+#include <GL/glew.h>
+#include <memory>
+#include <stdint.h>
+#include <vector>
+
+namespace eng
+{
+    class GraphicsAPI;
+    class ShaderProgram;
+    class Mesh;
+    class Material;
+    class OcclusionCuller;
+
+    // Per-instance world matrix attribute, occupies this location and the next 3 with a divisor of 1.
+    // Shaders of instanced materials read it as: layout (location = 4) in mat4 instanceTransform;
+    constexpr GLuint InstanceTransformLocation = 4;
+
+    // Many copies of one mesh that stay resident on the GPU and are culled there. Only transforms that
+    // changed since the last draw are uploaded. The mesh VAO gets the instance attribute, so a mesh should
+    // back a single batch.
+    //
+    // Add, SetTransform and Clear only touch the simulation side. The render queue publishes the changed
+    // range to the render side when the frame is handed off, so the next frame can be simulated while this
+    // one is drawn.
+    class GpuInstanceBatch
+    {
+    public:
+        GpuInstanceBatch(Mesh* mesh, Material* material);
+        GpuInstanceBatch(const GpuInstanceBatch&) = delete;
+        GpuInstanceBatch& operator=(const GpuInstanceBatch&) = delete;
+        ~GpuInstanceBatch();
+
+        // Column-major 4x4 world matrix, returns the instance index
+        uint32_t Add(const float* transform);
+        void SetTransform(uint32_t instance, const float* transform);
+        void Clear();
+
+        size_t GetCount() const;
+        Mesh* GetMesh() const;
+        Material* GetMaterial() const;
+
+    private:
+        friend class GpuCuller;
+        friend class RenderQueue;
+
+        // Copies the transforms changed since the last call to the render side and computes their bounds
+        void Publish();
+        size_t GetRenderCount() const;
+        static void ExtendRange(size_t& begin, size_t& end, size_t first, size_t last);
+
+        Mesh* m_mesh = nullptr;
+        Material* m_material = nullptr;
+
+        // Simulation side
+        std::vector<float> m_transforms;
+        size_t m_changedBegin = 0;
+        size_t m_changedEnd = 0;
+
+        // Render side, the dirty range is what still has to be uploaded
+        std::vector<float> m_renderTransforms;
+        CullingBounds m_bounds;
+        size_t m_dirtyBegin = 0;
+        size_t m_dirtyEnd = 0;
+
+        GLuint m_transformBuffer = 0;
+        GLuint m_boundsBuffer = 0;
+        GLuint m_commandBuffer = 0;
+        size_t m_capacity = 0;
+        bool m_attributesBound = false;
+    };
+
+    enum class GpuCullingPath
+    {
+        // Compute shader compacts visible draws, glMultiDrawElementsIndirectCount draws them
+        ComputeIndirectCount,
+        // Compute shader zeroes the instance count of hidden draws, glMultiDrawElementsIndirect draws all slots
+        ComputeIndirect,
+        // Culled on the CPU, visible transforms are uploaded for one instanced draw
+        Cpu
+    };
+
+    // Frustum and Hi-Z occlusion culling of instance batches on the GPU. The Hi-Z pyramid is the one the
+    // CPU occlusion culler built from this frame's occluders, so no depth ever comes back from the GPU.
+    class GpuCuller
+    {
+    public:
+        // Column-major view-projection, null draws every instance. hierarchy is optional and must have been
+        // built with the same view-projection.
+        void BeginFrame(GraphicsAPI& graphicsAPI, const float* viewProjection, const OcclusionCuller* hierarchy);
+        void Draw(GraphicsAPI& graphicsAPI, GpuInstanceBatch& batch);
+        void Shutdown();
+
+        GpuCullingPath GetPath() const;
+        // Instances culled on the CPU path during the frame, the compute paths never read results back
+        size_t GetCpuCulledCount() const;
+
+    private:
+        bool InitResources(GraphicsAPI& graphicsAPI);
+        void UploadHierarchy(const OcclusionCuller& hierarchy);
+        void UploadInstances(GpuInstanceBatch& batch);
+        void BindInstanceAttributes(GpuInstanceBatch& batch);
+        void DrawCompute(GraphicsAPI& graphicsAPI, GpuInstanceBatch& batch);
+        void DrawCpu(GraphicsAPI& graphicsAPI, GpuInstanceBatch& batch);
+
+        std::shared_ptr<ShaderProgram> m_cullProgram;
+        GLuint m_countBuffer = 0;
+        GLuint m_hierarchyBuffer = 0;
+        size_t m_hierarchyCapacity = 0;
+        int m_hierarchyLevels = 0;
+        // Interleaved center/extent pairs staged for the bounds buffer
+        std::vector<float> m_boundsUpload;
+
+        float m_viewProjection[16] = {};
+        bool m_hasViewProjection = false;
+        Frustum m_frustum;
+        const OcclusionCuller* m_hierarchy = nullptr;
+        std::vector<uint8_t> m_visible;
+        std::vector<float> m_visibleTransforms;
+        size_t m_cpuCulled = 0;
+        // Uploaded by helpers without access to the frame's render stats, added by the caller
+        size_t m_uploadedBytes = 0;
+
+        GpuCullingPath m_path = GpuCullingPath::Cpu;
+        bool m_initialized = false;
+    };
+}
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "render/Material.h"
 #include "graphics/ShaderProgram.h"
+#include "graphics/GraphicsAPI.h"
+#include "graphics/Texture.h"
+#include "Engine.h"
 
 namespace eng
 {
@@ -8,6 +11,16 @@ namespace eng
         m_shaderProgram = shaderProgram;
     }
 
+    void Material::SetName(const std::string& name)
+    {
+        m_name = name;
+    }
+
+    const std::string& Material::GetName() const
+    {
+        return m_name;
+    }
+
     void Material::SetParam(const std::string& name, float value)
     {
         m_floatParams[name] = value;
@@ -18,6 +31,35 @@ namespace eng
         m_float2Params[name] = { v0, v1 };
     }
 
+    void Material::SetTexture(const std::string& name, const std::shared_ptr<Texture>& texture,
+        const SamplerDesc& samplerDesc)
+    {
+        auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
+        GLuint sampler = graphicsAPI.GetSampler(samplerDesc);
+
+        for (auto& slot : m_textures)
+        {
+            if (slot.name == name)
+            {
+                slot.texture = texture;
+                slot.samplerDesc = samplerDesc;
+                slot.sampler = sampler;
+                return;
+            }
+        }
+
+        if (m_textures.size() >= GraphicsAPI::MaxTextureUnits)
+        {
+            return;
+        }
+        m_textures.push_back({ name, texture, samplerDesc, sampler });
+    }
+
+    const std::vector<MaterialTextureSlot>& Material::GetTextures() const
+    {
+        return m_textures;
+    }
+
     void Material::Bind()
     {
         if (!m_shaderProgram)
@@ -36,5 +78,14 @@ namespace eng
         {
             m_shaderProgram->SetUniform(param.first, param.second.first, param.second.second);
         }
+
+        auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
+        for (size_t unit = 0; unit < m_textures.size(); ++unit)
+        {
+            auto& slot = m_textures[unit];
+            graphicsAPI.BindTexture(static_cast<uint32_t>(unit), slot.texture.get());
+            graphicsAPI.BindSampler(static_cast<uint32_t>(unit), slot.sampler);
+            m_shaderProgram->SetUniform(slot.name, static_cast<int>(unit));
+        }
     }
 }
\ No newline at end of file
@@ -2,22 +2,43 @@
 #include <memory>
 #include <unordered_map>
 #include <string>
+#include <vector>
+#include <GL/glew.h>
+#include "graphics/Sampler.h"
 
 namespace eng
 {
     class ShaderProgram;
+    class Texture;
+
+    struct MaterialTextureSlot
+    {
+        std::string name;
+        std::shared_ptr<Texture> texture;
+        SamplerDesc samplerDesc;
+        GLuint sampler = 0;
+    };
 
     class Material
     {
     public:
         void SetShaderProgram(const std::shared_ptr<ShaderProgram>& shaderProgram);
+        // Labels the material's draws in GPU profiles
+        void SetName(const std::string& name);
+        const std::string& GetName() const;
         void SetParam(const std::string& name, float value);
         void SetParam(const std::string& name, float v0, float v1);
+        // Each sampler uniform gets its own texture unit in the order it was first set
+        void SetTexture(const std::string& name, const std::shared_ptr<Texture>& texture,
+            const SamplerDesc& samplerDesc = {});
+        const std::vector<MaterialTextureSlot>& GetTextures() const;
         void Bind();
 
     private:
+        std::string m_name;
         std::shared_ptr<ShaderProgram> m_shaderProgram;
         std::unordered_map<std::string, float> m_floatParams;
         std::unordered_map<std::string, std::pair<float, float>> m_float2Params;
+        std::vector<MaterialTextureSlot> m_textures;
     };
 }
\ No newline at end of file
@@ -1,17 +1,34 @@
 #include "render/Mesh.h"
 #include "graphics/GraphicsAPI.h"
 #include "Engine.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
 
 namespace eng
 {
     Mesh::Mesh(const VertexLayout& layout, const std::vector<float>& vertices, const std::vector<uint32_t>& indices)
+        : Mesh(layout, vertices.data(), vertices.size() * sizeof(float), indices.data(), indices.size())
+    {
+    }
+
+    Mesh::Mesh(const VertexLayout& layout, const std::vector<float>& vertices)
+        : Mesh(layout, vertices.data(), vertices.size() * sizeof(float), nullptr, 0)
+    {
+    }
+
+    Mesh::Mesh(const VertexLayout& layout, const void* vertexData, size_t vertexDataSize,
+        const uint32_t* indices, size_t indexCount, const BoundingBox* bounds)
     {
         m_vertexLayout = layout;
 
         auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
 
-        m_VBO = graphicsAPI.CreateVertexBuffer(vertices);
-        m_EBO = graphicsAPI.CreateIndexBuffer(indices);
+        m_VBO = graphicsAPI.CreateVertexBuffer(vertexData, vertexDataSize);
+        if (indices && indexCount > 0)
+        {
+            m_EBO = graphicsAPI.CreateIndexBuffer(indices, indexCount);
+        }
 
         glGenVertexArrays(1, &m_VAO);
         glBindVertexArray(m_VAO);
@@ -25,40 +42,57 @@ namespace eng
             glEnableVertexAttribArray(element.index);
         }
 
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+        if (m_EBO)
+        {
+            glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+        }
 
         glBindVertexArray(0);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
 
-        m_vertexCout = (vertices.size() * sizeof(float)) / m_vertexLayout.stride;
-        m_indexCount = indices.size();
+        m_vertexCout = m_vertexLayout.stride > 0 ? vertexDataSize / m_vertexLayout.stride : 0;
+        m_indexCount = m_EBO ? indexCount : 0;
+
+        if (bounds)
+        {
+            SetBounds(*bounds);
+        }
+        else
+        {
+            ComputeBounds(vertexData, m_vertexCout);
+        }
     }
 
-    Mesh::Mesh(const VertexLayout& layout, const std::vector<float>& vertices)
+    void Mesh::ComputeBounds(const void* vertexData, size_t vertexCount)
     {
-        m_vertexLayout = layout;
-
-        auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
-
-        m_VBO = graphicsAPI.CreateVertexBuffer(vertices);
-
-        glGenVertexArrays(1, &m_VAO);
-        glBindVertexArray(m_VAO);
-
-        glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-
+        const VertexElement* position = nullptr;
         for (auto& element : m_vertexLayout.elements)
         {
-            glVertexAttribPointer(element.index, element.size, element.type, GL_FALSE,
-                m_vertexLayout.stride, (void*)(uintptr_t)element.offset);
-            glEnableVertexAttribArray(element.index);
+            if (element.index == 0 && element.type == GL_FLOAT && element.size >= 2)
+            {
+                position = &element;
+            }
+        }
+        if (!position || !vertexData || vertexCount == 0)
+        {
+            return;
         }
 
-        glBindVertexArray(0);
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-        m_vertexCout = (vertices.size() * sizeof(float)) / m_vertexLayout.stride;
+        const auto* bytes = static_cast<const uint8_t*>(vertexData) + position->offset;
+        const GLuint components = std::min<GLuint>(position->size, 3);
+        BoundingBox bounds;
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            float p[3] = { 0.0f, 0.0f, 0.0f };
+            memcpy(p, bytes + v * m_vertexLayout.stride, components * sizeof(float));
+            for (int i = 0; i < 3; ++i)
+            {
+                bounds.min[i] = v == 0 ? p[i] : std::min(bounds.min[i], p[i]);
+                bounds.max[i] = v == 0 ? p[i] : std::max(bounds.max[i], p[i]);
+            }
+        }
+        SetBounds(bounds);
     }
 
     void Mesh::Bind()
@@ -68,7 +102,13 @@ namespace eng
 
     void Mesh::Draw()
     {
-        if (m_indexCount > 0)
+        if (m_currentLod < m_lods.size())
+        {
+            const auto& lod = m_lods[m_currentLod];
+            glDrawElements(GL_TRIANGLES, lod.indexCount, GL_UNSIGNED_INT,
+                (void*)(uintptr_t)(lod.indexOffset * sizeof(uint32_t)));
+        }
+        else if (m_indexCount > 0)
         {
             glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0);
         }
@@ -77,4 +117,72 @@ namespace eng
             glDrawArrays(GL_TRIANGLES, 0, m_vertexCout);
         }
     }
+
+    void Mesh::SetBounds(const BoundingBox& bounds)
+    {
+        m_bounds = bounds;
+
+        float radiusSquared = 0.0f;
+        for (int i = 0; i < 3; ++i)
+        {
+            float halfExtent = (bounds.max[i] - bounds.min[i]) * 0.5f;
+            m_boundingSphere.center[i] = bounds.min[i] + halfExtent;
+            radiusSquared += halfExtent * halfExtent;
+        }
+        m_boundingSphere.radius = std::sqrt(radiusSquared);
+    }
+
+    const BoundingBox& Mesh::GetBounds() const
+    {
+        return m_bounds;
+    }
+
+    const BoundingSphere& Mesh::GetBoundingSphere() const
+    {
+        return m_boundingSphere;
+    }
+
+    void Mesh::SetLods(const std::vector<MeshLod>& lods)
+    {
+        m_lods.clear();
+        for (auto& lod : lods)
+        {
+            // Ranges outside the uploaded index buffer would read past its end
+            if (static_cast<size_t>(lod.indexOffset) + lod.indexCount <= m_indexCount)
+            {
+                m_lods.push_back(lod);
+            }
+        }
+        m_currentLod = 0;
+    }
+
+    size_t Mesh::GetLodCount() const
+    {
+        return m_lods.size();
+    }
+
+    void Mesh::SetCurrentLod(size_t lod)
+    {
+        m_currentLod = lod;
+    }
+
+    MeshLod Mesh::GetCurrentIndexRange() const
+    {
+        if (m_currentLod < m_lods.size())
+        {
+            return m_lods[m_currentLod];
+        }
+        MeshLod range;
+        range.indexCount = static_cast<uint32_t>(m_indexCount);
+        return range;
+    }
+
+    uint32_t Mesh::GetCurrentTriangleCount() const
+    {
+        if (m_currentLod < m_lods.size())
+        {
+            return m_lods[m_currentLod].indexCount / 3;
+        }
+        return static_cast<uint32_t>((m_indexCount > 0 ? m_indexCount : m_vertexCout) / 3);
+    }
 }
\ No newline at end of file
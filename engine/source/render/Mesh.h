@@ -1,21 +1,48 @@
 #pragma once
 #include <GL/glew.h>
 #include "graphics/VertexLayout.h"
+#include "render/Bounds.h"
 
 namespace eng
 {
+    // Index range of one level of detail inside the mesh index buffer
+    struct MeshLod
+    {
+        uint32_t indexOffset = 0;
+        uint32_t indexCount = 0;
+    };
+
     class Mesh
     {
     public:
         Mesh(const VertexLayout& layout, const std::vector<float>& vertices, const std::vector<uint32_t>& indices);
         Mesh(const VertexLayout& layout, const std::vector<float>& vertices);
+        // Uploads straight from caller-owned memory (e.g. a mapped file), indices may be null.
+        // Passing precomputed bounds skips the pass over the vertex data.
+        Mesh(const VertexLayout& layout, const void* vertexData, size_t vertexDataSize,
+            const uint32_t* indices, size_t indexCount, const BoundingBox* bounds = nullptr);
         Mesh(const Mesh&) = delete;
         Mesh& operator=(const Mesh&) = delete;
 
         void Bind();
         void Draw();
 
+        // Unless given, bounds are computed from the position attribute (location 0) on creation
+        void SetBounds(const BoundingBox& bounds);
+        const BoundingBox& GetBounds() const;
+        const BoundingSphere& GetBoundingSphere() const;
+
+        void SetLods(const std::vector<MeshLod>& lods);
+        size_t GetLodCount() const;
+        void SetCurrentLod(size_t lod);
+        // Index range Draw uses at the current level of detail, empty for meshes without indices
+        MeshLod GetCurrentIndexRange() const;
+        // Triangles the next Draw submits
+        uint32_t GetCurrentTriangleCount() const;
+
     private:
+        void ComputeBounds(const void* vertexData, size_t vertexCount);
+
         VertexLayout m_vertexLayout;
         GLuint m_VBO = 0;
         GLuint m_EBO = 0;
@@ -23,5 +50,10 @@ namespace eng
 
         size_t m_vertexCout = 0;
         size_t m_indexCount = 0;
+
+        BoundingBox m_bounds;
+        BoundingSphere m_boundingSphere;
+        std::vector<MeshLod> m_lods;
+        size_t m_currentLod = 0;
     };
 }
\ No newline at end of file
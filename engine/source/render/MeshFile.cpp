@@ -0,0 +1,198 @@
+#include "render/MeshFile.h"
+#include "io/MappedFile.h"
+#include <fstream>
+#include <iostream>
+
+namespace eng
+{
+    namespace
+    {
+        uint64_t AlignUp(uint64_t value, uint64_t alignment)
+        {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        void WritePadding(std::ofstream& file, uint64_t from, uint64_t to)
+        {
+            static const char zeros[MeshFileBlobAlignment] = {};
+            file.write(zeros, static_cast<std::streamsize>(to - from));
+        }
+
+        // Written so that untrusted offsets and lengths cannot wrap around
+        bool IsInRange(uint64_t offset, uint64_t length, uint64_t size)
+        {
+            return offset <= size && length <= size - offset;
+        }
+
+        // 0 for types a vertex attribute cannot have
+        uint32_t GetComponentSize(uint32_t type)
+        {
+            switch (type)
+            {
+            case GL_BYTE:
+            case GL_UNSIGNED_BYTE:
+                return 1;
+            case GL_SHORT:
+            case GL_UNSIGNED_SHORT:
+            case GL_HALF_FLOAT:
+                return 2;
+            case GL_INT:
+            case GL_UNSIGNED_INT:
+            case GL_FLOAT:
+                return 4;
+            default:
+                return 0;
+            }
+        }
+    }
+
+    bool SaveMeshFile(const std::string& path, const VertexLayout& layout,
+        const void* vertexData, size_t vertexDataSize,
+        const uint32_t* indices, size_t indexCount,
+        const BoundingBox& bounds, const std::vector<MeshLod>& lods)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file)
+        {
+            std::cerr << "ERROR:MESH_FILE_WRITE_FAILED: " << path << std::endl;
+            return false;
+        }
+
+        MeshFileHeader header;
+        header.elementCount = static_cast<uint32_t>(layout.elements.size());
+        header.stride = layout.stride;
+        header.lodCount = static_cast<uint32_t>(lods.size());
+        for (int i = 0; i < 3; ++i)
+        {
+            header.boundsMin[i] = bounds.min[i];
+            header.boundsMax[i] = bounds.max[i];
+        }
+
+        uint64_t tablesEnd = sizeof(MeshFileHeader)
+            + header.elementCount * sizeof(MeshFileVertexElement)
+            + header.lodCount * sizeof(MeshLod);
+        header.vertexDataOffset = AlignUp(tablesEnd, MeshFileBlobAlignment);
+        header.vertexDataSize = vertexDataSize;
+        header.indexDataOffset = AlignUp(header.vertexDataOffset + vertexDataSize, MeshFileBlobAlignment);
+        header.indexCount = indices ? indexCount : 0;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        for (auto& element : layout.elements)
+        {
+            MeshFileVertexElement fileElement;
+            fileElement.index = element.index;
+            fileElement.size = element.size;
+            fileElement.type = element.type;
+            fileElement.offset = element.offset;
+            file.write(reinterpret_cast<const char*>(&fileElement), sizeof(fileElement));
+        }
+        if (!lods.empty())
+        {
+            file.write(reinterpret_cast<const char*>(lods.data()), lods.size() * sizeof(MeshLod));
+        }
+
+        WritePadding(file, tablesEnd, header.vertexDataOffset);
+        file.write(static_cast<const char*>(vertexData), static_cast<std::streamsize>(vertexDataSize));
+
+        WritePadding(file, header.vertexDataOffset + vertexDataSize, header.indexDataOffset);
+        if (header.indexCount > 0)
+        {
+            file.write(reinterpret_cast<const char*>(indices),
+                static_cast<std::streamsize>(header.indexCount * sizeof(uint32_t)));
+        }
+
+        return static_cast<bool>(file);
+    }
+
+    std::unique_ptr<Mesh> LoadMeshFile(const std::string& path)
+    {
+        MappedFile file;
+        if (!file.Open(path))
+        {
+            return nullptr;
+        }
+
+        const uint8_t* data = file.GetData();
+        const size_t size = file.GetSize();
+
+        if (size < sizeof(MeshFileHeader))
+        {
+            std::cerr << "ERROR:MESH_FILE_TRUNCATED: " << path << std::endl;
+            return nullptr;
+        }
+
+        const auto* header = reinterpret_cast<const MeshFileHeader*>(data);
+        if (header->magic != MeshFileMagic || header->version != MeshFileVersion)
+        {
+            std::cerr << "ERROR:MESH_FILE_BAD_HEADER: " << path << std::endl;
+            return nullptr;
+        }
+
+        uint64_t tablesEnd = sizeof(MeshFileHeader)
+            + uint64_t(header->elementCount) * sizeof(MeshFileVertexElement)
+            + uint64_t(header->lodCount) * sizeof(MeshLod);
+        if (header->indexCount > size / sizeof(uint32_t))
+        {
+            std::cerr << "ERROR:MESH_FILE_TRUNCATED: " << path << std::endl;
+            return nullptr;
+        }
+        uint64_t indexDataSize = header->indexCount * sizeof(uint32_t);
+        if (tablesEnd > size
+            || header->vertexDataOffset < tablesEnd
+            || !IsInRange(header->vertexDataOffset, header->vertexDataSize, size)
+            || (indexDataSize > 0 && !IsInRange(header->indexDataOffset, indexDataSize, size))
+            || header->indexDataOffset % alignof(uint32_t) != 0)
+        {
+            std::cerr << "ERROR:MESH_FILE_TRUNCATED: " << path << std::endl;
+            return nullptr;
+        }
+
+        // Attributes must fit their vertex and LODs the index blob, or the driver reads past the mapping
+        bool consistent = header->stride > 0 && header->vertexDataSize % header->stride == 0;
+        const auto* elements = reinterpret_cast<const MeshFileVertexElement*>(data + sizeof(MeshFileHeader));
+        for (uint32_t i = 0; i < header->elementCount && consistent; ++i)
+        {
+            const uint64_t componentSize = GetComponentSize(elements[i].type);
+            consistent = componentSize > 0 && elements[i].size >= 1 && elements[i].size <= 4
+                && elements[i].offset + componentSize * elements[i].size <= header->stride;
+        }
+        const auto* lodTable = reinterpret_cast<const MeshLod*>(elements + header->elementCount);
+        for (uint32_t i = 0; i < header->lodCount && consistent; ++i)
+        {
+            consistent = IsInRange(lodTable[i].indexOffset, lodTable[i].indexCount, header->indexCount);
+        }
+        if (!consistent)
+        {
+            std::cerr << "ERROR:MESH_FILE_BAD_LAYOUT: " << path << std::endl;
+            return nullptr;
+        }
+
+        VertexLayout layout;
+        layout.stride = header->stride;
+        layout.elements.reserve(header->elementCount);
+        for (uint32_t i = 0; i < header->elementCount; ++i)
+        {
+            layout.elements.push_back({ elements[i].index, elements[i].size, elements[i].type, elements[i].offset });
+        }
+
+        std::vector<MeshLod> lods(lodTable, lodTable + header->lodCount);
+
+        const uint32_t* indices = indexDataSize > 0
+            ? reinterpret_cast<const uint32_t*>(data + header->indexDataOffset)
+            : nullptr;
+
+        BoundingBox bounds;
+        for (int i = 0; i < 3; ++i)
+        {
+            bounds.min[i] = header->boundsMin[i];
+            bounds.max[i] = header->boundsMax[i];
+        }
+
+        auto mesh = std::make_unique<Mesh>(layout,
+            data + header->vertexDataOffset, static_cast<size_t>(header->vertexDataSize),
+            indices, static_cast<size_t>(header->indexCount), &bounds);
+        mesh->SetLods(lods);
+
+        return mesh;
+    }
+}
\ No newline at end of file
@@ -0,0 +1,47 @@
+#pragma once
+#include "graphics/VertexLayout.h"
+#include "render/Mesh.h"
+#include <memory>
+#include <string>
+
+namespace eng
+{
+    // Cooked mesh layout (little endian):
+    // MeshFileHeader | MeshFileVertexElement[elementCount] | MeshLod[lodCount] | vertex blob | index blob
+    // Blobs are aligned so they can be handed to the driver straight from the mapped file.
+    constexpr uint32_t MeshFileMagic = 0x534D5847; // "GXMS"
+    constexpr uint32_t MeshFileVersion = 1;
+    constexpr uint32_t MeshFileBlobAlignment = 16;
+
+    struct MeshFileHeader
+    {
+        uint32_t magic = MeshFileMagic;
+        uint32_t version = MeshFileVersion;
+        uint32_t elementCount = 0;
+        uint32_t stride = 0;
+        uint32_t lodCount = 0;
+        uint32_t reserved = 0;
+        uint64_t vertexDataOffset = 0;
+        uint64_t vertexDataSize = 0;
+        uint64_t indexDataOffset = 0;
+        uint64_t indexCount = 0;
+        float boundsMin[3] = { 0.0f, 0.0f, 0.0f };
+        float boundsMax[3] = { 0.0f, 0.0f, 0.0f };
+    };
+
+    struct MeshFileVertexElement
+    {
+        uint32_t index = 0;
+        uint32_t size = 0;
+        uint32_t type = 0;
+        uint32_t offset = 0;
+    };
+
+    bool SaveMeshFile(const std::string& path, const VertexLayout& layout,
+        const void* vertexData, size_t vertexDataSize,
+        const uint32_t* indices, size_t indexCount,
+        const BoundingBox& bounds, const std::vector<MeshLod>& lods = {});
+
+    // Maps the file and uploads vertex/index data directly from the mapping
+    std::unique_ptr<Mesh> LoadMeshFile(const std::string& path);
+}
\ No newline at end of file
@@ -0,0 +1,520 @@
+#include "render/OcclusionCulling.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ENG_OCCLUSION_SSE 1
+#endif
+
+namespace eng
+{
+    namespace
+    {
+        // Boxes reaching this close to the camera plane are always visible
+        const float MinClipW = 1e-5f;
+        // The test picks the pyramid level where the projected rect spans at most this many texels per axis
+        const int MaxTestTexels = 4;
+
+        // out = a * b, all column-major
+        void Multiply(const float* a, const float* b, float* out)
+        {
+            for (int c = 0; c < 4; ++c)
+            {
+                for (int r = 0; r < 4; ++r)
+                {
+                    out[c * 4 + r] = a[r] * b[c * 4] + a[4 + r] * b[c * 4 + 1] + a[8 + r] * b[c * 4 + 2]
+                        + a[12 + r] * b[c * 4 + 3];
+                }
+            }
+        }
+
+        void TransformPoint(const float* m, float x, float y, float z, float* out)
+        {
+            for (int r = 0; r < 4; ++r)
+            {
+                out[r] = m[r] * x + m[4 + r] * y + m[8 + r] * z + m[12 + r];
+            }
+        }
+
+        // Distance to the GL near plane (z = -w), inside when >= 0
+        float NearDistance(const float* clip)
+        {
+            return clip[2] + clip[3];
+        }
+    }
+
+    OcclusionCuller::OcclusionCuller(int width, int height)
+    {
+        Resize(width, height);
+    }
+
+    void OcclusionCuller::Resize(int width, int height)
+    {
+        m_width = std::max(4, (width + 3) & ~3);
+        m_height = std::max(1, height);
+
+        m_levels.clear();
+        m_levelWidths.clear();
+        m_levelHeights.clear();
+        int levelWidth = m_width;
+        int levelHeight = m_height;
+        while (true)
+        {
+            m_levels.emplace_back(static_cast<size_t>(levelWidth) * levelHeight, 1.0f);
+            m_levelWidths.push_back(levelWidth);
+            m_levelHeights.push_back(levelHeight);
+            if (levelWidth == 1 && levelHeight == 1)
+            {
+                break;
+            }
+            levelWidth = std::max(1, (levelWidth + 1) / 2);
+            levelHeight = std::max(1, (levelHeight + 1) / 2);
+        }
+    }
+
+    void OcclusionCuller::BeginFrame(const float* viewProjection)
+    {
+        std::copy(viewProjection, viewProjection + 16, m_viewProjection);
+        std::fill(m_levels[0].begin(), m_levels[0].end(), 1.0f);
+        m_rasterizedTriangles = 0;
+    }
+
+    void OcclusionCuller::RenderOccluder(const OccluderMesh& mesh, const float* transform)
+    {
+        float matrix[16];
+        if (transform)
+        {
+            Multiply(m_viewProjection, transform, matrix);
+        }
+        else
+        {
+            std::copy(m_viewProjection, m_viewProjection + 16, matrix);
+        }
+
+        const size_t vertexCount = mesh.positions.size() / 3;
+        m_clipVertices.resize(vertexCount * 4);
+        for (size_t i = 0; i < vertexCount; ++i)
+        {
+            const float* p = &mesh.positions[i * 3];
+            TransformPoint(matrix, p[0], p[1], p[2], &m_clipVertices[i * 4]);
+        }
+
+        for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3)
+        {
+            const float* c0 = &m_clipVertices[mesh.indices[i] * 4];
+            const float* c1 = &m_clipVertices[mesh.indices[i + 1] * 4];
+            const float* c2 = &m_clipVertices[mesh.indices[i + 2] * 4];
+
+            // Trivially reject triangles fully outside one of the side planes
+            bool outside = false;
+            for (int axis = 0; axis < 2 && !outside; ++axis)
+            {
+                outside = (c0[axis] > c0[3] && c1[axis] > c1[3] && c2[axis] > c2[3])
+                    || (c0[axis] < -c0[3] && c1[axis] < -c1[3] && c2[axis] < -c2[3]);
+            }
+            if (!outside)
+            {
+                ClipAndRasterize(c0, c1, c2);
+            }
+        }
+    }
+
+    void OcclusionCuller::ClipAndRasterize(const float* c0, const float* c1, const float* c2)
+    {
+        const float* input[3] = { c0, c1, c2 };
+        float clipped[4][4];
+        int clippedCount = 0;
+
+        // Sutherland-Hodgman against the near plane only, x/y are handled by the raster bounds
+        for (int i = 0; i < 3; ++i)
+        {
+            const float* a = input[i];
+            const float* b = input[(i + 1) % 3];
+            float da = NearDistance(a);
+            float db = NearDistance(b);
+            if (da >= 0.0f)
+            {
+                std::copy(a, a + 4, clipped[clippedCount++]);
+            }
+            if ((da >= 0.0f) != (db >= 0.0f))
+            {
+                float t = da / (da - db);
+                for (int c = 0; c < 4; ++c)
+                {
+                    clipped[clippedCount][c] = a[c] + (b[c] - a[c]) * t;
+                }
+                ++clippedCount;
+            }
+        }
+        if (clippedCount < 3)
+        {
+            return;
+        }
+
+        float screen[4][3];
+        for (int i = 0; i < clippedCount; ++i)
+        {
+            float w = std::max(clipped[i][3], MinClipW);
+            float inverseW = 1.0f / w;
+            screen[i][0] = (clipped[i][0] * inverseW * 0.5f + 0.5f) * m_width;
+            screen[i][1] = (clipped[i][1] * inverseW * 0.5f + 0.5f) * m_height;
+            // Unclamped, a triangle crossing the far plane keeps its true depth plane. RasterizeTriangle clamps
+            // per pixel.
+            screen[i][2] = clipped[i][2] * inverseW * 0.5f + 0.5f;
+        }
+
+        for (int i = 1; i + 1 < clippedCount; ++i)
+        {
+            RasterizeTriangle(screen[0], screen[i], screen[i + 1]);
+        }
+    }
+
+    void OcclusionCuller::RasterizeTriangle(const float* v0, const float* v1, const float* v2)
+    {
+        float area = (v1[0] - v0[0]) * (v2[1] - v0[1]) - (v2[0] - v0[0]) * (v1[1] - v0[1]);
+        if (std::fabs(area) < 1e-8f)
+        {
+            return;
+        }
+        // Occluders are rendered double sided, flip to counter-clockwise so inside means all edges >= 0
+        if (area < 0.0f)
+        {
+            std::swap(v1, v2);
+            area = -area;
+        }
+
+        int minX = static_cast<int>(std::floor(std::min({ v0[0], v1[0], v2[0] })));
+        int maxX = static_cast<int>(std::ceil(std::max({ v0[0], v1[0], v2[0] })));
+        int minY = static_cast<int>(std::floor(std::min({ v0[1], v1[1], v2[1] })));
+        int maxY = static_cast<int>(std::ceil(std::max({ v0[1], v1[1], v2[1] })));
+        minX = std::max(minX, 0) & ~3;
+        maxX = std::min(maxX, m_width - 1);
+        minY = std::max(minY, 0);
+        maxY = std::min(maxY, m_height - 1);
+        if (minX > maxX || minY > maxY)
+        {
+            return;
+        }
+        ++m_rasterizedTriangles;
+
+        // Edge functions e = a * x + b * y + c, positive inside
+        const float* vertices[3] = { v0, v1, v2 };
+        float edgeA[3];
+        float edgeB[3];
+        float edgeC[3];
+        for (int e = 0; e < 3; ++e)
+        {
+            const float* a = vertices[e];
+            const float* b = vertices[(e + 1) % 3];
+            edgeA[e] = a[1] - b[1];
+            edgeB[e] = b[0] - a[0];
+            edgeC[e] = -(edgeA[e] * a[0] + edgeB[e] * a[1]);
+        }
+
+        // Depth plane z = depthA * x + depthB * y + depthC
+        float dx1 = v1[0] - v0[0];
+        float dy1 = v1[1] - v0[1];
+        float dx2 = v2[0] - v0[0];
+        float dy2 = v2[1] - v0[1];
+        float dz1 = v1[2] - v0[2];
+        float dz2 = v2[2] - v0[2];
+        float depthA = (dz1 * dy2 - dz2 * dy1) / area;
+        float depthB = (dz2 * dx1 - dz1 * dx2) / area;
+        float depthC = v0[2] - depthA * v0[0] - depthB * v0[1];
+
+        float* depth = m_levels[0].data();
+
+#if defined(ENG_OCCLUSION_SSE)
+        const __m128 laneOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 a0 = _mm_set1_ps(edgeA[0]);
+        const __m128 a1 = _mm_set1_ps(edgeA[1]);
+        const __m128 a2 = _mm_set1_ps(edgeA[2]);
+        const __m128 depthStep = _mm_set1_ps(depthA);
+        for (int y = minY; y <= maxY; ++y)
+        {
+            float py = y + 0.5f;
+            __m128 row0 = _mm_set1_ps(edgeB[0] * py + edgeC[0]);
+            __m128 row1 = _mm_set1_ps(edgeB[1] * py + edgeC[1]);
+            __m128 row2 = _mm_set1_ps(edgeB[2] * py + edgeC[2]);
+            __m128 rowDepth = _mm_set1_ps(depthB * py + depthC);
+            float* depthRow = depth + static_cast<size_t>(y) * m_width;
+
+            for (int x = minX; x <= maxX; x += 4)
+            {
+                __m128 px = _mm_add_ps(_mm_set1_ps(static_cast<float>(x)), laneOffsets);
+                __m128 e0 = _mm_add_ps(_mm_mul_ps(a0, px), row0);
+                __m128 e1 = _mm_add_ps(_mm_mul_ps(a1, px), row1);
+                __m128 e2 = _mm_add_ps(_mm_mul_ps(a2, px), row2);
+                __m128 mask = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)),
+                    _mm_cmpge_ps(e2, zero));
+                if (_mm_movemask_ps(mask) == 0)
+                {
+                    continue;
+                }
+
+                __m128 z = _mm_min_ps(_mm_max_ps(_mm_add_ps(_mm_mul_ps(depthStep, px), rowDepth), zero), one);
+                __m128 old = _mm_loadu_ps(depthRow + x);
+                __m128 nearest = _mm_min_ps(old, z);
+                _mm_storeu_ps(depthRow + x, _mm_or_ps(_mm_and_ps(mask, nearest), _mm_andnot_ps(mask, old)));
+            }
+        }
+#else
+        for (int y = minY; y <= maxY; ++y)
+        {
+            float py = y + 0.5f;
+            float* depthRow = depth + static_cast<size_t>(y) * m_width;
+            for (int x = minX; x <= maxX; ++x)
+            {
+                float px = x + 0.5f;
+                if (edgeA[0] * px + edgeB[0] * py + edgeC[0] >= 0.0f
+                    && edgeA[1] * px + edgeB[1] * py + edgeC[1] >= 0.0f
+                    && edgeA[2] * px + edgeB[2] * py + edgeC[2] >= 0.0f)
+                {
+                    float z = std::min(std::max(depthA * px + depthB * py + depthC, 0.0f), 1.0f);
+                    depthRow[x] = std::min(depthRow[x], z);
+                }
+            }
+        }
+#endif
+    }
+
+    void OcclusionCuller::BuildHierarchy()
+    {
+        for (size_t level = 1; level < m_levels.size(); ++level)
+        {
+            const std::vector<float>& source = m_levels[level - 1];
+            std::vector<float>& target = m_levels[level];
+            const int sourceWidth = m_levelWidths[level - 1];
+            const int sourceHeight = m_levelHeights[level - 1];
+            const int width = m_levelWidths[level];
+            const int height = m_levelHeights[level];
+
+            for (int y = 0; y < height; ++y)
+            {
+                const float* row0 = &source[static_cast<size_t>(std::min(y * 2, sourceHeight - 1)) * sourceWidth];
+                const float* row1 = &source[static_cast<size_t>(std::min(y * 2 + 1, sourceHeight - 1)) * sourceWidth];
+                for (int x = 0; x < width; ++x)
+                {
+                    int x0 = std::min(x * 2, sourceWidth - 1);
+                    int x1 = std::min(x * 2 + 1, sourceWidth - 1);
+                    target[static_cast<size_t>(y) * width + x] = std::max(std::max(row0[x0], row0[x1]),
+                        std::max(row1[x0], row1[x1]));
+                }
+            }
+        }
+    }
+
+    bool OcclusionCuller::IsVisible(const BoundingBox& worldBox) const
+    {
+        float center[3];
+        float extent[3];
+        for (int axis = 0; axis < 3; ++axis)
+        {
+            center[axis] = (worldBox.min[axis] + worldBox.max[axis]) * 0.5f;
+            extent[axis] = (worldBox.max[axis] - worldBox.min[axis]) * 0.5f;
+        }
+        return IsVisible(center, extent);
+    }
+
+    size_t OcclusionCuller::TestBoxes(const CullingBounds& bounds, uint8_t* visible) const
+    {
+        size_t occluded = 0;
+        const size_t count = bounds.Size();
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!visible[i])
+            {
+                continue;
+            }
+
+            const float center[3] = { bounds.centerX[i], bounds.centerY[i], bounds.centerZ[i] };
+            const float extent[3] = { bounds.extentX[i], bounds.extentY[i], bounds.extentZ[i] };
+            if (!IsVisible(center, extent))
+            {
+                visible[i] = 0;
+                ++occluded;
+            }
+        }
+        return occluded;
+    }
+
+    bool OcclusionCuller::IsVisible(const float* center, const float* extent) const
+    {
+        // NDC rect as (minX, minY, maxX, maxY) plus the nearest depth of the 8 projected corners
+        float rect[4];
+        float minDepth;
+        const float* m = m_viewProjection;
+
+#if defined(ENG_OCCLUSION_SSE)
+        // Corners are center +- each scaled axis column, so the matrix is applied once instead of 8 times
+        const __m128 column0 = _mm_loadu_ps(m);
+        const __m128 column1 = _mm_loadu_ps(m + 4);
+        const __m128 column2 = _mm_loadu_ps(m + 8);
+        const __m128 column3 = _mm_loadu_ps(m + 12);
+        const __m128 clipCenter = _mm_add_ps(_mm_add_ps(_mm_mul_ps(column0, _mm_set1_ps(center[0])),
+            _mm_mul_ps(column1, _mm_set1_ps(center[1]))),
+            _mm_add_ps(_mm_mul_ps(column2, _mm_set1_ps(center[2])), column3));
+        const __m128 axisX = _mm_mul_ps(column0, _mm_set1_ps(extent[0]));
+        const __m128 axisY = _mm_mul_ps(column1, _mm_set1_ps(extent[1]));
+        const __m128 axisZ = _mm_mul_ps(column2, _mm_set1_ps(extent[2]));
+
+        __m128 minX = _mm_set1_ps(1e30f);
+        __m128 minY = minX;
+        __m128 minZ = minX;
+        __m128 maxX = _mm_set1_ps(-1e30f);
+        __m128 maxY = maxX;
+        __m128 behind = _mm_setzero_ps();
+        for (int half = 0; half < 2; ++half)
+        {
+            const __m128 base = half ? _mm_add_ps(clipCenter, axisZ) : _mm_sub_ps(clipCenter, axisZ);
+            const __m128 low = _mm_sub_ps(base, axisY);
+            const __m128 high = _mm_add_ps(base, axisY);
+            __m128 c0 = _mm_sub_ps(low, axisX);
+            __m128 c1 = _mm_add_ps(low, axisX);
+            __m128 c2 = _mm_sub_ps(high, axisX);
+            __m128 c3 = _mm_add_ps(high, axisX);
+            // Rows become x, y, z, w of the 4 corners
+            _MM_TRANSPOSE4_PS(c0, c1, c2, c3);
+
+            behind = _mm_or_ps(behind, _mm_or_ps(_mm_cmple_ps(c3, _mm_set1_ps(MinClipW)),
+                _mm_cmplt_ps(_mm_add_ps(c2, c3), _mm_setzero_ps())));
+            const __m128 inverseW = _mm_div_ps(_mm_set1_ps(1.0f), c3);
+            const __m128 x = _mm_mul_ps(c0, inverseW);
+            const __m128 y = _mm_mul_ps(c1, inverseW);
+            const __m128 z = _mm_mul_ps(c2, inverseW);
+            minX = _mm_min_ps(minX, x);
+            maxX = _mm_max_ps(maxX, x);
+            minY = _mm_min_ps(minY, y);
+            maxY = _mm_max_ps(maxY, y);
+            minZ = _mm_min_ps(minZ, z);
+        }
+        // Boxes crossing the near plane cannot be projected conservatively
+        if (_mm_movemask_ps(behind) != 0)
+        {
+            return true;
+        }
+
+        alignas(16) float values[5][4];
+        _mm_store_ps(values[0], minX);
+        _mm_store_ps(values[1], minY);
+        _mm_store_ps(values[2], maxX);
+        _mm_store_ps(values[3], maxY);
+        _mm_store_ps(values[4], minZ);
+        for (int i = 0; i < 4; ++i)
+        {
+            rect[i] = values[i][0];
+            for (int lane = 1; lane < 4; ++lane)
+            {
+                rect[i] = i < 2 ? std::min(rect[i], values[i][lane]) : std::max(rect[i], values[i][lane]);
+            }
+        }
+        minDepth = std::min(std::min(values[4][0], values[4][1]), std::min(values[4][2], values[4][3])) * 0.5f + 0.5f;
+#else
+        rect[0] = rect[1] = 1e30f;
+        rect[2] = rect[3] = -1e30f;
+        minDepth = 1e30f;
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            float clip[4];
+            TransformPoint(m, center[0] + ((corner & 1) ? extent[0] : -extent[0]),
+                center[1] + ((corner & 2) ? extent[1] : -extent[1]),
+                center[2] + ((corner & 4) ? extent[2] : -extent[2]), clip);
+            if (clip[3] <= MinClipW || NearDistance(clip) < 0.0f)
+            {
+                return true;
+            }
+            float inverseW = 1.0f / clip[3];
+            float x = clip[0] * inverseW;
+            float y = clip[1] * inverseW;
+            rect[0] = std::min(rect[0], x);
+            rect[1] = std::min(rect[1], y);
+            rect[2] = std::max(rect[2], x);
+            rect[3] = std::max(rect[3], y);
+            minDepth = std::min(minDepth, clip[2] * inverseW * 0.5f + 0.5f);
+        }
+#endif
+
+        // Off screen boxes are the frustum test's business
+        if (rect[2] < -1.0f || rect[0] > 1.0f || rect[3] < -1.0f || rect[1] > 1.0f)
+        {
+            return true;
+        }
+
+        // Clamped to >= 0 first so the truncating casts round down
+        auto toPixel = [](float ndc, int size)
+        {
+            return std::min(size - 1, static_cast<int>(std::max(0.0f, (ndc * 0.5f + 0.5f) * size)));
+        };
+        int x0 = toPixel(rect[0], m_width);
+        int y0 = toPixel(rect[1], m_height);
+        int x1 = toPixel(rect[2], m_width);
+        int y1 = toPixel(rect[3], m_height);
+
+        size_t level = 0;
+        while (level + 1 < m_levels.size() && (x1 - x0 >= MaxTestTexels || y1 - y0 >= MaxTestTexels))
+        {
+            x0 >>= 1;
+            x1 >>= 1;
+            y0 >>= 1;
+            y1 >>= 1;
+            ++level;
+        }
+
+        const float* depth = m_levels[level].data();
+        const int width = m_levelWidths[level];
+        for (int y = y0; y <= y1; ++y)
+        {
+            for (int x = x0; x <= x1; ++x)
+            {
+                if (depth[static_cast<size_t>(y) * width + x] >= minDepth)
+                {
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+
+    int OcclusionCuller::GetWidth() const
+    {
+        return m_width;
+    }
+
+    int OcclusionCuller::GetHeight() const
+    {
+        return m_height;
+    }
+
+    const float* OcclusionCuller::GetDepthBuffer() const
+    {
+        return m_levels[0].data();
+    }
+
+    size_t OcclusionCuller::GetLevelCount() const
+    {
+        return m_levels.size();
+    }
+
+    const float* OcclusionCuller::GetLevel(size_t level) const
+    {
+        return m_levels[level].data();
+    }
+
+    int OcclusionCuller::GetLevelWidth(size_t level) const
+    {
+        return m_levelWidths[level];
+    }
+
+    int OcclusionCuller::GetLevelHeight(size_t level) const
+    {
+        return m_levelHeights[level];
+    }
+
+    size_t OcclusionCuller::GetRasterizedTriangleCount() const
+    {
+        return m_rasterizedTriangles;
+    }
+}
\ No newline at end of file
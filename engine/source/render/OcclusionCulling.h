@@ -0,0 +1,70 @@
+#pragma once
+#include "render/Bounds.h"
+#include "render/FrustumCulling.h"
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace eng
+{
+    // CPU copy of a simplified mesh used only to fill the occlusion depth buffer
+    struct OccluderMesh
+    {
+        std::vector<float> positions; // xyz per vertex
+        std::vector<uint32_t> indices;
+        BoundingBox bounds;
+    };
+
+    // Software occlusion culling: occluders are rasterized on the CPU into a small depth buffer, 4 pixels at
+    // a time with coverage masks, then reduced into a max-depth pyramid that object bounds are tested against.
+    // Depth is GL window depth in [0, 1], smaller is closer.
+    class OcclusionCuller
+    {
+    public:
+        static constexpr int DefaultWidth = 256;
+        static constexpr int DefaultHeight = 128;
+
+        explicit OcclusionCuller(int width = DefaultWidth, int height = DefaultHeight);
+
+        // Width is rounded up to a multiple of 4
+        void Resize(int width, int height);
+
+        // Clears the depth buffer, the matrix is the column-major view-projection used for occluders and tests
+        void BeginFrame(const float* viewProjection);
+        // Transform is a column-major world matrix, null = identity
+        void RenderOccluder(const OccluderMesh& mesh, const float* transform);
+        // Must run after the last occluder and before any test
+        void BuildHierarchy();
+
+        bool IsVisible(const BoundingBox& worldBox) const;
+        // Clears visible[i] for every box hidden behind the occluders and returns how many were cleared.
+        // Boxes already marked invisible are skipped.
+        size_t TestBoxes(const CullingBounds& bounds, uint8_t* visible) const;
+
+        int GetWidth() const;
+        int GetHeight() const;
+        const float* GetDepthBuffer() const;
+        // Pyramid levels as built by BuildHierarchy, level 0 is the depth buffer
+        size_t GetLevelCount() const;
+        const float* GetLevel(size_t level) const;
+        int GetLevelWidth(size_t level) const;
+        int GetLevelHeight(size_t level) const;
+        size_t GetRasterizedTriangleCount() const;
+
+    private:
+        // Vertices are (screen x, screen y, depth)
+        void RasterizeTriangle(const float* v0, const float* v1, const float* v2);
+        void ClipAndRasterize(const float* c0, const float* c1, const float* c2);
+        bool IsVisible(const float* center, const float* extent) const;
+
+        int m_width = 0;
+        int m_height = 0;
+        float m_viewProjection[16] = {};
+        // Level 0 is the full resolution depth buffer, each further level keeps the max of 2x2 texels
+        std::vector<std::vector<float>> m_levels;
+        std::vector<int> m_levelWidths;
+        std::vector<int> m_levelHeights;
+        std::vector<float> m_clipVertices;
+        size_t m_rasterizedTriangles = 0;
+    };
+}
\ No newline at end of file
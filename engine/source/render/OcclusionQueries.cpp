@@ -0,0 +1,283 @@
+#include "render/OcclusionQueries.h"
+#include "render/RenderQueue.h"
+#include "render/Mesh.h"
+#include "graphics/GraphicsAPI.h"
+#include "graphics/ShaderProgram.h"
+
+namespace eng
+{
+    namespace
+    {
+        const char* BoxVertexSource = R"(
+            #version 330 core
+            layout (location = 0) in vec3 position;
+
+            uniform mat4 uViewProjection;
+            uniform vec3 uCenter;
+            uniform vec3 uExtent;
+
+            void main()
+            {
+                gl_Position = uViewProjection * vec4(uCenter + position * uExtent, 1.0);
+            }
+        )";
+
+        const char* BoxFragmentSource = R"(
+            #version 330 core
+            out vec4 FragColor;
+
+            void main()
+            {
+                FragColor = vec4(1.0);
+            }
+        )";
+
+        const size_t QueryAllocationBatch = 64;
+        // Boxes are grown slightly so they never z-fight with the surface of the mesh they enclose
+        const float BoxInflation = 1.01f;
+    }
+
+    void OcclusionQueries::Draw(GraphicsAPI& graphicsAPI, const float* viewProjection, const RenderCommand* commands,
+        size_t count)
+    {
+        m_conditionalDraws = 0;
+        if (count == 0)
+        {
+            return;
+        }
+
+        if (!m_initialized && !InitResources(graphicsAPI))
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                graphicsAPI.BindMaterial(commands[i].material);
+                graphicsAPI.BindMesh(commands[i].mesh);
+                graphicsAPI.DrawMesh(commands[i].mesh);
+            }
+            return;
+        }
+
+        ++m_frame;
+        m_freeQueries.insert(m_freeQueries.end(), m_retiredQueries.begin(), m_retiredQueries.end());
+        m_retiredQueries.clear();
+
+        m_boxes.Clear();
+        m_boxes.Reserve(count);
+        for (size_t i = 0; i < count; ++i)
+        {
+            BoundingBox bounds = commands[i].mesh ? commands[i].mesh->GetBounds() : BoundingBox();
+            if (commands[i].transform)
+            {
+                m_boxes.Add(bounds, commands[i].transform);
+            }
+            else
+            {
+                m_boxes.Add(bounds);
+            }
+        }
+
+        // Meshes first, each behind the result its box produced last frame
+        for (size_t i = 0; i < count; ++i)
+        {
+            const RenderCommand& command = commands[i];
+            auto it = m_entries.find(command.occlusionQueryId);
+            bool conditional = it != m_entries.end() && it->second.query != 0;
+
+            graphicsAPI.BindMaterial(command.material);
+            graphicsAPI.BindMesh(command.mesh);
+            if (conditional)
+            {
+                glBeginConditionalRender(it->second.query, GL_QUERY_NO_WAIT);
+                ++m_conditionalDraws;
+            }
+            graphicsAPI.DrawMesh(command.mesh);
+            if (conditional)
+            {
+                glEndConditionalRender();
+            }
+        }
+
+        // Then this frame's box queries, without touching color or depth
+        glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+        glDepthMask(GL_FALSE);
+        m_boxShader->Bind();
+        m_boxShader->SetUniformMatrix4("uViewProjection", viewProjection);
+        glBindVertexArray(m_VAO);
+        RenderStats& stats = graphicsAPI.GetFrameStats();
+        stats.Add(RenderCounter::VertexArrayBinds);
+
+        for (size_t i = 0; i < count; ++i)
+        {
+            Entry& entry = m_entries[commands[i].occlusionQueryId];
+            entry.lastFrame = m_frame;
+            if (entry.query != 0)
+            {
+                RetireQuery(entry.query);
+                entry.query = 0;
+            }
+
+            // A camera inside the box would only see back faces that fail the depth test, keep it unconditional
+            if (!commands[i].mesh || CrossesNearPlane(i, viewProjection))
+            {
+                continue;
+            }
+
+            entry.query = AcquireQuery();
+            m_boxShader->SetUniform("uCenter", m_boxes.centerX[i], m_boxes.centerY[i], m_boxes.centerZ[i]);
+            m_boxShader->SetUniform("uExtent", m_boxes.extentX[i] * BoxInflation, m_boxes.extentY[i] * BoxInflation,
+                m_boxes.extentZ[i] * BoxInflation);
+            glBeginQuery(m_queryTarget, entry.query);
+            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_INT, nullptr);
+            glEndQuery(m_queryTarget);
+            stats.Add(RenderCounter::DrawCalls);
+            stats.Add(RenderCounter::Instances);
+            stats.Add(RenderCounter::Triangles, 12);
+        }
+
+        glBindVertexArray(0);
+        glDepthMask(GL_TRUE);
+        glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+        // Objects that stopped being submitted give their query back
+        for (auto it = m_entries.begin(); it != m_entries.end();)
+        {
+            if (it->second.lastFrame != m_frame)
+            {
+                if (it->second.query != 0)
+                {
+                    RetireQuery(it->second.query);
+                }
+                it = m_entries.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+    void OcclusionQueries::Shutdown()
+    {
+        if (!m_allQueries.empty())
+        {
+            glDeleteQueries(static_cast<GLsizei>(m_allQueries.size()), m_allQueries.data());
+        }
+        if (m_VAO)
+        {
+            glDeleteVertexArrays(1, &m_VAO);
+            glDeleteBuffers(1, &m_VBO);
+            glDeleteBuffers(1, &m_EBO);
+        }
+        m_VAO = 0;
+        m_VBO = 0;
+        m_EBO = 0;
+        m_allQueries.clear();
+        m_freeQueries.clear();
+        m_retiredQueries.clear();
+        m_entries.clear();
+        m_boxShader.reset();
+        m_initialized = false;
+    }
+
+    size_t OcclusionQueries::GetConditionalDrawCount() const
+    {
+        return m_conditionalDraws;
+    }
+
+    size_t OcclusionQueries::GetPooledQueryCount() const
+    {
+        return m_allQueries.size();
+    }
+
+    bool OcclusionQueries::InitResources(GraphicsAPI& graphicsAPI)
+    {
+        m_boxShader = graphicsAPI.CreateShaderProgram(BoxVertexSource, BoxFragmentSource);
+        if (!m_boxShader)
+        {
+            return false;
+        }
+
+        // Conservative queries (GL 4.3 / ES3 compatibility) may skip exact per-sample testing
+        m_queryTarget = (GLEW_VERSION_4_3 || GLEW_ARB_ES3_compatibility)
+            ? GL_ANY_SAMPLES_PASSED_CONSERVATIVE : GL_ANY_SAMPLES_PASSED;
+
+        const float vertices[] =
+        {
+            -1.0f, -1.0f, -1.0f,
+            1.0f, -1.0f, -1.0f,
+            1.0f, 1.0f, -1.0f,
+            -1.0f, 1.0f, -1.0f,
+            -1.0f, -1.0f, 1.0f,
+            1.0f, -1.0f, 1.0f,
+            1.0f, 1.0f, 1.0f,
+            -1.0f, 1.0f, 1.0f
+        };
+        const uint32_t indices[] =
+        {
+            0, 2, 1, 0, 3, 2,
+            4, 5, 6, 4, 6, 7,
+            0, 1, 5, 0, 5, 4,
+            3, 6, 2, 3, 7, 6,
+            0, 4, 7, 0, 7, 3,
+            1, 2, 6, 1, 6, 5
+        };
+
+        glGenVertexArrays(1, &m_VAO);
+        glBindVertexArray(m_VAO);
+
+        glGenBuffers(1, &m_VBO);
+        glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
+        glEnableVertexAttribArray(0);
+
+        glGenBuffers(1, &m_EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices), indices, GL_STATIC_DRAW);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        m_initialized = true;
+        return true;
+    }
+
+    GLuint OcclusionQueries::AcquireQuery()
+    {
+        if (m_freeQueries.empty())
+        {
+            size_t first = m_allQueries.size();
+            m_allQueries.resize(first + QueryAllocationBatch);
+            glGenQueries(static_cast<GLsizei>(QueryAllocationBatch), &m_allQueries[first]);
+            m_freeQueries.insert(m_freeQueries.end(), m_allQueries.begin() + first, m_allQueries.end());
+        }
+        GLuint query = m_freeQueries.back();
+        m_freeQueries.pop_back();
+        return query;
+    }
+
+    void OcclusionQueries::RetireQuery(GLuint query)
+    {
+        m_retiredQueries.push_back(query);
+    }
+
+    bool OcclusionQueries::CrossesNearPlane(size_t index, const float* m) const
+    {
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            float extentX = m_boxes.extentX[index] * BoxInflation;
+            float extentY = m_boxes.extentY[index] * BoxInflation;
+            float extentZ = m_boxes.extentZ[index] * BoxInflation;
+            float x = m_boxes.centerX[index] + ((corner & 1) ? extentX : -extentX);
+            float y = m_boxes.centerY[index] + ((corner & 2) ? extentY : -extentY);
+            float z = m_boxes.centerZ[index] + ((corner & 4) ? extentZ : -extentZ);
+            float clipZ = m[2] * x + m[6] * y + m[10] * z + m[14];
+            float clipW = m[3] * x + m[7] * y + m[11] * z + m[15];
+            if (clipZ + clipW < 0.0f)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
\ No newline at end of file
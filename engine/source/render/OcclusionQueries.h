@@ -0,0 +1,58 @@
+#pragma once
+#include "render/FrustumCulling.h"
+#include <GL/glew.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace eng
+{
+    class GraphicsAPI;
+    class ShaderProgram;
+    struct RenderCommand;
+
+    // Hardware occlusion queries for expensive meshes. Each frame the bounding box of every command is drawn
+    // into a query, and the mesh itself is drawn under glBeginConditionalRender with the query its key got
+    // the frame before. The CPU never reads a result, so nothing ever waits on the GPU.
+    class OcclusionQueries
+    {
+    public:
+        // Commands must have a non-zero occlusionQueryId. Draw them after the regular opaque commands, with the
+        // depth test on, so their boxes are tested against that depth.
+        void Draw(GraphicsAPI& graphicsAPI, const float* viewProjection, const RenderCommand* commands,
+            size_t count);
+        void Shutdown();
+
+        // Commands drawn under a conditional render during the last Draw
+        size_t GetConditionalDrawCount() const;
+        size_t GetPooledQueryCount() const;
+
+    private:
+        struct Entry
+        {
+            GLuint query = 0;
+            uint64_t lastFrame = 0;
+        };
+
+        bool InitResources(GraphicsAPI& graphicsAPI);
+        GLuint AcquireQuery();
+        void RetireQuery(GLuint query);
+        bool CrossesNearPlane(size_t index, const float* viewProjection) const;
+
+        std::unordered_map<uint32_t, Entry> m_entries;
+        // Queries become reusable one frame after they were last referenced
+        std::vector<GLuint> m_freeQueries;
+        std::vector<GLuint> m_retiredQueries;
+        std::vector<GLuint> m_allQueries;
+        CullingBounds m_boxes;
+
+        std::shared_ptr<ShaderProgram> m_boxShader;
+        GLuint m_VAO = 0;
+        GLuint m_VBO = 0;
+        GLuint m_EBO = 0;
+        GLenum m_queryTarget = GL_ANY_SAMPLES_PASSED;
+        uint64_t m_frame = 0;
+        size_t m_conditionalDraws = 0;
+        bool m_initialized = false;
+    };
+}
\ No newline at end of file
@@ -2,23 +2,356 @@
 #include "render/Mesh.h"
 #include "render/Material.h"
 #include "graphics/GraphicsAPI.h"
+#include "graphics/Texture.h"
+#include "render/TextureStreamer.h"
+#include "Engine.h"
+#include "profile/GpuProfiler.h"
+#include <algorithm>
+#include <cfloat>
 
 namespace eng
 {
     void RenderQueue::Submit(const RenderCommand& command)
     {
-        m_commands.push_back(command);
+        m_recording.commands.push_back(command);
+        m_recording.commandTransforms.push_back(CopyTransform(command.transform));
+    }
+
+    void RenderQueue::SubmitOccluder(const OccluderCommand& occluder)
+    {
+        if (occluder.mesh)
+        {
+            m_recording.occluders.push_back(occluder);
+            m_recording.occluderTransforms.push_back(CopyTransform(occluder.transform));
+        }
+    }
+
+    void RenderQueue::SubmitInstances(GpuInstanceBatch* batch)
+    {
+        if (batch)
+        {
+            m_recording.instanceBatches.push_back(batch);
+        }
+    }
+
+    void RenderQueue::EndFrame()
+    {
+        ENG_PROFILE_SCOPE("RenderQueue::EndFrame");
+        m_rendering.Clear();
+        m_culled = false;
+        m_recorded = false;
+        m_culledCount = m_frameCulledCount;
+        m_occludedCount = m_frameOccludedCount;
+        m_frameCulledCount = 0;
+        m_frameOccludedCount = 0;
+
+        std::swap(m_recording, m_rendering);
+        std::copy(m_rendering.viewProjection, m_rendering.viewProjection + 16, m_recording.viewProjection);
+        m_recording.hasViewProjection = m_rendering.hasViewProjection;
+        m_recording.cullingEnabled = m_rendering.cullingEnabled;
+        m_recording.occlusionQueriesEnabled = m_rendering.occlusionQueriesEnabled;
+
+        // The transform storage no longer grows, so commands can point into it now
+        Frame& frame = m_rendering;
+        for (size_t i = 0; i < frame.commands.size(); ++i)
+        {
+            const uint32_t offset = frame.commandTransforms[i];
+            frame.commands[i].transform = offset == NoTransform ? nullptr : &frame.transforms[offset];
+        }
+        for (size_t i = 0; i < frame.occluders.size(); ++i)
+        {
+            const uint32_t offset = frame.occluderTransforms[i];
+            frame.occluders[i].transform = offset == NoTransform ? nullptr : &frame.transforms[offset];
+        }
+        for (auto* batch : frame.instanceBatches)
+        {
+            batch->Publish();
+        }
+    }
+
+    void RenderQueue::SetViewProjection(const float* matrix)
+    {
+        std::copy(matrix, matrix + 16, m_recording.viewProjection);
+        m_recording.hasViewProjection = true;
+        m_recording.cullingEnabled = true;
+    }
+
+    void RenderQueue::DisableCulling()
+    {
+        m_recording.cullingEnabled = false;
+    }
+
+    void RenderQueue::SetViewportSize(int width, int height)
+    {
+        m_viewportWidth = width;
+        m_viewportHeight = height;
+    }
+
+    size_t RenderQueue::GetCulledCount() const
+    {
+        return m_culledCount;
+    }
+
+    size_t RenderQueue::GetOccludedCount() const
+    {
+        return m_occludedCount;
+    }
+
+    OcclusionCuller& RenderQueue::GetOcclusionCuller()
+    {
+        return m_occlusionCuller;
+    }
+
+    void RenderQueue::EnableOcclusionQueries(bool enable)
+    {
+        m_recording.occlusionQueriesEnabled = enable;
+    }
+
+    OcclusionQueries& RenderQueue::GetOcclusionQueries()
+    {
+        return m_occlusionQueries;
+    }
+
+    GpuCuller& RenderQueue::GetGpuCuller()
+    {
+        return m_gpuCuller;
+    }
+
+    void RenderQueue::Cull()
+    {
+        ENG_PROFILE_SCOPE("RenderQueue::Cull");
+        Frame& frame = m_rendering;
+        m_culled = true;
+        m_hierarchyBuilt = false;
+        RenderStats& stats = Engine::GetInstance().GetGraphicsAPI().GetFrameStats();
+        stats.Add(RenderCounter::CommandsSubmitted, frame.commands.size());
+
+        // Texture requests are sized by the projected boxes, so they are built without culling as well
+        const bool projectBounds = frame.hasViewProjection && m_viewportWidth > 0 && m_viewportHeight > 0;
+        if (frame.cullingEnabled || projectBounds)
+        {
+            m_cullingBounds.Clear();
+            m_cullingBounds.Reserve(frame.commands.size());
+            for (auto& command : frame.commands)
+            {
+                // Commands without a mesh never reach the GPU anyway; an empty box keeps indices aligned
+                BoundingBox bounds = command.mesh ? command.mesh->GetBounds() : BoundingBox();
+                if (command.transform)
+                {
+                    m_cullingBounds.Add(bounds, command.transform);
+                }
+                else
+                {
+                    m_cullingBounds.Add(bounds);
+                }
+            }
+        }
+
+        m_visible.assign(frame.commands.size(), 1);
+        if (frame.cullingEnabled)
+        {
+            m_frustum = Frustum::FromViewProjection(frame.viewProjection);
+            CullBoxes(m_frustum, m_cullingBounds, m_visible.data());
+
+            if (!frame.occluders.empty())
+            {
+                m_occlusionCuller.BeginFrame(frame.viewProjection);
+                for (auto& occluder : frame.occluders)
+                {
+                    m_occlusionCuller.RenderOccluder(*occluder.mesh, occluder.transform);
+                }
+                m_occlusionCuller.BuildHierarchy();
+                m_hierarchyBuilt = true;
+                m_frameOccludedCount = m_occlusionCuller.TestBoxes(m_cullingBounds, m_visible.data());
+            }
+        }
+
+        // Culled commands request nothing, so their textures can fall back to the resident mips
+        size_t visibleCount = 0;
+        for (size_t i = 0; i < frame.commands.size(); ++i)
+        {
+            if (m_visible[i])
+            {
+                // Without a view-projection the size is unknown and full resolution is requested
+                RequestTextures(frame.commands[i], projectBounds ? GetScreenSize(i, frame.viewProjection) : 0.0f);
+                frame.commands[visibleCount++] = frame.commands[i];
+            }
+        }
+        m_frameCulledCount = frame.commands.size() - visibleCount;
+        frame.commands.resize(visibleCount);
+        stats.Add(RenderCounter::CommandsCulled, m_frameCulledCount);
+        stats.Add(RenderCounter::CommandsOccluded, m_frameOccludedCount);
+    }
+
+    void RenderQueue::Record()
+    {
+        ENG_PROFILE_SCOPE("RenderQueue::Record");
+        if (!m_culled)
+        {
+            Cull();
+        }
+
+        // Queried commands go last so their boxes are tested against everything else
+        Frame& frame = m_rendering;
+        m_queriedBegin = frame.commands.size();
+        if (frame.occlusionQueriesEnabled && frame.hasViewProjection)
+        {
+            auto queried = std::stable_partition(frame.commands.begin(), frame.commands.end(),
+                [](const RenderCommand& command) { return command.occlusionQueryId == 0; });
+            m_queriedBegin = static_cast<size_t>(queried - frame.commands.begin());
+        }
+        m_recorded = true;
     }
 
     void RenderQueue::Draw(GraphicsAPI& graphicsAPI)
     {
-        for (auto& command : m_commands)
+        ENG_PROFILE_SCOPE("RenderQueue::Draw");
+        if (!m_recorded)
+        {
+            Record();
+        }
+
+        Frame& frame = m_rendering;
+        GpuProfiler& gpuProfiler = Engine::GetInstance().GetGpuProfiler();
+        // Meshes write depth for the occlusion query boxes drawn last, sprites drawn afterwards stay on top
+        graphicsAPI.SetDepthTest(true);
+        if (m_queriedBegin > 0)
+        {
+            // Consecutive commands sharing a material are timed as one bucket
+            ENG_PROFILE_GPU_SCOPE(gpuProfiler, "Meshes");
+            const bool timeBuckets = gpuProfiler.IsEnabled();
+            Material* bucket = nullptr;
+            for (size_t i = 0; i < m_queriedBegin; ++i)
+            {
+                const RenderCommand& command = frame.commands[i];
+                if (timeBuckets && (i == 0 || command.material != bucket))
+                {
+                    if (i > 0)
+                    {
+                        gpuProfiler.EndScope();
+                    }
+                    bucket = command.material;
+                    gpuProfiler.BeginScope(bucket && !bucket->GetName().empty() ? bucket->GetName() :
+                        std::string("Material"));
+                }
+                graphicsAPI.BindMaterial(command.material);
+                graphicsAPI.BindMesh(command.mesh);
+                graphicsAPI.DrawMesh(command.mesh);
+            }
+            if (timeBuckets)
+            {
+                gpuProfiler.EndScope();
+            }
+        }
+
+        if (!frame.instanceBatches.empty())
+        {
+            ENG_PROFILE_GPU_SCOPE(gpuProfiler, "Instances");
+            m_gpuCuller.BeginFrame(graphicsAPI, frame.cullingEnabled ? frame.viewProjection : nullptr,
+                m_hierarchyBuilt ? &m_occlusionCuller : nullptr);
+            for (auto* batch : frame.instanceBatches)
+            {
+                m_gpuCuller.Draw(graphicsAPI, *batch);
+            }
+        }
+
+        if (m_queriedBegin < frame.commands.size())
         {
-            graphicsAPI.BindMaterial(command.material);
-            graphicsAPI.BindMesh(command.mesh);
-            graphicsAPI.DrawMesh(command.mesh);
+            ENG_PROFILE_GPU_SCOPE(gpuProfiler, "OcclusionQueries");
+            m_occlusionQueries.Draw(graphicsAPI, frame.viewProjection, &frame.commands[m_queriedBegin],
+                frame.commands.size() - m_queriedBegin);
         }
+        graphicsAPI.SetDepthTest(false);
 
-        m_commands.clear();
+        frame.Clear();
+        m_culled = false;
+        m_recorded = false;
+        m_queriedBegin = 0;
+    }
+
+    void RenderQueue::Shutdown()
+    {
+        m_occlusionQueries.Shutdown();
+        m_gpuCuller.Shutdown();
+        m_recording.Clear();
+        m_rendering.Clear();
+        m_culled = false;
+        m_recorded = false;
+        m_queriedBegin = 0;
+    }
+
+    uint32_t RenderQueue::CopyTransform(const float* transform)
+    {
+        if (!transform)
+        {
+            return NoTransform;
+        }
+        const uint32_t offset = static_cast<uint32_t>(m_recording.transforms.size());
+        m_recording.transforms.insert(m_recording.transforms.end(), transform, transform + 16);
+        return offset;
+    }
+
+    float RenderQueue::GetScreenSize(size_t index, const float* m) const
+    {
+        const float center[3] = { m_cullingBounds.centerX[index], m_cullingBounds.centerY[index],
+            m_cullingBounds.centerZ[index] };
+        const float extent[3] = { m_cullingBounds.extentX[index], m_cullingBounds.extentY[index],
+            m_cullingBounds.extentZ[index] };
+
+        float minX = FLT_MAX;
+        float minY = FLT_MAX;
+        float maxX = -FLT_MAX;
+        float maxY = -FLT_MAX;
+        for (int corner = 0; corner < 8; ++corner)
+        {
+            const float x = center[0] + ((corner & 1) ? extent[0] : -extent[0]);
+            const float y = center[1] + ((corner & 2) ? extent[1] : -extent[1]);
+            const float z = center[2] + ((corner & 4) ? extent[2] : -extent[2]);
+            const float w = m[3] * x + m[7] * y + m[11] * z + m[15];
+            // A box reaching behind the camera plane is as close as it gets
+            if (w <= 1e-6f)
+            {
+                return 0.0f;
+            }
+            const float ndcX = (m[0] * x + m[4] * y + m[8] * z + m[12]) / w;
+            const float ndcY = (m[1] * x + m[5] * y + m[9] * z + m[13]) / w;
+            minX = std::min(minX, ndcX);
+            minY = std::min(minY, ndcY);
+            maxX = std::max(maxX, ndcX);
+            maxY = std::max(maxY, ndcY);
+        }
+
+        // Not clipped to the viewport: a box larger than the screen still needs the texel density of its size.
+        // At least one pixel, 0 would request full resolution.
+        const float width = (maxX - minX) * 0.5f * m_viewportWidth;
+        const float height = (maxY - minY) * 0.5f * m_viewportHeight;
+        return std::max(std::max(width, height), 1.0f);
+    }
+
+    void RenderQueue::RequestTextures(const RenderCommand& command, float screenSize)
+    {
+        if (!command.mesh || !command.material)
+        {
+            return;
+        }
+        // The UV range is assumed to span the mesh bounds once
+        auto& textureStreamer = Engine::GetInstance().GetTextureStreamer();
+        for (auto& slot : command.material->GetTextures())
+        {
+            if (slot.texture && slot.texture->GetStreamingHandle() >= 0)
+            {
+                textureStreamer.RequestResolution(slot.texture.get(), screenSize);
+            }
+        }
+    }
+
+    void RenderQueue::Frame::Clear()
+    {
+        commands.clear();
+        occluders.clear();
+        instanceBatches.clear();
+        transforms.clear();
+        commandTransforms.clear();
+        occluderTransforms.clear();
     }
 }
\ No newline at end of file
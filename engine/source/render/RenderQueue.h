@@ -1,4 +1,8 @@
 #pragma once
+#include "render/FrustumCulling.h"
+#include "render/GpuCulling.h"
+#include "render/OcclusionCulling.h"
+#include "render/OcclusionQueries.h"
 #include <vector>
 
 namespace eng
@@ -11,15 +15,102 @@ namespace eng
     {
         Mesh* mesh = nullptr;
         Material* material = nullptr;
+        // Column-major 4x4 world matrix placing the mesh bounds for culling, null = identity. Copied on submit.
+        const float* transform = nullptr;
+        // Stable per-object key, non-zero wraps the draw in a hardware occlusion query when enabled.
+        // Meant for expensive meshes, the result is applied one frame late.
+        uint32_t occlusionQueryId = 0;
     };
 
+    struct OccluderCommand
+    {
+        const OccluderMesh* mesh = nullptr;
+        // Column-major 4x4 world matrix, null = identity. Copied on submit.
+        const float* transform = nullptr;
+    };
+
+    // Double buffered: the simulation submits into the recording frame while the previous one is culled and
+    // drawn. EndFrame hands the recorded frame over, then Cull and Record (CPU only) and Draw (GL) render it.
+    // Submission and the settings below belong to the simulation, the rest to the main thread. Cull also
+    // requests the streamed textures of the surviving commands, sized by their bounds projected on screen.
     class RenderQueue
     {
     public:
         void Submit(const RenderCommand& command);
+        // Occluders only fill the CPU occlusion depth buffer, submit a RenderCommand to also draw them
+        void SubmitOccluder(const OccluderCommand& occluder);
+        // Instances are culled by the GPU against the same frustum and occluders, after the regular commands.
+        // The batch must stay alive until the queue is drawn.
+        void SubmitInstances(GpuInstanceBatch* batch);
+
+        // Main thread, while no frame is being recorded. Drops the frame handed off last if it was not drawn.
+        void EndFrame();
+        void Cull();
+        void Record();
         void Draw(GraphicsAPI& graphicsAPI);
+        void Shutdown();
+        // The framebuffer the view-projection maps onto, texture requests are sized in its pixels
+        void SetViewportSize(int width, int height);
+
+        // Enables frustum culling of submitted commands against this column-major view-projection. Applies to
+        // the frame being recorded and the ones after it.
+        void SetViewProjection(const float* matrix);
+        void DisableCulling();
+        // Commands removed by either the frustum or the occluders in the last frame drawn before EndFrame
+        size_t GetCulledCount() const;
+        size_t GetOccludedCount() const;
+        OcclusionCuller& GetOcclusionCuller();
+
+        // Needs a view-projection from SetViewProjection, commands are drawn normally otherwise
+        void EnableOcclusionQueries(bool enable);
+        OcclusionQueries& GetOcclusionQueries();
+        GpuCuller& GetGpuCuller();
 
     private:
-        std::vector<RenderCommand> m_commands;
+        static constexpr uint32_t NoTransform = ~0u;
+
+        struct Frame
+        {
+            std::vector<RenderCommand> commands;
+            std::vector<OccluderCommand> occluders;
+            std::vector<GpuInstanceBatch*> instanceBatches;
+            // Submitted matrices, commands point into this once the frame is handed off
+            std::vector<float> transforms;
+            std::vector<uint32_t> commandTransforms;
+            std::vector<uint32_t> occluderTransforms;
+            float viewProjection[16] = {};
+            bool hasViewProjection = false;
+            bool cullingEnabled = false;
+            bool occlusionQueriesEnabled = false;
+
+            void Clear();
+        };
+
+        uint32_t CopyTransform(const float* transform);
+        // Pixels covered by the culling box at index, 0 if it reaches behind the camera
+        float GetScreenSize(size_t index, const float* viewProjection) const;
+        void RequestTextures(const RenderCommand& command, float screenSize);
+
+        Frame m_recording;
+        Frame m_rendering;
+        // Draw order from Record: commands before this index are drawn directly, the rest through queries
+        size_t m_queriedBegin = 0;
+        bool m_recorded = false;
+        Frustum m_frustum;
+        CullingBounds m_cullingBounds;
+        std::vector<uint8_t> m_visible;
+        int m_viewportWidth = 0;
+        int m_viewportHeight = 0;
+        OcclusionCuller m_occlusionCuller;
+        OcclusionQueries m_occlusionQueries;
+        bool m_occlusionQueriesEnabled = false;
+        GpuCuller m_gpuCuller;
+        bool m_hierarchyBuilt = false;
+        bool m_culled = false;
+        // Written while rendering, published by EndFrame
+        size_t m_frameCulledCount = 0;
+        size_t m_frameOccludedCount = 0;
+        size_t m_culledCount = 0;
+        size_t m_occludedCount = 0;
     };
 }
\ No newline at end of file
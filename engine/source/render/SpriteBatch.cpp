@@ -0,0 +1,398 @@
+#include "render/SpriteBatch.h"
+#include "render/TextureAtlas.h"
+#include "graphics/GraphicsAPI.h"
+#include "graphics/ShaderProgram.h"
+#include "graphics/Texture.h"
+#include "profile/Profiler.h"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+
+namespace eng
+{
+    namespace
+    {
+        const char* SpriteVertexSource = R"(
+            #version 330 core
+            layout (location = 0) in vec2 position;
+            layout (location = 1) in vec2 uv;
+            layout (location = 2) in vec4 color;
+            layout (location = 3) in float layer;
+
+            out vec2 vUV;
+            out vec4 vColor;
+            flat out float vLayer;
+
+            uniform vec2 uViewScale;
+            uniform vec2 uViewOffset;
+
+            void main()
+            {
+                vUV = uv;
+                vColor = color;
+                vLayer = layer;
+                gl_Position = vec4(position * uViewScale + uViewOffset, 0.0, 1.0);
+            }
+        )";
+
+        const char* SpriteFragmentSource2D = R"(
+            #version 330 core
+            out vec4 FragColor;
+
+            in vec2 vUV;
+            in vec4 vColor;
+            flat in float vLayer;
+
+            uniform sampler2D uTexture;
+
+            void main()
+            {
+                FragColor = texture(uTexture, vUV) * vColor;
+            }
+        )";
+
+        const char* SpriteFragmentSourceArray = R"(
+            #version 330 core
+            out vec4 FragColor;
+
+            in vec2 vUV;
+            in vec4 vColor;
+            flat in float vLayer;
+
+            uniform sampler2DArray uTexture;
+
+            void main()
+            {
+                FragColor = texture(uTexture, vec3(vUV, vLayer)) * vColor;
+            }
+        )";
+
+        // Stable counting sort on one 16-bit digit of the key
+        void RadixPass(const std::vector<uint64_t>& source, std::vector<uint64_t>& destination, int shift)
+        {
+            static thread_local std::vector<uint32_t> counts;
+            counts.assign(65536 + 1, 0);
+            for (uint64_t key : source)
+            {
+                ++counts[((key >> shift) & 0xFFFF) + 1];
+            }
+            for (size_t i = 1; i < counts.size(); ++i)
+            {
+                counts[i] += counts[i - 1];
+            }
+            for (uint64_t key : source)
+            {
+                destination[counts[(key >> shift) & 0xFFFF]++] = key;
+            }
+        }
+    }
+
+    void Sprite::SetRegion(const AtlasRegion& region)
+    {
+        uvMin[0] = region.uvOffset[0];
+        uvMin[1] = region.uvOffset[1];
+        uvMax[0] = region.uvOffset[0] + region.uvScale[0];
+        uvMax[1] = region.uvOffset[1] + region.uvScale[1];
+        textureLayer = region.layer;
+    }
+
+    void SpriteBatch::Shutdown()
+    {
+        if (m_VAO)
+        {
+            glDeleteVertexArrays(1, &m_VAO);
+            glDeleteBuffers(1, &m_VBO);
+            glDeleteBuffers(1, &m_EBO);
+        }
+        m_VAO = 0;
+        m_VBO = 0;
+        m_EBO = 0;
+        m_shader2D.reset();
+        m_shaderArray.reset();
+        m_whiteTexture.reset();
+        m_recordingSprites.clear();
+        m_sprites.clear();
+        m_recorded = false;
+        m_initialized = false;
+    }
+
+    void SpriteBatch::Submit(const Sprite& sprite)
+    {
+        m_recordingSprites.push_back(sprite);
+    }
+
+    void SpriteBatch::EndFrame()
+    {
+        m_sprites.clear();
+        m_sprites.swap(m_recordingSprites);
+        std::copy(m_recordingViewScale, m_recordingViewScale + 2, m_viewScale);
+        std::copy(m_recordingViewOffset, m_recordingViewOffset + 2, m_viewOffset);
+        m_recorded = false;
+    }
+
+    void SpriteBatch::Record()
+    {
+        ENG_PROFILE_SCOPE("SpriteBatch::Record");
+        SortSprites();
+        m_recorded = true;
+    }
+
+    void SpriteBatch::SetView(float left, float right, float bottom, float top)
+    {
+        m_recordingViewScale[0] = 2.0f / (right - left);
+        m_recordingViewScale[1] = 2.0f / (top - bottom);
+        m_recordingViewOffset[0] = -(right + left) / (right - left);
+        m_recordingViewOffset[1] = -(top + bottom) / (top - bottom);
+    }
+
+    void SpriteBatch::SetSampler(const SamplerDesc& desc)
+    {
+        m_samplerDesc = desc;
+    }
+
+    size_t SpriteBatch::GetLastDrawCallCount() const
+    {
+        return m_lastDrawCalls;
+    }
+
+    bool SpriteBatch::InitResources(GraphicsAPI& graphicsAPI)
+    {
+        m_shader2D = graphicsAPI.CreateShaderProgram(SpriteVertexSource, SpriteFragmentSource2D);
+        m_shaderArray = graphicsAPI.CreateShaderProgram(SpriteVertexSource, SpriteFragmentSourceArray);
+        if (!m_shader2D || !m_shaderArray)
+        {
+            return false;
+        }
+
+        const uint32_t white = 0xFFFFFFFF;
+        m_whiteTexture = graphicsAPI.CreateTexture(TextureFormat::RGBA8, 1, 1, &white, false);
+
+        // Every quad uses the same 6 indices relative to its first vertex
+        std::vector<uint32_t> indices(size_t(MaxSpritesPerDraw) * 6);
+        for (uint32_t i = 0; i < MaxSpritesPerDraw; ++i)
+        {
+            uint32_t base = i * 4;
+            uint32_t* quad = &indices[size_t(i) * 6];
+            quad[0] = base;
+            quad[1] = base + 1;
+            quad[2] = base + 2;
+            quad[3] = base;
+            quad[4] = base + 2;
+            quad[5] = base + 3;
+        }
+
+        m_vertexCapacity = size_t(MaxSpritesPerDraw) * 4 * 2;
+
+        glGenVertexArrays(1, &m_VAO);
+        glBindVertexArray(m_VAO);
+
+        glGenBuffers(1, &m_VBO);
+        glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+        glBufferData(GL_ARRAY_BUFFER, m_vertexCapacity * sizeof(SpriteVertex), nullptr, GL_STREAM_DRAW);
+
+        const GLsizei stride = sizeof(SpriteVertex);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(SpriteVertex, position));
+        glEnableVertexAttribArray(0);
+        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(SpriteVertex, uv));
+        glEnableVertexAttribArray(1);
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, (void*)offsetof(SpriteVertex, color));
+        glEnableVertexAttribArray(2);
+        glVertexAttribPointer(3, 1, GL_FLOAT, GL_FALSE, stride, (void*)offsetof(SpriteVertex, layer));
+        glEnableVertexAttribArray(3);
+
+        glGenBuffers(1, &m_EBO);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_EBO);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(uint32_t), indices.data(), GL_STATIC_DRAW);
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        m_vertexCursor = 0;
+        m_initialized = true;
+        return true;
+    }
+
+    uint16_t SpriteBatch::GetTextureSlot(Texture* texture)
+    {
+        // Consecutive sprites usually share a texture, skip the map lookup for them
+        if (texture == m_lastTexture && !m_textures.empty())
+        {
+            return m_lastTextureSlot;
+        }
+
+        auto it = m_textureSlots.find(texture);
+        uint16_t slot = 0;
+        if (it != m_textureSlots.end())
+        {
+            slot = it->second;
+        }
+        else
+        {
+            slot = static_cast<uint16_t>(m_textures.size());
+            m_textures.push_back(texture);
+            m_textureSlots.emplace(texture, slot);
+        }
+
+        m_lastTexture = texture;
+        m_lastTextureSlot = slot;
+        return slot;
+    }
+
+    void SpriteBatch::SortSprites()
+    {
+        const size_t count = m_sprites.size();
+        m_keys.resize(count);
+        m_sortScratch.resize(count);
+
+        // draw layer | texture slot | sprite index; the radix passes skip the index so order is stable
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Sprite& sprite = m_sprites[i];
+            uint64_t layer = static_cast<uint16_t>(sprite.drawLayer) ^ 0x8000u;
+            uint64_t slot = GetTextureSlot(sprite.texture);
+            m_keys[i] = (layer << 48) | (slot << 32) | i;
+        }
+
+        RadixPass(m_keys, m_sortScratch, 32);
+        RadixPass(m_sortScratch, m_keys, 48);
+    }
+
+    void SpriteBatch::WriteVertices(const uint64_t* keys, size_t count, SpriteVertex* vertices) const
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Sprite& sprite = m_sprites[static_cast<uint32_t>(keys[i])];
+            const float halfWidth = sprite.size[0] * 0.5f;
+            const float halfHeight = sprite.size[1] * 0.5f;
+            const float layer = static_cast<float>(sprite.textureLayer);
+
+            float axisX[2] = { halfWidth, 0.0f };
+            float axisY[2] = { 0.0f, halfHeight };
+            if (sprite.rotation != 0.0f)
+            {
+                float c = std::cos(sprite.rotation);
+                float s = std::sin(sprite.rotation);
+                axisX[0] = c * halfWidth;
+                axisX[1] = s * halfWidth;
+                axisY[0] = -s * halfHeight;
+                axisY[1] = c * halfHeight;
+            }
+
+            const float x = sprite.position[0];
+            const float y = sprite.position[1];
+            SpriteVertex* quad = vertices + i * 4;
+            quad[0] = { { x + axisX[0] + axisY[0], y + axisX[1] + axisY[1] },
+                { sprite.uvMax[0], sprite.uvMax[1] }, sprite.color, layer };
+            quad[1] = { { x - axisX[0] + axisY[0], y - axisX[1] + axisY[1] },
+                { sprite.uvMin[0], sprite.uvMax[1] }, sprite.color, layer };
+            quad[2] = { { x - axisX[0] - axisY[0], y - axisX[1] - axisY[1] },
+                { sprite.uvMin[0], sprite.uvMin[1] }, sprite.color, layer };
+            quad[3] = { { x + axisX[0] - axisY[0], y + axisX[1] - axisY[1] },
+                { sprite.uvMax[0], sprite.uvMin[1] }, sprite.color, layer };
+        }
+    }
+
+    void SpriteBatch::Draw(GraphicsAPI& graphicsAPI)
+    {
+        ENG_PROFILE_SCOPE("SpriteBatch::Draw");
+        m_lastDrawCalls = 0;
+        if (m_sprites.empty())
+        {
+            return;
+        }
+
+        if (!m_initialized && !InitResources(graphicsAPI))
+        {
+            m_sprites.clear();
+            m_recorded = false;
+            return;
+        }
+
+        if (!m_recorded)
+        {
+            SortSprites();
+        }
+
+        glEnable(GL_BLEND);
+        glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+        glBindVertexArray(m_VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+        RenderStats& stats = graphicsAPI.GetFrameStats();
+        stats.Add(RenderCounter::VertexArrayBinds);
+
+        GLuint sampler = graphicsAPI.GetSampler(m_samplerDesc);
+        ShaderProgram* boundShader = nullptr;
+
+        const size_t count = m_keys.size();
+        size_t begin = 0;
+        while (begin < count)
+        {
+            // A run ends where the draw layer or texture changes, or the index buffer is exhausted
+            const uint64_t group = m_keys[begin] >> 32;
+            size_t end = begin + 1;
+            while (end < count && (m_keys[end] >> 32) == group && end - begin < MaxSpritesPerDraw)
+            {
+                ++end;
+            }
+            const size_t spriteCount = end - begin;
+            const size_t vertexCount = spriteCount * 4;
+
+            if (m_vertexCursor + vertexCount > m_vertexCapacity)
+            {
+                // Orphan the storage so the GPU keeps reading the old copy while we fill a new one
+                glBufferData(GL_ARRAY_BUFFER, m_vertexCapacity * sizeof(SpriteVertex), nullptr, GL_STREAM_DRAW);
+                m_vertexCursor = 0;
+            }
+
+            void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, m_vertexCursor * sizeof(SpriteVertex),
+                vertexCount * sizeof(SpriteVertex),
+                GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+            if (!mapped)
+            {
+                break;
+            }
+            WriteVertices(&m_keys[begin], spriteCount, static_cast<SpriteVertex*>(mapped));
+            glUnmapBuffer(GL_ARRAY_BUFFER);
+
+            Texture* texture = m_textures[(group & 0xFFFF)];
+            if (!texture)
+            {
+                texture = m_whiteTexture.get();
+            }
+            ShaderProgram* shader = texture->GetTarget() == GL_TEXTURE_2D_ARRAY ? m_shaderArray.get() : m_shader2D.get();
+            if (shader != boundShader)
+            {
+                shader->Bind();
+                shader->SetUniform("uViewScale", m_viewScale[0], m_viewScale[1]);
+                shader->SetUniform("uViewOffset", m_viewOffset[0], m_viewOffset[1]);
+                shader->SetUniform("uTexture", 0);
+                boundShader = shader;
+            }
+            graphicsAPI.BindTexture(0, texture);
+            graphicsAPI.BindSampler(0, sampler);
+
+            glDrawElementsBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(spriteCount * 6), GL_UNSIGNED_INT,
+                nullptr, static_cast<GLint>(m_vertexCursor));
+            m_vertexCursor += vertexCount;
+            ++m_lastDrawCalls;
+            stats.Add(RenderCounter::DrawCalls);
+            stats.Add(RenderCounter::Instances);
+            stats.Add(RenderCounter::Triangles, spriteCount * 2);
+            stats.Add(RenderCounter::Sprites, spriteCount);
+            stats.Add(RenderCounter::BytesUploaded, vertexCount * sizeof(SpriteVertex));
+
+            begin = end;
+        }
+
+        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        glDisable(GL_BLEND);
+
+        m_sprites.clear();
+        m_recorded = false;
+        m_textures.clear();
+        m_textureSlots.clear();
+        m_lastTexture = nullptr;
+    }
+}
\ No newline at end of file
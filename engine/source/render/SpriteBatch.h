@@ -0,0 +1,100 @@
+#pragma once
+#include <GL/glew.h>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+#include "graphics/Sampler.h"
+
+namespace eng
+{
+    class GraphicsAPI;
+    class ShaderProgram;
+    class Texture;
+    struct AtlasRegion;
+
+    struct Sprite
+    {
+        // GL_TEXTURE_2D or GL_TEXTURE_2D_ARRAY, null draws a solid color
+        Texture* texture = nullptr;
+        float position[2] = { 0.0f, 0.0f }; // center
+        float size[2] = { 1.0f, 1.0f };
+        float rotation = 0.0f; // radians
+        float uvMin[2] = { 0.0f, 0.0f };
+        float uvMax[2] = { 1.0f, 1.0f };
+        uint32_t color = 0xFFFFFFFF; // RGBA8, red in the lowest byte
+        uint32_t textureLayer = 0; // layer of a texture array
+        int16_t drawLayer = 0; // lower layers are drawn first
+
+        void SetRegion(const AtlasRegion& region);
+    };
+
+    // Collects sprites during the frame and draws them with as few draw calls as possible:
+    // sprites are sorted by draw layer then texture, expanded into a streaming vertex buffer and
+    // every run that shares a texture becomes one indexed draw. Like the render queue it is double
+    // buffered: Submit and SetView record the next frame, EndFrame hands it over to Record and Draw.
+    class SpriteBatch
+    {
+    public:
+        static constexpr uint32_t MaxSpritesPerDraw = 65536;
+
+        SpriteBatch() = default;
+        SpriteBatch(const SpriteBatch&) = delete;
+        SpriteBatch& operator=(const SpriteBatch&) = delete;
+
+        void Submit(const Sprite& sprite);
+        // Main thread, while no frame is being recorded
+        void EndFrame();
+        // Sorts the handed off sprites, CPU only
+        void Record();
+        void Draw(GraphicsAPI& graphicsAPI);
+        // Frees GL resources, must run while the context is still alive
+        void Shutdown();
+
+        // Maps the given world rectangle onto the viewport
+        void SetView(float left, float right, float bottom, float top);
+        void SetSampler(const SamplerDesc& desc);
+
+        size_t GetLastDrawCallCount() const;
+
+    private:
+        struct SpriteVertex
+        {
+            float position[2];
+            float uv[2];
+            uint32_t color;
+            float layer;
+        };
+
+        bool InitResources(GraphicsAPI& graphicsAPI);
+        void SortSprites();
+        uint16_t GetTextureSlot(Texture* texture);
+        void WriteVertices(const uint64_t* keys, size_t count, SpriteVertex* vertices) const;
+
+        std::vector<Sprite> m_recordingSprites;
+        float m_recordingViewScale[2] = { 1.0f, 1.0f };
+        float m_recordingViewOffset[2] = { 0.0f, 0.0f };
+
+        std::vector<Sprite> m_sprites;
+        bool m_recorded = false;
+        std::vector<uint64_t> m_keys;
+        std::vector<uint64_t> m_sortScratch;
+        std::vector<Texture*> m_textures;
+        std::unordered_map<Texture*, uint16_t> m_textureSlots;
+        Texture* m_lastTexture = nullptr;
+        uint16_t m_lastTextureSlot = 0;
+
+        std::shared_ptr<ShaderProgram> m_shader2D;
+        std::shared_ptr<ShaderProgram> m_shaderArray;
+        std::shared_ptr<Texture> m_whiteTexture;
+        SamplerDesc m_samplerDesc;
+        GLuint m_VAO = 0;
+        GLuint m_VBO = 0;
+        GLuint m_EBO = 0;
+        size_t m_vertexCapacity = 0;
+        size_t m_vertexCursor = 0;
+        float m_viewScale[2] = { 1.0f, 1.0f };
+        float m_viewOffset[2] = { 0.0f, 0.0f };
+        size_t m_lastDrawCalls = 0;
+        bool m_initialized = false;
+    };
+}
\ No newline at end of file
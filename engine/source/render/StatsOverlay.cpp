@@ -0,0 +1,156 @@
+#include "render/StatsOverlay.h"
+#include "graphics/GraphicsAPI.h"
+#include <cctype>
+#include <cstdio>
+
+namespace eng
+{
+    namespace
+    {
+        // 3x5 glyphs, rows top to bottom
+        struct Glyph
+        {
+            char character;
+            const char* pixels;
+        };
+
+        const Glyph Glyphs[] =
+        {
+            { '0', "111101101101111" }, { '1', "010110010010111" }, { '2', "111001111100111" },
+            { '3', "111001111001111" }, { '4', "101101111001001" }, { '5', "111100111001111" },
+            { '6', "111100111101111" }, { '7', "111001001001001" }, { '8', "111101111101111" },
+            { '9', "111101111001111" }, { 'A', "010101111101101" }, { 'B', "110101110101110" },
+            { 'C', "011100100100011" }, { 'D', "110101101101110" }, { 'E', "111100110100111" },
+            { 'F', "111100110100100" }, { 'G', "011100101101011" }, { 'H', "101101111101101" },
+            { 'I', "111010010010111" }, { 'J', "001001001101010" }, { 'K', "101101110101101" },
+            { 'L', "100100100100111" }, { 'M', "101111111101101" }, { 'N', "110101101101101" },
+            { 'O', "010101101101010" }, { 'P', "110101110100100" }, { 'Q', "010101101110011" },
+            { 'R', "110101110101101" }, { 'S', "011100010001110" }, { 'T', "111010010010010" },
+            { 'U', "101101101101111" }, { 'V', "101101101101010" }, { 'W', "101101111111101" },
+            { 'X', "101101010101101" }, { 'Y', "101101010010010" }, { 'Z', "111001010100111" },
+            { '.', "000000000000010" }, { ':', "000010000010000" }, { '/', "001001010100100" },
+            { '-', "000000111000000" }, { '_', "000000000000111" }
+        };
+
+        const char* FindGlyph(char character)
+        {
+            const char upper = static_cast<char>(std::toupper(static_cast<unsigned char>(character)));
+            for (const Glyph& glyph : Glyphs)
+            {
+                if (glyph.character == upper)
+                {
+                    return glyph.pixels;
+                }
+            }
+            return nullptr;
+        }
+
+        const uint32_t TextColor = 0xFFFFFFFF;
+        const uint32_t OverBudgetColor = 0xFF4040FF;
+        const uint32_t BackgroundColor = 0xB0000000;
+        const int LabelColumns = 20;
+    }
+
+    void StatsOverlay::SetBudget(RenderCounter counter, uint64_t budget)
+    {
+        const size_t index = static_cast<size_t>(counter);
+        if (index < m_budgets.size())
+        {
+            m_budgets[index] = budget;
+        }
+    }
+
+    uint64_t StatsOverlay::GetBudget(RenderCounter counter) const
+    {
+        const size_t index = static_cast<size_t>(counter);
+        return index < m_budgets.size() ? m_budgets[index] : 0;
+    }
+
+    void StatsOverlay::SetScale(float scale)
+    {
+        m_scale = scale > 0.0f ? scale : 1.0f;
+    }
+
+    void StatsOverlay::Draw(GraphicsAPI& graphicsAPI, const RenderStats& stats, double frameMilliseconds,
+        double gpuMilliseconds, int width, int height)
+    {
+        if (width <= 0 || height <= 0)
+        {
+            return;
+        }
+
+        // Screen pixels, origin in the top left corner
+        m_batch.SetView(0.0f, static_cast<float>(width), static_cast<float>(height), 0.0f);
+
+        const float lineHeight = 7.0f * m_scale;
+        const float margin = 4.0f * m_scale;
+        const size_t lineCount = RenderStats::CounterCount + 2;
+        Sprite background;
+        background.size[0] = (LabelColumns + 12) * 4.0f * m_scale + margin * 2.0f;
+        background.size[1] = lineCount * lineHeight + margin * 2.0f;
+        background.position[0] = background.size[0] * 0.5f;
+        background.position[1] = background.size[1] * 0.5f;
+        background.color = BackgroundColor;
+        background.drawLayer = -1;
+        m_batch.Submit(background);
+
+        const float valueX = margin + LabelColumns * 4.0f * m_scale;
+        char value[32];
+        float y = margin;
+        std::snprintf(value, sizeof(value), "%.2f", frameMilliseconds);
+        DrawText("frame_ms", margin, y, TextColor);
+        DrawText(value, valueX, y, TextColor);
+        y += lineHeight;
+        std::snprintf(value, sizeof(value), "%.2f", gpuMilliseconds);
+        DrawText("gpu_ms", margin, y, TextColor);
+        DrawText(value, valueX, y, TextColor);
+        y += lineHeight;
+
+        for (size_t i = 0; i < RenderStats::CounterCount; ++i)
+        {
+            const RenderCounter counter = static_cast<RenderCounter>(i);
+            const uint64_t count = stats.Get(counter);
+            const uint32_t color = m_budgets[i] != 0 && count > m_budgets[i] ? OverBudgetColor : TextColor;
+            std::snprintf(value, sizeof(value), "%llu", static_cast<unsigned long long>(count));
+            DrawText(RenderStats::GetName(counter), margin, y, color);
+            DrawText(value, valueX, y, color);
+            y += lineHeight;
+        }
+
+        m_batch.EndFrame();
+        m_batch.Record();
+        m_batch.Draw(graphicsAPI);
+    }
+
+    void StatsOverlay::Shutdown()
+    {
+        m_batch.Shutdown();
+    }
+
+    void StatsOverlay::DrawText(const std::string& text, float x, float y, uint32_t color)
+    {
+        Sprite pixel;
+        pixel.size[0] = m_scale;
+        pixel.size[1] = m_scale;
+        pixel.color = color;
+        for (char character : text)
+        {
+            if (const char* glyph = FindGlyph(character))
+            {
+                for (int row = 0; row < 5; ++row)
+                {
+                    for (int column = 0; column < 3; ++column)
+                    {
+                        if (glyph[row * 3 + column] == '1')
+                        {
+                            pixel.position[0] = x + (column + 0.5f) * m_scale;
+                            pixel.position[1] = y + (row + 0.5f) * m_scale;
+                            m_batch.Submit(pixel);
+                        }
+                    }
+                }
+            }
+            x += 4.0f * m_scale;
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,35 @@
+#pragma once
+#include "graphics/RenderStats.h"
+#include "render/SpriteBatch.h"
+#include <array>
+#include <string>
+
+namespace eng
+{
+    class GraphicsAPI;
+
+    // Draws frame times and render counters in the top left corner with a built-in pixel font. Uses a sprite
+    // batch of its own, so the application's view and sprites are not affected. Its own draw calls are
+    // counted in the next frame's stats.
+    class StatsOverlay
+    {
+    public:
+        // Counters above their budget are drawn in red, 0 means no budget
+        void SetBudget(RenderCounter counter, uint64_t budget);
+        uint64_t GetBudget(RenderCounter counter) const;
+        // Size of one font pixel in screen pixels
+        void SetScale(float scale);
+
+        void Draw(GraphicsAPI& graphicsAPI, const RenderStats& stats, double frameMilliseconds,
+            double gpuMilliseconds, int width, int height);
+        void Shutdown();
+
+    private:
+        // x and y are the top left corner of the first character
+        void DrawText(const std::string& text, float x, float y, uint32_t color);
+
+        SpriteBatch m_batch;
+        std::array<uint64_t, RenderStats::CounterCount> m_budgets = {};
+        float m_scale = 2.0f;
+    };
+}
\ No newline at end of file
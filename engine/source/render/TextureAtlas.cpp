@@ -0,0 +1,242 @@
+#include "render/TextureAtlas.h"
+#include "graphics/GraphicsAPI.h"
+#include "Engine.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <numeric>
+
+namespace eng
+{
+    SkylinePacker::SkylinePacker(uint32_t width, uint32_t height) : m_width(width), m_height(height)
+    {
+        m_skyline.push_back({ 0, 0, width });
+    }
+
+    bool SkylinePacker::Fit(size_t index, uint32_t width, uint32_t height, uint32_t& y) const
+    {
+        uint32_t x = m_skyline[index].x;
+        if (x + width > m_width)
+        {
+            return false;
+        }
+
+        // The rectangle rests on the highest segment it spans
+        y = 0;
+        uint32_t remaining = width;
+        for (size_t i = index; remaining > 0; ++i)
+        {
+            if (i >= m_skyline.size())
+            {
+                return false;
+            }
+            y = std::max(y, m_skyline[i].y);
+            if (y + height > m_height)
+            {
+                return false;
+            }
+            remaining -= std::min(remaining, m_skyline[i].width);
+        }
+        return true;
+    }
+
+    bool SkylinePacker::Insert(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y)
+    {
+        size_t bestIndex = SIZE_MAX;
+        uint32_t bestTop = UINT32_MAX;
+        uint32_t bestWidth = UINT32_MAX;
+
+        for (size_t i = 0; i < m_skyline.size(); ++i)
+        {
+            uint32_t fitY = 0;
+            if (!Fit(i, width, height, fitY))
+            {
+                continue;
+            }
+            uint32_t top = fitY + height;
+            if (top < bestTop || (top == bestTop && m_skyline[i].width < bestWidth))
+            {
+                bestIndex = i;
+                bestTop = top;
+                bestWidth = m_skyline[i].width;
+                y = fitY;
+            }
+        }
+
+        if (bestIndex == SIZE_MAX)
+        {
+            return false;
+        }
+
+        x = m_skyline[bestIndex].x;
+        m_skyline.insert(m_skyline.begin() + bestIndex, { x, y + height, width });
+
+        // Trim or drop the segments now covered by the new one
+        for (size_t i = bestIndex + 1; i < m_skyline.size();)
+        {
+            Node& previous = m_skyline[i - 1];
+            Node& node = m_skyline[i];
+            uint32_t previousEnd = previous.x + previous.width;
+            if (node.x >= previousEnd)
+            {
+                break;
+            }
+            uint32_t shrink = previousEnd - node.x;
+            if (shrink >= node.width)
+            {
+                m_skyline.erase(m_skyline.begin() + i);
+                continue;
+            }
+            node.x += shrink;
+            node.width -= shrink;
+            break;
+        }
+
+        for (size_t i = 0; i + 1 < m_skyline.size();)
+        {
+            if (m_skyline[i].y == m_skyline[i + 1].y)
+            {
+                m_skyline[i].width += m_skyline[i + 1].width;
+                m_skyline.erase(m_skyline.begin() + i + 1);
+            }
+            else
+            {
+                ++i;
+            }
+        }
+
+        m_usedArea += uint64_t(width) * height;
+        return true;
+    }
+
+    float SkylinePacker::GetOccupancy() const
+    {
+        return static_cast<float>(double(m_usedArea) / (double(m_width) * m_height));
+    }
+
+    void AtlasRegion::RemapUVs(float* uvs, size_t vertexCount, size_t strideInFloats) const
+    {
+        for (size_t v = 0; v < vertexCount; ++v)
+        {
+            float* uv = uvs + v * strideInFloats;
+            uv[0] = uv[0] * uvScale[0] + uvOffset[0];
+            uv[1] = uv[1] * uvScale[1] + uvOffset[1];
+        }
+    }
+
+    TextureAtlasBuilder::TextureAtlasBuilder(TextureFormat format, uint32_t layerWidth, uint32_t layerHeight,
+        uint32_t padding)
+        : m_format(format), m_layerWidth(layerWidth), m_layerHeight(layerHeight), m_padding(padding)
+    {
+    }
+
+    uint32_t TextureAtlasBuilder::AddImage(uint32_t width, uint32_t height, const void* pixels)
+    {
+        Image image;
+        image.width = width;
+        image.height = height;
+        const auto* source = static_cast<const uint8_t*>(pixels);
+        image.pixels.assign(source, source + size_t(width) * height * GetBytesPerPixel(m_format));
+        m_images.push_back(std::move(image));
+        return static_cast<uint32_t>(m_images.size() - 1);
+    }
+
+    void TextureAtlasBuilder::Blit(const Image& image, const AtlasRegion& region, uint8_t* layer) const
+    {
+        const size_t bytesPerPixel = GetBytesPerPixel(m_format);
+        const size_t layerPitch = size_t(m_layerWidth) * bytesPerPixel;
+        const size_t imagePitch = size_t(image.width) * bytesPerPixel;
+
+        // Padding repeats the edge texels so filtering and lower mips do not pull in neighbours
+        int64_t top = int64_t(region.y) - m_padding;
+        int64_t bottom = int64_t(region.y) + region.height + m_padding;
+        int64_t left = int64_t(region.x) - m_padding;
+        int64_t right = int64_t(region.x) + region.width + m_padding;
+
+        for (int64_t y = std::max<int64_t>(top, 0); y < std::min<int64_t>(bottom, m_layerHeight); ++y)
+        {
+            int64_t sourceY = std::min<int64_t>(std::max<int64_t>(y - region.y, 0), image.height - 1);
+            const uint8_t* sourceRow = image.pixels.data() + sourceY * imagePitch;
+            uint8_t* row = layer + y * layerPitch;
+
+            memcpy(row + region.x * bytesPerPixel, sourceRow, imagePitch);
+            for (int64_t x = std::max<int64_t>(left, 0); x < region.x; ++x)
+            {
+                memcpy(row + x * bytesPerPixel, sourceRow, bytesPerPixel);
+            }
+            for (int64_t x = region.x + region.width; x < std::min<int64_t>(right, m_layerWidth); ++x)
+            {
+                memcpy(row + x * bytesPerPixel, sourceRow + imagePitch - bytesPerPixel, bytesPerPixel);
+            }
+        }
+    }
+
+    std::shared_ptr<Texture> TextureAtlasBuilder::Build(std::vector<AtlasRegion>& regions, bool generateMips)
+    {
+        regions.assign(m_images.size(), AtlasRegion());
+        if (m_images.empty())
+        {
+            return nullptr;
+        }
+
+        // Tallest first keeps the skyline flat
+        std::vector<uint32_t> order(m_images.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(), [this](uint32_t a, uint32_t b)
+        {
+            if (m_images[a].height != m_images[b].height)
+            {
+                return m_images[a].height > m_images[b].height;
+            }
+            return m_images[a].width > m_images[b].width;
+        });
+
+        std::vector<SkylinePacker> layers;
+        for (uint32_t index : order)
+        {
+            const Image& image = m_images[index];
+            uint32_t cellWidth = image.width + m_padding * 2;
+            uint32_t cellHeight = image.height + m_padding * 2;
+            if (image.width == 0 || image.height == 0 || cellWidth > m_layerWidth || cellHeight > m_layerHeight)
+            {
+                std::cerr << "ERROR:ATLAS_IMAGE_TOO_LARGE: " << image.width << "x" << image.height << std::endl;
+                return nullptr;
+            }
+
+            uint32_t x = 0;
+            uint32_t y = 0;
+            size_t layer = 0;
+            while (layer < layers.size() && !layers[layer].Insert(cellWidth, cellHeight, x, y))
+            {
+                ++layer;
+            }
+            if (layer == layers.size())
+            {
+                layers.emplace_back(m_layerWidth, m_layerHeight);
+                layers.back().Insert(cellWidth, cellHeight, x, y);
+            }
+
+            AtlasRegion& region = regions[index];
+            region.layer = static_cast<uint32_t>(layer);
+            region.x = x + m_padding;
+            region.y = y + m_padding;
+            region.width = image.width;
+            region.height = image.height;
+            region.uvOffset[0] = float(region.x) / m_layerWidth;
+            region.uvOffset[1] = float(region.y) / m_layerHeight;
+            region.uvScale[0] = float(region.width) / m_layerWidth;
+            region.uvScale[1] = float(region.height) / m_layerHeight;
+        }
+
+        const size_t layerSize = size_t(m_layerWidth) * m_layerHeight * GetBytesPerPixel(m_format);
+        std::vector<uint8_t> pixels(layerSize * layers.size(), 0);
+        for (size_t i = 0; i < m_images.size(); ++i)
+        {
+            Blit(m_images[i], regions[i], pixels.data() + regions[i].layer * layerSize);
+        }
+
+        auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
+        return graphicsAPI.CreateTextureArray(m_format, m_layerWidth, m_layerHeight,
+            static_cast<uint32_t>(layers.size()), pixels.data(), generateMips);
+    }
+}
\ No newline at end of file
@@ -0,0 +1,77 @@
+#pragma once
+#include "graphics/Texture.h"
+#include <memory>
+#include <vector>
+
+namespace eng
+{
+    // Skyline bottom-left rectangle packer for one fixed size page
+    class SkylinePacker
+    {
+    public:
+        SkylinePacker(uint32_t width, uint32_t height);
+
+        bool Insert(uint32_t width, uint32_t height, uint32_t& x, uint32_t& y);
+        float GetOccupancy() const;
+
+    private:
+        struct Node
+        {
+            uint32_t x = 0;
+            uint32_t y = 0;
+            uint32_t width = 0;
+        };
+
+        bool Fit(size_t index, uint32_t width, uint32_t height, uint32_t& y) const;
+
+        std::vector<Node> m_skyline;
+        uint32_t m_width = 0;
+        uint32_t m_height = 0;
+        uint64_t m_usedArea = 0;
+    };
+
+    // Where an image ended up inside the texture array
+    struct AtlasRegion
+    {
+        uint32_t layer = 0;
+        uint32_t x = 0;
+        uint32_t y = 0;
+        uint32_t width = 0;
+        uint32_t height = 0;
+        // uv' = uv * uvScale + uvOffset maps the image's own 0..1 range into the layer
+        float uvOffset[2] = { 0.0f, 0.0f };
+        float uvScale[2] = { 1.0f, 1.0f };
+
+        void RemapUVs(float* uvs, size_t vertexCount, size_t strideInFloats) const;
+    };
+
+    // Packs many small images into the layers of one GL_TEXTURE_2D_ARRAY so materials that only
+    // differ by texture can share a single texture binding and select the image by layer + UV.
+    class TextureAtlasBuilder
+    {
+    public:
+        TextureAtlasBuilder(TextureFormat format, uint32_t layerWidth, uint32_t layerHeight, uint32_t padding = 2);
+
+        // Pixels are copied, the returned index addresses the region after Build
+        uint32_t AddImage(uint32_t width, uint32_t height, const void* pixels);
+
+        // Returns nullptr if an image is larger than a layer
+        std::shared_ptr<Texture> Build(std::vector<AtlasRegion>& regions, bool generateMips = true);
+
+    private:
+        struct Image
+        {
+            uint32_t width = 0;
+            uint32_t height = 0;
+            std::vector<uint8_t> pixels;
+        };
+
+        void Blit(const Image& image, const AtlasRegion& region, uint8_t* layer) const;
+
+        std::vector<Image> m_images;
+        TextureFormat m_format;
+        uint32_t m_layerWidth;
+        uint32_t m_layerHeight;
+        uint32_t m_padding;
+    };
+}
\ No newline at end of file
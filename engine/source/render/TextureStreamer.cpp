@@ -0,0 +1,397 @@
+#include "render/TextureStreamer.h"
+#include "asset/TextureSource.h"
+#include "graphics/GraphicsAPI.h"
+#include "Engine.h"
+#include "profile/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace eng
+{
+    TextureStreamer::~TextureStreamer()
+    {
+        Shutdown();
+    }
+
+    std::shared_ptr<Texture> TextureStreamer::CreateTexture(const std::shared_ptr<TextureSource>& source)
+    {
+        if (!source || source->GetWidth() == 0 || source->GetHeight() == 0 || source->GetMipLevels() == 0)
+        {
+            return nullptr;
+        }
+
+        if (!m_worker.joinable())
+        {
+            m_stopWorker = false;
+            m_worker = std::thread(&TextureStreamer::WorkerLoop, this);
+        }
+
+        int32_t handle = 0;
+        if (!m_freeEntries.empty())
+        {
+            handle = m_freeEntries.back();
+            m_freeEntries.pop_back();
+        }
+        else
+        {
+            handle = static_cast<int32_t>(m_entries.size());
+            m_entries.emplace_back();
+        }
+
+        Entry& entry = m_entries[handle];
+        uint32_t generation = entry.generation + 1;
+        entry = Entry();
+        entry.generation = generation;
+        entry.alive = true;
+        entry.source = source;
+        entry.mipLevels = source->GetMipLevels();
+
+        // First level whose larger side fits the always resident size
+        entry.minResidentTop = entry.mipLevels - 1;
+        while (entry.minResidentTop > 0
+            && std::max(source->GetWidth(), source->GetHeight()) >> (entry.minResidentTop - 1) <= ResidentMipSize)
+        {
+            --entry.minResidentTop;
+        }
+
+        entry.residentMips.resize(entry.mipLevels - entry.minResidentTop);
+        for (uint32_t level = entry.minResidentTop; level < entry.mipLevels; ++level)
+        {
+            if (!source->ReadMip(level, entry.residentMips[level - entry.minResidentTop]))
+            {
+                entry.alive = false;
+                m_freeEntries.push_back(handle);
+                return nullptr;
+            }
+        }
+
+        uint32_t width = std::max(1u, source->GetWidth() >> entry.minResidentTop);
+        uint32_t height = std::max(1u, source->GetHeight() >> entry.minResidentTop);
+        uint32_t levels = entry.mipLevels - entry.minResidentTop;
+        auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
+        GLuint textureID = graphicsAPI.CreateTextureStorage(source->GetFormat(), width, height, levels);
+        auto texture = std::make_shared<Texture>(textureID, source->GetFormat(), width, height, levels);
+        for (uint32_t level = 0; level < levels; ++level)
+        {
+            texture->Upload(level, entry.residentMips[level].data());
+        }
+
+        texture->SetStreamingHandle(handle);
+        entry.texture = texture;
+        entry.residentTop = entry.minResidentTop;
+        entry.requestedTop = entry.minResidentTop;
+        m_residentBytes += GetResidentSize(entry, entry.residentTop);
+
+        return texture;
+    }
+
+    void TextureStreamer::RequestResolution(Texture* texture, float screenSize)
+    {
+        int32_t handle = texture ? texture->GetStreamingHandle() : -1;
+        if (handle < 0 || handle >= static_cast<int32_t>(m_entries.size()))
+        {
+            return;
+        }
+
+        Entry& entry = m_entries[handle];
+        const TextureSource& source = *entry.source;
+        uint32_t mip = 0;
+        if (screenSize > 0.0f)
+        {
+            // One texel per pixel: every halving of the on-screen size drops one level
+            float texelsPerPixel = std::max(source.GetWidth(), source.GetHeight()) / screenSize;
+            if (texelsPerPixel > 1.0f)
+            {
+                mip = std::min(static_cast<uint32_t>(std::log2(texelsPerPixel)), entry.mipLevels - 1);
+            }
+        }
+
+        if (entry.lastRequestFrame != m_frame)
+        {
+            entry.lastRequestFrame = m_frame;
+            entry.requestedTop = mip;
+        }
+        else
+        {
+            entry.requestedTop = std::min(entry.requestedTop, mip);
+        }
+    }
+
+    void TextureStreamer::Update()
+    {
+        ENG_PROFILE_SCOPE("TextureStreamer::Update");
+        ApplyLoadResults();
+        ReleaseDeadEntries();
+        ScheduleLoads();
+        ++m_frame;
+    }
+
+    void TextureStreamer::Shutdown()
+    {
+        if (m_worker.joinable())
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_stopWorker = true;
+                m_jobs.clear();
+            }
+            m_condition.notify_all();
+            m_worker.join();
+        }
+
+        m_results.clear();
+        m_entries.clear();
+        m_freeEntries.clear();
+        m_residentBytes = 0;
+        m_pendingBytes = 0;
+        m_loadsInFlight = 0;
+    }
+
+    void TextureStreamer::SetMemoryBudget(size_t bytes)
+    {
+        m_memoryBudget = bytes;
+    }
+
+    size_t TextureStreamer::GetMemoryBudget() const
+    {
+        return m_memoryBudget;
+    }
+
+    size_t TextureStreamer::GetResidentBytes() const
+    {
+        return m_residentBytes;
+    }
+
+    void TextureStreamer::WorkerLoop()
+    {
+        while (true)
+        {
+            LoadJob job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_condition.wait(lock, [this]() { return m_stopWorker || !m_jobs.empty(); });
+                if (m_stopWorker)
+                {
+                    return;
+                }
+                job = std::move(m_jobs.front());
+                m_jobs.pop_front();
+            }
+
+            LoadResult result;
+            result.handle = job.handle;
+            result.generation = job.generation;
+            result.topMip = job.topMip;
+            result.success = true;
+            result.mips.resize(job.source->GetMipLevels() - job.topMip);
+            for (uint32_t level = job.topMip; level < job.source->GetMipLevels() && result.success; ++level)
+            {
+                result.success = job.source->ReadMip(level, result.mips[level - job.topMip]);
+            }
+
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_results.push_back(std::move(result));
+        }
+    }
+
+    size_t TextureStreamer::GetResidentSize(const Entry& entry, uint32_t topMip) const
+    {
+        size_t size = 0;
+        for (uint32_t level = topMip; level < entry.mipLevels; ++level)
+        {
+            size += entry.source->GetMipSize(level);
+        }
+        return size;
+    }
+
+    void TextureStreamer::SetResidentMips(Entry& entry, Texture& texture, uint32_t topMip,
+        const std::vector<std::vector<uint8_t>>& mips)
+    {
+        const TextureSource& source = *entry.source;
+        uint32_t width = std::max(1u, source.GetWidth() >> topMip);
+        uint32_t height = std::max(1u, source.GetHeight() >> topMip);
+        uint32_t levels = entry.mipLevels - topMip;
+
+        auto& graphicsAPI = Engine::GetInstance().GetGraphicsAPI();
+        GLuint textureID = graphicsAPI.CreateTextureStorage(source.GetFormat(), width, height, levels);
+        texture.ReplaceStorage(textureID, width, height, levels);
+        for (uint32_t level = 0; level < levels; ++level)
+        {
+            texture.Upload(level, mips[level].data());
+        }
+
+        m_residentBytes -= GetResidentSize(entry, entry.residentTop);
+        m_residentBytes += GetResidentSize(entry, topMip);
+        entry.residentTop = topMip;
+    }
+
+    void TextureStreamer::ApplyLoadResults()
+    {
+        size_t uploadedBytes = 0;
+        while (uploadedBytes < MaxUploadBytesPerFrame)
+        {
+            LoadResult result;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (m_results.empty())
+                {
+                    break;
+                }
+                result = std::move(m_results.front());
+                m_results.pop_front();
+            }
+
+            --m_loadsInFlight;
+            if (result.handle < 0 || result.handle >= static_cast<int32_t>(m_entries.size()))
+            {
+                continue;
+            }
+
+            Entry& entry = m_entries[result.handle];
+            auto texture = entry.texture.lock();
+            if (!entry.alive || entry.generation != result.generation || !texture)
+            {
+                continue;
+            }
+
+            entry.loading = false;
+            m_pendingBytes -= entry.pendingBytes;
+            entry.pendingBytes = 0;
+            if (result.success)
+            {
+                SetResidentMips(entry, *texture, result.topMip, result.mips);
+                uploadedBytes += GetResidentSize(entry, result.topMip);
+            }
+        }
+    }
+
+    void TextureStreamer::ReleaseDeadEntries()
+    {
+        for (size_t i = 0; i < m_entries.size(); ++i)
+        {
+            Entry& entry = m_entries[i];
+            if (entry.alive && entry.texture.expired())
+            {
+                m_residentBytes -= GetResidentSize(entry, entry.residentTop);
+                m_pendingBytes -= entry.pendingBytes;
+                entry.pendingBytes = 0;
+                entry.alive = false;
+                entry.source.reset();
+                entry.residentMips.clear();
+                m_freeEntries.push_back(static_cast<int32_t>(i));
+            }
+        }
+    }
+
+    bool TextureStreamer::EvictLeastRecentlyUsed(size_t requiredBytes, int32_t exclude)
+    {
+        while (m_residentBytes + m_pendingBytes + requiredBytes > m_memoryBudget)
+        {
+            int32_t victim = -1;
+            for (size_t i = 0; i < m_entries.size(); ++i)
+            {
+                const Entry& entry = m_entries[i];
+                if (!entry.alive || entry.loading || static_cast<int32_t>(i) == exclude
+                    || entry.residentTop >= entry.minResidentTop || entry.lastRequestFrame == m_frame)
+                {
+                    continue;
+                }
+                if (victim < 0 || entry.lastRequestFrame < m_entries[victim].lastRequestFrame)
+                {
+                    victim = static_cast<int32_t>(i);
+                }
+            }
+
+            if (victim < 0)
+            {
+                return false;
+            }
+
+            Entry& entry = m_entries[victim];
+            auto texture = entry.texture.lock();
+            if (!texture)
+            {
+                return false;
+            }
+            SetResidentMips(entry, *texture, entry.minResidentTop, entry.residentMips);
+        }
+        return true;
+    }
+
+    void TextureStreamer::ScheduleLoads()
+    {
+        std::vector<int32_t> candidates;
+        for (size_t i = 0; i < m_entries.size(); ++i)
+        {
+            Entry& entry = m_entries[i];
+            if (!entry.alive || entry.loading || entry.lastRequestFrame != m_frame)
+            {
+                continue;
+            }
+            uint32_t desired = std::min(entry.requestedTop, entry.minResidentTop);
+            // Only drop detail once it is two levels finer than needed to avoid thrashing
+            if (desired < entry.residentTop || desired > entry.residentTop + 1)
+            {
+                candidates.push_back(static_cast<int32_t>(i));
+            }
+        }
+
+        // Largest quality gap first
+        std::sort(candidates.begin(), candidates.end(), [this](int32_t a, int32_t b)
+        {
+            const Entry& ea = m_entries[a];
+            const Entry& eb = m_entries[b];
+            return int(ea.residentTop) - int(ea.requestedTop) > int(eb.residentTop) - int(eb.requestedTop);
+        });
+
+        for (int32_t handle : candidates)
+        {
+            if (m_loadsInFlight >= MaxLoadsInFlight)
+            {
+                break;
+            }
+
+            Entry& entry = m_entries[handle];
+            auto texture = entry.texture.lock();
+            if (!texture)
+            {
+                continue;
+            }
+
+            uint32_t desired = std::min(entry.requestedTop, entry.minResidentTop);
+            size_t extra = 0;
+            if (desired < entry.residentTop)
+            {
+                // Settle for a coarser level if the budget cannot be freed for the requested one
+                while (desired < entry.residentTop)
+                {
+                    extra = GetResidentSize(entry, desired) - GetResidentSize(entry, entry.residentTop);
+                    if (EvictLeastRecentlyUsed(extra, handle))
+                    {
+                        break;
+                    }
+                    ++desired;
+                }
+                if (desired >= entry.residentTop)
+                {
+                    continue;
+                }
+            }
+            else if (desired == entry.minResidentTop)
+            {
+                SetResidentMips(entry, *texture, desired, entry.residentMips);
+                continue;
+            }
+
+            entry.loading = true;
+            entry.pendingBytes = extra;
+            m_pendingBytes += extra;
+            ++m_loadsInFlight;
+            {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_jobs.push_back({ handle, entry.generation, desired, entry.source });
+            }
+            m_condition.notify_one();
+        }
+    }
+}
\ No newline at end of file
@@ -0,0 +1,104 @@
+#pragma once
+#include "graphics/Texture.h"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace eng
+{
+    class TextureSource;
+
+    // Keeps the small mips of every streamed texture resident and loads larger ones in the
+    // background based on the on-screen size the render queue requests for visible meshes.
+    // Resident GPU memory stays under a budget by dropping least recently used textures back
+    // to their small mips.
+    class TextureStreamer
+    {
+    public:
+        // Mips at or below this size are loaded synchronously and never evicted
+        static constexpr uint32_t ResidentMipSize = 64;
+        static constexpr size_t MaxLoadsInFlight = 4;
+        static constexpr size_t MaxUploadBytesPerFrame = 16 * 1024 * 1024;
+
+        TextureStreamer() = default;
+        TextureStreamer(const TextureStreamer&) = delete;
+        TextureStreamer& operator=(const TextureStreamer&) = delete;
+        ~TextureStreamer();
+
+        std::shared_ptr<Texture> CreateTexture(const std::shared_ptr<TextureSource>& source);
+
+        // Main thread. screenSize is the on-screen extent in pixels of the full UV range, 0 requests full resolution
+        void RequestResolution(Texture* texture, float screenSize);
+
+        // Main thread, once per frame: uploads finished loads and schedules new ones
+        void Update();
+        void Shutdown();
+
+        void SetMemoryBudget(size_t bytes);
+        size_t GetMemoryBudget() const;
+        size_t GetResidentBytes() const;
+
+    private:
+        struct Entry
+        {
+            std::weak_ptr<Texture> texture;
+            std::shared_ptr<TextureSource> source;
+            // CPU copy of the always resident tail so eviction needs no I/O
+            std::vector<std::vector<uint8_t>> residentMips;
+            uint32_t mipLevels = 0;
+            uint32_t minResidentTop = 0;
+            uint32_t residentTop = 0;
+            uint32_t requestedTop = 0;
+            uint64_t lastRequestFrame = 0;
+            uint32_t generation = 0;
+            // Budget reserved for the load in flight
+            size_t pendingBytes = 0;
+            bool loading = false;
+            bool alive = false;
+        };
+
+        struct LoadJob
+        {
+            int32_t handle = -1;
+            uint32_t generation = 0;
+            uint32_t topMip = 0;
+            std::shared_ptr<TextureSource> source;
+        };
+
+        struct LoadResult
+        {
+            int32_t handle = -1;
+            uint32_t generation = 0;
+            uint32_t topMip = 0;
+            bool success = false;
+            std::vector<std::vector<uint8_t>> mips;
+        };
+
+        void WorkerLoop();
+        void ApplyLoadResults();
+        void ReleaseDeadEntries();
+        void ScheduleLoads();
+        bool EvictLeastRecentlyUsed(size_t requiredBytes, int32_t exclude);
+        void SetResidentMips(Entry& entry, Texture& texture, uint32_t topMip,
+            const std::vector<std::vector<uint8_t>>& mips);
+        size_t GetResidentSize(const Entry& entry, uint32_t topMip) const;
+
+        std::vector<Entry> m_entries;
+        std::vector<int32_t> m_freeEntries;
+        size_t m_memoryBudget = 256 * 1024 * 1024;
+        size_t m_residentBytes = 0;
+        size_t m_pendingBytes = 0;
+        size_t m_loadsInFlight = 0;
+        uint64_t m_frame = 1;
+
+        std::thread m_worker;
+        std::mutex m_mutex;
+        std::condition_variable m_condition;
+        std::deque<LoadJob> m_jobs;
+        std::deque<LoadResult> m_results;
+        bool m_stopWorker = false;
+    };
+}
\ No newline at end of file
@@ -0,0 +1,574 @@
+#include "scene/TransformHierarchy.h"
+#include "profile/Profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace eng
+{
+    namespace
+    {
+        const float Identity[16] =
+        {
+            1.0f, 0.0f, 0.0f, 0.0f,
+            0.0f, 1.0f, 0.0f, 0.0f,
+            0.0f, 0.0f, 1.0f, 0.0f,
+            0.0f, 0.0f, 0.0f, 1.0f
+        };
+
+        void ComposeMatrix(const float* position, const float* rotation, const float* scale, float* m)
+        {
+            const float x = rotation[0];
+            const float y = rotation[1];
+            const float z = rotation[2];
+            const float w = rotation[3];
+
+            m[0] = (1.0f - 2.0f * (y * y + z * z)) * scale[0];
+            m[1] = 2.0f * (x * y + z * w) * scale[0];
+            m[2] = 2.0f * (x * z - y * w) * scale[0];
+            m[3] = 0.0f;
+            m[4] = 2.0f * (x * y - z * w) * scale[1];
+            m[5] = (1.0f - 2.0f * (x * x + z * z)) * scale[1];
+            m[6] = 2.0f * (y * z + x * w) * scale[1];
+            m[7] = 0.0f;
+            m[8] = 2.0f * (x * z + y * w) * scale[2];
+            m[9] = 2.0f * (y * z - x * w) * scale[2];
+            m[10] = (1.0f - 2.0f * (x * x + y * y)) * scale[2];
+            m[11] = 0.0f;
+            m[12] = position[0];
+            m[13] = position[1];
+            m[14] = position[2];
+            m[15] = 1.0f;
+        }
+
+        // Both matrices are affine, so the bottom row is never read
+        void MultiplyAffine(const float* a, const float* b, float* out)
+        {
+            for (int column = 0; column < 4; ++column)
+            {
+                const float* bc = b + column * 4;
+                for (int row = 0; row < 3; ++row)
+                {
+                    out[column * 4 + row] = a[row] * bc[0] + a[4 + row] * bc[1] + a[8 + row] * bc[2]
+                        + (column == 3 ? a[12 + row] : 0.0f);
+                }
+                out[column * 4 + 3] = column == 3 ? 1.0f : 0.0f;
+            }
+        }
+
+        void Lerp(const float* a, const float* b, float t, int count, float* out)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                out[i] = a[i] + (b[i] - a[i]) * t;
+            }
+        }
+
+        // Normalized lerp along the shorter arc, close enough to slerp over one simulation step
+        void Nlerp(const float* a, const float* b, float t, float* out)
+        {
+            const float dot = a[0] * b[0] + a[1] * b[1] + a[2] * b[2] + a[3] * b[3];
+            const float sign = dot < 0.0f ? -1.0f : 1.0f;
+            float lengthSquared = 0.0f;
+            for (int i = 0; i < 4; ++i)
+            {
+                out[i] = a[i] + (b[i] * sign - a[i]) * t;
+                lengthSquared += out[i] * out[i];
+            }
+            const float inverseLength = lengthSquared > 0.0f ? 1.0f / std::sqrt(lengthSquared) : 0.0f;
+            for (int i = 0; i < 4; ++i)
+            {
+                out[i] *= inverseLength;
+            }
+        }
+
+        template <typename T>
+        void Permute(std::vector<T>& values, const std::vector<int32_t>& order, size_t stride)
+        {
+            std::vector<T> permuted(order.size() * stride);
+            for (size_t i = 0; i < order.size(); ++i)
+            {
+                std::copy_n(&values[order[i] * stride], stride, &permuted[i * stride]);
+            }
+            values.swap(permuted);
+        }
+    }
+
+    int32_t TransformHierarchy::Create(int32_t parent)
+    {
+        int32_t parentSlot = NullTransform;
+        if (parent != NullTransform)
+        {
+            parentSlot = GetSlot(parent);
+            if (parentSlot < 0)
+            {
+                return NullTransform;
+            }
+        }
+
+        int32_t transform;
+        if (!m_freeTransforms.empty())
+        {
+            transform = m_freeTransforms.back();
+            m_freeTransforms.pop_back();
+        }
+        else
+        {
+            transform = static_cast<int32_t>(m_slots.size());
+            m_slots.push_back(NullTransform);
+        }
+
+        const int32_t slot = static_cast<int32_t>(m_parents.size());
+        const int32_t depth = parentSlot >= 0 ? m_depths[parentSlot] + 1 : 0;
+        // Appending keeps parents ahead of children, a shallower node only breaks the depth sort
+        if (!m_depths.empty() && depth < m_depths.back())
+        {
+            m_orderDirty = true;
+        }
+
+        m_positions.insert(m_positions.end(), { 0.0f, 0.0f, 0.0f });
+        m_rotations.insert(m_rotations.end(), { 0.0f, 0.0f, 0.0f, 1.0f });
+        m_scales.insert(m_scales.end(), { 1.0f, 1.0f, 1.0f });
+        m_localMatrices.insert(m_localMatrices.end(), Identity, Identity + 16);
+        m_worldMatrices.insert(m_worldMatrices.end(), Identity, Identity + 16);
+        m_previousPositions.insert(m_previousPositions.end(), { 0.0f, 0.0f, 0.0f });
+        m_previousRotations.insert(m_previousRotations.end(), { 0.0f, 0.0f, 0.0f, 1.0f });
+        m_previousScales.insert(m_previousScales.end(), { 1.0f, 1.0f, 1.0f });
+        m_interpolatedMatrices.insert(m_interpolatedMatrices.end(), Identity, Identity + 16);
+        m_parents.push_back(parentSlot);
+        m_depths.push_back(depth);
+        m_transforms.push_back(transform);
+        m_flags.push_back(Snapped);
+        m_slots[transform] = slot;
+        MarkDirty(slot);
+        ++m_count;
+        return transform;
+    }
+
+    void TransformHierarchy::Destroy(int32_t transform)
+    {
+        int32_t slot = GetSlot(transform);
+        if (slot < 0)
+        {
+            return;
+        }
+        m_flags[slot] |= Destroyed;
+        m_slots[transform] = NullTransform;
+        m_freeTransforms.push_back(transform);
+        m_orderDirty = true;
+        --m_count;
+    }
+
+    bool TransformHierarchy::SetParent(int32_t transform, int32_t parent)
+    {
+        int32_t slot = GetSlot(transform);
+        if (slot < 0)
+        {
+            return false;
+        }
+
+        int32_t parentSlot = NullTransform;
+        if (parent != NullTransform)
+        {
+            parentSlot = GetSlot(parent);
+            if (parentSlot < 0)
+            {
+                return false;
+            }
+            for (int32_t ancestor = parentSlot; ancestor >= 0; ancestor = m_parents[ancestor])
+            {
+                if (ancestor == slot)
+                {
+                    return false;
+                }
+            }
+        }
+
+        if (m_parents[slot] != parentSlot)
+        {
+            m_parents[slot] = parentSlot;
+            m_orderDirty = true;
+            MarkDirty(slot);
+        }
+        return true;
+    }
+
+    int32_t TransformHierarchy::GetParent(int32_t transform) const
+    {
+        int32_t slot = GetSlot(transform);
+        if (slot < 0 || m_parents[slot] < 0)
+        {
+            return NullTransform;
+        }
+        return m_transforms[m_parents[slot]];
+    }
+
+    void TransformHierarchy::SetLocalPosition(int32_t transform, float x, float y, float z)
+    {
+        int32_t slot = GetSlot(transform);
+        if (slot >= 0)
+        {
+            float* position = &m_positions[slot * 3];
+            position[0] = x;
+            position[1] = y;
+            position[2] = z;
+            MarkDirty(slot);
+        }
+    }
+
+    void TransformHierarchy::SetLocalRotation(int32_t transform, float x, float y, float z, float w)
+    {
+        int32_t slot = GetSlot(transform);
+        if (slot >= 0)
+        {
+            float* rotation = &m_rotations[slot * 4];
+            rotation[0] = x;
+            rotation[1] = y;
+            rotation[2] = z;
+            rotation[3] = w;
+            MarkDirty(slot);
+        }
+    }
+
+    void TransformHierarchy::SetLocalScale(int32_t transform, float x, float y, float z)
+    {
+        int32_t slot = GetSlot(transform);
+        if (slot >= 0)
+        {
+            float* scale = &m_scales[slot * 3];
+            scale[0] = x;
+            scale[1] = y;
+            scale[2] = z;
+            MarkDirty(slot);
+        }
+    }
+
+    const float* TransformHierarchy::GetLocalPosition(int32_t transform) const
+    {
+        int32_t slot = GetSlot(transform);
+        return slot >= 0 ? &m_positions[slot * 3] : nullptr;
+    }
+
+    const float* TransformHierarchy::GetLocalRotation(int32_t transform) const
+    {
+        int32_t slot = GetSlot(transform);
+        return slot >= 0 ? &m_rotations[slot * 4] : nullptr;
+    }
+
+    const float* TransformHierarchy::GetLocalScale(int32_t transform) const
+    {
+        int32_t slot = GetSlot(transform);
+        return slot >= 0 ? &m_scales[slot * 3] : nullptr;
+    }
+
+    void TransformHierarchy::Update()
+    {
+        ENG_PROFILE_SCOPE("TransformHierarchy::Update");
+        for (int32_t transform : m_changed)
+        {
+            int32_t slot = GetSlot(transform);
+            if (slot >= 0)
+            {
+                m_flags[slot] &= ~WorldChanged;
+            }
+        }
+        m_changed.clear();
+
+        if (m_orderDirty)
+        {
+            Reorder();
+        }
+        if (!m_hasDirty)
+        {
+            return;
+        }
+
+        // Everything ahead of the first dirty slot is unaffected, parents always precede their children
+        const size_t count = m_parents.size();
+        for (size_t slot = m_firstDirty; slot < count; ++slot)
+        {
+            const uint8_t flags = m_flags[slot];
+            const int32_t parent = m_parents[slot];
+            const bool parentChanged = parent >= 0 && (m_flags[parent] & WorldChanged);
+            if (!(flags & LocalDirty) && !parentChanged)
+            {
+                continue;
+            }
+
+            float* local = &m_localMatrices[slot * 16];
+            if (flags & LocalDirty)
+            {
+                ComposeMatrix(&m_positions[slot * 3], &m_rotations[slot * 4], &m_scales[slot * 3], local);
+            }
+
+            float* world = &m_worldMatrices[slot * 16];
+            if (parent >= 0)
+            {
+                MultiplyAffine(&m_worldMatrices[parent * 16], local, world);
+            }
+            else
+            {
+                std::copy_n(local, 16, world);
+            }
+
+            m_flags[slot] = static_cast<uint8_t>((flags & ~LocalDirty) | WorldChanged);
+            m_changed.push_back(m_transforms[slot]);
+        }
+
+        m_hasDirty = false;
+        m_firstDirty = count;
+    }
+
+    const float* TransformHierarchy::GetLocalMatrix(int32_t transform) const
+    {
+        int32_t slot = GetSlot(transform);
+        return slot >= 0 ? &m_localMatrices[slot * 16] : nullptr;
+    }
+
+    const float* TransformHierarchy::GetWorldMatrix(int32_t transform) const
+    {
+        int32_t slot = GetSlot(transform);
+        return slot >= 0 ? &m_worldMatrices[slot * 16] : nullptr;
+    }
+
+    const std::vector<int32_t>& TransformHierarchy::GetChangedTransforms() const
+    {
+        return m_changed;
+    }
+
+    size_t TransformHierarchy::GetCount() const
+    {
+        return m_count;
+    }
+
+    void TransformHierarchy::BeginStep()
+    {
+        for (int32_t transform : m_moved)
+        {
+            int32_t slot = GetSlot(transform);
+            if (slot < 0)
+            {
+                continue;
+            }
+            std::copy_n(&m_positions[slot * 3], 3, &m_previousPositions[slot * 3]);
+            std::copy_n(&m_rotations[slot * 4], 4, &m_previousRotations[slot * 4]);
+            std::copy_n(&m_scales[slot * 3], 3, &m_previousScales[slot * 3]);
+            if (!(m_flags[slot] & Settling))
+            {
+                m_settling.push_back(transform);
+            }
+            m_flags[slot] = static_cast<uint8_t>((m_flags[slot] & ~(Moved | Snapped)) | Settling);
+        }
+        m_moved.clear();
+    }
+
+    void TransformHierarchy::Snap(int32_t transform)
+    {
+        int32_t slot = GetSlot(transform);
+        if (slot >= 0)
+        {
+            m_flags[slot] |= Snapped;
+            MarkDirty(slot);
+        }
+    }
+
+    void TransformHierarchy::Interpolate(float alpha)
+    {
+        ENG_PROFILE_SCOPE("TransformHierarchy::Interpolate");
+        for (int32_t transform : m_interpolated)
+        {
+            int32_t slot = GetSlot(transform);
+            if (slot >= 0)
+            {
+                m_flags[slot] &= ~InterpolatedChanged;
+            }
+        }
+        m_interpolated.clear();
+
+        // Parents precede their children, so the walk starts at the first moving or settling node
+        const size_t count = m_parents.size();
+        size_t first = count;
+        for (const std::vector<int32_t>* list : { &m_moved, &m_settling })
+        {
+            for (int32_t transform : *list)
+            {
+                int32_t slot = GetSlot(transform);
+                if (slot >= 0)
+                {
+                    first = std::min(first, static_cast<size_t>(slot));
+                }
+            }
+        }
+        m_settling.clear();
+
+        alpha = std::min(std::max(alpha, 0.0f), 1.0f);
+        float local[16];
+        for (size_t slot = first; slot < count; ++slot)
+        {
+            const uint8_t flags = m_flags[slot];
+            const int32_t parent = m_parents[slot];
+            const bool parentChanged = parent >= 0 && (m_flags[parent] & InterpolatedChanged);
+            if (!(flags & (Moved | Settling)) && !parentChanged)
+            {
+                continue;
+            }
+
+            const float* source = &m_localMatrices[slot * 16];
+            if ((flags & Moved) && !(flags & Snapped))
+            {
+                float position[3];
+                float rotation[4];
+                float scale[3];
+                Lerp(&m_previousPositions[slot * 3], &m_positions[slot * 3], alpha, 3, position);
+                Nlerp(&m_previousRotations[slot * 4], &m_rotations[slot * 4], alpha, rotation);
+                Lerp(&m_previousScales[slot * 3], &m_scales[slot * 3], alpha, 3, scale);
+                ComposeMatrix(position, rotation, scale, local);
+                source = local;
+            }
+
+            float* world = &m_interpolatedMatrices[slot * 16];
+            if (parent >= 0)
+            {
+                MultiplyAffine(&m_interpolatedMatrices[parent * 16], source, world);
+            }
+            else
+            {
+                std::copy_n(source, 16, world);
+            }
+
+            m_flags[slot] = static_cast<uint8_t>((flags & ~Settling) | InterpolatedChanged);
+            m_interpolated.push_back(m_transforms[slot]);
+        }
+    }
+
+    const float* TransformHierarchy::GetInterpolatedWorldMatrix(int32_t transform) const
+    {
+        int32_t slot = GetSlot(transform);
+        return slot >= 0 ? &m_interpolatedMatrices[slot * 16] : nullptr;
+    }
+
+    const std::vector<int32_t>& TransformHierarchy::GetInterpolatedTransforms() const
+    {
+        return m_interpolated;
+    }
+
+    int32_t TransformHierarchy::GetSlot(int32_t transform) const
+    {
+        if (transform < 0 || static_cast<size_t>(transform) >= m_slots.size())
+        {
+            return NullTransform;
+        }
+        return m_slots[transform];
+    }
+
+    void TransformHierarchy::MarkDirty(int32_t slot)
+    {
+        if (!(m_flags[slot] & Moved))
+        {
+            m_moved.push_back(m_transforms[slot]);
+        }
+        m_flags[slot] |= LocalDirty | Moved;
+        if (!m_hasDirty || static_cast<size_t>(slot) < m_firstDirty)
+        {
+            m_firstDirty = static_cast<size_t>(slot);
+        }
+        m_hasDirty = true;
+    }
+
+    void TransformHierarchy::Reorder()
+    {
+        const size_t count = m_parents.size();
+
+        // Depths from the parent links, which SetParent may have pointed at later slots. Walking up until
+        // a known depth also tells whether an ancestor was destroyed.
+        std::vector<int32_t> depths(count, -1);
+        std::vector<int32_t> path;
+        int32_t maxDepth = 0;
+        for (size_t slot = 0; slot < count; ++slot)
+        {
+            int32_t current = static_cast<int32_t>(slot);
+            while (current >= 0 && depths[current] < 0)
+            {
+                path.push_back(current);
+                current = m_parents[current];
+            }
+
+            int32_t depth = current >= 0 ? depths[current] : -1;
+            bool destroyed = current >= 0 && (m_flags[current] & Destroyed);
+            while (!path.empty())
+            {
+                int32_t node = path.back();
+                path.pop_back();
+                depths[node] = ++depth;
+                if (m_flags[node] & Destroyed)
+                {
+                    destroyed = true;
+                }
+                else if (destroyed)
+                {
+                    m_flags[node] |= Destroyed;
+                    m_slots[m_transforms[node]] = NullTransform;
+                    m_freeTransforms.push_back(m_transforms[node]);
+                    --m_count;
+                }
+            }
+            maxDepth = std::max(maxDepth, depths[slot]);
+        }
+
+        // Stable counting sort by depth, destroyed slots are dropped
+        std::vector<int32_t> offsets(static_cast<size_t>(maxDepth) + 2, 0);
+        for (size_t slot = 0; slot < count; ++slot)
+        {
+            if (!(m_flags[slot] & Destroyed))
+            {
+                ++offsets[depths[slot] + 1];
+            }
+        }
+        for (size_t depth = 1; depth < offsets.size(); ++depth)
+        {
+            offsets[depth] += offsets[depth - 1];
+        }
+
+        std::vector<int32_t> order(offsets.back());
+        std::vector<int32_t> newSlots(count, NullTransform);
+        for (size_t slot = 0; slot < count; ++slot)
+        {
+            if (!(m_flags[slot] & Destroyed))
+            {
+                int32_t newSlot = offsets[depths[slot]]++;
+                order[newSlot] = static_cast<int32_t>(slot);
+                newSlots[slot] = newSlot;
+            }
+        }
+
+        Permute(m_positions, order, 3);
+        Permute(m_rotations, order, 4);
+        Permute(m_scales, order, 3);
+        Permute(m_localMatrices, order, 16);
+        Permute(m_worldMatrices, order, 16);
+        Permute(m_previousPositions, order, 3);
+        Permute(m_previousRotations, order, 4);
+        Permute(m_previousScales, order, 3);
+        Permute(m_interpolatedMatrices, order, 16);
+        Permute(m_transforms, order, 1);
+        Permute(m_flags, order, 1);
+
+        std::vector<int32_t> parents(order.size());
+        m_depths.resize(order.size());
+        m_hasDirty = false;
+        m_firstDirty = order.size();
+        for (size_t slot = 0; slot < order.size(); ++slot)
+        {
+            int32_t oldParent = m_parents[order[slot]];
+            parents[slot] = oldParent >= 0 ? newSlots[oldParent] : NullTransform;
+            m_depths[slot] = depths[order[slot]];
+            m_slots[m_transforms[slot]] = static_cast<int32_t>(slot);
+            if ((m_flags[slot] & LocalDirty) && !m_hasDirty)
+            {
+                m_firstDirty = slot;
+                m_hasDirty = true;
+            }
+        }
+        m_parents.swap(parents);
+        m_orderDirty = false;
+    }
+}
\ No newline at end of file
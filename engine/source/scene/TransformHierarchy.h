@@ -0,0 +1,105 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <vector>
+
+namespace eng
+{
+    // Scene graph transforms stored as structure-of-arrays. Slots are kept sorted by depth so Update walks
+    // the arrays once with every parent ahead of its children. Only nodes whose local transform changed, and
+    // their descendants, are recomputed; a frame without changes returns immediately.
+    //
+    // For fixed step simulation, BeginStep keeps the local transforms a step starts from and Interpolate
+    // blends towards the current ones for rendering. Both only visit nodes that moved and their descendants.
+    class TransformHierarchy
+    {
+    public:
+        static constexpr int32_t NullTransform = -1;
+
+        int32_t Create(int32_t parent = NullTransform);
+        // Removes the node and its whole subtree, descendants are released on the next Update
+        void Destroy(int32_t transform);
+        // Fails when the new parent is the node itself or one of its descendants
+        bool SetParent(int32_t transform, int32_t parent);
+        int32_t GetParent(int32_t transform) const;
+
+        void SetLocalPosition(int32_t transform, float x, float y, float z);
+        // Unit quaternion (x, y, z, w)
+        void SetLocalRotation(int32_t transform, float x, float y, float z, float w);
+        void SetLocalScale(int32_t transform, float x, float y, float z);
+        const float* GetLocalPosition(int32_t transform) const;
+        const float* GetLocalRotation(int32_t transform) const;
+        const float* GetLocalScale(int32_t transform) const;
+
+        // Recomputes the world matrices of moved nodes and their descendants
+        void Update();
+
+        // Column-major 4x4 matrices, as of the last Update. Pointers stay valid until the next Update that
+        // follows a Create, Destroy or SetParent.
+        const float* GetLocalMatrix(int32_t transform) const;
+        const float* GetWorldMatrix(int32_t transform) const;
+        // Nodes whose world matrix was rewritten by the last Update, e.g. to refresh instance buffers
+        const std::vector<int32_t>& GetChangedTransforms() const;
+        size_t GetCount() const;
+
+        // Call before each simulation step, what the step changes is interpolated from the current state
+        void BeginStep();
+        // Renders this node at its current transform until the next step, for spawns and teleports. Created
+        // nodes start out this way.
+        void Snap(int32_t transform);
+        // World matrices between the state at the last BeginStep (alpha 0) and the current one (alpha 1).
+        // Call after Update.
+        void Interpolate(float alpha);
+        const float* GetInterpolatedWorldMatrix(int32_t transform) const;
+        // Nodes whose interpolated matrix was rewritten by the last Interpolate
+        const std::vector<int32_t>& GetInterpolatedTransforms() const;
+
+    private:
+        enum Flags : uint8_t
+        {
+            LocalDirty = 1,
+            WorldChanged = 2,
+            Destroyed = 4,
+            // Local transform changed since the last BeginStep
+            Moved = 8,
+            // Moved during the previous step, its interpolated matrix still has to reach the current one
+            Settling = 16,
+            Snapped = 32,
+            InterpolatedChanged = 64
+        };
+
+        int32_t GetSlot(int32_t transform) const;
+        void MarkDirty(int32_t slot);
+        // Restores the depth order after structural changes and drops destroyed subtrees
+        void Reorder();
+
+        // Indexed by slot
+        std::vector<float> m_positions;
+        std::vector<float> m_rotations;
+        std::vector<float> m_scales;
+        std::vector<float> m_localMatrices;
+        std::vector<float> m_worldMatrices;
+        std::vector<float> m_previousPositions;
+        std::vector<float> m_previousRotations;
+        std::vector<float> m_previousScales;
+        std::vector<float> m_interpolatedMatrices;
+        std::vector<int32_t> m_parents;
+        std::vector<int32_t> m_depths;
+        std::vector<int32_t> m_transforms;
+        std::vector<uint8_t> m_flags;
+
+        // Indexed by transform handle
+        std::vector<int32_t> m_slots;
+        std::vector<int32_t> m_freeTransforms;
+
+        std::vector<int32_t> m_changed;
+        // Transform handles, by the flag that put them there
+        std::vector<int32_t> m_moved;
+        std::vector<int32_t> m_settling;
+        std::vector<int32_t> m_interpolated;
+        size_t m_firstDirty = 0;
+        bool m_hasDirty = false;
+        bool m_orderDirty = false;
+        size_t m_count = 0;
+    };
+}
\ No newline at end of file
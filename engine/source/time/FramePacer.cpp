@@ -0,0 +1,112 @@
+#include "time/FramePacer.h"
+#include <algorithm>
+#include <thread>
+
+namespace eng
+{
+    namespace
+    {
+        const FramePacer::Clock::duration MinSpinMargin = std::chrono::microseconds(200);
+        const FramePacer::Clock::duration MaxSpinMargin = std::chrono::microseconds(4000);
+    }
+
+    void FramePacer::SetTargetFrameRate(double framesPerSecond)
+    {
+        m_targetFrameRate = framesPerSecond > 0.0 ? framesPerSecond : 0.0;
+        m_period = m_targetFrameRate > 0.0
+            ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / m_targetFrameRate))
+            : Clock::duration::zero();
+        m_scheduled = false;
+    }
+
+    double FramePacer::GetTargetFrameRate() const
+    {
+        return m_targetFrameRate;
+    }
+
+    void FramePacer::SetWaitMode(FrameWaitMode mode)
+    {
+        m_waitMode = mode;
+    }
+
+    FrameWaitMode FramePacer::GetWaitMode() const
+    {
+        return m_waitMode;
+    }
+
+    void FramePacer::Wait()
+    {
+        m_lastSleepTime = 0.0;
+        m_lastSpinTime = 0.0;
+
+        Clock::time_point now = Clock::now();
+        if (m_targetFrameRate > 0.0)
+        {
+            if (!m_scheduled || now - m_deadline > m_period)
+            {
+                m_deadline = now;
+                m_scheduled = true;
+            }
+            m_deadline += m_period;
+
+            if (m_waitMode != FrameWaitMode::Spin)
+            {
+                const Clock::time_point sleepStart = Clock::now();
+                SleepUntil(m_waitMode == FrameWaitMode::Sleep ? m_deadline : m_deadline - m_spinMargin);
+                m_lastSleepTime = std::chrono::duration<double>(Clock::now() - sleepStart).count();
+            }
+            if (m_waitMode != FrameWaitMode::Sleep)
+            {
+                const Clock::time_point spinStart = Clock::now();
+                while (Clock::now() < m_deadline)
+                {
+                    std::this_thread::yield();
+                }
+                m_lastSpinTime = std::chrono::duration<double>(Clock::now() - spinStart).count();
+            }
+            now = Clock::now();
+        }
+
+        if (m_lastFrame != Clock::time_point())
+        {
+            m_lastFrameTime = std::chrono::duration<double>(now - m_lastFrame).count();
+        }
+        m_lastFrame = now;
+    }
+
+    void FramePacer::Reset()
+    {
+        m_scheduled = false;
+        m_lastFrame = Clock::time_point();
+    }
+
+    double FramePacer::GetLastFrameTime() const
+    {
+        return m_lastFrameTime;
+    }
+
+    double FramePacer::GetLastSleepTime() const
+    {
+        return m_lastSleepTime;
+    }
+
+    double FramePacer::GetLastSpinTime() const
+    {
+        return m_lastSpinTime;
+    }
+
+    void FramePacer::SleepUntil(Clock::time_point deadline)
+    {
+        const Clock::time_point start = Clock::now();
+        if (deadline <= start)
+        {
+            return;
+        }
+        std::this_thread::sleep_until(deadline);
+
+        // Oversleep raises the margin right away, the margin then shrinks slowly while sleeps are punctual
+        const Clock::duration late = Clock::now() - deadline;
+        m_spinMargin = std::max(m_spinMargin - m_spinMargin / 64, late + late / 4);
+        m_spinMargin = std::min(std::max(m_spinMargin, MinSpinMargin), MaxSpinMargin);
+    }
+}
\ No newline at end of file
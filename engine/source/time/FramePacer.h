@@ -0,0 +1,56 @@
+#pragma once
+#include <chrono>
+
+namespace eng
+{
+    enum class FrameWaitMode
+    {
+        // Sleeps until shortly before the deadline and spins the rest, the margin follows how late sleeps wake
+        Hybrid,
+        // Cheapest, frame times jitter by the scheduler's wake-up latency
+        Sleep,
+        // Most precise, keeps a core busy
+        Spin
+    };
+
+    // Holds frames to a target rate. Deadlines advance by exactly one period, so a frame that finishes early
+    // does not shift the ones after it; one that misses by more than a period starts a new schedule instead
+    // of rushing to catch up.
+    class FramePacer
+    {
+    public:
+        using Clock = std::chrono::steady_clock;
+
+        // 0 disables limiting
+        void SetTargetFrameRate(double framesPerSecond);
+        double GetTargetFrameRate() const;
+        void SetWaitMode(FrameWaitMode mode);
+        FrameWaitMode GetWaitMode() const;
+
+        // Once per frame after present, returns when the next frame should start
+        void Wait();
+        // Forgets the schedule, e.g. after the loop sat idle
+        void Reset();
+
+        // Seconds between the last two returns from Wait
+        double GetLastFrameTime() const;
+        // Seconds Wait spent sleeping and spinning in the last frame
+        double GetLastSleepTime() const;
+        double GetLastSpinTime() const;
+
+    private:
+        void SleepUntil(Clock::time_point deadline);
+
+        double m_targetFrameRate = 0.0;
+        FrameWaitMode m_waitMode = FrameWaitMode::Hybrid;
+        Clock::duration m_period{};
+        Clock::time_point m_deadline;
+        Clock::time_point m_lastFrame;
+        bool m_scheduled = false;
+        // How long before the deadline to stop sleeping, tracks the worst recent oversleep
+        Clock::duration m_spinMargin = std::chrono::microseconds(1000);
+        double m_lastFrameTime = 0.0;
+        double m_lastSleepTime = 0.0;
+        double m_lastSpinTime = 0.0;
+    };
+}
\ No newline at end of file
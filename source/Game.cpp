@@ -1,5 +1,6 @@
 #include "Game.h"
 #include <GLFW/glfw3.h>
+#include <cmath>
 #include <iostream>
 
 bool Game::Init()
@@ -8,15 +9,14 @@ bool Game::Init()
         #version 330 core
         layout (location = 0) in vec3 position;
         layout (location = 1) in vec3 color;
+        layout (location = 4) in mat4 instanceTransform;
 
         out vec3 vColor;
 
-        uniform vec2 uOffset;
-
         void main()
         {
             vColor = color;
-            gl_Position = vec4(position.x + uOffset.x, position.y + uOffset.y, position.z, 1.0);
+            gl_Position = instanceTransform * vec4(position, 1.0);
         }
     )";
 
@@ -32,6 +32,10 @@ bool Game::Init()
         }
     )";
 
+    // Update only touches the ECS, transforms and submissions, so it can run alongside the previous frame's draw
+    eng::Engine::GetInstance().SetFramePipelining(true);
+    eng::Engine::GetInstance().SetFixedTimestep(1.0f / 60.0f);
+
     auto& graphicsAPI = eng::Engine::GetInstance().GetGraphicsAPI();
     auto shaderProgram = graphicsAPI.CreateShaderProgram(vertexShaderSource, fragmentShaderSource);
     m_material.SetShaderProgram(shaderProgram);
@@ -69,43 +73,110 @@ bool Game::Init()
     vertexLayout.stride = sizeof(float) * 6; 
 
     m_mesh = std::make_unique<eng::Mesh>(vertexLayout, vertices, indices);
+    m_instances = std::make_unique<eng::GpuInstanceBatch>(m_mesh.get(), &m_material);
+
+    // A quad with two smaller quads orbiting it, one of which carries its own moon
+    m_root = m_transforms.Create();
+    m_transforms.SetLocalScale(m_root, 0.5f, 0.5f, 1.0f);
+    int32_t orbiters[2];
+    for (int i = 0; i < 2; ++i)
+    {
+        orbiters[i] = m_transforms.Create(m_root);
+        m_transforms.SetLocalPosition(orbiters[i], i == 0 ? 1.5f : -1.5f, 0.0f, 0.0f);
+        m_transforms.SetLocalScale(orbiters[i], 0.4f, 0.4f, 1.0f);
+    }
+    int32_t moon = m_transforms.Create(orbiters[0]);
+    m_transforms.SetLocalPosition(moon, 0.0f, 1.5f, 0.0f);
+    m_transforms.SetLocalScale(moon, 0.5f, 0.5f, 1.0f);
+
+    m_world.CreateEntity(Spin{ m_root, 1.0f, 0.0f });
+    eng::Entity orbiter = m_world.CreateEntity(Spin{ orbiters[0], 2.0f, 0.0f });
+    m_spinning = &m_world.CreateQuery<Spin>();
+    eng::Engine::GetInstance().GetTaskScheduler().Spawn(ReverseSpin(orbiter, 3.0f));
+
+    m_transforms.Update();
+    for (int32_t transform : m_transforms.GetChangedTransforms())
+    {
+        if (static_cast<size_t>(transform) >= m_instanceOfTransform.size())
+        {
+            m_instanceOfTransform.resize(transform + 1);
+        }
+        m_instanceOfTransform[transform] = m_instances->Add(m_transforms.GetWorldMatrix(transform));
+    }
 
     return true;
 }
 
-void Game::Update(float deltaTime)
+void Game::FixedUpdate(float fixedDeltaTime)
 {
+    // World units per second
+    const float moveSpeed = 0.5f;
+
+    m_transforms.BeginStep();
+
     auto& input = eng::Engine::GetInstance().GetInputManager();
     // Horizontal movement
-    if (input.IsKeyPressed(GLFW_KEY_A))
+    if (input.IsKeyDown(GLFW_KEY_A))
     {
-        m_offsetX -= 0.001f;
+        m_offsetX -= moveSpeed * fixedDeltaTime;
     }
-    else if (input.IsKeyPressed(GLFW_KEY_D))
+    else if (input.IsKeyDown(GLFW_KEY_D))
     {
-        m_offsetX += 0.001f;
+        m_offsetX += moveSpeed * fixedDeltaTime;
     }
     // Vertical movement
-    if (input.IsKeyPressed(GLFW_KEY_W))
+    if (input.IsKeyDown(GLFW_KEY_W))
     {
-        m_offsetY += 0.001f;
+        m_offsetY += moveSpeed * fixedDeltaTime;
     }
-    else if (input.IsKeyPressed(GLFW_KEY_S))
+    else if (input.IsKeyDown(GLFW_KEY_S))
     {
-        m_offsetY -= 0.001f;
+        m_offsetY -= moveSpeed * fixedDeltaTime;
     }
 
-    m_material.SetParam("uOffset", m_offsetX, m_offsetY);
+    m_transforms.SetLocalPosition(m_root, m_offsetX, m_offsetY, 0.0f);
+    m_spinning->ForEach<Spin>([this, fixedDeltaTime](Spin& spin)
+    {
+        spin.angle += spin.speed * fixedDeltaTime;
+        m_transforms.SetLocalRotation(spin.transform, 0.0f, 0.0f, std::sin(spin.angle * 0.5f),
+            std::cos(spin.angle * 0.5f));
+    });
+    m_transforms.Update();
+}
 
-    eng::RenderCommand command;
-    command.material = &m_material;
-    command.mesh = m_mesh.get();
+void Game::Update(float)
+{
+    if (eng::Engine::GetInstance().GetInputManager().WasKeyPressed(GLFW_KEY_ESCAPE))
+    {
+        SetNeedsToBeClosed(true);
+    }
+
+    // Rendered between the last two simulation steps, only moving parts of the hierarchy are re-uploaded
+    m_transforms.Interpolate(eng::Engine::GetInstance().GetInterpolationAlpha());
+    for (int32_t transform : m_transforms.GetInterpolatedTransforms())
+    {
+        m_instances->SetTransform(m_instanceOfTransform[transform],
+            m_transforms.GetInterpolatedWorldMatrix(transform));
+    }
 
     auto& renderQueue = eng::Engine::GetInstance().GetRenderQueue();
-    renderQueue.Submit(command);
+    renderQueue.SubmitInstances(m_instances.get());
 }
 
-void Game::Destroy()
+eng::Task<> Game::ReverseSpin(eng::Entity entity, float interval)
 {
+    auto& scheduler = eng::Engine::GetInstance().GetTaskScheduler();
+    while (m_world.IsAlive(entity))
+    {
+        co_await scheduler.Delay(interval);
+        if (Spin* spin = m_world.GetComponent<Spin>(entity))
+        {
+            spin->speed = -spin->speed;
+        }
+    }
+}
 
+void Game::Destroy()
+{
+    m_instances.reset();
 }
\ No newline at end of file
@@ -2,16 +2,34 @@
 #include <eng.h>
 #include <memory>
 
+// Turns a transform around z at a constant rate
+struct Spin
+{
+    int32_t transform;
+    float speed;
+    float angle;
+};
+
 class Game : public eng::Application
 {
 public:
     bool Init() override;
+    void FixedUpdate(float fixedDeltaTime) override;
     void Update(float deltaTime) override;
     void Destroy() override;
 
 private:
+    // Flips the spin direction of the entity every few seconds
+    eng::Task<> ReverseSpin(eng::Entity entity, float interval);
+
     eng::Material m_material;
     std::unique_ptr<eng::Mesh> m_mesh;
+    std::unique_ptr<eng::GpuInstanceBatch> m_instances;
+    eng::TransformHierarchy m_transforms;
+    std::vector<uint32_t> m_instanceOfTransform;
+    int32_t m_root = eng::TransformHierarchy::NullTransform;
+    eng::World m_world;
+    eng::Query* m_spinning = nullptr;
     float m_offsetX = 0.0f;
     float m_offsetY = 0.0f;
 };
\ No newline at end of file